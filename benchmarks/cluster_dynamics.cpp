@@ -0,0 +1,144 @@
+// Microbenchmarks of the CPU right hand side, the per step sums, the rate
+// functions and a full run, across cluster sizes. Throughput is reported as
+// items per second, one item being one cluster size.
+//
+// Usage: bench_cluster_dynamics [google benchmark flags]
+//   e.g. --benchmark_filter=system --benchmark_format=json
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cluster_dynamics/cluster_dynamics.hpp"
+#include "cluster_dynamics/cluster_dynamics_config.hpp"
+#include "cpu/cluster_dynamics_cpu_impl.hpp"
+#include "model/material.hpp"
+#include "model/nuclear_reactor.hpp"
+
+namespace {
+constexpr int64_t smallest_size = 10;
+constexpr int64_t largest_size = 100000;
+
+ClusterDynamicsConfig make_config(size_t max_cluster_size) {
+  ClusterDynamicsConfig config;
+  materials::SA304(config.material);
+  nuclear_reactors::OSIRIS(config.reactor);
+  config.max_cluster_size = max_cluster_size;
+  config.init_interstitials = std::vector<gp_float>(max_cluster_size, 0.);
+  config.init_vacancies = std::vector<gp_float>(max_cluster_size, 0.);
+  // The dense Newton matrix would not fit in memory for the large sizes
+  config.linear_solver = LinearSolverType::arrowhead;
+  return config;
+}
+
+/** @brief Returns a simulation whose concentrations are all nonzero, so no
+ * branch of the right hand side is skipped.
+ */
+std::unique_ptr<ClusterDynamicsCpuImpl> make_impl(size_t max_cluster_size) {
+  ClusterDynamicsConfig config = make_config(max_cluster_size);
+  auto cd = std::make_unique<ClusterDynamicsCpuImpl>(config, 1);
+  for (size_t n = 1; n <= max_cluster_size; ++n) {
+    cd->interstitials[n] = 1e12 / (gp_float)(n * n);
+    cd->vacancies[n] = 3e11 / (gp_float)n;
+  }
+  return cd;
+}
+
+void set_cluster_sizes_processed(benchmark::State& state) {
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_System(benchmark::State& state) {
+  const auto cd = make_impl(state.range(0));
+  N_Vector derivatives = N_VClone(cd->state);
+  for (auto _ : state) {
+    ClusterDynamicsCpuImpl::system(0., cd->state, derivatives, cd.get());
+    benchmark::ClobberMemory();
+  }
+  N_VDestroy(derivatives);
+  set_cluster_sizes_processed(state);
+}
+
+void BM_StepInit(benchmark::State& state) {
+  const auto cd = make_impl(state.range(0));
+  for (auto _ : state) {
+    cd->step_init();
+    benchmark::ClobberMemory();
+  }
+  set_cluster_sizes_processed(state);
+}
+
+using RateFunction = gp_float (ClusterDynamicsCpuImpl::*)(size_t) const;
+
+/** @brief Evaluates a rate function once for every cluster size away from
+ * the boundaries, where the concentration derivatives are special cased.
+ */
+void BM_Rate(benchmark::State& state, RateFunction rate) {
+  const auto cd = make_impl(state.range(0));
+  const size_t N = state.range(0);
+  for (auto _ : state) {
+    for (size_t n = 2; n < N; ++n)
+      benchmark::DoNotOptimize(((*cd).*rate)(n));
+  }
+  set_cluster_sizes_processed(state);
+}
+
+/** @brief Integrates the default OSIRIS irradiation of SA304 for one
+ * second, including the creation of the simulation but not of its config.
+ */
+void BM_Run(benchmark::State& state) {
+  ClusterDynamicsConfig config = make_config(state.range(0));
+  for (auto _ : state) {
+    ClusterDynamics cd = ClusterDynamics::cpu(config);
+    benchmark::DoNotOptimize(cd.run(0., 1.));
+  }
+  set_cluster_sizes_processed(state);
+}
+}  // namespace
+
+BENCHMARK(BM_System)
+    ->RangeMultiplier(10)
+    ->Range(smallest_size, largest_size);
+BENCHMARK(BM_StepInit)
+    ->RangeMultiplier(10)
+    ->Range(smallest_size, largest_size);
+BENCHMARK(BM_Run)
+    ->RangeMultiplier(10)
+    ->Range(smallest_size, largest_size)
+    ->Unit(benchmark::kMillisecond);
+
+int main(int argc, char* argv[]) {
+  const std::pair<std::string, RateFunction> rates[] = {
+      {"ii_emission", &ClusterDynamicsCpuImpl::ii_emission},
+      {"vv_emission", &ClusterDynamicsCpuImpl::vv_emission},
+      {"ii_absorption", &ClusterDynamicsCpuImpl::ii_absorption},
+      {"iv_absorption", &ClusterDynamicsCpuImpl::iv_absorption},
+      {"vi_absorption", &ClusterDynamicsCpuImpl::vi_absorption},
+      {"vv_absorption", &ClusterDynamicsCpuImpl::vv_absorption},
+      {"i_bias_factor", &ClusterDynamicsCpuImpl::i_bias_factor},
+      {"v_bias_factor", &ClusterDynamicsCpuImpl::v_bias_factor},
+      {"i_binding_energy", &ClusterDynamicsCpuImpl::i_binding_energy},
+      {"v_binding_energy", &ClusterDynamicsCpuImpl::v_binding_energy},
+      {"cluster_radius", &ClusterDynamicsCpuImpl::cluster_radius},
+      {"i_dislocation_loop_unfault_probability",
+       &ClusterDynamicsCpuImpl::i_dislocation_loop_unfault_probability},
+      {"i_concentration_derivative",
+       &ClusterDynamicsCpuImpl::i_concentration_derivative},
+      {"v_concentration_derivative",
+       &ClusterDynamicsCpuImpl::v_concentration_derivative},
+  };
+  for (const auto& [name, rate] : rates) {
+    benchmark::RegisterBenchmark(("BM_Rate/" + name).c_str(), BM_Rate, rate)
+        ->RangeMultiplier(10)
+        ->Range(smallest_size, largest_size);
+  }
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,85 @@
+// Measures the throughput of the CPU right hand side for every instruction set
+// the transport kernels support, across cluster sizes.
+//
+// Usage: bench_transport_kernel [min seconds per measurement] [threads]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include "cluster_dynamics/cluster_dynamics_config.hpp"
+#include "cpu/cluster_dynamics_cpu_impl.hpp"
+#include "cpu/transport_kernel.hpp"
+#include "model/material.hpp"
+#include "model/nuclear_reactor.hpp"
+
+namespace {
+/** @brief Returns the mean time of one right hand side evaluation in seconds.
+ */
+double time_system(ClusterDynamicsCpuImpl& cd, N_Vector derivatives,
+                   double min_seconds) {
+  using clock = std::chrono::steady_clock;
+
+  // Warm up the caches and the branch predictors
+  for (int i = 0; i < 10; ++i)
+    ClusterDynamicsCpuImpl::system(0., cd.state, derivatives, &cd);
+
+  size_t evaluations = 0;
+  size_t batch = 1;
+  const clock::time_point start = clock::now();
+  double elapsed = 0.;
+  while (elapsed < min_seconds) {
+    for (size_t i = 0; i < batch; ++i)
+      ClusterDynamicsCpuImpl::system(0., cd.state, derivatives, &cd);
+    evaluations += batch;
+    batch *= 2;
+    elapsed = std::chrono::duration<double>(clock::now() - start).count();
+  }
+
+  return elapsed / evaluations;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const double min_seconds = argc > 1 ? std::atof(argv[1]) : 0.2;
+  const size_t num_threads = argc > 2 ? std::atoi(argv[2]) : 1;
+
+  std::printf("threads: %zu\n", num_threads);
+  std::printf("%-10s %-8s %14s %18s\n", "clusters", "simd", "ns / rhs",
+              "clusters / s");
+
+  for (size_t max_cluster_size : {10, 100, 1000, 10000, 100000}) {
+    ClusterDynamicsConfig config;
+    materials::SA304(config.material);
+    nuclear_reactors::OSIRIS(config.reactor);
+    config.max_cluster_size = max_cluster_size;
+    config.init_interstitials = std::vector<gp_float>(max_cluster_size, 0.);
+    config.init_vacancies = std::vector<gp_float>(max_cluster_size, 0.);
+    // The dense Newton matrix would not fit in memory for the large sizes
+    config.linear_solver = LinearSolverType::arrowhead;
+
+    ClusterDynamicsCpuImpl cd(config, num_threads);
+    for (size_t n = 1; n <= max_cluster_size; ++n) {
+      cd.interstitials[n] = 1e12 / (gp_float)(n * n);
+      cd.vacancies[n] = 3e11 / (gp_float)n;
+    }
+    N_Vector derivatives = N_VClone(cd.state);
+
+    for (SimdLevel level :
+         {SimdLevel::scalar, SimdLevel::avx2, SimdLevel::avx512}) {
+      cd.transport_kernel = select_transport_kernel(level);
+      if (cd.transport_kernel.level != level) continue;
+
+      const double seconds = time_system(cd, derivatives, min_seconds);
+      std::printf("%-10zu %-8s %14.1f %18.4g\n", max_cluster_size,
+                  simd_level_name(level), seconds * 1e9,
+                  max_cluster_size / seconds);
+    }
+
+    N_VDestroy(derivatives);
+  }
+
+  return 0;
+}
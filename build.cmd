@@ -40,6 +40,10 @@ if "%option_help%" neq "" (
   echo Targets:
   echo   cd                  The Cluster Dynamics library
   echo   gpies               The CLI for the Cluster Dynamics library
+  echo   cdtests             GoogleTest based tests for Cluster Dynamics library
+  echo   cdbench             Throughput benchmark of the Cluster Dynamics CPU kernels
+  echo   cdmicrobench        Google Benchmark microbenchmarks of the Cluster Dynamics
+  echo                       CPU right hand side, rates and runs
   echo   db                  The DB Library
   echo   dbcli               The CLI for the DB library
   echo   dbtests             GoogleTest based tests for DB library
@@ -268,6 +272,12 @@ goto :eof
   ) else if "%1" equ "gpies" (
     set cpu_runnable_targets=%cpu_runnable_targets% gpies
     set cuda_runnable_targets=%cuda_runnable_targets% gpies
+  ) else if "%1" equ "cdtests" (
+    set cpu_runnable_targets=%cpu_runnable_targets% test_clusterdynamics
+  ) else if "%1" equ "cdbench" (
+    set cpu_runnable_targets=%cpu_runnable_targets% bench_transport_kernel
+  ) else if "%1" equ "cdmicrobench" (
+    set cpu_runnable_targets=%cpu_runnable_targets% bench_cluster_dynamics
   ) else if "%1" equ "db" (
     set cpu_targets=%cpu_targets% clientdb
   ) else if "%1" equ "dbcli" (
@@ -70,6 +70,10 @@ if [ "$HELP" ]; then
   echo "Targets:"
   echo "  cd                  The Cluster Dynamics library"
   echo "  gpies               The CLI for the Cluster Dynamics library"
+  echo "  cdtests             GoogleTest based tests for Cluster Dynamics library"
+  echo "  cdbench             Throughput benchmark of the Cluster Dynamics CPU kernels"
+  echo "  cdmicrobench        Google Benchmark microbenchmarks of the Cluster Dynamics"
+  echo "                      CPU right hand side, rates and runs"
   echo "  db                  The DB Library"
   echo "  dbcli               The CLI for the DB library"
   echo "  dbtests             GoogleTest based tests for DB library"
@@ -120,6 +124,15 @@ for target in "${TARGETS[@]}"; do
       CPU_RUNNABLE_TARGETS+=("gpies")
       CUDA_RUNNABLE_TARGETS+=("gpies")
       ;;
+    cdtests)
+      CPU_RUNNABLE_TARGETS+=("test_clusterdynamics")
+      ;;
+    cdbench)
+      CPU_RUNNABLE_TARGETS+=("bench_transport_kernel")
+      ;;
+    cdmicrobench)
+      CPU_RUNNABLE_TARGETS+=("bench_cluster_dynamics")
+      ;;
     db)
       CPU_TARGETS+=("clientdb")
       ;;
@@ -1,19 +1,35 @@
+#include <algorithm>
 #include <array>
 #include <boost/program_options.hpp>
 #include <cmath>
+#include <condition_variable>
 #include <cstring>
+#include <exception>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "client_db/client_db.hpp"
+#include "cluster_dynamics/async_sink.hpp"
 #include "cluster_dynamics/cluster_dynamics.hpp"
 #include "cluster_dynamics/cluster_dynamics_config.hpp"
+#include "cluster_dynamics/global_sensitivity.hpp"
 #include "model/material.hpp"
 #include "model/nuclear_reactor.hpp"
 #include "utils/consumers/cli_arg_consumer.hpp"
+#include "utils/peak_rss.hpp"
 #include "utils/progress_bar.hpp"
+#include "utils/scalar_observable.hpp"
 #include "utils/sensitivity_variable.hpp"
+#include "utils/thread_pool.hpp"
 #include "utils/timer.hpp"
 
 namespace po = boost::program_options;
@@ -24,98 +40,131 @@ std::ostream os(std::cout.rdbuf());
 
 bool csv = false;
 bool step_print = false;
+bool show_stats = false;
+bool cuda = false;
+
+// Checkpoints are saved every checkpoint_every seconds of simulation time,
+// 0 turns them off
+gp_float checkpoint_every = 0.;
+std::string checkpoint_file = "gpies.checkpoint";
 
 ClusterDynamicsConfig cd_config;
 
-void print_reactor() {
+void print_reactor(const ClusterDynamicsConfig& config = cd_config) {
   std::cout
-      << cd_config.reactor.species << "\nflux: " << cd_config.reactor.get_flux()
+      << config.reactor.species << "\nflux: " << config.reactor.get_flux()
       << " dpa/s"
-      << "\ntemperature: " << cd_config.reactor.get_temperature() << " kelvin"
-      << "\nrecombination rate: " << cd_config.reactor.get_recombination()
-      << "\nbi-interstitial generation rate: " << cd_config.reactor.get_i_bi()
-      << "\ntri-interstitial generation rate: " << cd_config.reactor.get_i_tri()
+      << "\ntemperature: " << config.reactor.get_temperature() << " kelvin"
+      << "\nrecombination rate: " << config.reactor.get_recombination()
+      << "\nbi-interstitial generation rate: " << config.reactor.get_i_bi()
+      << "\ntri-interstitial generation rate: " << config.reactor.get_i_tri()
       << "\nquad-interstitial generation rate: "
-      << cd_config.reactor.get_i_quad()
-      << "\nbi-vacancy generation rate: " << cd_config.reactor.get_v_bi()
-      << "\ntri-vacancy generation rate: " << cd_config.reactor.get_v_tri()
-      << "\nquad-vacancy generation rate: " << cd_config.reactor.get_v_quad()
+      << config.reactor.get_i_quad()
+      << "\nbi-vacancy generation rate: " << config.reactor.get_v_bi()
+      << "\ntri-vacancy generation rate: " << config.reactor.get_v_tri()
+      << "\nquad-vacancy generation rate: " << config.reactor.get_v_quad()
       << "\ndislocation density evolution: "
-      << cd_config.reactor.get_dislocation_density_evolution() << std::endl;
+      << config.reactor.get_dislocation_density_evolution() << std::endl;
+
+  const ReactorHistory& history = config.reactor_history;
+  if (!history.empty())
+    std::cout << "reactor history: " << history.points.size() << " "
+              << (history.interpolation == ReactorHistoryInterpolation::linear
+                      ? "linear"
+                      : "constant")
+              << " points from " << history.points.front().time << " to "
+              << history.points.back().time << " s" << std::endl;
 }
 
-void print_material() {
-  std::cout << cd_config.material.species << "\ninterstitial migration: "
-            << cd_config.material.get_i_migration() << " eV"
-            << "\nvacancy migration: " << cd_config.material.get_v_migration()
+void print_material(const ClusterDynamicsConfig& config = cd_config) {
+  std::cout << config.material.species << "\ninterstitial migration: "
+            << config.material.get_i_migration() << " eV"
+            << "\nvacancy migration: " << config.material.get_v_migration()
             << " eV"
             << "\ninitial interstitial diffusion: "
-            << cd_config.material.get_i_diffusion_0() << " cm^2/s"
+            << config.material.get_i_diffusion_0() << " cm^2/s"
             << "\ninitial vacancy diffusion: "
-            << cd_config.material.get_v_diffusion_0() << " cm^2/s"
+            << config.material.get_v_diffusion_0() << " cm^2/s"
             << "\ninterstitial formation: "
-            << cd_config.material.get_i_formation() << " eV"
-            << "\nvacancy formation: " << cd_config.material.get_v_formation()
+            << config.material.get_i_formation() << " eV"
+            << "\nvacancy formation: " << config.material.get_v_formation()
             << " eV"
-            << "\ninterstitial binding: " << cd_config.material.get_i_binding()
+            << "\ninterstitial binding: " << config.material.get_i_binding()
             << " eV"
-            << "\nvacancy binding: " << cd_config.material.get_v_binding()
+            << "\nvacancy binding: " << config.material.get_v_binding()
             << " eV"
             << "\nrecombination radius: "
-            << cd_config.material.get_recombination_radius() << " cm"
+            << config.material.get_recombination_radius() << " cm"
             << "\ninterstitial loop bias: "
-            << cd_config.material.get_i_loop_bias()
+            << config.material.get_i_loop_bias()
             << "\ninterstitial dislocation bias: "
-            << cd_config.material.get_i_dislocation_bias()
+            << config.material.get_i_dislocation_bias()
             << "\ninterstitial dislocation bias param: "
-            << cd_config.material.get_i_dislocation_bias_param()
-            << "\nvacancy loop bias: " << cd_config.material.get_v_loop_bias()
+            << config.material.get_i_dislocation_bias_param()
+            << "\nvacancy loop bias: " << config.material.get_v_loop_bias()
             << "\nvacancy dislocation bias: "
-            << cd_config.material.get_v_dislocation_bias()
+            << config.material.get_v_dislocation_bias()
             << "\nvacancy dislocation bias param: "
-            << cd_config.material.get_v_dislocation_bias_param()
+            << config.material.get_v_dislocation_bias_param()
             << "\ninitial dislocation density: "
-            << cd_config.material.get_dislocation_density_0() << " cm^-2"
-            << "\ngrain size: " << cd_config.material.get_grain_size() << " cm"
-            << "\nlattice parameter: " << cd_config.material.get_lattice_param()
+            << config.material.get_dislocation_density_0() << " cm^-2"
+            << "\ngrain size: " << config.material.get_grain_size() << " cm"
+            << "\nlattice parameter: " << config.material.get_lattice_param()
             << " cm"
             << "\nburgers vector (lattice_parameter / sqrt(2)): "
-            << cd_config.material.get_burgers_vector() << " cm"
+            << config.material.get_burgers_vector() << " cm"
             << "\natomic volume (lattice_parameter^3 / 4): "
-            << cd_config.material.get_atomic_volume() << "cm^3" << std::endl;
+            << config.material.get_atomic_volume() << "cm^3" << std::endl;
 }
 
-void print_start_message() {
+void print_start_message(const ClusterDynamicsConfig& config = cd_config) {
   std::cout << "\nG-PIES SIMULATION CONFIGURATION\n"
-            << "simulation time: " << cd_config.simulation_time
-            << "  time delta: " << cd_config.time_delta
-            << "  sample interval: " << cd_config.sample_interval
+            << "simulation time: " << config.simulation_time
+            << "  time delta: " << config.time_delta
+            << "  sample interval: " << config.sample_interval
             << "  max cluster size: "
-            << static_cast<int>(cd_config.max_cluster_size)
+            << static_cast<int>(config.max_cluster_size)
             << "  data validation: "
-            << (cd_config.data_validation_on ? "on" : "off") << std::endl
+            << (config.data_validation_on ? "on" : "off") << std::endl
             << "Integration Settings\n"
-            << "  relative tolerance: " << cd_config.relative_tolerance
-            << "  absolute tolerance: " << cd_config.absolute_tolerance
+            << "  relative tolerance: " << config.relative_tolerance
+            << "  absolute tolerance: " << config.absolute_tolerance
             << "  max num integration steps: "
-            << cd_config.max_num_integration_steps
-            << "  min integration step: " << cd_config.min_integration_step
-            << "  max integration step: " << cd_config.max_integration_step
-            << std::endl;
+            << config.max_num_integration_steps
+            << "  min integration step: " << config.min_integration_step
+            << "  max integration step: " << config.max_integration_step;
+  for (const auto& [key, value] : linear_solver_types) {
+    if (value == config.linear_solver)
+      std::cout << "  linear solver: " << key;
+  }
+  if (config.linear_solver == LinearSolverType::gmres ||
+      config.linear_solver == LinearSolverType::bicgstab)
+    std::cout << "  krylov subspace size: " << config.krylov_subspace_size;
+  if (config.group_threshold > 0)
+    std::cout << "  group threshold: " << config.group_threshold
+              << "  group growth: " << config.group_growth;
+  if (config.continuum_threshold > 0)
+    std::cout << "  continuum threshold: " << config.continuum_threshold
+              << "  continuum growth: " << config.continuum_growth;
+  if (config.initial_max_cluster_size > 0)
+    std::cout << "  initial max cluster size: "
+              << config.initial_max_cluster_size
+              << "  tail threshold: " << config.tail_threshold;
+  std::cout << std::endl;
 
   std::cout << "\nReactor Settings\n";
-  print_reactor();
+  print_reactor(config);
 
   std::cout << "\nMaterial Settings\n";
-  print_material();
+  print_material(config);
 
   std::cout << std::endl;
 
   std::cout << "\nInitial Defect Clustering";
   bool is_perfect_lattice = true;
-  for (size_t n = 1; n < cd_config.max_cluster_size; ++n) {
-    if (cd_config.init_interstitials[n] > 0. ||
-        cd_config.init_vacancies[n] > 0.) {
+  for (size_t n = 1; n < config.max_cluster_size; ++n) {
+    if (config.init_interstitials[n] > 0. ||
+        config.init_vacancies[n] > 0.) {
       // only print header if there is information to display
       if (is_perfect_lattice) {
         is_perfect_lattice = false;
@@ -123,8 +172,8 @@ void print_start_message() {
             << "\nCluster Size\t\t-\t\tInterstitials\t\t-\t\tVacancies\n\n";
       }
       std::cout << (long long unsigned int)n << "\t\t\t\t\t"
-                << cd_config.init_interstitials[n] << "\t\t\t"
-                << cd_config.init_vacancies[n] << std::endl;
+                << config.init_interstitials[n] << "\t\t\t"
+                << config.init_vacancies[n] << std::endl;
     }
   }
 
@@ -136,17 +185,18 @@ void print_start_message() {
   std::cout << std::endl;
 }
 
-void print_state(const ClusterDynamicsState& state) {
+// The printers read the groups in place rather than expanding a copy
+void print_state(const ClusterDynamicsStateView& state) {
   os << "\nTime=" << state.time;
 
-  size_t size = state.interstitials.size();
+  size_t size = state.size();
 
   os << "\nCluster Size\t\t-\t\tInterstitials\t\t-\t\tVacancies\n\n";
   for (size_t n = 1; n < size; ++n) {
     for (size_t n = 1; n < size; ++n) {
       os << (long long unsigned int)n << "\t\t\t\t\t" << std::setprecision(13)
-         << state.interstitials[n] << "\t\t\t" << std::setprecision(15)
-         << state.vacancies[n] << std::endl;
+         << state.interstitial(n) << "\t\t\t" << std::setprecision(15)
+         << state.vacancy(n) << std::endl;
     }
 
     os << "\nDislocation Network Density: " << state.dislocation_density
@@ -154,15 +204,42 @@ void print_state(const ClusterDynamicsState& state) {
   }
 }
 
-void print_csv(const ClusterDynamicsState& state) {
+void print_csv(const ClusterDynamicsStateView& state) {
   os << state.time << ", " << state.dislocation_density;
+  // The adaptive max cluster size may track fewer sizes than the columns
+  const size_t size = state.size();
   for (uint64_t n = 1; n < cd_config.max_cluster_size; ++n) {
-    os << "," << state.interstitials[n] << "," << state.vacancies[n];
+    if (n < size)
+      os << "," << state.interstitial(n) << "," << state.vacancy(n);
+    else
+      os << ",0,0";
   }
   os << std::endl;
 }
 
-void step_print_prompt(const ClusterDynamicsState& state) {
+void print_stats(const ClusterDynamicsStats& stats) {
+  std::cout << "\nSolver Statistics\n"
+            << "  steps: " << stats.steps << "\n"
+            << "  rhs evaluations: " << stats.rhs_evaluations << "\n"
+            << "  jacobian evaluations: " << stats.jacobian_evaluations << "\n"
+            << "  linear solver setups: " << stats.linear_solver_setups << "\n"
+            << "  linear iterations: " << stats.linear_iterations << "\n"
+            << "  nonlinear iterations: " << stats.nonlinear_iterations << "\n"
+            << "  error test failures: " << stats.error_test_failures << "\n"
+            << "  nonlinear failures: " << stats.nonlinear_failures << "\n"
+            << "  last step: " << stats.last_step << " s (order "
+            << stats.last_order << ")\n"
+            << "  current step: " << stats.current_step << " s (order "
+            << stats.current_order << ")\n"
+            << "Wall Time: " << stats.wall_time() << " s\n"
+            << "  rhs: " << stats.rhs_time << " s\n"
+            << "  jacobian: " << stats.jacobian_time << " s\n"
+            << "  linear setup: " << stats.linear_setup_time << " s\n"
+            << "  linear solve: " << stats.linear_solve_time << " s\n"
+            << "  integrator: " << stats.integrator_time << " s\n";
+}
+
+void step_print_prompt(const ClusterDynamicsStateView& state) {
   if (csv) {
     print_csv(state);
   } else {
@@ -193,7 +270,8 @@ void print_simulation_history(ClientDb& db, bool print_details) {
 
       // Print the state(s) of the simulation
       if (print_details) {
-        print_state(s.cd_state);
+        print_state(s.cd_state.view());
+        if (show_stats) print_stats(s.stats);
         os << "\n\n";
       }
     }
@@ -202,108 +280,27 @@ void print_simulation_history(ClientDb& db, bool print_details) {
   }
 }
 
-void profile() {
-  std::vector<gp_float> times;
-  Timer timer;
-
-  ClusterDynamicsState state;
-
-  nuclear_reactors::OSIRIS(cd_config.reactor);
-  materials::SA304(cd_config.material);
-
-  ClusterDynamics cd = ClusterDynamics::cpu(cd_config);
-  cd.run(1e-5, 1e-5);
-
-  for (int n = 100; n < 400000; n += 10000) {
-    os << "N=" << n << std::endl;
-    ClusterDynamics cd = ClusterDynamics::cpu(cd_config);
-
-    timer.Start();
-    state = cd.run(1e-5, 1e-5);
-    gp_float time = timer.Stop();
-
-    os << std::endl << time;
-  }
+gp_float get_sa_var_value() {
+  return sensitivity_variable_value(cd_config, cd_config.sa_var);
 }
 
 gp_float sa_update_config() {
-  switch (cd_config.sa_var) {
-    case SensitivityVariable::interstitial_migration_ev:
-      cd_config.material.set_i_migration(cd_config.material.get_i_migration() +
-                                         cd_config.sa_var_delta);
-      return cd_config.material.get_i_migration();
-    case SensitivityVariable::vacancy_migration_ev:
-      cd_config.material.set_v_migration(cd_config.material.get_v_migration() +
-                                         cd_config.sa_var_delta);
-      return cd_config.material.get_v_migration();
-    case SensitivityVariable::interstitial_formation_ev:
-      cd_config.material.set_i_formation(cd_config.material.get_i_formation() +
-                                         cd_config.sa_var_delta);
-      return cd_config.material.get_i_formation();
-    case SensitivityVariable::vacancy_formation_ev:
-      cd_config.material.set_v_formation(cd_config.material.get_v_formation() +
-                                         cd_config.sa_var_delta);
-      return cd_config.material.get_v_formation();
-    case SensitivityVariable::interstitial_binding_ev:
-      cd_config.material.set_i_binding(cd_config.material.get_i_binding() +
-                                       cd_config.sa_var_delta);
-      return cd_config.material.get_i_binding();
-    case SensitivityVariable::vacancy_binding_ev:
-      cd_config.material.set_v_binding(cd_config.material.get_v_binding() +
-                                       cd_config.sa_var_delta);
-      return cd_config.material.get_v_binding();
-    case SensitivityVariable::initial_dislocation_density_cm:
-      cd_config.material.set_dislocation_density_0(
-          cd_config.material.get_dislocation_density_0() +
-          cd_config.sa_var_delta);
-      return cd_config.material.get_dislocation_density_0();
-    case SensitivityVariable::flux_dpa_s:
-      cd_config.reactor.set_flux(cd_config.reactor.get_flux() +
-                                 cd_config.sa_var_delta);
-      return cd_config.reactor.get_flux();
-    case SensitivityVariable::temperature_kelvin:
-      cd_config.reactor.set_temperature(cd_config.reactor.get_temperature() +
-                                        cd_config.sa_var_delta);
-      return cd_config.reactor.get_temperature();
-    case SensitivityVariable::dislocation_density_evolution:
-      cd_config.reactor.set_dislocation_density_evolution(
-          cd_config.reactor.get_dislocation_density_evolution() +
-          cd_config.sa_var_delta);
-      return cd_config.reactor.get_dislocation_density_evolution();
-    default:
-      break;
-  }
-
-  return 0.;
+  set_sensitivity_variable(cd_config, cd_config.sa_var,
+                           get_sa_var_value() + cd_config.sa_var_delta);
+  return get_sa_var_value();
 }
 
-gp_float get_sa_var_value() {
-  switch (cd_config.sa_var) {
-    case SensitivityVariable::interstitial_migration_ev:
-      return cd_config.material.get_i_migration();
-    case SensitivityVariable::vacancy_migration_ev:
-      return cd_config.material.get_v_migration();
-    case SensitivityVariable::interstitial_formation_ev:
-      return cd_config.material.get_i_formation();
-    case SensitivityVariable::vacancy_formation_ev:
-      return cd_config.material.get_v_formation();
-    case SensitivityVariable::interstitial_binding_ev:
-      return cd_config.material.get_i_binding();
-    case SensitivityVariable::vacancy_binding_ev:
-      return cd_config.material.get_v_binding();
-    case SensitivityVariable::initial_dislocation_density_cm:
-      return cd_config.material.get_dislocation_density_0();
-    case SensitivityVariable::flux_dpa_s:
-      return cd_config.reactor.get_flux();
-    case SensitivityVariable::temperature_kelvin:
-      return cd_config.reactor.get_temperature();
-    case SensitivityVariable::dislocation_density_evolution:
-      return cd_config.reactor.get_dislocation_density_evolution();
-    default:
-      break;
-  }
-
-  return 0.;
+/** @brief Returns the times at which the simulation state is printed, every
+ * sample interval after start_time until the simulation time is reached.
+ */
+std::vector<gp_float> sample_times(gp_float start_time = 0.) {
+  std::vector<gp_float> times;
+  for (size_t n = 1;
+       (gp_float)(n - 1) * cd_config.sample_interval < cd_config.simulation_time;
+       ++n)
+    if ((gp_float)n * cd_config.sample_interval > start_time)
+      times.push_back((gp_float)n * cd_config.sample_interval);
+  return times;
 }
 
 ClusterDynamicsState run_simulation(ClusterDynamics& cd) {
@@ -333,36 +330,173 @@ ClusterDynamicsState run_simulation(ClusterDynamics& cd) {
 
   // --------------------------------------------------------------------------------------------
   // main simulation loop
-  for (gp_float t = 0.; t < cd_config.simulation_time; t = state.time) {
-    if (!step_print) {
-      bar.update();
+  const std::vector<gp_float> times = sample_times(cd.get_time());
+
+  // The rows are written by a sink, on a background thread when they go to a
+  // file so writing them does not hold up the integration
+  std::unique_ptr<AsyncSink> csv_writer;
+  size_t csv_sink = 0;
+  if (csv && !step_print) {
+    ClusterDynamicsSinkFn print_row = [](const ClusterDynamicsStateView& sample,
+                                         const ClusterDynamicsStats&) {
+      print_csv(sample);
+    };
+    if (os.rdbuf() != std::cout.rdbuf()) {
+      csv_writer = std::make_unique<AsyncSink>(
+          std::vector<ClusterDynamicsSinkFn>{print_row});
+      print_row = csv_writer->sink();
     }
+    csv_sink = cd.add_sink(times, print_row);
+  }
 
-    // run simulation for this time slice
-    state = cd.run(cd_config.time_delta, cd_config.sample_interval);
+  gp_float next_checkpoint = cd.get_time() + checkpoint_every;
+  try {
+    state = cd.sample(times, [&](const ClusterDynamicsState& sample) {
+      if (!step_print) {
+        bar.update();
+      }
 
-    if (step_print) {
-      step_print_prompt(state);
-    } else if (csv) {
-      print_csv(state);
-    }
+      // Checkpoints are taken at the first sample past each interval
+      if (checkpoint_every > 0. && sample.time >= next_checkpoint) {
+        cd.save_checkpoint(checkpoint_file);
+        next_checkpoint = (std::floor(sample.time / checkpoint_every) + 1.) *
+                          checkpoint_every;
+      }
+
+      if (step_print) {
+        step_print_prompt(sample.view());
+      }
+    });
+    if (csv_writer) csv_writer->flush();
+  } catch (...) {
+    cd.remove_sink(csv_sink);
+    throw;
   }
+  cd.remove_sink(csv_sink);
   // --------------------------------------------------------------------------------------------
 
   // --------------------------------------------------------------------------------------------
   // print results
   if (!csv && !step_print) {
-    print_state(state);
+    print_state(state.view());
   }
   // --------------------------------------------------------------------------------------------
 
   return state;
 }
 
+ClusterDynamicsState run_steady_state(ClusterDynamics& cd) {
+  print_start_message();
+  std::cout << "G-PIES Steady State Solver Running..." << std::endl;
+
+  const ClusterDynamicsState state = cd.solve_steady_state();
+
+  if (csv) {
+    os << "Time (s), Dislocation Density (cm^-2),";
+    for (size_t i = 1; i < cd_config.max_cluster_size; ++i) {
+      os << "i" << i << ",v" << i << ",";
+    }
+    os << "\n";
+    print_csv(state.view());
+  } else {
+    print_state(state.view());
+  }
+
+  return state;
+}
+
+void print_sensitivity(const ClusterDynamicsSensitivity& sensitivity) {
+  os << "\nTime=" << sensitivity.time;
+
+  const size_t size = sensitivity.interstitials.size();
+
+  os << "\nCluster Size\t\t-\t\tdInterstitials/dp\t\t-\t\tdVacancies/dp\n\n";
+  for (size_t n = 1; n < size; ++n) {
+    os << (long long unsigned int)n << "\t\t\t\t\t" << std::setprecision(13)
+       << sensitivity.interstitials[n] << "\t\t\t" << std::setprecision(15)
+       << sensitivity.vacancies[n] << std::endl;
+  }
+
+  os << "\ndDislocation Network Density/dp: " << sensitivity.dislocation_density
+     << std::endl;
+}
+
+void print_sensitivity_csv(const ClusterDynamicsSensitivity& sensitivity) {
+  os << sensitivity.time << ", " << sensitivity.dislocation_density;
+  for (size_t n = 1; n < sensitivity.interstitials.size(); ++n) {
+    os << "," << sensitivity.interstitials[n] << ","
+       << sensitivity.vacancies[n];
+  }
+  os << std::endl;
+}
+
+// Integrates the state together with its derivative with respect to the
+// sensitivity variable, in a single simulation.
+ClusterDynamicsSensitivity run_forward_sensitivity(ClusterDynamics& cd) {
+  print_start_message();
+  std::cout << "G-PIES Forward Sensitivity Simulation Running..." << std::endl;
+
+  cd.enable_sensitivities({cd_config.sa_var});
+
+  if (csv) {
+    os << "Time (s), dDislocation Density / dp,";
+    for (size_t i = 1; i < cd_config.max_cluster_size; ++i) {
+      os << "di" << i << "/dp,dv" << i << "/dp,";
+    }
+    os << "\n";
+  }
+
+  cd.sample(sample_times(cd.get_time()), [&](const ClusterDynamicsState&) {
+    const ClusterDynamicsSensitivity sensitivity =
+        cd.get_sensitivities().front();
+    if (step_print) {
+      print_sensitivity(sensitivity);
+    } else if (csv) {
+      print_sensitivity_csv(sensitivity);
+    }
+  });
+
+  const ClusterDynamicsSensitivity sensitivity = cd.get_sensitivities().front();
+  if (!csv && !step_print) {
+    print_sensitivity(sensitivity);
+  }
+
+  return sensitivity;
+}
+
+// Runs the simulation once forwards and once backwards to differentiate an
+// observable of the end state with respect to every model parameter.
+std::map<std::string, gp_float> run_adjoint_gradient(
+    ClusterDynamics& cd, ScalarObservable observable) {
+  print_start_message();
+  std::cout << "G-PIES Adjoint Simulation Running..." << std::endl;
+
+  const std::map<std::string, gp_float> gradient = cd.adjoint_gradient(
+      cd_config.simulation_time - cd.get_time(), observable);
+
+  if (csv) {
+    os << "parameter,derivative\n";
+    for (const auto& [name, derivative] : gradient)
+      os << name << "," << derivative << "\n";
+  } else {
+    os << "\nTime=" << cd.get_time();
+    os << "\nParameter\t\t\t\t-\t\tDerivative\n\n";
+    for (const auto& [name, derivative] : gradient)
+      os << std::left << std::setw(32) << name << std::right
+         << std::setprecision(13) << derivative << "\n";
+  }
+  os << std::flush;
+
+  return gradient;
+}
+
 void emit_config_yaml(const std::string& filename) {
   YAML::Emitter out;
   YAML::Emitter sa_comment;
+  YAML::Emitter gsa_comment;
   YAML::Emitter arrays_comment;
+  YAML::Emitter history_comment;
+  YAML::Emitter benchmark_comment;
 
   arrays_comment
       << YAML::BeginMap << YAML::Key << "init-interstitials" << YAML::Value
@@ -390,12 +524,51 @@ void emit_config_yaml(const std::string& filename) {
       << YAML::Flow << std::vector<std::string>{"995", "1000", "4.3e-12"}
       << YAML::Comment("cluster concentrations for cluster sizes 995-1000")
       << YAML::EndSeq << YAML::EndMap << YAML::EndMap;
+  history_comment
+      << YAML::BeginMap << YAML::Key << "reactor-history" << YAML::Value
+      << YAML::BeginMap << YAML::Key << "interpolation" << YAML::Value
+      << "constant" << YAML::Key << "points" << YAML::Value << YAML::BeginSeq
+      << YAML::Flow << std::vector<std::string>{"0.0", "2.9e-7", "603.15"}
+      << YAML::Comment("[time, flux, temperature] from time 0 on")
+      << YAML::Flow << std::vector<std::string>{"2.6e+7", "0.0", "300.0"}
+      << YAML::Comment("outage") << YAML::EndSeq << YAML::Key << "cycles"
+      << YAML::Value << "60" << YAML::Key << "period" << YAML::Value
+      << "3.0e+7" << YAML::EndMap << YAML::EndMap;
   sa_comment << YAML::BeginMap << YAML::Key << "sensitivity-analysis"
              << YAML::Value << YAML::BeginMap << YAML::Key << "num-sims"
              << YAML::Value << "10" << YAML::Key << "sensitivity-var"
              << YAML::Value << "flux-dpa-s" << YAML::Key
              << "sensitivity-var-delta" << YAML::Value << "1.0e-7"
-             << YAML::EndMap << YAML::EndMap;
+             << YAML::Key << "jobs" << YAML::Value << "1" << YAML::EndMap
+             << YAML::EndMap;
+  gsa_comment
+      << YAML::BeginMap << YAML::Key << "sensitivity-analysis" << YAML::Value
+      << YAML::BeginMap << YAML::Key << "global-sensitivity" << YAML::Value
+      << "on" << YAML::Key << "sampling" << YAML::Value << "sobol"
+      << YAML::Key << "num-samples" << YAML::Value << "1024" << YAML::Key
+      << "seed" << YAML::Value << "0" << YAML::Key << "observables"
+      << YAML::Value << YAML::Flow
+      << std::vector<std::string>{"dislocation-density",
+                                  "vacancy-cluster-volume"}
+      << YAML::Key << "jobs" << YAML::Value << "1" << YAML::Key
+      << "parameter-ranges" << YAML::Value << YAML::BeginMap << YAML::Key
+      << "flux-dpa-s" << YAML::Value << YAML::Flow
+      << std::vector<std::string>{"2.0e-7", "4.0e-7"} << YAML::Key
+      << "temperature-kelvin" << YAML::Value << YAML::Flow
+      << std::vector<std::string>{"573.15", "633.15"} << YAML::EndMap
+      << YAML::EndMap << YAML::EndMap;
+
+  benchmark_comment
+      << YAML::BeginMap << YAML::Key << "benchmark" << YAML::Value
+      << YAML::BeginMap << YAML::Key << "max-cluster-sizes" << YAML::Value
+      << YAML::Flow << std::vector<std::string>{"100", "1000", "10000"}
+      << YAML::Key << "backends" << YAML::Value << YAML::Flow
+      << std::vector<std::string>{"cpu", "cpu-threaded"} << YAML::Key
+      << "linear-solvers" << YAML::Value << YAML::Flow
+      << std::vector<std::string>{"dense", "arrowhead", "gmres"} << YAML::Key
+      << "threads" << YAML::Value << "4" << YAML::Key << "warmup-runs"
+      << YAML::Value << "1" << YAML::Key << "runs" << YAML::Value << "5"
+      << YAML::EndMap << YAML::EndMap;
 
   out << YAML::BeginMap << YAML::Key << "simulation" << YAML::Value
       << YAML::BeginMap << YAML::Key << "time" << YAML::Value << "1.0e+8"
@@ -407,7 +580,9 @@ void emit_config_yaml(const std::string& filename) {
       << "absolute-tolerance" << YAML::Value << "1.0e+1" << YAML::Key
       << "max-num-integration-steps" << YAML::Value << "5000" << YAML::Key
       << "min-integration-step" << YAML::Value << "1.0e-30" << YAML::Key
-      << "max-integration-step" << YAML::Value << "1.0e+20" << YAML::EndMap
+      << "max-integration-step" << YAML::Value << "1.0e+20" << YAML::Key
+      << "linear-solver" << YAML::Value << "dense" << YAML::Key
+      << "krylov-subspace-size" << YAML::Value << "5" << YAML::EndMap
       << YAML::EndMap << YAML::Newline << YAML::Newline << YAML::BeginMap
       << YAML::Key << "reactor" << YAML::Value << YAML::BeginMap << YAML::Key
       << "flux-dpa-s" << YAML::Value << "2.9e-7" << YAML::Key
@@ -466,8 +641,21 @@ void emit_config_yaml(const std::string& filename) {
              "CONCENTRATIONS")
       << YAML::Newline << YAML::Comment(arrays_comment.c_str()) << YAML::Newline
       << YAML::Newline
+      << YAML::Comment(
+             "UNCOMMENT LINES BELOW TO VARY THE FLUX AND TEMPERATURE OVER TIME")
+      << YAML::Newline << YAML::Comment(history_comment.c_str())
+      << YAML::Newline << YAML::Newline
       << YAML::Comment("UNCOMMENT LINES BELOW TO TURN ON SENSITIVITY ANALYSIS")
-      << YAML::Newline << YAML::Comment(sa_comment.c_str()) << YAML::Newline;
+      << YAML::Newline << YAML::Comment(sa_comment.c_str()) << YAML::Newline
+      << YAML::Newline
+      << YAML::Comment(
+             "UNCOMMENT LINES BELOW TO TURN ON GLOBAL SENSITIVITY ANALYSIS")
+      << YAML::Newline << YAML::Comment(gsa_comment.c_str()) << YAML::Newline
+      << YAML::Newline
+      << YAML::Comment(
+             "UNCOMMENT LINES BELOW TO BENCHMARK THE SIMULATION INSTEAD")
+      << YAML::Newline << YAML::Comment(benchmark_comment.c_str())
+      << YAML::Newline;
 
   std::ofstream file;
   file.open(filename);
@@ -480,13 +668,475 @@ void emit_config_yaml(const std::string& filename) {
   }
 }
 
-ClusterDynamics create_cd([[maybe_unused]] CliArgConsumer& arg_consumer) {
+ClusterDynamics create_cd(ClusterDynamicsConfig& config = cd_config) {
 #if defined(USE_CUDA)
-  if (arg_consumer.has_arg("cuda")) {
-    return ClusterDynamics::cuda(cd_config);
+  if (cuda) {
+    return ClusterDynamics::cuda(config);
   }
 #endif
-  return ClusterDynamics::cpu(cd_config);
+  return ClusterDynamics::cpu(config);
+}
+
+/** @brief Resumes a simulation from a checkpoint. The checkpoint provides the
+ * simulation settings, material and reactor, the command line still sets the
+ * simulation time and the sample interval.
+ */
+ClusterDynamics resume_cd(const std::string& path) {
+  ClusterDynamicsConfig saved_config;
+  ClusterDynamics cd = ClusterDynamics::from_checkpoint(path, saved_config);
+  saved_config.simulation_time = cd_config.simulation_time;
+  saved_config.time_delta = cd_config.time_delta;
+  saved_config.sample_interval = cd_config.sample_interval;
+  cd_config = saved_config;
+
+  std::cout << "\nResuming from " << path << " at " << cd.get_time() << " s"
+            << std::endl;
+  return cd;
+}
+
+/** @brief One simulation of a sensitivity analysis, run by a worker thread
+ * and printed by the main thread.
+ */
+struct SensitivityJob {
+  ClusterDynamicsConfig config;
+  gp_float sa_var_value;
+  /// @brief Samples the main thread has yet to print.
+  std::vector<ClusterDynamicsState> samples;
+  ClusterDynamicsState state;
+  std::exception_ptr error;
+  bool done = false;
+};
+
+/** @brief Runs the simulations of a sensitivity analysis on num_jobs threads.
+ *
+ * The output of each simulation is printed in order as soon as it is
+ * available, so it is the same as that of running them one after another.
+ */
+void run_sensitivity_analysis(const std::string& sa_var_name,
+                              size_t num_jobs) {
+  // The configs follow each other by sensitivity-var-delta. Updating
+  // cd_config leaves the material and reactor of the earlier copies as they
+  // were.
+  std::vector<SensitivityJob> jobs(cd_config.sa_num_simulations);
+  for (SensitivityJob& job : jobs) {
+    job.config = cd_config;
+    job.sa_var_value = get_sa_var_value();
+    sa_update_config();
+  }
+
+  const std::vector<gp_float> times = sample_times();
+  std::mutex mutex;
+  std::condition_variable progress;
+  bool cancelled = false;
+
+  auto run_job = [&](size_t n) {
+    SensitivityJob& job = jobs[n];
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (cancelled) return;
+    }
+
+    try {
+      ClusterDynamics cd = create_cd(job.config);
+      ClusterDynamicsState state =
+          cd.sample(times, [&](const ClusterDynamicsState& sample) {
+            if (!step_print && !csv) return;
+            std::lock_guard<std::mutex> lock(mutex);
+            job.samples.push_back(sample);
+            progress.notify_one();
+          });
+      std::lock_guard<std::mutex> lock(mutex);
+      job.state = std::move(state);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex);
+      job.error = std::current_exception();
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    job.done = true;
+    progress.notify_one();
+  };
+
+  std::thread runner([&] {
+    ThreadPool pool(std::min(num_jobs, jobs.size()));
+    pool.parallel_for(jobs.size(), run_job);
+  });
+
+  // Waits for the remaining jobs when printing fails
+  auto cancel = [&] {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      cancelled = true;
+    }
+    runner.join();
+  };
+
+  try {
+    for (size_t n = 0; n < jobs.size(); n++) {
+      SensitivityJob& job = jobs[n];
+
+      if (n > 0) os << "\n";  // visual divider for consecutive sims
+
+      if (csv) {
+        os << "simulation " << n + 1
+           << ",sensitivity variable: " << sa_var_name
+           << ",current value: " << job.sa_var_value << ",current delta: "
+           << static_cast<gp_float>(n) * cd_config.sa_var_delta << "\n\n";
+        os << "time (s),cluster size,"
+              "interstitials / cm^3,vacancies / cm^3\n";
+      } else {
+        os << "simulation " << n + 1
+           << "\tsensitivity variable: " << sa_var_name
+           << "\tcurrent value: " << job.sa_var_value << "\tcurrent delta: "
+           << static_cast<gp_float>(n) * cd_config.sa_var_delta << std::endl;
+      }
+
+      print_start_message(job.config);
+
+      // Stream the samples as the job produces them
+      bool done = false;
+      while (!done) {
+        std::vector<ClusterDynamicsState> samples;
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          progress.wait(lock, [&] { return job.done || !job.samples.empty(); });
+          samples.swap(job.samples);
+          done = job.done;
+        }
+
+        for (const ClusterDynamicsState& sample : samples) {
+          if (step_print) {
+            step_print_prompt(sample.view());
+          } else if (csv) {
+            print_csv(sample.view());
+          }
+        }
+      }
+
+      if (job.error) std::rethrow_exception(job.error);
+
+      // ----------------------------------------------------------------
+      // print results
+      if (!step_print && !csv) {
+        print_state(job.state.view());
+      }
+      // ----------------------------------------------------------------
+    }
+  } catch (...) {
+    cancel();
+    throw;
+  }
+
+  runner.join();
+}
+
+/** @brief Estimates the Sobol' indices of the observables over the parameter
+ * ranges of the analysis, running num_jobs simulations at a time.
+ */
+std::vector<GlobalSensitivity> run_global_sensitivity_analysis(
+    const GlobalSensitivityAnalysis& analysis,
+    const std::vector<std::string>& observable_names, size_t num_jobs) {
+  print_start_message();
+
+  progressbar bar(static_cast<int>(analysis.num_simulations()), true,
+                  std::cout);
+  bar.set_todo_char(" ");
+  bar.set_done_char("█");
+  bar.set_opening_bracket_char("[");
+  bar.set_closing_bracket_char("]");
+
+  std::cout << "G-PIES Global Sensitivity Simulations Running..."
+            << std::endl;
+
+  size_t finished = 0;
+  const std::vector<GlobalSensitivity> sensitivities = analysis.run(
+      [](ClusterDynamicsConfig& config) {
+        ClusterDynamics cd = create_cd(config);
+        return cd.run(config.time_delta, config.simulation_time);
+      },
+      num_jobs,
+      [&](size_t done) {
+        for (; finished < done; ++finished) bar.update();
+      });
+
+  auto variable_name = [](SensitivityVariable variable) {
+    for (const auto& [name, value] : sensitivity_variables)
+      if (value == variable) return name;
+    return std::string();
+  };
+
+  if (csv) {
+    os << "\nobservable,mean,variance,parameter,first order index,"
+          "total index\n";
+    for (size_t o = 0; o < sensitivities.size(); ++o)
+      for (const SobolIndices& indices : sensitivities[o].indices)
+        os << observable_names[o] << "," << sensitivities[o].mean << ","
+           << sensitivities[o].variance << ","
+           << variable_name(indices.variable) << "," << indices.first_order
+           << "," << indices.total << "\n";
+  } else {
+    for (size_t o = 0; o < sensitivities.size(); ++o) {
+      os << "\nObservable: " << observable_names[o]
+         << "  mean: " << sensitivities[o].mean
+         << "  variance: " << sensitivities[o].variance;
+      os << "\nParameter\t\t\t\t-\t\tFirst Order\t\t-\t\tTotal\n\n";
+      for (const SobolIndices& indices : sensitivities[o].indices)
+        os << std::left << std::setw(40) << variable_name(indices.variable)
+           << std::right << std::setprecision(6) << indices.first_order
+           << "\t\t\t" << indices.total << "\n";
+    }
+  }
+  os << std::flush;
+
+  return sensitivities;
+}
+
+/** @brief Returns the number of simulations to run at the same time.
+ */
+size_t get_num_jobs(CliArgConsumer& arg_consumer) {
+  if (!arg_consumer.has_arg("jobs", "sensitivity-analysis")) return 1;
+
+  const size_t num_jobs =
+      arg_consumer.get_value<size_t>("jobs", "sensitivity-analysis");
+  if (num_jobs == 0)
+    throw GpiesException(
+        "Value for jobs must be a positive, non-zero integer.");
+  return num_jobs;
+}
+
+/** @brief The median and spread of a quantity over the timed runs of a
+ * benchmark case.
+ */
+struct BenchmarkSummary {
+  gp_float median = 0.;
+  gp_float min = 0.;
+  gp_float max = 0.;
+  /// @brief Median absolute deviation from the median.
+  gp_float mad = 0.;
+};
+
+gp_float median(std::vector<gp_float> values) {
+  std::sort(values.begin(), values.end());
+  const size_t n = values.size();
+  return n % 2 ? values[n / 2] : .5 * (values[n / 2 - 1] + values[n / 2]);
+}
+
+BenchmarkSummary summarize(const std::vector<gp_float>& values) {
+  BenchmarkSummary summary;
+  if (values.empty()) return summary;
+
+  summary.median = median(values);
+  summary.min = *std::min_element(values.begin(), values.end());
+  summary.max = *std::max_element(values.begin(), values.end());
+  std::vector<gp_float> deviations;
+  for (gp_float value : values)
+    deviations.push_back(std::abs(value - summary.median));
+  summary.mad = median(deviations);
+  return summary;
+}
+
+/** @brief One combination of the benchmark sweep and its measurements.
+ */
+struct BenchmarkCase {
+  size_t max_cluster_size;
+  std::string backend;
+  size_t threads;
+  std::string linear_solver;
+  std::vector<gp_float> wall_times;
+  std::vector<gp_float> rhs_times;
+  std::vector<gp_float> peak_rss;
+  /// @brief Stats of the last run, whose counters do not depend on timing.
+  ClusterDynamicsStats stats;
+  /// @brief Why the case could not run, empty when it did.
+  std::string error;
+};
+
+std::string json_string(const std::string& text) {
+  std::ostringstream escaped;
+  escaped << '"';
+  for (const char c : text) {
+    switch (c) {
+      case '"':
+        escaped << "\\\"";
+        break;
+      case '\\':
+        escaped << "\\\\";
+        break;
+      case '\n':
+        escaped << "\\n";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20)
+          escaped << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                  << static_cast<int>(c) << std::dec << std::setfill(' ');
+        else
+          escaped << c;
+    }
+  }
+  escaped << '"';
+  return escaped.str();
+}
+
+std::string json_summary(const std::vector<gp_float>& values) {
+  const BenchmarkSummary summary = summarize(values);
+  std::ostringstream json;
+  json << std::setprecision(9) << "{\"median\": " << summary.median
+       << ", \"min\": " << summary.min << ", \"max\": " << summary.max
+       << ", \"mad\": " << summary.mad << "}";
+  return json.str();
+}
+
+ClusterDynamics create_benchmark_cd(const BenchmarkCase& benchmark,
+                                    ClusterDynamicsConfig& config) {
+#if defined(USE_CUDA)
+  if (benchmark.backend == "cuda") return ClusterDynamics::cuda(config);
+#endif
+  if (benchmark.backend == "cpu-threaded")
+    return ClusterDynamics::cpu_threaded(config, benchmark.threads);
+  return ClusterDynamics::cpu(config);
+}
+
+/** @brief Times creating and running the simulation of a benchmark case,
+ * after warmup_runs untimed runs.
+ */
+void run_benchmark_case(BenchmarkCase& benchmark, size_t warmup_runs,
+                        size_t runs) {
+  ClusterDynamicsConfig config = cd_config;
+  config.max_cluster_size = benchmark.max_cluster_size;
+  config.linear_solver = linear_solver_types[benchmark.linear_solver];
+  config.init_interstitials.resize(config.max_cluster_size, 0.);
+  config.init_vacancies.resize(config.max_cluster_size, 0.);
+
+  Timer timer;
+  for (size_t r = 0; r < warmup_runs + runs; ++r) {
+    reset_peak_rss();
+    timer.Start();
+    ClusterDynamics cd = create_benchmark_cd(benchmark, config);
+    cd.run(config.time_delta, config.simulation_time);
+    const gp_float wall_time = timer.Stop();
+    if (r < warmup_runs) continue;
+
+    benchmark.stats = cd.get_stats();
+    benchmark.wall_times.push_back(wall_time);
+    benchmark.rhs_times.push_back(benchmark.stats.rhs_time);
+    benchmark.peak_rss.push_back(static_cast<gp_float>(peak_rss()));
+  }
+}
+
+/** @brief Runs every combination of the max cluster sizes, backends and
+ * linear solvers of the benchmark options and writes the median and spread
+ * of their wall time, right hand side time and peak resident set size as
+ * JSON.
+ */
+void run_benchmark(CliArgConsumer& arg_consumer) {
+  std::vector<size_t> max_cluster_sizes{cd_config.max_cluster_size};
+  if (arg_consumer.has_arg("max-cluster-sizes", "benchmark"))
+    max_cluster_sizes = arg_consumer.get_value<std::vector<size_t>>(
+        "max-cluster-sizes", "benchmark");
+  for (size_t max_cluster_size : max_cluster_sizes)
+    if (max_cluster_size < 2)
+      throw GpiesException(
+          "Values for max-cluster-sizes must be integers of at least 2.");
+
+  std::vector<std::string> backends{"cpu"};
+  if (arg_consumer.has_arg("backends", "benchmark"))
+    backends = arg_consumer.get_value<std::vector<std::string>>("backends",
+                                                                "benchmark");
+  for (const std::string& backend : backends) {
+#if defined(USE_CUDA)
+    if (backend == "cuda") continue;
+#endif
+    if (backend != "cpu" && backend != "cpu-threaded")
+      throw GpiesException("Unknown value for backends: " + backend + ".");
+  }
+
+  std::vector<std::string> linear_solvers;
+  for (const auto& [name, type] : linear_solver_types)
+    if (type == cd_config.linear_solver) linear_solvers = {name};
+  if (arg_consumer.has_arg("linear-solvers", "benchmark"))
+    linear_solvers = arg_consumer.get_value<std::vector<std::string>>(
+        "linear-solvers", "benchmark");
+  for (const std::string& linear_solver : linear_solvers)
+    if (!linear_solver_types.count(linear_solver))
+      throw GpiesException("Unknown value for linear-solvers: " +
+                           linear_solver + ".");
+
+  size_t threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  if (arg_consumer.has_arg("threads", "benchmark")) {
+    threads = arg_consumer.get_value<size_t>("threads", "benchmark");
+    if (threads == 0)
+      throw GpiesException(
+          "Value for threads must be a positive, non-zero integer.");
+  }
+
+  size_t warmup_runs = 1;
+  if (arg_consumer.has_arg("warmup-runs", "benchmark"))
+    warmup_runs = arg_consumer.get_value<size_t>("warmup-runs", "benchmark");
+
+  size_t runs = 5;
+  if (arg_consumer.has_arg("runs", "benchmark")) {
+    runs = arg_consumer.get_value<size_t>("runs", "benchmark");
+    if (runs == 0)
+      throw GpiesException(
+          "Value for runs must be a positive, non-zero integer.");
+  }
+
+  std::vector<BenchmarkCase> cases;
+  for (size_t max_cluster_size : max_cluster_sizes)
+    for (const std::string& backend : backends)
+      for (const std::string& linear_solver : linear_solvers) {
+        BenchmarkCase benchmark;
+        benchmark.max_cluster_size = max_cluster_size;
+        benchmark.backend = backend;
+        benchmark.threads = backend == "cpu-threaded" ? threads : 1;
+        benchmark.linear_solver = linear_solver;
+        cases.push_back(benchmark);
+      }
+
+  // The JSON may go to the standard output, so the progress goes to the
+  // standard error
+  std::cerr << "\nBENCHMARK MODE\n"
+            << "# of cases: " << cases.size()
+            << "  warmup runs: " << warmup_runs << "  runs: " << runs
+            << "  simulation time: " << cd_config.simulation_time << " s\n";
+  for (BenchmarkCase& benchmark : cases) {
+    std::cerr << "max cluster size " << benchmark.max_cluster_size << ", "
+              << benchmark.backend << ", " << benchmark.linear_solver
+              << std::endl;
+    try {
+      run_benchmark_case(benchmark, warmup_runs, runs);
+    } catch (const ClusterDynamicsException& e) {
+      benchmark.error = e.message;
+    }
+  }
+
+  os << std::setprecision(9) << "{\n"
+     << "  \"version\": " << json_string(GPIES_SEMANTIC_VERSION) << ",\n"
+     << "  \"simulation_time\": " << cd_config.simulation_time << ",\n"
+     << "  \"warmup_runs\": " << warmup_runs << ",\n"
+     << "  \"runs\": " << runs << ",\n"
+     << "  \"cases\": [";
+  for (size_t c = 0; c < cases.size(); ++c) {
+    const BenchmarkCase& benchmark = cases[c];
+    os << (c ? ",\n" : "\n") << "    {\"max_cluster_size\": "
+       << benchmark.max_cluster_size
+       << ", \"backend\": " << json_string(benchmark.backend)
+       << ", \"threads\": " << benchmark.threads
+       << ", \"linear_solver\": " << json_string(benchmark.linear_solver);
+    if (!benchmark.error.empty()) {
+      os << ", \"error\": " << json_string(benchmark.error) << "}";
+      continue;
+    }
+
+    os << ",\n     \"steps\": " << benchmark.stats.steps
+       << ", \"rhs_evaluations\": " << benchmark.stats.rhs_evaluations
+       << ", \"jacobian_evaluations\": "
+       << benchmark.stats.jacobian_evaluations
+       << ",\n     \"wall_time\": " << json_summary(benchmark.wall_times)
+       << ",\n     \"rhs_time\": " << json_summary(benchmark.rhs_times)
+       << ",\n     \"peak_rss\": " << json_summary(benchmark.peak_rss)
+       << "}";
+  }
+  os << "\n  ]\n}" << std::endl;
 }
 
 int main(int argc, char* argv[]) {
@@ -540,7 +1190,49 @@ int main(int argc, char* argv[]) {
         "minimum step size for integration")(
         "max-integration-step",
         po::value<gp_float>()->implicit_value(cd_config.max_integration_step),
-        "maximum step size for integration");
+        "maximum step size for integration")(
+        "linear-solver", po::value<std::string>()->value_name("solver"),
+        "linear solver for the implicit integrator: dense, sparse, arrowhead, "
+        "gmres or bicgstab (dense by default)")(
+        "krylov-subspace-size",
+        po::value<size_t>()->implicit_value(cd_config.krylov_subspace_size),
+        "maximum Krylov subspace size for the gmres and bicgstab linear "
+        "solvers")(
+        "group-threshold", po::value<size_t>()->value_name("size"),
+        "largest cluster size tracked individually, larger sizes are lumped "
+        "into groups (off by default)")(
+        "group-growth",
+        po::value<gp_float>()->implicit_value(cd_config.group_growth),
+        "ratio between the widths of consecutive cluster size groups")(
+        "continuum-threshold", po::value<size_t>()->value_name("size"),
+        "largest cluster size following the master equation, larger sizes "
+        "follow its Fokker-Planck approximation (off by default)")(
+        "continuum-growth",
+        po::value<gp_float>()->implicit_value(cd_config.continuum_growth),
+        "ratio between the widths of consecutive Fokker-Planck cells")(
+        "initial-max-cluster-size", po::value<size_t>()->value_name("size"),
+        "start with this max cluster size and grow it up to max-cluster-size "
+        "as the distribution spreads (off by default)")(
+        "tail-threshold",
+        po::value<gp_float>()->implicit_value(cd_config.tail_threshold),
+        "concentration of the largest tracked sizes which grows the adaptive "
+        "max cluster size")(
+        "checkpoint-every", po::value<gp_float>()->value_name("seconds"),
+        "save a checkpoint every [seconds] of simulation time, at the first "
+        "sample past each interval (off by default)")(
+        "checkpoint-file", po::value<std::string>()->value_name("filename"),
+        "file to save checkpoints to (gpies.checkpoint by default)")(
+        "resume", po::value<std::string>()->value_name("filename"),
+        "resume a simulation from a checkpoint file, running it on until "
+        "[time]. The integrator restarts at first order with a step scaled "
+        "down from the saved one for it")(
+        "steady-state",
+        "solve directly for the saturated state instead of simulating up to "
+        "[time], which only bounds the fallback integration when Newton "
+        "does not converge")(
+        "stats",
+        "print the integrator statistics and the wall time spent in each "
+        "phase of the integration after the simulation");
 
     po::options_description db_options("Database Options [--db]");
     db_options.add_options()("history,h", "display simulation history")(
@@ -561,9 +1253,68 @@ int main(int argc, char* argv[]) {
         "sensitivity-var,v", po::value<std::string>()->value_name("var name"),
         "specify the variable to do sensitivity analysis on (REQUIRED)")(
         "sensitivity-var-delta,d", po::value<gp_float>(),
-        "amount to change [sensitivity-var] by for each simulation (REQUIRED)");
-
-    all_options.add(db_options).add(sa_options);
+        "amount to change [sensitivity-var] by for each simulation (REQUIRED)")(
+        "jobs,j", po::value<size_t>()->value_name("N"),
+        "number of simulations to run at the same time, the output stays in "
+        "simulation order (1 by default)")(
+        "forward-sensitivity",
+        "compute the derivative of the state with respect to "
+        "[sensitivity-var] in a single simulation (replaces num-sims and "
+        "sensitivity-var-delta)")(
+        "adjoint-gradient", po::value<std::string>()->value_name("observable"),
+        "compute the derivatives of an observable of the end state with "
+        "respect to every material and reactor parameter in a single "
+        "adjoint simulation")(
+        "global-sensitivity",
+        "estimate the first order and total Sobol' indices of [observables] "
+        "over the parameter-ranges of the sensitivity-analysis section of "
+        "the config file")(
+        "sampling", po::value<std::string>()->value_name("method"),
+        "sample design of the global sensitivity analysis: sobol or "
+        "latin-hypercube (sobol by default)")(
+        "num-samples", po::value<size_t>()->value_name("N"),
+        "number of base samples of the global sensitivity analysis, which "
+        "runs N * (parameters + 2) simulations (1024 by default)")(
+        "seed", po::value<uint64_t>(),
+        "seed of the latin-hypercube design (0 by default)")(
+        "observables",
+        po::value<std::vector<std::string>>()->multitoken()->value_name(
+            "names"),
+        "observables of the end state to compute the Sobol' indices of "
+        "(dislocation-density by default)");
+
+    po::options_description benchmark_options(
+        "Benchmark Options [--benchmark]");
+    benchmark_options.add_options()(
+        "benchmark",
+        "time creating and running the simulation for [time] over every "
+        "combination of max-cluster-sizes, backends and linear-solvers, and "
+        "write the median and spread of the wall time, right hand side time "
+        "and peak resident set size as JSON")(
+        "max-cluster-sizes",
+        po::value<std::vector<size_t>>()->multitoken()->value_name("sizes"),
+        "max cluster sizes to benchmark (max-cluster-size by default)")(
+        "backends",
+        po::value<std::vector<std::string>>()->multitoken()->value_name(
+            "names"),
+        "backends to benchmark: cpu, cpu-threaded"
+#if defined(USE_CUDA)
+        " or cuda"
+#endif
+        " (cpu by default)")(
+        "linear-solvers",
+        po::value<std::vector<std::string>>()->multitoken()->value_name(
+            "names"),
+        "linear solvers to benchmark (linear-solver by default)")(
+        "threads", po::value<size_t>()->value_name("N"),
+        "threads of the cpu-threaded backend (one per hardware thread by "
+        "default)")(
+        "warmup-runs", po::value<size_t>()->value_name("N"),
+        "untimed runs before the timed ones of each case (1 by default)")(
+        "runs", po::value<size_t>()->value_name("N"),
+        "timed runs of each case (5 by default)");
+
+    all_options.add(db_options).add(sa_options).add(benchmark_options);
 
     CliArgConsumer arg_consumer(argc, argv, all_options);
 
@@ -577,11 +1328,40 @@ int main(int argc, char* argv[]) {
         std::cout << key << std::endl;
       }
 
+      std::cout << "\nSupported Observables [--adjoint-gradient] "
+                   "[--observables]:\n";
+      for (const auto& [key, value] : scalar_observables) {
+        std::cout << key << std::endl;
+      }
+
+      std::cout << "\nSupported Sampling Methods [--sampling]:\n";
+      for (const auto& [key, value] : sampling_methods) {
+        std::cout << key << std::endl;
+      }
+
       std::cout
           << "\nexample command: run 10 simulations, increasing the "
              "reactor flux by 1e-7 for each simulation\n"
           << "./gpies --sensitivity-analysis --num-sims 10 "
-             "--sensitivity-var flux-dpa-s --sensitivity-var-delta 1e-7\n\n";
+             "--sensitivity-var flux-dpa-s --sensitivity-var-delta 1e-7\n"
+          << "\nexample command: the same simulations, 4 at a time\n"
+          << "./gpies --sensitivity-analysis --num-sims 10 "
+             "--sensitivity-var flux-dpa-s --sensitivity-var-delta 1e-7 "
+             "--jobs 4\n"
+          << "\nexample command: compute the derivative of the state with "
+             "respect to the reactor flux in one simulation\n"
+          << "./gpies --sensitivity-analysis --forward-sensitivity "
+             "--sensitivity-var flux-dpa-s\n"
+          << "\nexample command: compute the derivatives of the final "
+             "dislocation density with respect to every parameter\n"
+          << "./gpies --sensitivity-analysis --adjoint-gradient "
+             "dislocation-density\n"
+          << "\nexample command: estimate the Sobol' indices of both "
+             "observables over the parameter-ranges of config.yaml, 8 "
+             "simulations at a time\n"
+          << "./gpies --config config.yaml --sensitivity-analysis "
+             "--global-sensitivity --num-samples 256 --observables "
+             "dislocation-density vacancy-cluster-volume --jobs 8\n\n";
       return 1;
     } else if (arg_consumer.has_arg("version")) {
       std::cout << "G-PIES version " << GPIES_SEMANTIC_VERSION << "\n";
@@ -607,10 +1387,26 @@ int main(int argc, char* argv[]) {
     csv = static_cast<bool>(arg_consumer.has_arg("csv", "simulation"));
     step_print =
         static_cast<bool>(arg_consumer.has_arg("step-print", "simulation"));
+    show_stats = static_cast<bool>(arg_consumer.has_arg("stats"));
+#if defined(USE_CUDA)
+    cuda = static_cast<bool>(arg_consumer.has_arg("cuda"));
+#endif
 
     // Get cluster dynamics configuration
     arg_consumer.populate_cd_config(cd_config);
 
+    // Checkpointing
+    if (arg_consumer.has_arg("checkpoint-every", "simulation")) {
+      checkpoint_every =
+          arg_consumer.get_float("checkpoint-every", "simulation");
+      if (checkpoint_every <= 0.)
+        throw GpiesException(
+            "Value for checkpoint-every must be a positive, non-zero decimal.");
+    }
+    if (arg_consumer.has_arg("checkpoint-file", "simulation"))
+      checkpoint_file =
+          arg_consumer.get_string("checkpoint-file", "simulation");
+
     ClientDb db(DEV_DEFAULT_CLIENT_DB_PATH, false);
     // Open SQLite connection and create database
     db.init();
@@ -649,13 +1445,108 @@ int main(int argc, char* argv[]) {
           cd_config.material = sim.material;
           cd_config.reactor = sim.reactor;
 
-          ClusterDynamics cd = create_cd(arg_consumer);
+          ClusterDynamics cd = create_cd();
           run_simulation(cd);
+          if (show_stats) print_stats(cd.get_stats());
         } else {
           std::cerr << "Could not find simulation " << sim_sqlite_id
                     << std::endl;
         }
       }
+    } else if (arg_consumer.has_arg("sensitivity-analysis", "") &&
+               arg_consumer.has_arg("adjoint-gradient",
+                                    "sensitivity-analysis")) {
+      // ADJOINT GRADIENT
+      const std::string observable_name = arg_consumer.get_value<std::string>(
+          "adjoint-gradient", "sensitivity-analysis");
+      if (!scalar_observables.count(observable_name))
+        throw GpiesException("Unknown observable " + observable_name +
+                             ".\n--sensitivity-analysis-help to see the "
+                             "supported observables.");
+
+      std::cout << "\nADJOINT SENSITIVITY ANALYSIS MODE\n"
+                << "observable: " << observable_name << "\n\n";
+
+      ClusterDynamics cd = create_cd();
+      run_adjoint_gradient(cd, scalar_observables[observable_name]);
+    } else if (arg_consumer.has_arg("sensitivity-analysis", "") &&
+               arg_consumer.has_arg("global-sensitivity",
+                                    "sensitivity-analysis")) {
+      // GLOBAL SENSITIVITY ANALYSIS
+      std::vector<ParameterRange> ranges;
+      arg_consumer.populate_parameter_ranges(ranges);
+
+      std::string sampling_name = "sobol";
+      if (arg_consumer.has_arg("sampling", "sensitivity-analysis")) {
+        sampling_name =
+            arg_consumer.get_string("sampling", "sensitivity-analysis");
+        if (!sampling_methods.count(sampling_name))
+          throw GpiesException("Unknown value for sampling: " + sampling_name +
+                               ".");
+      }
+
+      size_t num_samples = 1024;
+      if (arg_consumer.has_arg("num-samples", "sensitivity-analysis")) {
+        num_samples =
+            arg_consumer.get_size_t("num-samples", "sensitivity-analysis");
+        if (num_samples == 0)
+          throw GpiesException(
+              "Value for num-samples must be a positive, non-zero integer.");
+      }
+
+      uint64_t seed = 0;
+      if (arg_consumer.has_arg("seed", "sensitivity-analysis"))
+        seed = arg_consumer.get_value<uint64_t>("seed", "sensitivity-analysis");
+
+      std::vector<std::string> observable_names{"dislocation-density"};
+      if (arg_consumer.has_arg("observables", "sensitivity-analysis"))
+        observable_names = arg_consumer.get_value<std::vector<std::string>>(
+            "observables", "sensitivity-analysis");
+      std::vector<ScalarObservable> observables;
+      for (const std::string& name : observable_names) {
+        if (!scalar_observables.count(name))
+          throw GpiesException("Unknown observable " + name +
+                               ".\n--sensitivity-analysis-help to see the "
+                               "supported observables.");
+        observables.push_back(scalar_observables[name]);
+      }
+
+      const size_t num_jobs = get_num_jobs(arg_consumer);
+      const GlobalSensitivityAnalysis analysis(
+          cd_config, ranges, observables, sampling_methods[sampling_name],
+          num_samples, seed);
+
+      std::cout << "\nGLOBAL SENSITIVITY ANALYSIS MODE\n"
+                << "sampling: " << sampling_name
+                << "  # of samples: " << num_samples
+                << "  # of simulations: " << analysis.num_simulations()
+                << "  jobs: " << num_jobs << "\n";
+      for (const ParameterRange& range : ranges)
+        for (const auto& [name, variable] : sensitivity_variables)
+          if (variable == range.variable)
+            std::cout << name << ": [" << range.min << ", " << range.max
+                      << "]\n";
+      std::cout << std::endl;
+
+      run_global_sensitivity_analysis(analysis, observable_names, num_jobs);
+    } else if (arg_consumer.has_arg("sensitivity-analysis", "") &&
+               arg_consumer.has_arg("forward-sensitivity",
+                                    "sensitivity-analysis")) {
+      // FORWARD SENSITIVITY ANALYSIS
+      if (!arg_consumer.has_arg("sensitivity-var", "sensitivity-analysis"))
+        throw GpiesException(
+            "Missing required arguments for forward sensitivity "
+            "analysis.\n--help to see required variables.");
+
+      cd_config.sa_var = arg_consumer.get_sa_var();
+      std::cout << "\nFORWARD SENSITIVITY ANALYSIS MODE\n"
+                << "sensitivity variable: "
+                << arg_consumer.get_value<std::string>("sensitivity-var",
+                                                       "sensitivity-analysis")
+                << "\n\n";
+
+      ClusterDynamics cd = create_cd();
+      run_forward_sensitivity(cd);
     } else if (arg_consumer.has_arg("sensitivity-analysis",
                                     "")) {  // SENSITIVITY ANALYSIS
       std::string sa_var_name;
@@ -683,68 +1574,40 @@ int main(int argc, char* argv[]) {
             "analysis.\n--help to see required variables.");
       }
 
+      const size_t num_jobs = get_num_jobs(arg_consumer);
+
       std::cout << "\nSENSITIVITY ANALYSIS MODE\n"
                 << "# of simulations: " << cd_config.sa_num_simulations
                 << "  sensitivity variable: " << sa_var_name
                 << "  sensitivity variable delta: " << cd_config.sa_var_delta
-                << "\n\n";
-
-      gp_float sa_var_value = get_sa_var_value();
+                << "  jobs: " << num_jobs << "\n\n";
 
       // --------------------------------------------------------------------------------------------
-      // sensitivity analysis simulation loop
-      for (size_t n = 0; n < cd_config.sa_num_simulations; n++) {
-        ClusterDynamics cd = create_cd(arg_consumer);
-        ClusterDynamicsState state;
-
-        if (n > 0) os << "\n";  // visual divider for consecutive sims
-
-        if (csv) {
-          os << "simulation " << n + 1
-             << ",sensitivity variable: " << sa_var_name
-             << ",current value: " << sa_var_value << ",current delta: "
-             << static_cast<gp_float>(n) * cd_config.sa_var_delta << "\n\n";
-          os << "time (s),cluster size,"
-                "interstitials / cm^3,vacancies / cm^3\n";
-        } else {
-          os << "simulation " << n + 1
-             << "\tsensitivity variable: " << sa_var_name
-             << "\tcurrent value: " << sa_var_value << "\tcurrent delta: "
-             << static_cast<gp_float>(n) * cd_config.sa_var_delta << std::endl;
-        }
-
-        print_start_message();
-
-        for (gp_float t = 0; t < cd_config.simulation_time; t = state.time) {
-          // run simulation for this time slice
-          state = cd.run(cd_config.time_delta, cd_config.sample_interval);
-
-          if (step_print) {
-            step_print_prompt(state);
-          } else if (csv) {
-            print_csv(state);
-          }
-        }
-
-        // ----------------------------------------------------------------
-        // print results
-        if (!step_print && !csv) {
-          print_state(state);
-        }
-        // ----------------------------------------------------------------
-
-        sa_var_value = sa_update_config();
-      }
+      // sensitivity analysis simulations
+      run_sensitivity_analysis(sa_var_name, num_jobs);
       // --------------------------------------------------------------------
+    } else if (arg_consumer.has_arg("benchmark")) {
+      run_benchmark(arg_consumer);
     } else {  // CLUSTER DYNAMICS OPTIONS
-      ClusterDynamics cd = create_cd(arg_consumer);
-      ClusterDynamicsState state = run_simulation(cd);
+      const bool steady_state = arg_consumer.has_arg("steady-state");
+      if (steady_state)
+        cd_config.steady_state_max_time = cd_config.simulation_time;
+
+      ClusterDynamics cd =
+          arg_consumer.has_arg("resume")
+              ? resume_cd(arg_consumer.get_value<std::string>("resume"))
+              : create_cd();
+      ClusterDynamicsState state =
+          steady_state ? run_steady_state(cd) : run_simulation(cd);
+      const ClusterDynamicsStats solver_stats = cd.get_stats();
+      if (show_stats) print_stats(solver_stats);
 
       // --------------------------------------------------------------------------------------------
       // Write simulation result to the database
       HistorySimulation history_simulation(
           cd_config.max_cluster_size, cd_config.simulation_time,
-          cd_config.time_delta, cd_config.reactor, cd_config.material, state);
+          cd_config.time_delta, cd_config.reactor, cd_config.material,
+          std::move(state), solver_stats);
 
       db.create_simulation(history_simulation);
       // --------------------------------------------------------------------------------------------
@@ -753,7 +1616,7 @@ int main(int argc, char* argv[]) {
     std::cerr << "A simulation error occured.\n"
               << "Details: " << e.message << "\n"
               << "Last Simulation State:\n";
-    print_state(e.err_state);
+    print_state(e.err_state.view());
     std::exit(EXIT_FAILURE);
   } catch (const ClientDbException& e) {
     std::cerr << "A database error occured.\n"
@@ -7,3 +7,4 @@ include(cmake/GpiesSetupBoost.cmake)
 include(cmake/GpiesSetupSQLite3.cmake)
 include(cmake/GpiesSetupYamlCpp.cmake)
 include(cmake/GpiesSetupGoogleTest.cmake)
+include(cmake/GpiesSetupGoogleBenchmark.cmake)
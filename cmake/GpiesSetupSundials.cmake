@@ -6,6 +6,11 @@ if(NOT SUNDIALS_FOUND)
   set(BUILD_IDAS OFF)
   set(BUILD_KINSOL OFF)
   set(BUILD_SHARED_LIBS OFF)
+  # Builds the OpenMP vector used by ClusterDynamics::cpu_threaded
+  find_package(OpenMP)
+  if(OpenMP_FOUND)
+    set(ENABLE_OPENMP ON)
+  endif()
   FetchContent_Declare(
     SUNDIALS
     URL https://github.com/LLNL/sundials/releases/download/v7.0.0/sundials-7.0.0.tar.gz
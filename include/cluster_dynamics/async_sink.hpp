@@ -0,0 +1,95 @@
+#ifndef ASYNC_SINK_HPP
+#define ASYNC_SINK_HPP
+
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "cluster_dynamics/cluster_dynamics_state.hpp"
+
+/** @brief What an AsyncSink does with a state when its queue is full.
+ */
+enum class SinkOverflow {
+  /// @brief Wait for the sinks to catch up, no state is lost.
+  block,
+  /// @brief Drop the new state, the integrator never waits.
+  drop,
+};
+
+/** @brief Passes the states it receives to a set of sinks on a background
+ * thread, so slow consumers such as file or database writers do not stall
+ * the integrator.
+ *
+ * The states are copied into a bounded queue whose slots are reused, so
+ * once every slot has held a state of the max cluster size no more memory
+ * is allocated. The sinks are invoked in the order the states were
+ * received. Register the AsyncSink through sink(), which must not outlive
+ * it.
+ */
+class AsyncSink {
+ public:
+  /** @param sinks Invoked one after another for every state, on the
+   * background thread.
+   *  @param capacity The number of states the queue holds, at least 1,
+   * counting the one being passed to the sinks.
+   *  @param overflow What to do when the queue is full.
+   */
+  explicit AsyncSink(std::vector<ClusterDynamicsSinkFn> sinks,
+                     size_t capacity = 16,
+                     SinkOverflow overflow = SinkOverflow::block);
+
+  /** @brief Waits for the queued states to be passed to the sinks.
+   */
+  ~AsyncSink();
+
+  AsyncSink(const AsyncSink&) = delete;
+  AsyncSink& operator=(const AsyncSink&) = delete;
+
+  /** @brief Returns a sink which queues the states it is passed, to
+   * register with ClusterDynamics::add_sink() or add_step_sink().
+   *
+   *  The returned sink must not be called from several threads at once.
+   * Rethrows the first exception a sink threw, so the simulation stops.
+   */
+  ClusterDynamicsSinkFn sink();
+
+  /** @brief Waits until every queued state has been passed to the sinks,
+   * then rethrows the first exception a sink threw.
+   */
+  void flush();
+
+  /** @brief Returns the number of states dropped because the queue was
+   * full.
+   */
+  size_t get_dropped() const;
+
+ private:
+  struct Observation {
+    ClusterDynamicsState state;
+    ClusterDynamicsStats stats;
+  };
+
+  void push(const ClusterDynamicsStateView& state,
+            const ClusterDynamicsStats& stats);
+  void work();
+
+  std::vector<ClusterDynamicsSinkFn> sinks;
+  SinkOverflow overflow;
+
+  /// @brief Ring buffer of the queue, the oldest state is at head.
+  std::vector<Observation> slots;
+  size_t head = 0;
+  size_t count = 0;
+  size_t dropped = 0;
+  bool stopping = false;
+  std::exception_ptr error;
+
+  mutable std::mutex mutex;
+  std::condition_variable not_empty;
+  std::condition_variable not_full;
+  std::thread worker;
+};
+
+#endif  // ASYNC_SINK_HPP
@@ -1,14 +1,17 @@
 #ifndef CLUSTER_DYNAMICS_HPP
 #define CLUSTER_DYNAMICS_HPP
 
+#include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "cluster_dynamics/cluster_dynamics_config.hpp"
 #include "cluster_dynamics_state.hpp"
 #include "model/material.hpp"
 #include "model/nuclear_reactor.hpp"
 #include "utils/gpies_exception.hpp"
+#include "utils/scalar_observable.hpp"
 #include "utils/types.hpp"
 
 class ClusterDynamicsImpl;
@@ -25,23 +28,191 @@ class ClusterDynamics {
 
  public:
   static ClusterDynamics cpu(ClusterDynamicsConfig &config);
+  /** @brief Creates a CPU simulation which evaluates the right hand side on
+   * n_threads threads.
+   *
+   * Meant for very large max_cluster_size. The results do not depend on
+   * n_threads above 1: the right hand side and the norms of the integrator
+   * sum over the state in fixed blocks, added in the same order for any
+   * n_threads. A single thread runs the cpu() backend, whose right hand side
+   * is the same but whose norms are the stock serial ones.
+   */
+  static ClusterDynamics cpu_threaded(ClusterDynamicsConfig &config,
+                                      size_t n_threads);
 #if defined(USE_CUDA)
   static ClusterDynamics cuda(ClusterDynamicsConfig &config);
 #endif
+  /** @brief Creates a CPU simulation which resumes from a checkpoint written
+   * by save_checkpoint().
+   *  @param path The checkpoint file.
+   *  @param n_threads Threads evaluating the right hand side, see
+   * cpu_threaded().
+   *
+   *  The simulation continues from the checkpoint time with the config,
+   * material and reactor it was saved with. The integrator restarts at first
+   * order, from a step scaled down from the saved one for that order.
+   */
+  static ClusterDynamics from_checkpoint(const std::string &path,
+                                         size_t n_threads = 1);
+  /** @brief Creates a CPU simulation which resumes from a checkpoint and
+   * fills config with the settings, material and reactor it was saved with.
+   * The initial concentrations of config are left empty.
+   */
+  static ClusterDynamics from_checkpoint(const std::string &path,
+                                         ClusterDynamicsConfig &config,
+                                         size_t n_threads = 1);
 
+  ClusterDynamics(ClusterDynamics &&);
+  ClusterDynamics &operator=(ClusterDynamics &&);
   ~ClusterDynamics();
 
   /** @brief Runs the simulation and returns the end simulation state as a
    * ClusterDynamicsState object.
-   *  @param time_delta The time step for the simulation in seconds.
+   *  @param time_delta Unused, the integrator picks its own steps between
+   * min_integration_step and max_integration_step.
    *  @param total_time The length of time that should be simulated in
    * seconds.
    *
    *  run() can be called multiple times, and the simulation will resume from
-   * where it stopped after the last time run() was called.
+   * where it stopped after the last time run() was called. With a reactor
+   * history the integrator restarts at each of its breakpoints, the linear
+   * solver is kept.
    */
   ClusterDynamicsState run(gp_float time_delta, gp_float total_time);
 
+  /** @brief Runs the simulation like run() and copies the end state into
+   * state, reusing the capacity its vectors already have.
+   *
+   *  Repeated runs into the same state allocate nothing once it has grown to
+   * the max cluster size.
+   */
+  void run_into(gp_float time_delta, gp_float total_time,
+                ClusterDynamicsState &state);
+
+  /** @brief Runs the simulation up to the last of the given times and passes
+   * the state at each of them to on_sample, then returns the end state.
+   *  @param sample_times Absolute simulation times in seconds, in increasing
+   * order and not before the current time.
+   *
+   *  The integrator takes its own steps and the samples are interpolated
+   * within them, so dense sample grids cost little more than a single run().
+   * Like run(), sample() resumes from where the simulation stopped.
+   */
+  ClusterDynamicsState sample(const std::vector<gp_float> &sample_times,
+                              const ClusterDynamicsSampleFn &on_sample);
+
+  /** @brief Returns the states of the simulation at the given times, see
+   * sample(const std::vector<gp_float> &, const ClusterDynamicsSampleFn &).
+   */
+  std::vector<ClusterDynamicsState> sample(
+      const std::vector<gp_float> &sample_times);
+
+  /** @brief Solves directly for the saturated state, where every
+   * concentration and the dislocation density stop changing, and returns it.
+   *
+   *  A globalized Newton iteration starts from the current state. Only when
+   * it does not converge is the simulation integrated towards the steady
+   * state, for at most steady_state_max_time seconds. Throws if the steady
+   * state is not found. Only the CPU backend without cluster grouping, the
+   * continuum or a reactor history supports it.
+   */
+  ClusterDynamicsState solve_steady_state();
+
+  /** @brief Integrates the derivatives of the state with respect to the given
+   * variables along with the state from now on, instead of rerunning the
+   * simulation with perturbed parameters.
+   *
+   *  Each variable adds about the cost of one more right hand side
+   * evaluation per step. The derivatives are measured from the current
+   * state, so the initial dislocation density only has an effect when they
+   * are enabled before the first run(). Only the CPU backend without
+   * cluster grouping, the continuum, the adaptive max cluster size or a
+   * reactor history supports sensitivities.
+   */
+  void enable_sensitivities(const std::vector<SensitivityVariable> &variables);
+
+  /** @brief Returns the sensitivities of the current state, in the order the
+   * variables were given to enable_sensitivities(). Inside a sample()
+   * callback they are those of the sampled state.
+   */
+  std::vector<ClusterDynamicsSensitivity> get_sensitivities() const;
+
+  /** @brief Runs the simulation for total_time seconds and returns the
+   * derivatives of an observable of the end state with respect to every
+   * Material and NuclearReactor parameter.
+   *  @param total_time The length of time that should be simulated in
+   * seconds.
+   *  @param observable The scalar function of the end state to differentiate.
+   *
+   *  The gradient is keyed by the parameter names of the Material and
+   * NuclearReactor accessors, e.g. "i_migration" or "flux". The adjoint
+   * equations are integrated back over checkpoints of the run, which costs
+   * about two runs. On top of that the gradient quadratures evaluate the
+   * right hand side once per backward step for each parameter, apart from
+   * those of the defect production, whose derivatives are read off the
+   * production rates. Like run(), the simulation continues from the end
+   * state afterwards. Only the CPU backend without cluster grouping, the
+   * continuum, the adaptive max cluster size, forward sensitivities or a
+   * reactor history supports it.
+   */
+  std::map<std::string, gp_float> adjoint_gradient(
+      gp_float total_time, ScalarObservable observable);
+
+  /** @brief Returns the current simulation time in seconds.
+   */
+  gp_float get_time() const;
+
+  /** @brief Returns a read-only view of the current state, without copying
+   * the concentrations.
+   *
+   *  The view points into the simulation and is only valid until it is next
+   * run, sampled or destroyed. Inside a sample() callback it is the sampled
+   * state.
+   */
+  ClusterDynamicsStateView get_state_view() const;
+
+  /** @brief Registers a sink which is passed a view of the state and the
+   * solver statistics at each of the given times, as run() and sample()
+   * advance past them.
+   *  @param sample_times Absolute simulation times in seconds, in increasing
+   * order. Those before the current time are skipped.
+   *  @return The id to pass to remove_sink().
+   *
+   *  The states are interpolated like those of sample(), and the sinks are
+   * invoked on the thread running the simulation after the sample()
+   * callback. Wrap slow sinks in an AsyncSink. Sinks must not add or remove
+   * sinks.
+   */
+  size_t add_sink(const std::vector<gp_float> &sample_times,
+                  ClusterDynamicsSinkFn sink);
+
+  /** @brief Registers a sink which is passed a view of the state and the
+   * solver statistics after every step the integrator accepts, see
+   * add_sink(). Only the CPU backend supports step sinks.
+   */
+  size_t add_step_sink(ClusterDynamicsSinkFn sink);
+
+  /** @brief Unregisters a sink added by add_sink() or add_step_sink().
+   */
+  void remove_sink(size_t id);
+
+  /** @brief Returns the integrator counters and the wall time spent in each
+   * phase of the integration since the simulation was created.
+   *
+   * The counters of the integrator carry over its restarts. The CUDA backend
+   * only reports the counters.
+   */
+  ClusterDynamicsStats get_stats() const;
+
+  /** @brief Saves the simulation state, time, step size, config and
+   * material and reactor parameters to a compact binary file.
+   *  @param path The checkpoint file, which is replaced atomically.
+   *
+   *  Long runs can be resumed with from_checkpoint(). Only the CPU backend
+   * supports checkpoints.
+   */
+  void save_checkpoint(const std::string &path) const;
+
   /** @brief Returns the Material parameters that the simulation currently has
    * set.
    */
@@ -66,7 +237,8 @@ class ClusterDynamics {
    * parameters.
    *
    *  It is okay to change the reactor parameters even if the simulation
-   *  has already been run() for some time.
+   *  has already been run() for some time. With a reactor history its flux
+   *  and temperature take the place of those of reactor.
    */
   void set_reactor(const NuclearReactor &reactor);
 
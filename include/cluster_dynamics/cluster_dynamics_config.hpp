@@ -2,13 +2,35 @@
 #define CLUSTER_DYNAMICS_CONFIG_HPP
 
 #include <cstring>
+#include <map>
+#include <string>
 #include <vector>
 
+#include "cluster_dynamics/reactor_history.hpp"
 #include "model/material.hpp"
 #include "model/nuclear_reactor.hpp"
 #include "utils/sensitivity_variable.hpp"
 #include "utils/types.hpp"
 
+/** @brief The linear solver used for the Newton iterations of the implicit
+ * integrator.
+ */
+enum class LinearSolverType {
+  dense,   //!< Dense LU of the analytic Jacobian.
+  sparse,  //!< Sparse (CSR) LU of the analytic Jacobian. Requires KLU.
+  arrowhead,  //!< Linear time elimination of the bordered tridiagonal
+              //!< structure of the analytic Jacobian.
+  gmres,      //!< Matrix-free GMRES with a tridiagonal preconditioner.
+  bicgstab,   //!< Matrix-free BiCGStab with a tridiagonal preconditioner.
+};
+
+static std::map<std::string, LinearSolverType> linear_solver_types{
+    {"dense", LinearSolverType::dense},
+    {"sparse", LinearSolverType::sparse},
+    {"arrowhead", LinearSolverType::arrowhead},
+    {"gmres", LinearSolverType::gmres},
+    {"bicgstab", LinearSolverType::bicgstab}};
+
 struct ClusterDynamicsConfig {
   gp_float simulation_time = 1e8;
   gp_float time_delta = 1e6;
@@ -23,8 +45,44 @@ struct ClusterDynamicsConfig {
   size_t max_num_integration_steps = 5000;
   gp_float min_integration_step = 1e-30;
   gp_float max_integration_step = 1e20;
+  LinearSolverType linear_solver = LinearSolverType::dense;
+  /// @brief Maximum Krylov subspace dimension for the gmres and bicgstab
+  /// linear solvers.
+  size_t krylov_subspace_size = 5;
+
+  // Cluster Size Grouping Params
+  /// @brief Largest cluster size tracked individually. Larger sizes up to
+  /// max_cluster_size are lumped into groups. 0 tracks every size.
+  size_t group_threshold = 0;
+  /// @brief Ratio between the widths of consecutive groups.
+  gp_float group_growth = 1.05;
+
+  // Fokker-Planck Continuum Params
+  /// @brief Largest cluster size following the master equation. Larger sizes
+  /// up to max_cluster_size follow its Fokker-Planck approximation. 0 follows
+  /// the master equation for every size. Exclusive with group_threshold.
+  size_t continuum_threshold = 0;
+  /// @brief Ratio between the widths of consecutive continuum cells.
+  gp_float continuum_growth = 1.1;
+
+  // Adaptive Max Cluster Size Params
+  /// @brief Max cluster size to start with. It doubles, up to
+  /// max_cluster_size, whenever a concentration among its largest eighth of
+  /// sizes reaches tail_threshold, and halves again once the upper half of
+  /// the sizes empties. 0 keeps max_cluster_size fixed.
+  size_t initial_max_cluster_size = 0;
+  /// @brief Concentration which counts as a populated tail.
+  gp_float tail_threshold = 1e2;
+
+  // Steady State Params
+  /// @brief Longest simulation time solve_steady_state() integrates for when
+  /// its Newton iteration does not converge.
+  gp_float steady_state_max_time = 1e12;
 
   NuclearReactor reactor;
+  /// @brief Flux and temperature of the reactor over time. Empty keeps those
+  /// of reactor.
+  ReactorHistory reactor_history;
   Material material;
 
   // Initial Defect Concentration State
@@ -0,0 +1,64 @@
+#ifndef CLUSTER_DYNAMICS_ENSEMBLE_HPP
+#define CLUSTER_DYNAMICS_ENSEMBLE_HPP
+
+#include <memory>
+#include <vector>
+
+#include "cluster_dynamics/cluster_dynamics_config.hpp"
+#include "cluster_dynamics_state.hpp"
+#include "utils/types.hpp"
+
+class ClusterDynamicsEnsembleImpl;
+
+/** @brief Class which runs the cluster dynamics simulations of many configs
+ * together, such as the parameter sets of a sensitivity study.
+ *
+ * The simulations are integrated as one block diagonal system. They share
+ * the integrator's steps, so its overhead is paid once per step for the
+ * whole ensemble, and each step evaluates and solves every member with the
+ * kernels and linear solver of a single CPU simulation. Members which
+ * evolve on very different time scales force small steps on each other,
+ * so ensembles work best for nearby parameter sets.
+ */
+class ClusterDynamicsEnsemble {
+ private:
+  std::unique_ptr<ClusterDynamicsEnsembleImpl>
+      _impl;  //< Pointer to the backend implementation class.
+
+ public:
+  /** @brief Creates an ensemble with one member per config.
+   *  @param configs The configs of the members. Each member is integrated
+   * with its own tolerances: a step is accepted when the error of every
+   * member meets them, whatever the number of members. The remaining
+   * integrator settings are taken from the first config. Cluster grouping,
+   * the continuum, the adaptive max cluster size and reactor histories are
+   * not supported, and the linear solver setting is ignored for the
+   * arrowhead solver.
+   *  @param n_threads Threads evaluating and solving the members in
+   * parallel.
+   */
+  explicit ClusterDynamicsEnsemble(std::vector<ClusterDynamicsConfig> &configs,
+                                   size_t n_threads = 1);
+
+  ClusterDynamicsEnsemble(ClusterDynamicsEnsemble &&);
+  ClusterDynamicsEnsemble &operator=(ClusterDynamicsEnsemble &&);
+  ~ClusterDynamicsEnsemble();
+
+  /** @brief Runs every member for total_time seconds and returns their end
+   * states, in the order of the configs.
+   *
+   *  Like ClusterDynamics::run(), run() can be called multiple times and
+   * resumes from where the ensemble stopped.
+   */
+  std::vector<ClusterDynamicsState> run(gp_float total_time);
+
+  /** @brief Returns the current simulation time in seconds.
+   */
+  gp_float get_time() const;
+
+  /** @brief Returns the number of members.
+   */
+  size_t size() const;
+};
+
+#endif  // CLUSTER_DYNAMICS_ENSEMBLE_HPP
@@ -1,10 +1,50 @@
 #ifndef CLUSTER_DYNAMICS_STATE_HPP
 #define CLUSTER_DYNAMICS_STATE_HPP
 
+#include <algorithm>
+#include <functional>
+#include <span>
 #include <vector>
 
+#include "utils/sensitivity_variable.hpp"
 #include "utils/types.hpp"
 
+/** @brief The moments of the concentrations of a group of consecutive cluster
+ * sizes.
+ *
+ * Within the group the concentration is taken to be linear in the cluster
+ * size:
+ *
+ * \f$
+ *   C(n) = \frac{L_0}{\Delta} + \frac{L_1}{\sigma^2}(n - \bar{n})
+ * \f$
+ *
+ * where \f$\Delta\f$ is the number of sizes in the group, \f$\bar{n}\f$
+ * their mean and \f$\sigma^2 = \sum (n - \bar{n})^2\f$.
+ */
+struct ClusterGroupState {
+  size_t first_size = 0;  //!< Smallest cluster size in the group.
+  size_t last_size = 0;   //!< Largest cluster size in the group.
+  /// @brief \f$L_0 = \sum_n C(n)\f$
+  gp_float zeroth_moment = 0.0;
+  /// @brief \f$L_1 = \sum_n (n - \bar{n}) C(n)\f$
+  gp_float first_moment = 0.0;
+
+  /** @brief Returns the concentration of clusters of size n, which must lie
+   * in the group.
+   */
+  gp_float concentration(size_t n) const {
+    const gp_float width = (gp_float)(last_size - first_size + 1);
+    const gp_float mean = .5 * (gp_float)(first_size + last_size);
+    const gp_float spread = width * (width * width - 1.) / 12.;
+    gp_float value = zeroth_moment / width;
+    if (spread > 0.) value += first_moment * ((gp_float)n - mean) / spread;
+    return value;
+  }
+};
+
+struct ClusterDynamicsStateView;
+
 /** @brief Class which contains information about the state of a ClusterDynamics
  * simulation.
  */
@@ -40,6 +80,212 @@ struct ClusterDynamicsState {
   /** @brief The current density of the dislocation network in \todo UNITS
    */
   gp_float dislocation_density = 0.0;
+
+  /** @brief The groups of interstitial cluster sizes following the last
+   * element of interstitials. Empty unless the simulation was configured with
+   * a ClusterDynamicsConfig::group_threshold or
+   * ClusterDynamicsConfig::continuum_threshold, whose cells are reported as
+   * groups without a first moment.
+   */
+  std::vector<ClusterGroupState> interstitial_groups;
+
+  /** @brief The groups of vacancy cluster sizes following the last element of
+   * vacancies.
+   */
+  std::vector<ClusterGroupState> vacancy_groups;
+
+  /** @brief Returns a copy of the state where every group is expanded back
+   * into per size concentrations.
+   */
+  ClusterDynamicsState expanded() const {
+    ClusterDynamicsState state = *this;
+    for (const ClusterGroupState& group : interstitial_groups) {
+      for (size_t n = group.first_size; n <= group.last_size; ++n)
+        state.interstitials.push_back(group.concentration(n));
+    }
+    for (const ClusterGroupState& group : vacancy_groups) {
+      for (size_t n = group.first_size; n <= group.last_size; ++n)
+        state.vacancies.push_back(group.concentration(n));
+    }
+    state.interstitial_groups.clear();
+    state.vacancy_groups.clear();
+    return state;
+  }
+
+  /** @brief Returns a read-only view of the state, valid while the state is
+   * neither modified nor destroyed.
+   */
+  ClusterDynamicsStateView view() const;
 };
 
+/** @brief A read-only view of a ClusterDynamicsState, laid out the same way,
+ * which does not own the concentrations.
+ *
+ * The views returned by ClusterDynamics::get_state_view() point into the
+ * simulation itself and are only valid until it is next run, sampled or
+ * destroyed. Copy them with copy_to() to keep them.
+ */
+struct ClusterDynamicsStateView {
+  gp_float time = 0.0;  //!< See ClusterDynamicsState::time.
+  gp_float dpa = 0.0;   //!< See ClusterDynamicsState::dpa.
+  std::span<const gp_float> interstitials;  //!< Indexed by cluster size.
+  std::span<const gp_float> vacancies;      //!< Indexed by cluster size.
+  gp_float dislocation_density = 0.0;
+  std::span<const ClusterGroupState> interstitial_groups;
+  std::span<const ClusterGroupState> vacancy_groups;
+
+  /** @brief Returns one past the largest cluster size of the state, counting
+   * the sizes in groups, like the size of the vectors of
+   * ClusterDynamicsState::expanded().
+   */
+  size_t size() const {
+    if (interstitial_groups.empty()) return interstitials.size();
+    return interstitial_groups.back().last_size + 1;
+  }
+
+  /** @brief Returns the concentration of interstitial clusters of size n,
+   * which may lie in a group, or 0 when n is not below size().
+   */
+  gp_float interstitial(size_t n) const {
+    return concentration(interstitials, interstitial_groups, n);
+  }
+
+  /** @brief Returns the concentration of vacancy clusters of size n, see
+   * interstitial().
+   */
+  gp_float vacancy(size_t n) const {
+    return concentration(vacancies, vacancy_groups, n);
+  }
+
+  /** @brief Copies the viewed state into state, reusing the capacity its
+   * vectors already have.
+   */
+  void copy_to(ClusterDynamicsState& state) const {
+    state.time = time;
+    state.dpa = dpa;
+    state.interstitials.assign(interstitials.begin(), interstitials.end());
+    state.vacancies.assign(vacancies.begin(), vacancies.end());
+    state.dislocation_density = dislocation_density;
+    state.interstitial_groups.assign(interstitial_groups.begin(),
+                                     interstitial_groups.end());
+    state.vacancy_groups.assign(vacancy_groups.begin(), vacancy_groups.end());
+  }
+
+  /** @brief Returns a copy of the viewed state.
+   */
+  ClusterDynamicsState to_state() const {
+    ClusterDynamicsState state;
+    copy_to(state);
+    return state;
+  }
+
+ private:
+  static gp_float concentration(std::span<const gp_float> exact,
+                                std::span<const ClusterGroupState> groups,
+                                size_t n) {
+    if (n < exact.size()) return exact[n];
+    // The groups are sorted and do not overlap
+    auto group = std::upper_bound(
+        groups.begin(), groups.end(), n,
+        [](size_t size, const ClusterGroupState& g) {
+          return size < g.first_size;
+        });
+    if (group == groups.begin()) return 0.0;
+    --group;
+    return n <= group->last_size ? group->concentration(n) : 0.0;
+  }
+};
+
+inline ClusterDynamicsStateView ClusterDynamicsState::view() const {
+  return ClusterDynamicsStateView{.time = time,
+                                  .dpa = dpa,
+                                  .interstitials = interstitials,
+                                  .vacancies = vacancies,
+                                  .dislocation_density = dislocation_density,
+                                  .interstitial_groups = interstitial_groups,
+                                  .vacancy_groups = vacancy_groups};
+}
+
+/** @brief The derivatives of a ClusterDynamicsState with respect to one of
+ * the sensitivity variables, see ClusterDynamics::enable_sensitivities().
+ */
+struct ClusterDynamicsSensitivity {
+  SensitivityVariable variable = SensitivityVariable::NONE;
+
+  /** Simulation time in seconds of the state the derivatives are taken of.
+   */
+  gp_float time = 0.0;
+
+  /** @brief \f$\partial C_i(n) / \partial p\f$, indexed like
+   * ClusterDynamicsState::interstitials.
+   */
+  std::vector<gp_float> interstitials;
+
+  /** @brief \f$\partial C_v(n) / \partial p\f$, indexed like
+   * ClusterDynamicsState::vacancies.
+   */
+  std::vector<gp_float> vacancies;
+
+  /** @brief \f$\partial \rho / \partial p\f$
+   */
+  gp_float dislocation_density = 0.0;
+};
+
+/** @brief Counters and timings of the integrator of a simulation, summed
+ * since the simulation was created, see ClusterDynamics::get_stats().
+ *
+ * The phase times do not overlap: time spent in a phase nested in another,
+ * such as right hand side evaluations inside a linear solve, only counts
+ * towards the inner phase.
+ */
+struct ClusterDynamicsStats {
+  long steps = 0;  //!< Integration steps taken.
+  /// @brief Right hand side evaluations, including those of difference
+  /// quotient Jacobians.
+  long rhs_evaluations = 0;
+  /// @brief Jacobian and preconditioner evaluations.
+  long jacobian_evaluations = 0;
+  long linear_solver_setups = 0;  //!< Setups (factorizations) of the solver.
+  long linear_iterations = 0;     //!< Krylov iterations, 0 when direct.
+  long nonlinear_iterations = 0;  //!< Newton iterations.
+  long error_test_failures = 0;   //!< Steps rejected by the error test.
+  /// @brief Steps rejected because the Newton iteration did not converge.
+  long nonlinear_failures = 0;
+  gp_float last_step = 0.0;     //!< Size of the last step in seconds.
+  gp_float current_step = 0.0;  //!< Size of the next step in seconds.
+  int last_order = 0;           //!< Order of the last step.
+  int current_order = 0;        //!< Order of the next step.
+
+  // Wall time in seconds
+  /// @brief Spent evaluating the right hand side.
+  gp_float rhs_time = 0.0;
+  /// @brief Spent evaluating Jacobians and Jacobian-vector products.
+  gp_float jacobian_time = 0.0;
+  /// @brief Spent setting up the linear solver and the preconditioner.
+  gp_float linear_setup_time = 0.0;
+  /// @brief Spent solving the linear systems.
+  gp_float linear_solve_time = 0.0;
+  /// @brief Spent in the integrator itself, choosing steps and orders,
+  /// testing errors and interpolating samples.
+  gp_float integrator_time = 0.0;
+
+  /** @brief Returns the wall time spent integrating, the sum of the phases.
+   */
+  gp_float wall_time() const {
+    return rhs_time + jacobian_time + linear_setup_time + linear_solve_time +
+           integrator_time;
+  }
+};
+
+/** @brief Receives the states of ClusterDynamics::sample() in order of time.
+ */
+using ClusterDynamicsSampleFn = std::function<void(const ClusterDynamicsState&)>;
+
+/** @brief Receives a view of the state of a simulation and its solver
+ * statistics, see ClusterDynamics::add_sink(). The view is only valid during
+ * the call.
+ */
+using ClusterDynamicsSinkFn = std::function<void(
+    const ClusterDynamicsStateView&, const ClusterDynamicsStats&)>;
+
 #endif  // CLUSTER_DYNAMICS_STATE_HPP
@@ -0,0 +1,185 @@
+#ifndef GLOBAL_SENSITIVITY_HPP
+#define GLOBAL_SENSITIVITY_HPP
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "cluster_dynamics/cluster_dynamics_config.hpp"
+#include "cluster_dynamics_state.hpp"
+#include "utils/sampling_method.hpp"
+#include "utils/scalar_observable.hpp"
+#include "utils/sensitivity_variable.hpp"
+#include "utils/types.hpp"
+
+/** @brief Returns the value of a sensitivity variable in the material or
+ * reactor of a config.
+ */
+gp_float sensitivity_variable_value(const ClusterDynamicsConfig &config,
+                                    SensitivityVariable variable);
+
+/** @brief Sets a sensitivity variable in the material or reactor of a
+ * config. Does nothing for SensitivityVariable::NONE.
+ */
+void set_sensitivity_variable(ClusterDynamicsConfig &config,
+                              SensitivityVariable variable, gp_float value);
+
+/** @brief Returns the value of an observable of a state simulated with the
+ * material of config.
+ */
+gp_float observable_value(const ClusterDynamicsConfig &config,
+                          const ClusterDynamicsState &state,
+                          ScalarObservable observable);
+
+/** @brief The interval a parameter of a global sensitivity analysis is drawn
+ * from, uniformly.
+ */
+struct ParameterRange {
+  SensitivityVariable variable = SensitivityVariable::NONE;
+  gp_float min = 0.0;
+  gp_float max = 0.0;
+};
+
+/** @brief The shares of the variance of an observable explained by one
+ * parameter.
+ */
+struct SobolIndices {
+  SensitivityVariable variable = SensitivityVariable::NONE;
+  /// @brief \f$S_i\f$, the share explained by the parameter alone.
+  gp_float first_order = 0.0;
+  /// @brief \f$S_{Ti}\f$, the share explained by the parameter together with
+  /// its interactions with the other parameters.
+  gp_float total = 0.0;
+};
+
+/** @brief The result of a global sensitivity analysis for one observable.
+ */
+struct GlobalSensitivity {
+  ScalarObservable observable = ScalarObservable::dislocation_density;
+  gp_float mean = 0.0;
+  gp_float variance = 0.0;
+  /// @brief The indices of every parameter, in the order of the ranges.
+  std::vector<SobolIndices> indices;
+};
+
+/** @brief Draws the two independent sample matrices A and B of the Saltelli
+ * design in the unit hypercube.
+ *
+ * Rows are generated on demand, the Sobol' sequence from its index and the
+ * Latin hypercube from one permutation of the strata per column.
+ */
+class SaltelliSampler {
+ public:
+  /// @brief The Sobol' sequence has direction numbers for this many
+  /// dimensions, and A and B take two dimensions per parameter.
+  static constexpr size_t max_sobol_dimensions = 21;
+
+  /** @brief Creates a sampler of num_samples rows of num_parameters columns.
+   *  @param seed Seeds the random permutations and offsets of the Latin
+   * hypercube, the Sobol' sequence ignores it.
+   */
+  SaltelliSampler(SamplingMethod method, size_t num_samples,
+                  size_t num_parameters, uint64_t seed = 0);
+
+  /** @brief Writes row j of A to a and row j of B to b.
+   */
+  void sample(size_t j, std::vector<gp_float> &a,
+              std::vector<gp_float> &b) const;
+
+ private:
+  SamplingMethod method;
+  size_t num_samples;
+  size_t num_parameters;
+  /// @brief Direction numbers of the Sobol' dimensions, 32 per dimension.
+  std::vector<uint32_t> directions;
+  /// @brief Latin hypercube points, row major with 2 * num_parameters
+  /// columns, A's then B's.
+  std::vector<gp_float> points;
+};
+
+/** @brief Running estimates of the Sobol' indices of one observable.
+ *
+ * Each Saltelli sample adds the observable at row j of A, of B and of the
+ * matrices \f$A_B^{(i)}\f$, A with column i taken from B. The first order
+ * indices use the estimator of Saltelli et al. (2010) and the total indices
+ * that of Jansen (1999). Only sums are kept, so the memory does not grow
+ * with the number of samples.
+ */
+class SobolAccumulator {
+ public:
+  explicit SobolAccumulator(size_t num_parameters);
+
+  /** @brief Adds the observable values of one Saltelli sample.
+   *  @param f_ab The values at the rows of \f$A_B^{(i)}\f$, one per
+   * parameter.
+   */
+  void add(gp_float f_a, gp_float f_b, const std::vector<gp_float> &f_ab);
+
+  size_t num_samples() const;
+  /** @brief Returns the mean of the observable over A and B.
+   */
+  gp_float mean() const;
+  /** @brief Returns the variance of the observable over A and B.
+   */
+  gp_float variance() const;
+  gp_float first_order(size_t i) const;
+  gp_float total(size_t i) const;
+
+ private:
+  size_t n;
+  /// @brief Welford mean and sum of squared deviations over A and B.
+  gp_float mean_val;
+  gp_float squared_deviations;
+  std::vector<gp_float> first_order_sums;
+  std::vector<gp_float> total_sums;
+};
+
+/** @brief Variance based global sensitivity analysis of observables of the
+ * end state over ranges of material and reactor parameters.
+ *
+ * The Saltelli design runs num_samples * (ranges + 2) simulations. They are
+ * run in batches on a thread pool and their observables are folded into
+ * SobolAccumulators in sample order, so the results do not depend on the
+ * number of threads and no state is kept past its batch.
+ */
+class GlobalSensitivityAnalysis {
+ public:
+  /// @brief Runs the simulation of a config and returns its end state.
+  using Simulation =
+      std::function<ClusterDynamicsState(ClusterDynamicsConfig &)>;
+
+  /** @brief Creates an analysis around a config.
+   *  @param config The settings, material and reactor of every simulation,
+   * except for the parameters drawn from the ranges.
+   *  @param seed Seeds the Latin hypercube.
+   */
+  GlobalSensitivityAnalysis(const ClusterDynamicsConfig &config,
+                            const std::vector<ParameterRange> &ranges,
+                            const std::vector<ScalarObservable> &observables,
+                            SamplingMethod method, size_t num_samples,
+                            uint64_t seed = 0);
+
+  /** @brief Returns the number of simulations run() runs.
+   */
+  size_t num_simulations() const;
+
+  /** @brief Runs every simulation of the design and returns the indices of
+   * each observable, in the order of the observables.
+   *  @param simulate Runs one simulation, called from num_threads threads
+   * at once.
+   *  @param progress Called on the calling thread with the number of
+   * finished simulations after every batch.
+   */
+  std::vector<GlobalSensitivity> run(
+      const Simulation &simulate, size_t num_threads = 1,
+      const std::function<void(size_t)> &progress = nullptr) const;
+
+ private:
+  ClusterDynamicsConfig config;
+  std::vector<ParameterRange> ranges;
+  std::vector<ScalarObservable> observables;
+  size_t num_samples;
+  SaltelliSampler sampler;
+};
+
+#endif  // GLOBAL_SENSITIVITY_HPP
@@ -0,0 +1,84 @@
+#ifndef REACTOR_HISTORY_HPP
+#define REACTOR_HISTORY_HPP
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "utils/types.hpp"
+
+/** @brief How the flux and temperature of a ReactorHistory vary between its
+ * points.
+ */
+enum class ReactorHistoryInterpolation {
+  /// @brief Each point holds until the next one, for power steps and
+  /// outages.
+  constant,
+  /// @brief Linear ramps from each point to the next one.
+  linear,
+};
+
+static std::map<std::string, ReactorHistoryInterpolation>
+    reactor_history_interpolations{
+        {"constant", ReactorHistoryInterpolation::constant},
+        {"linear", ReactorHistoryInterpolation::linear}};
+
+/** @brief The flux and temperature of the reactor from a point in time on.
+ */
+struct ReactorHistoryPoint {
+  gp_float time = 0.0;         //!< Simulation time in seconds.
+  gp_float flux = 0.0;         //!< Neutron flux in dpa/s.
+  gp_float temperature = 0.0;  //!< Temperature in Kelvin.
+};
+
+/** @brief Flux and temperature of the reactor over the simulation time, for
+ * power cycles, ramps and outages.
+ *
+ * The points are the breakpoints of the history, in increasing time. Before
+ * the first point its values hold, and after the last point its values. The
+ * other reactor parameters stay those of the config's reactor. An empty
+ * history keeps the flux and temperature of the reactor fixed.
+ */
+struct ReactorHistory {
+  ReactorHistoryInterpolation interpolation =
+      ReactorHistoryInterpolation::constant;
+  std::vector<ReactorHistoryPoint> points;
+
+  bool empty() const { return points.empty(); }
+
+  /** @brief Throws a ClusterDynamicsException unless the times increase
+   * strictly, the fluxes are not negative and the temperatures are
+   * positive.
+   */
+  void validate() const;
+
+  /** @brief Returns the flux and temperature at time t.
+   */
+  ReactorHistoryPoint at(gp_float t) const;
+
+  /** @brief Returns the dose in dpa accumulated from time 0 to time t.
+   */
+  gp_float dose(gp_float t) const;
+
+  /** @brief Returns the first breakpoint after time t, or infinity when
+   * there is none.
+   */
+  gp_float next_breakpoint(gp_float t) const;
+
+  /** @brief Whether the flux or temperature change between time t and the
+   * next breakpoint.
+   */
+  bool ramps(gp_float t) const;
+
+  /** @brief Returns the history repeated count times, each repetition
+   * shifted by period from the previous one.
+   */
+  ReactorHistory repeat(size_t count, gp_float period) const;
+
+ private:
+  /** @brief Returns the integral of the flux from the first point to t.
+   */
+  gp_float flux_integral(gp_float t) const;
+};
+
+#endif  // REACTOR_HISTORY_HPP
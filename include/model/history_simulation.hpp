@@ -2,6 +2,7 @@
 #define HISTORY_SIMULATION_HPP
 
 #include <string>
+#include <utility>
 
 #include "cluster_dynamics/cluster_dynamics_state.hpp"
 #include "model/material.hpp"
@@ -14,14 +15,16 @@ struct HistorySimulation {
   HistorySimulation(size_t max_cluster_size, gp_float simulation_time,
                     gp_float time_delta, const NuclearReactor& reactor,
                     const Material& material,
-                    const ClusterDynamicsState& cd_state)
+                    ClusterDynamicsState cd_state,
+                    const ClusterDynamicsStats& stats = ClusterDynamicsStats())
       : sqlite_id(-1),
         max_cluster_size(max_cluster_size),
         simulation_time(simulation_time),
         time_delta(time_delta),
         reactor(reactor),
         material(material),
-        cd_state(cd_state) {
+        cd_state(std::move(cd_state)),
+        stats(stats) {
     datetime::utc_now(creation_datetime);
   }
 
@@ -33,6 +36,7 @@ struct HistorySimulation {
   NuclearReactor reactor;
   Material material;
   ClusterDynamicsState cd_state;
+  ClusterDynamicsStats stats;
 };
 
 #endif  // HISTORY_SIMULATION_HPP
@@ -16,6 +16,9 @@ struct MaterialImpl;
  * ClusterDynamics simulation.
  *
  * Based loosely on: C. Pokor / Journal of Nuclear Materials 326 (2004), Table 6
+ *
+ * Copies share their parameters until one of them is changed, so copying is
+ * cheap and copies can be read and changed on different threads.
  * */
 struct Material {
   Material();
@@ -169,7 +172,11 @@ struct Material {
   /// @param val Atomic volume in cm^3.
   void set_atomic_volume(const gp_float val);
 
-  MaterialImpl *impl();
+  /// @brief Returns the parameters, which copies of this Material may share.
+  const MaterialImpl *impl() const;
+  /// @brief Returns the parameters for writing, copying them first if they
+  /// are shared.
+  MaterialImpl *mutable_impl();
 
   int sqlite_id;
   std::string creation_datetime;  //!< Timestamp of when this Material was
@@ -177,6 +184,9 @@ struct Material {
   std::string
       species;  //!< A name for what kind of material this data represents.
 
+ private:
+  /// @brief Parameters shared by the copies of this Material until one of them
+  /// is written to.
   std::shared_ptr<MaterialImpl> _impl;
 };
 
@@ -15,6 +15,9 @@ struct NuclearReactorImpl;
  *
  *  Based loosely on: C. Pokor / Journal of Nuclear Materials 326 (2004), Table
  * 5
+ *
+ *  Copies share their parameters until one of them is changed, so copying is
+ *  cheap and copies can be read and changed on different threads.
  */
 struct NuclearReactor {
   NuclearReactor();
@@ -104,7 +107,11 @@ struct NuclearReactor {
   /// @param val The parameter of dislocation network evolution.
   void set_dislocation_density_evolution(const gp_float val);
 
-  NuclearReactorImpl *impl();
+  /// @brief Returns the parameters, which copies of this NuclearReactor may share.
+  const NuclearReactorImpl *impl() const;
+  /// @brief Returns the parameters for writing, copying them first if they
+  /// are shared.
+  NuclearReactorImpl *mutable_impl();
 
   int sqlite_id;
   std::string creation_datetime;  //!< Timestamp of when this Material was
@@ -112,6 +119,9 @@ struct NuclearReactor {
   std::string
       species;  //!< A name for what kind of material this data represents.
 
+ private:
+  /// @brief Parameters shared by the copies of this NuclearReactor until one of them
+  /// is written to.
   std::shared_ptr<NuclearReactorImpl> _impl;
 };
 
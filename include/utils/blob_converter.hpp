@@ -1,6 +1,7 @@
 #ifndef BLOB_CONVERTER_HPP
 #define BLOB_CONVERTER_HPP
 
+#include <span>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -10,6 +11,7 @@
 #pragma GCC diagnostic ignored "-Wdeprecated-copy"
 #endif
 #include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/device/array.hpp>
 #include <boost/iostreams/filter/bzip2.hpp>
 #include <boost/iostreams/filtering_streambuf.hpp>
 #ifdef __GNUC__
@@ -20,12 +22,13 @@
 
 class BlobConverter {
  public:
-  static std::vector<char> to_blob(const std::vector<gp_float> &vec) {
+  // Compresses the values in place, without copying them into a stream
+  static std::vector<char> to_blob(std::span<const gp_float> vec) {
     if (vec.empty()) return {};
 
-    std::stringstream data;
-    data.write(reinterpret_cast<const char *>(vec.data()),
-               vec.size() * sizeof(gp_float));
+    boost::iostreams::array_source data(
+        reinterpret_cast<const char *>(vec.data()),
+        vec.size() * sizeof(gp_float));
 
     std::stringstream data_comp;
     boost::iostreams::filtering_streambuf<boost::iostreams::output> out;
@@ -18,6 +18,7 @@ class ArgConsumer {
   virtual gp_float get_float(const std::string &, const std::string & = "") = 0;
   virtual void populate_init_interstitials(ClusterDynamicsConfig &) = 0;
   virtual void populate_init_vacancies(ClusterDynamicsConfig &) = 0;
+  virtual void populate_reactor_history(ClusterDynamicsConfig &) = 0;
 
   void populate_cd_config(ClusterDynamicsConfig &cd_config) {
     if (has_arg("time", "simulation")) {
@@ -114,12 +115,88 @@ class ArgConsumer {
       cd_config.max_integration_step = maxis;
     }
 
+    if (has_arg("linear-solver", "simulation")) {
+      std::string ls = get_string("linear-solver", "simulation");
+      if (!linear_solver_types.count(ls))
+        throw GpiesException("Unknown value for linear-solver: " + ls + ".");
+
+      cd_config.linear_solver = linear_solver_types[ls];
+    }
+
+    if (has_arg("krylov-subspace-size", "simulation")) {
+      size_t kss = get_size_t("krylov-subspace-size", "simulation");
+      if (kss == 0)
+        throw GpiesException(
+            "Value for krylov-subspace-size must be a positive, non-zero "
+            "integer.");
+
+      cd_config.krylov_subspace_size = kss;
+    }
+
+    if (has_arg("group-threshold", "simulation")) {
+      size_t gt = get_size_t("group-threshold", "simulation");
+      if (gt > 0 && gt < 4)
+        throw GpiesException(
+            "Value for group-threshold must be 0 or an integer of at least 4.");
+
+      cd_config.group_threshold = gt;
+    }
+
+    if (has_arg("group-growth", "simulation")) {
+      gp_float gg = get_float("group-growth", "simulation");
+      if (gg < 1.)
+        throw GpiesException(
+            "Value for group-growth must be a decimal of at least 1.");
+
+      cd_config.group_growth = gg;
+    }
+
+    if (has_arg("continuum-threshold", "simulation")) {
+      size_t ct = get_size_t("continuum-threshold", "simulation");
+      if (ct > 0 && ct < 4)
+        throw GpiesException(
+            "Value for continuum-threshold must be 0 or an integer of at "
+            "least 4.");
+
+      cd_config.continuum_threshold = ct;
+    }
+
+    if (has_arg("continuum-growth", "simulation")) {
+      gp_float cg = get_float("continuum-growth", "simulation");
+      if (cg < 1.)
+        throw GpiesException(
+            "Value for continuum-growth must be a decimal of at least 1.");
+
+      cd_config.continuum_growth = cg;
+    }
+
+    if (has_arg("initial-max-cluster-size", "simulation")) {
+      size_t imcs = get_size_t("initial-max-cluster-size", "simulation");
+      if (imcs > 0 && imcs < 4)
+        throw GpiesException(
+            "Value for initial-max-cluster-size must be 0 or an integer of at "
+            "least 4.");
+
+      cd_config.initial_max_cluster_size = imcs;
+    }
+
+    if (has_arg("tail-threshold", "simulation")) {
+      gp_float tt = get_float("tail-threshold", "simulation");
+      if (tt <= 0.)
+        throw GpiesException(
+            "Value for tail-threshold must be a positive, non-zero decimal.");
+
+      cd_config.tail_threshold = tt;
+    }
+
     if (has_arg("reactor")) {
       populate_reactor(cd_config.reactor);
     } else {
       nuclear_reactors::OSIRIS(cd_config.reactor);
     }
 
+    if (has_arg("reactor-history")) populate_reactor_history(cd_config);
+
     if (has_arg("material")) {
       populate_material(cd_config.material);
     } else {
@@ -90,6 +90,14 @@ class CliArgConsumer : public ArgConsumer {
     yaml_consumer.populate_init_vacancies(cd_config);
   }
 
+  void populate_reactor_history(ClusterDynamicsConfig &cd_config) {
+    yaml_consumer.populate_reactor_history(cd_config);
+  }
+
+  void populate_parameter_ranges(std::vector<ParameterRange> &ranges) {
+    yaml_consumer.populate_parameter_ranges(ranges);
+  }
+
  private:
   po::variables_map vm;
   YamlConsumer yaml_consumer;
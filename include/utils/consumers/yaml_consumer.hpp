@@ -9,6 +9,7 @@
 
 #include "arg_consumer.hpp"
 #include "cluster_dynamics/cluster_dynamics_config.hpp"
+#include "cluster_dynamics/global_sensitivity.hpp"
 #include "model/material.hpp"
 #include "model/nuclear_reactor.hpp"
 
@@ -82,6 +83,77 @@ class YamlConsumer : public ArgConsumer {
                                 config["init-vacancies"]);
   }
 
+  /** @brief Reads the reactor-history section: the interpolation, constant
+   * or linear, the [time, flux, temperature] points and optionally a number
+   * of cycles to repeat them for, each a period later than the previous one.
+   */
+  void populate_reactor_history(ClusterDynamicsConfig &cd_config) {
+    const YAML::Node history = config["reactor-history"];
+    if (!history.IsMap() || !history["points"].IsSequence())
+      throw GpiesException(
+          "The reactor-history section needs a sequence of points.");
+
+    ReactorHistory &reactor_history = cd_config.reactor_history;
+    reactor_history = ReactorHistory();
+    if (history["interpolation"]) {
+      const std::string name = history["interpolation"].as<std::string>();
+      if (!reactor_history_interpolations.count(name))
+        throw GpiesException("Unknown reactor history interpolation " + name +
+                             ".");
+      reactor_history.interpolation = reactor_history_interpolations[name];
+    }
+
+    for (const YAML::Node &point : history["points"]) {
+      if (!point.IsSequence() || point.size() != 3)
+        throw GpiesException(
+            "reactor history points must have 3 elements: [time, flux, "
+            "temperature]");
+
+      reactor_history.points.push_back(
+          ReactorHistoryPoint{.time = point[0].as<gp_float>(),
+                              .flux = point[1].as<gp_float>(),
+                              .temperature = point[2].as<gp_float>()});
+    }
+
+    if (history["cycles"]) {
+      const size_t cycles = history["cycles"].as<size_t>();
+      const gp_float period =
+          history["period"] ? history["period"].as<gp_float>() : 0.;
+      if (cycles == 0 || period <= 0.)
+        throw GpiesException(
+            "Repeating a reactor history needs at least 1 cycle and a "
+            "positive period.");
+      reactor_history = reactor_history.repeat(cycles, period);
+    }
+  }
+
+  /** @brief Reads the parameter-ranges of the sensitivity-analysis section, a
+   * map from sensitivity variable names to [min, max] ranges.
+   */
+  void populate_parameter_ranges(std::vector<ParameterRange> &ranges) {
+    if (!has_config_file() ||
+        !config["sensitivity-analysis"]["parameter-ranges"].IsMap())
+      throw GpiesException(
+          "Global sensitivity analysis needs the parameter-ranges of the "
+          "sensitivity-analysis section of a config file.");
+
+    for (const auto &entry :
+         config["sensitivity-analysis"]["parameter-ranges"]) {
+      const std::string name = entry.first.as<std::string>();
+      if (!sensitivity_variables.count(name))
+        throw GpiesException("Unknown sensitivity variable " + name + ".");
+
+      const YAML::Node &range = entry.second;
+      if (!range.IsSequence() || range.size() != 2)
+        throw GpiesException(
+            "parameter ranges must have 2 elements: [min, max]");
+
+      ranges.push_back(ParameterRange{.variable = sensitivity_variables[name],
+                                      .min = range[0].as<gp_float>(),
+                                      .max = range[1].as<gp_float>()});
+    }
+  }
+
  private:
   YAML::Node config;
 
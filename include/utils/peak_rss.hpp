@@ -0,0 +1,57 @@
+#ifndef PEAK_RSS_HPP
+#define PEAK_RSS_HPP
+
+#include <cstddef>
+#include <fstream>
+#include <limits>
+#include <string>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+/** @brief Resets the peak resident set size of the process to its current
+ * resident set size.
+ *  @return Whether the platform supports it (Linux only), otherwise
+ * peak_rss() keeps returning the peak since the process started.
+ */
+inline bool reset_peak_rss() {
+#if defined(__linux__)
+  std::ofstream clear_refs("/proc/self/clear_refs");
+  clear_refs << "5" << std::flush;
+  return static_cast<bool>(clear_refs);
+#else
+  return false;
+#endif
+}
+
+/** @brief Returns the peak resident set size of the process in bytes since
+ * the last reset_peak_rss(), or 0 where it is unknown.
+ */
+inline size_t peak_rss() {
+#if defined(__linux__)
+  std::ifstream status("/proc/self/status");
+  std::string key;
+  while (status >> key) {
+    if (key == "VmHWM:") {
+      size_t kilobytes = 0;
+      status >> kilobytes;
+      return kilobytes * 1024;
+    }
+    status.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+  }
+
+  // ru_maxrss is in kilobytes on Linux
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0)
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#elif defined(__APPLE__)
+  // and in bytes on macOS
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0)
+    return static_cast<size_t>(usage.ru_maxrss);
+#endif
+  return 0;
+}
+
+#endif  // PEAK_RSS_HPP
@@ -66,6 +66,24 @@ class Randomizer {
     }
 
     simulation.cd_state.dislocation_density = randd();
+
+    simulation.stats.steps = rand();
+    simulation.stats.rhs_evaluations = rand();
+    simulation.stats.jacobian_evaluations = rand();
+    simulation.stats.linear_solver_setups = rand();
+    simulation.stats.linear_iterations = rand();
+    simulation.stats.nonlinear_iterations = rand();
+    simulation.stats.error_test_failures = rand();
+    simulation.stats.nonlinear_failures = rand();
+    simulation.stats.last_step = randd();
+    simulation.stats.current_step = randd();
+    simulation.stats.last_order = rand() % 5 + 1;
+    simulation.stats.current_order = rand() % 5 + 1;
+    simulation.stats.rhs_time = randd();
+    simulation.stats.jacobian_time = randd();
+    simulation.stats.linear_setup_time = randd();
+    simulation.stats.linear_solve_time = randd();
+    simulation.stats.integrator_time = randd();
   }
 };
 
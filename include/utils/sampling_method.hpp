@@ -0,0 +1,22 @@
+#ifndef SAMPLING_METHOD_HPP
+#define SAMPLING_METHOD_HPP
+
+#include <map>
+#include <string>
+
+/** @brief Designs drawing the parameter sets of a global sensitivity
+ * analysis, see GlobalSensitivityAnalysis.
+ */
+enum class SamplingMethod {
+  /// @brief Randomized Latin hypercube, every parameter range is split into
+  /// as many strata as there are samples and each stratum is drawn once.
+  latin_hypercube,
+  /// @brief The Sobol' low discrepancy sequence, deterministic.
+  sobol,
+};
+
+static std::map<std::string, SamplingMethod> sampling_methods{
+    {"latin-hypercube", SamplingMethod::latin_hypercube},
+    {"sobol", SamplingMethod::sobol}};
+
+#endif  // SAMPLING_METHOD_HPP
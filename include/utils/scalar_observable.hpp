@@ -0,0 +1,22 @@
+#ifndef SCALAR_OBSERVABLE_HPP
+#define SCALAR_OBSERVABLE_HPP
+
+#include <map>
+#include <string>
+
+/** @brief Scalar functions of the end state whose gradients
+ * ClusterDynamics::adjoint_gradient() computes.
+ */
+enum class ScalarObservable {
+  /// @brief The dislocation network density in cm^-2.
+  dislocation_density,
+  /// @brief The volume fraction of vacancy clusters of size 2 and up,
+  /// \f$\Omega \sum_{n \geq 2} n C_v(n)\f$.
+  vacancy_cluster_volume,
+};
+
+static std::map<std::string, ScalarObservable> scalar_observables{
+    {"dislocation-density", ScalarObservable::dislocation_density},
+    {"vacancy-cluster-volume", ScalarObservable::vacancy_cluster_volume}};
+
+#endif  // SCALAR_OBSERVABLE_HPP
@@ -0,0 +1,111 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/** @brief A fixed set of threads running fork-join loops.
+ *
+ * The thread calling parallel_for() takes part in the loop, so a pool of size
+ * n starts n - 1 worker threads.
+ */
+class ThreadPool {
+ public:
+  explicit ThreadPool(size_t num_threads) {
+    for (size_t i = 1; i < num_threads; ++i) {
+      workers.emplace_back([this] { work(); });
+    }
+  }
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    start.notify_all();
+    for (std::thread& worker : workers) worker.join();
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /** @brief Returns the number of threads taking part in parallel_for().
+   */
+  size_t size() const { return workers.size() + 1; }
+
+  /** @brief Calls task(i) for every i in [0, num_tasks) and returns once all
+   * of them have finished.
+   *
+   * Tasks are handed out in an unspecified order and must not throw.
+   */
+  void parallel_for(size_t num_tasks,
+                    const std::function<void(size_t)>& task) {
+    if (workers.empty() || num_tasks <= 1) {
+      for (size_t i = 0; i < num_tasks; ++i) task(i);
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      current_task = &task;
+      current_num_tasks = num_tasks;
+      next_task = 0;
+      busy_workers = workers.size();
+      ++generation;
+    }
+    start.notify_all();
+
+    run_tasks(task, num_tasks);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return busy_workers == 0; });
+    current_task = nullptr;
+  }
+
+ private:
+  void run_tasks(const std::function<void(size_t)>& task, size_t num_tasks) {
+    for (size_t i = next_task++; i < num_tasks; i = next_task++) task(i);
+  }
+
+  void work() {
+    size_t seen_generation = 0;
+    while (true) {
+      const std::function<void(size_t)>* task;
+      size_t num_tasks;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        start.wait(lock, [&] {
+          return stopping || generation != seen_generation;
+        });
+        if (stopping) return;
+        seen_generation = generation;
+        task = current_task;
+        num_tasks = current_num_tasks;
+      }
+
+      run_tasks(*task, num_tasks);
+
+      std::lock_guard<std::mutex> lock(mutex);
+      if (--busy_workers == 0) done.notify_one();
+    }
+  }
+
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable start;
+  std::condition_variable done;
+
+  const std::function<void(size_t)>* current_task = nullptr;
+  size_t current_num_tasks = 0;
+  std::atomic<size_t> next_task = 0;
+  size_t busy_workers = 0;
+  size_t generation = 0;
+  bool stopping = false;
+};
+
+#endif  // THREAD_POOL_HPP
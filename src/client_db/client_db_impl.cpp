@@ -30,6 +30,22 @@ bool ClientDbImpl::init(int *sqlite_result_code) {
     throw ClientDbException("Failed to initialize database.", sqlite_errmsg,
                             sqlite_code, db_queries::init);
 
+  sqlite3_stmt *stmt;
+  sqlite_code = sqlite3_prepare_v2(db, db_queries::has_simulation_stats.c_str(),
+                                   -1, &stmt, nullptr);
+  const bool has_simulation_stats = is_sqlite_success(sqlite_code) &&
+                                    sqlite3_step(stmt) == SQLITE_ROW &&
+                                    sqlite3_column_int(stmt, 0) > 0;
+  sqlite3_finalize(stmt);
+
+  if (!has_simulation_stats) {
+    sqlite_code = sqlite3_exec(db, db_queries::add_simulation_stats.c_str(),
+                               nullptr, nullptr, &sqlite_errmsg);
+    if (is_sqlite_error(sqlite_code))
+      throw ClientDbException("Failed to initialize database.", sqlite_errmsg,
+                              sqlite_code, db_queries::add_simulation_stats);
+  }
+
   if (sqlite_result_code) *sqlite_result_code = sqlite_code;
   return is_sqlite_success(sqlite_code);
 }
@@ -68,7 +68,24 @@ std::string init =
     "interstitials BLOB,"
     "vacancies BLOB,"
     "dislocation_density FLOAT DEFAULT 0.0,"
-    "density_per_atom FLOAT DEFAULT 0.0"
+    "density_per_atom FLOAT DEFAULT 0.0,"
+    "steps INTEGER DEFAULT 0,"
+    "rhs_evaluations INTEGER DEFAULT 0,"
+    "jacobian_evaluations INTEGER DEFAULT 0,"
+    "linear_solver_setups INTEGER DEFAULT 0,"
+    "linear_iterations INTEGER DEFAULT 0,"
+    "nonlinear_iterations INTEGER DEFAULT 0,"
+    "error_test_failures INTEGER DEFAULT 0,"
+    "nonlinear_failures INTEGER DEFAULT 0,"
+    "last_step FLOAT DEFAULT 0.0,"
+    "current_step FLOAT DEFAULT 0.0,"
+    "last_order INTEGER DEFAULT 0,"
+    "current_order INTEGER DEFAULT 0,"
+    "rhs_time FLOAT DEFAULT 0.0,"
+    "jacobian_time FLOAT DEFAULT 0.0,"
+    "linear_setup_time FLOAT DEFAULT 0.0,"
+    "linear_solve_time FLOAT DEFAULT 0.0,"
+    "integrator_time FLOAT DEFAULT 0.0"
     ");";
 
 std::string clear =
@@ -79,6 +96,46 @@ std::string clear =
 
 std::string last_insert_rowid = "SELECT last_insert_rowid();";
 
+std::string has_simulation_stats =
+    "SELECT COUNT(*) FROM pragma_table_info('history_simulations') "
+    "WHERE name = 'steps';";
+
+std::string add_simulation_stats =
+    "ALTER TABLE history_simulations ADD COLUMN "
+    "steps INTEGER DEFAULT 0;"
+    "ALTER TABLE history_simulations ADD COLUMN "
+    "rhs_evaluations INTEGER DEFAULT 0;"
+    "ALTER TABLE history_simulations ADD COLUMN "
+    "jacobian_evaluations INTEGER DEFAULT 0;"
+    "ALTER TABLE history_simulations ADD COLUMN "
+    "linear_solver_setups INTEGER DEFAULT 0;"
+    "ALTER TABLE history_simulations ADD COLUMN "
+    "linear_iterations INTEGER DEFAULT 0;"
+    "ALTER TABLE history_simulations ADD COLUMN "
+    "nonlinear_iterations INTEGER DEFAULT 0;"
+    "ALTER TABLE history_simulations ADD COLUMN "
+    "error_test_failures INTEGER DEFAULT 0;"
+    "ALTER TABLE history_simulations ADD COLUMN "
+    "nonlinear_failures INTEGER DEFAULT 0;"
+    "ALTER TABLE history_simulations ADD COLUMN "
+    "last_step FLOAT DEFAULT 0.0;"
+    "ALTER TABLE history_simulations ADD COLUMN "
+    "current_step FLOAT DEFAULT 0.0;"
+    "ALTER TABLE history_simulations ADD COLUMN "
+    "last_order INTEGER DEFAULT 0;"
+    "ALTER TABLE history_simulations ADD COLUMN "
+    "current_order INTEGER DEFAULT 0;"
+    "ALTER TABLE history_simulations ADD COLUMN "
+    "rhs_time FLOAT DEFAULT 0.0;"
+    "ALTER TABLE history_simulations ADD COLUMN "
+    "jacobian_time FLOAT DEFAULT 0.0;"
+    "ALTER TABLE history_simulations ADD COLUMN "
+    "linear_setup_time FLOAT DEFAULT 0.0;"
+    "ALTER TABLE history_simulations ADD COLUMN "
+    "linear_solve_time FLOAT DEFAULT 0.0;"
+    "ALTER TABLE history_simulations ADD COLUMN "
+    "integrator_time FLOAT DEFAULT 0.0;";
+
 // reactors CRUD
 
 std::string create_reactor =
@@ -158,8 +215,14 @@ std::string create_simulation =
     "INSERT INTO history_simulations ("
     "max_cluster_size, simulation_time, time_delta, id_reactor, "
     "id_material, interstitials, vacancies, "
-    "dislocation_density, density_per_atom, creation_datetime"
-    ") VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?);";
+    "dislocation_density, density_per_atom, creation_datetime, steps, "
+    "rhs_evaluations, jacobian_evaluations, linear_solver_setups, "
+    "linear_iterations, nonlinear_iterations, error_test_failures, "
+    "nonlinear_failures, last_step, current_step, last_order, current_order, "
+    "rhs_time, jacobian_time, linear_setup_time, linear_solve_time, "
+    "integrator_time"
+    ") VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, "
+    "?, ?, ?, ?, ?, ?);";
 
 std::string read_simulations =
     "SELECT * FROM history_simulations "
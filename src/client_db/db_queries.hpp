@@ -15,6 +15,12 @@ extern std::string clear;
 
 extern std::string last_insert_rowid;
 
+// Adds the solver statistics columns to history_simulations tables created
+// before they were stored
+extern std::string has_simulation_stats;
+
+extern std::string add_simulation_stats;
+
 // reactors CRUD
 
 extern std::string create_reactor;
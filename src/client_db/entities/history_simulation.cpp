@@ -46,6 +46,25 @@ void HistorySimulationEntity::bind_base(sqlite3_stmt *stmt,
   sqlite3_bind_double(stmt, 9, static_cast<double>(simulation.cd_state.dpa));
   sqlite3_bind_text(stmt, 10, simulation.creation_datetime.c_str(),
                     simulation.creation_datetime.length(), nullptr);
+
+  const ClusterDynamicsStats &stats = simulation.stats;
+  sqlite3_bind_int64(stmt, 11, stats.steps);
+  sqlite3_bind_int64(stmt, 12, stats.rhs_evaluations);
+  sqlite3_bind_int64(stmt, 13, stats.jacobian_evaluations);
+  sqlite3_bind_int64(stmt, 14, stats.linear_solver_setups);
+  sqlite3_bind_int64(stmt, 15, stats.linear_iterations);
+  sqlite3_bind_int64(stmt, 16, stats.nonlinear_iterations);
+  sqlite3_bind_int64(stmt, 17, stats.error_test_failures);
+  sqlite3_bind_int64(stmt, 18, stats.nonlinear_failures);
+  sqlite3_bind_double(stmt, 19, static_cast<double>(stats.last_step));
+  sqlite3_bind_double(stmt, 20, static_cast<double>(stats.current_step));
+  sqlite3_bind_int(stmt, 21, stats.last_order);
+  sqlite3_bind_int(stmt, 22, stats.current_order);
+  sqlite3_bind_double(stmt, 23, static_cast<double>(stats.rhs_time));
+  sqlite3_bind_double(stmt, 24, static_cast<double>(stats.jacobian_time));
+  sqlite3_bind_double(stmt, 25, static_cast<double>(stats.linear_setup_time));
+  sqlite3_bind_double(stmt, 26, static_cast<double>(stats.linear_solve_time));
+  sqlite3_bind_double(stmt, 27, static_cast<double>(stats.integrator_time));
 }
 
 void HistorySimulationEntity::bind_update_one(
@@ -91,8 +110,27 @@ void HistorySimulationEntity::read_row(sqlite3_stmt *stmt,
 
   simulation.cd_state.dpa = sqlite3_column_double(stmt, 10);
 
-  _nuclear_reactor_entity.read_row(stmt, simulation.reactor, 11);
-  _material_entity.read_row(stmt, simulation.material, 25);
+  ClusterDynamicsStats &stats = simulation.stats;
+  stats.steps = sqlite3_column_int64(stmt, 11);
+  stats.rhs_evaluations = sqlite3_column_int64(stmt, 12);
+  stats.jacobian_evaluations = sqlite3_column_int64(stmt, 13);
+  stats.linear_solver_setups = sqlite3_column_int64(stmt, 14);
+  stats.linear_iterations = sqlite3_column_int64(stmt, 15);
+  stats.nonlinear_iterations = sqlite3_column_int64(stmt, 16);
+  stats.error_test_failures = sqlite3_column_int64(stmt, 17);
+  stats.nonlinear_failures = sqlite3_column_int64(stmt, 18);
+  stats.last_step = sqlite3_column_double(stmt, 19);
+  stats.current_step = sqlite3_column_double(stmt, 20);
+  stats.last_order = sqlite3_column_int(stmt, 21);
+  stats.current_order = sqlite3_column_int(stmt, 22);
+  stats.rhs_time = sqlite3_column_double(stmt, 23);
+  stats.jacobian_time = sqlite3_column_double(stmt, 24);
+  stats.linear_setup_time = sqlite3_column_double(stmt, 25);
+  stats.linear_solve_time = sqlite3_column_double(stmt, 26);
+  stats.integrator_time = sqlite3_column_double(stmt, 27);
+
+  _nuclear_reactor_entity.read_row(stmt, simulation.reactor, 28);
+  _material_entity.read_row(stmt, simulation.material, 42);
 }
 
 std::string HistorySimulationEntity::get_entity_name() { return "simulation"; }
@@ -0,0 +1,87 @@
+#include "cluster_dynamics/async_sink.hpp"
+
+#include <algorithm>
+#include <utility>
+
+AsyncSink::AsyncSink(std::vector<ClusterDynamicsSinkFn> sinks,
+                     size_t capacity, SinkOverflow overflow)
+    : sinks(std::move(sinks)),
+      overflow(overflow),
+      slots(std::max<size_t>(capacity, 1)),
+      worker([this] { work(); }) {}
+
+AsyncSink::~AsyncSink() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  not_empty.notify_one();
+  worker.join();
+}
+
+ClusterDynamicsSinkFn AsyncSink::sink() {
+  return [this](const ClusterDynamicsStateView& state,
+                const ClusterDynamicsStats& stats) { push(state, stats); };
+}
+
+void AsyncSink::push(const ClusterDynamicsStateView& state,
+                     const ClusterDynamicsStats& stats) {
+  std::unique_lock<std::mutex> lock(mutex);
+  if (error) std::rethrow_exception(error);
+  if (count == slots.size()) {
+    if (overflow == SinkOverflow::drop) {
+      ++dropped;
+      return;
+    }
+    not_full.wait(lock, [this] { return count < slots.size() || error; });
+    if (error) std::rethrow_exception(error);
+  }
+
+  // The worker only reads the slots between head and head + count, so the
+  // free slot can be filled without holding the lock
+  Observation& slot = slots[(head + count) % slots.size()];
+  lock.unlock();
+  state.copy_to(slot.state);
+  slot.stats = stats;
+  lock.lock();
+
+  ++count;
+  not_empty.notify_one();
+}
+
+void AsyncSink::flush() {
+  std::unique_lock<std::mutex> lock(mutex);
+  not_full.wait(lock, [this] { return count == 0 || error; });
+  if (error) std::rethrow_exception(error);
+}
+
+size_t AsyncSink::get_dropped() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return dropped;
+}
+
+void AsyncSink::work() {
+  while (true) {
+    std::unique_lock<std::mutex> lock(mutex);
+    not_empty.wait(lock, [this] { return stopping || count > 0; });
+    // The queue is drained before stopping
+    if (count == 0) return;
+
+    Observation& slot = slots[head];
+    lock.unlock();
+    try {
+      if (!error) {
+        const ClusterDynamicsStateView view = slot.state.view();
+        for (const ClusterDynamicsSinkFn& sink : sinks) sink(view, slot.stats);
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> error_lock(mutex);
+      error = std::current_exception();
+    }
+    lock.lock();
+
+    head = (head + 1) % slots.size();
+    --count;
+    not_full.notify_all();
+  }
+}
@@ -13,6 +13,12 @@ ClusterDynamics ClusterDynamics::cpu(ClusterDynamicsConfig &config) {
   return ClusterDynamics(config, std::move(impl));
 }
 
+ClusterDynamics ClusterDynamics::cpu_threaded(ClusterDynamicsConfig &config,
+                                              size_t n_threads) {
+  auto impl = std::make_unique<ClusterDynamicsCpuImpl>(config, n_threads);
+  return ClusterDynamics(config, std::move(impl));
+}
+
 #if defined(USE_CUDA)
 ClusterDynamics ClusterDynamics::cuda(ClusterDynamicsConfig &config) {
   auto impl = std::make_unique<ClusterDynamicsCudaImpl>(config);
@@ -20,36 +26,121 @@ ClusterDynamics ClusterDynamics::cuda(ClusterDynamicsConfig &config) {
 }
 #endif
 
+ClusterDynamics ClusterDynamics::from_checkpoint(const std::string &path,
+                                                 size_t n_threads) {
+  ClusterDynamicsConfig config;
+  return from_checkpoint(path, config, n_threads);
+}
+
+ClusterDynamics ClusterDynamics::from_checkpoint(const std::string &path,
+                                                 ClusterDynamicsConfig &config,
+                                                 size_t n_threads) {
+  auto impl = ClusterDynamicsCpuImpl::from_checkpoint(path, config, n_threads);
+  config.init_interstitials = {};
+  config.init_vacancies = {};
+  return ClusterDynamics(config, std::move(impl));
+}
+
 ClusterDynamics::ClusterDynamics(ClusterDynamicsConfig &config,
                                  std::unique_ptr<ClusterDynamicsImpl> impl)
     : _impl(std::move(impl)),
       material(config.material),
       reactor(config.reactor) {}
 
-/** We cannot use the default destructor that the header would've defined
- * because unique_ptr needs to know how to delete the type it contains:
+/** We cannot use the default destructor and moves that the header would've
+ * defined because unique_ptr needs to know how to delete the type it contains:
  * \n
  * https://stackoverflow.com/questions/34072862/why-is-error-invalid-application-of-sizeof-to-an-incomplete-type-using-uniqu
  */
 ClusterDynamics::~ClusterDynamics() {}
 
+ClusterDynamics::ClusterDynamics(ClusterDynamics &&) = default;
+
+ClusterDynamics &ClusterDynamics::operator=(ClusterDynamics &&) = default;
+
 ClusterDynamicsState ClusterDynamics::run([[maybe_unused]] gp_float time_delta,
                                           gp_float total_time) {
   return _impl->run(total_time);
 }
 
+void ClusterDynamics::run_into([[maybe_unused]] gp_float time_delta,
+                               gp_float total_time,
+                               ClusterDynamicsState &state) {
+  _impl->run_into(total_time, state);
+}
+
+ClusterDynamicsState ClusterDynamics::sample(
+    const std::vector<gp_float> &sample_times,
+    const ClusterDynamicsSampleFn &on_sample) {
+  return _impl->sample(sample_times, on_sample);
+}
+
+std::vector<ClusterDynamicsState> ClusterDynamics::sample(
+    const std::vector<gp_float> &sample_times) {
+  std::vector<ClusterDynamicsState> states;
+  states.reserve(sample_times.size());
+  _impl->sample(sample_times, [&](const ClusterDynamicsState &state) {
+    states.push_back(state);
+  });
+  return states;
+}
+
+ClusterDynamicsState ClusterDynamics::solve_steady_state() {
+  return _impl->solve_steady_state();
+}
+
+void ClusterDynamics::enable_sensitivities(
+    const std::vector<SensitivityVariable> &variables) {
+  _impl->enable_sensitivities(variables);
+}
+
+std::vector<ClusterDynamicsSensitivity> ClusterDynamics::get_sensitivities()
+    const {
+  return _impl->get_sensitivities();
+}
+
+std::map<std::string, gp_float> ClusterDynamics::adjoint_gradient(
+    gp_float total_time, ScalarObservable observable) {
+  return _impl->adjoint_gradient(total_time, observable);
+}
+
+gp_float ClusterDynamics::get_time() const { return _impl->get_time(); }
+
+ClusterDynamicsStateView ClusterDynamics::get_state_view() const {
+  return _impl->get_state_view();
+}
+
+size_t ClusterDynamics::add_sink(const std::vector<gp_float> &sample_times,
+                                 ClusterDynamicsSinkFn sink) {
+  return _impl->sinks.add(sample_times, _impl->get_time(), std::move(sink));
+}
+
+size_t ClusterDynamics::add_step_sink(ClusterDynamicsSinkFn sink) {
+  return _impl->sinks.add_step(std::move(sink));
+}
+
+void ClusterDynamics::remove_sink(size_t id) { _impl->sinks.remove(id); }
+
+ClusterDynamicsStats ClusterDynamics::get_stats() const {
+  return _impl->get_stats();
+}
+
+void ClusterDynamics::save_checkpoint(const std::string &path) const {
+  _impl->save_checkpoint(path);
+}
+
 Material ClusterDynamics::get_material() const { return material; }
 
 void ClusterDynamics::set_material(const Material &material) {
   this->material = material;
-  _impl->set_material(*material._impl);
+  _impl->set_material(*material.impl());
 }
 
 NuclearReactor ClusterDynamics::get_reactor() const { return reactor; }
 
 void ClusterDynamics::set_reactor(const NuclearReactor &reactor) {
   this->reactor = reactor;
-  _impl->set_reactor(*reactor._impl);
+  _impl->set_reactor(*reactor.impl());
 }
 
 void ClusterDynamics::set_data_validation(const bool data_validation_on) {
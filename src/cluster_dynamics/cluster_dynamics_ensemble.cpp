@@ -0,0 +1,29 @@
+#include "cluster_dynamics/cluster_dynamics_ensemble.hpp"
+
+#include "cpu/cluster_dynamics_ensemble_impl.hpp"
+
+ClusterDynamicsEnsemble::ClusterDynamicsEnsemble(
+    std::vector<ClusterDynamicsConfig> &configs, size_t n_threads)
+    : _impl(std::make_unique<ClusterDynamicsEnsembleImpl>(configs,
+                                                          n_threads)) {}
+
+// The destructor and moves need the complete ClusterDynamicsEnsembleImpl,
+// see ~ClusterDynamics()
+ClusterDynamicsEnsemble::~ClusterDynamicsEnsemble() {}
+
+ClusterDynamicsEnsemble::ClusterDynamicsEnsemble(ClusterDynamicsEnsemble &&) =
+    default;
+
+ClusterDynamicsEnsemble &ClusterDynamicsEnsemble::operator=(
+    ClusterDynamicsEnsemble &&) = default;
+
+std::vector<ClusterDynamicsState> ClusterDynamicsEnsemble::run(
+    gp_float total_time) {
+  return _impl->run(total_time);
+}
+
+gp_float ClusterDynamicsEnsemble::get_time() const {
+  return _impl->get_time();
+}
+
+size_t ClusterDynamicsEnsemble::size() const { return _impl->members.size(); }
@@ -1,11 +1,16 @@
 #ifndef CLUSTER_DYNAMICS_IMPL_HPP
 #define CLUSTER_DYNAMICS_IMPL_HPP
 
+#include <map>
+#include <string>
+
 #include "cluster_dynamics/cluster_dynamics_config.hpp"
 #include "cluster_dynamics/cluster_dynamics_state.hpp"
 #include "material_impl.hpp"
 #include "nuclear_reactor_impl.hpp"
+#include "sink_registry.hpp"
 #include "utils/constants.hpp"
+#include "utils/scalar_observable.hpp"
 
 class ClusterDynamicsImpl {
  public:
@@ -15,8 +20,24 @@ class ClusterDynamicsImpl {
   size_t max_num_integration_steps;
   gp_float min_integration_step;
   gp_float max_integration_step;
+  SinkRegistry sinks;
 
   virtual ClusterDynamicsState run(gp_float total_time) = 0;
+  virtual void run_into(gp_float total_time, ClusterDynamicsState& state) = 0;
+  virtual ClusterDynamicsState sample(
+      const std::vector<gp_float>& sample_times,
+      const ClusterDynamicsSampleFn& on_sample) = 0;
+  virtual ClusterDynamicsState solve_steady_state() = 0;
+  virtual void enable_sensitivities(
+      const std::vector<SensitivityVariable>& variables) = 0;
+  virtual std::vector<ClusterDynamicsSensitivity> get_sensitivities()
+      const = 0;
+  virtual std::map<std::string, gp_float> adjoint_gradient(
+      gp_float total_time, ScalarObservable observable) = 0;
+  virtual gp_float get_time() const = 0;
+  virtual ClusterDynamicsStateView get_state_view() const = 0;
+  virtual ClusterDynamicsStats get_stats() const = 0;
+  virtual void save_checkpoint(const std::string& path) const = 0;
   virtual MaterialImpl get_material() const = 0;
   virtual void set_material(const MaterialImpl& material) = 0;
   virtual NuclearReactorImpl get_reactor() const = 0;
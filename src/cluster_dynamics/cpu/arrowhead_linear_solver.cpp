@@ -0,0 +1,422 @@
+#include "arrowhead_linear_solver.hpp"
+
+DIAGNOSTIC_PUSH
+DIAGNOSTIC_DISABLE("-Wunused-parameter")
+#include <sundials/sundials_nvector.h>
+DIAGNOSTIC_POP
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+ArrowheadMatrixContent::ArrowheadMatrixContent(
+    sunindextype size, const std::vector<sunindextype>& border)
+    : size(size), border(border), position(size, 0) {
+  for (size_t k = 0; k < border.size(); ++k) {
+    position[border[k]] = -(sunindextype)(k + 1);
+  }
+
+  for (sunindextype i = 0; i < size; ++i) {
+    if (position[i] < 0) continue;
+    position[i] = interior.size();
+    interior.push_back(i);
+  }
+
+  const size_t m = interior.size();
+  const size_t k = border.size();
+  lower = std::vector<gp_float>(m, 0.);
+  diagonal = std::vector<gp_float>(m, 0.);
+  upper = std::vector<gp_float>(m, 0.);
+  right = std::vector<gp_float>(m * k, 0.);
+  bottom = std::vector<gp_float>(k * m, 0.);
+  corner = std::vector<gp_float>(k * k, 0.);
+}
+
+bool ArrowheadMatrixContent::add(sunindextype row, sunindextype col,
+                                 gp_float value) {
+  const sunindextype r = position[row];
+  const sunindextype c = position[col];
+  const sunindextype m = num_interior();
+  const sunindextype k = num_border();
+
+  if (r >= 0 && c >= 0) {
+    switch (c - r) {
+      case -1:
+        lower[r] += value;
+        return true;
+      case 0:
+        diagonal[r] += value;
+        return true;
+      case 1:
+        upper[r] += value;
+        return true;
+      default:
+        return value == 0.;
+    }
+  }
+
+  if (r >= 0) {
+    right[r * k - c - 1] += value;
+  } else if (c >= 0) {
+    bottom[(-r - 1) * m + c] += value;
+  } else {
+    corner[(-r - 1) * k - c - 1] += value;
+  }
+
+  return true;
+}
+
+ArrowheadMatrixContent* SUNArrowheadMatrix_Content(SUNMatrix matrix) {
+  return static_cast<ArrowheadMatrixContent*>(matrix->content);
+}
+
+namespace {
+// --------------------------------------------------------------------------------------------
+// SUNMatrix operations
+
+SUNMatrix_ID arrowhead_getid([[maybe_unused]] SUNMatrix matrix) {
+  return SUNMATRIX_CUSTOM;
+}
+
+SUNMatrix arrowhead_clone(SUNMatrix matrix) {
+  const ArrowheadMatrixContent* content = SUNArrowheadMatrix_Content(matrix);
+  return SUNArrowheadMatrix(content->size, content->border, matrix->sunctx);
+}
+
+void arrowhead_destroy(SUNMatrix matrix) {
+  if (!matrix) return;
+  delete SUNArrowheadMatrix_Content(matrix);
+  matrix->content = nullptr;
+  SUNMatFreeEmpty(matrix);
+}
+
+template <typename Function>
+void for_each_block(ArrowheadMatrixContent* content, Function function) {
+  function(content->lower);
+  function(content->diagonal);
+  function(content->upper);
+  function(content->right);
+  function(content->bottom);
+  function(content->corner);
+}
+
+SUNErrCode arrowhead_zero(SUNMatrix matrix) {
+  for_each_block(SUNArrowheadMatrix_Content(matrix),
+                 [](std::vector<gp_float>& block) {
+                   std::fill(block.begin(), block.end(), 0.);
+                 });
+  return SUN_SUCCESS;
+}
+
+SUNErrCode arrowhead_copy(SUNMatrix from, SUNMatrix to) {
+  *SUNArrowheadMatrix_Content(to) = *SUNArrowheadMatrix_Content(from);
+  return SUN_SUCCESS;
+}
+
+/* A = c * A + B */
+SUNErrCode arrowhead_scale_add(sunrealtype c, SUNMatrix a, SUNMatrix b) {
+  ArrowheadMatrixContent* content_a = SUNArrowheadMatrix_Content(a);
+  ArrowheadMatrixContent* content_b = SUNArrowheadMatrix_Content(b);
+  const auto scale_add = [c](std::vector<gp_float>& x,
+                             const std::vector<gp_float>& y) {
+    for (size_t i = 0; i < x.size(); ++i) x[i] = c * x[i] + y[i];
+  };
+
+  scale_add(content_a->lower, content_b->lower);
+  scale_add(content_a->diagonal, content_b->diagonal);
+  scale_add(content_a->upper, content_b->upper);
+  scale_add(content_a->right, content_b->right);
+  scale_add(content_a->bottom, content_b->bottom);
+  scale_add(content_a->corner, content_b->corner);
+  return SUN_SUCCESS;
+}
+
+/* A = c * A + I */
+SUNErrCode arrowhead_scale_add_identity(sunrealtype c, SUNMatrix matrix) {
+  ArrowheadMatrixContent* content = SUNArrowheadMatrix_Content(matrix);
+  for_each_block(content, [c](std::vector<gp_float>& block) {
+    for (gp_float& value : block) value *= c;
+  });
+
+  for (gp_float& value : content->diagonal) value += 1.;
+  const sunindextype k = content->num_border();
+  for (sunindextype j = 0; j < k; ++j) content->corner[j * k + j] += 1.;
+  return SUN_SUCCESS;
+}
+
+/* y = A * x */
+SUNErrCode arrowhead_matvec(SUNMatrix matrix, N_Vector v_x, N_Vector v_y) {
+  const ArrowheadMatrixContent* content = SUNArrowheadMatrix_Content(matrix);
+  const sunrealtype* x = N_VGetArrayPointer(v_x);
+  sunrealtype* y = N_VGetArrayPointer(v_y);
+  const sunindextype m = content->num_interior();
+  const sunindextype k = content->num_border();
+
+  for (sunindextype i = 0; i < m; ++i) {
+    gp_float value = content->diagonal[i] * x[content->interior[i]];
+    if (i > 0) value += content->lower[i] * x[content->interior[i - 1]];
+    if (i < m - 1) value += content->upper[i] * x[content->interior[i + 1]];
+    for (sunindextype j = 0; j < k; ++j)
+      value += content->right[i * k + j] * x[content->border[j]];
+    y[content->interior[i]] = value;
+  }
+
+  for (sunindextype j = 0; j < k; ++j) {
+    gp_float value = 0.;
+    for (sunindextype i = 0; i < m; ++i)
+      value += content->bottom[j * m + i] * x[content->interior[i]];
+    for (sunindextype l = 0; l < k; ++l)
+      value += content->corner[j * k + l] * x[content->border[l]];
+    y[content->border[j]] = value;
+  }
+
+  return SUN_SUCCESS;
+}
+
+SUNErrCode arrowhead_space(SUNMatrix matrix, long int* lenrw, long int* leniw) {
+  const ArrowheadMatrixContent* content = SUNArrowheadMatrix_Content(matrix);
+  const long int m = content->num_interior();
+  const long int k = content->num_border();
+  *lenrw = 3 * m + 2 * m * k + k * k;
+  *leniw = content->size + m + k;
+  return SUN_SUCCESS;
+}
+
+// --------------------------------------------------------------------------------------------
+// SUNLinearSolver operations
+
+/** @brief The factorization computed by the arrowhead linear solver setup.
+ */
+struct ArrowheadSolverContent {
+  std::vector<gp_float> multipliers;  //!< Thomas algorithm lower factors.
+  std::vector<gp_float> pivots;       //!< Thomas algorithm diagonal pivots.
+  std::vector<gp_float> fill;   //!< A^-1 B, interior-major (i * border + k).
+  std::vector<gp_float> schur;  //!< LU factors of D - C A^-1 B, row-major.
+  std::vector<sunindextype> schur_pivots;
+  std::vector<gp_float> interior_work;
+  std::vector<gp_float> border_work;
+  sunindextype last_flag = 0;
+};
+
+ArrowheadSolverContent* solver_content(SUNLinearSolver solver) {
+  return static_cast<ArrowheadSolverContent*>(solver->content);
+}
+
+/* Solves A x = b in place for the factored interior block, with the entries of
+ * x spaced stride apart. */
+void interior_solve(const ArrowheadMatrixContent* matrix,
+                    const ArrowheadSolverContent* solver, gp_float* x,
+                    sunindextype stride) {
+  const sunindextype m = matrix->num_interior();
+  if (m == 0) return;
+
+  for (sunindextype i = 1; i < m; ++i)
+    x[i * stride] -= solver->multipliers[i] * x[(i - 1) * stride];
+
+  x[(m - 1) * stride] /= solver->pivots[m - 1];
+  for (sunindextype i = m - 2; i >= 0; --i) {
+    x[i * stride] = (x[i * stride] - matrix->upper[i] * x[(i + 1) * stride]) /
+                    solver->pivots[i];
+  }
+}
+
+SUNLinearSolver_Type arrowhead_gettype(
+    [[maybe_unused]] SUNLinearSolver solver) {
+  return SUNLINEARSOLVER_DIRECT;
+}
+
+SUNLinearSolver_ID arrowhead_getid([[maybe_unused]] SUNLinearSolver solver) {
+  return SUNLINEARSOLVER_CUSTOM;
+}
+
+SUNErrCode arrowhead_initialize(SUNLinearSolver solver) {
+  solver_content(solver)->last_flag = 0;
+  return SUN_SUCCESS;
+}
+
+int arrowhead_setup(SUNLinearSolver solver, SUNMatrix matrix) {
+  ArrowheadSolverContent* content = solver_content(solver);
+  const ArrowheadMatrixContent* a = SUNArrowheadMatrix_Content(matrix);
+  const sunindextype m = a->num_interior();
+  const sunindextype k = a->num_border();
+
+  // Thomas factorization of the interior block
+  for (sunindextype i = 0; i < m; ++i) {
+    gp_float pivot = a->diagonal[i];
+    if (i > 0) {
+      content->multipliers[i] = a->lower[i] / content->pivots[i - 1];
+      pivot -= content->multipliers[i] * a->upper[i - 1];
+    }
+
+    if (pivot == 0. || !std::isfinite(pivot)) {
+      content->last_flag = i + 1;
+      return SUNLS_LUFACT_FAIL;
+    }
+    content->pivots[i] = pivot;
+  }
+
+  // Eliminate the border columns from the interior block
+  content->fill = a->right;
+  for (sunindextype j = 0; j < k; ++j)
+    interior_solve(a, content, content->fill.data() + j, k);
+
+  // Schur complement of the interior block
+  for (sunindextype r = 0; r < k; ++r) {
+    for (sunindextype c = 0; c < k; ++c) {
+      gp_float value = a->corner[r * k + c];
+      for (sunindextype i = 0; i < m; ++i)
+        value -= a->bottom[r * m + i] * content->fill[i * k + c];
+      content->schur[r * k + c] = value;
+    }
+  }
+
+  // LU factorization of the Schur complement with partial pivoting
+  std::vector<gp_float>& s = content->schur;
+  for (sunindextype c = 0; c < k; ++c) {
+    sunindextype pivot_row = c;
+    for (sunindextype r = c + 1; r < k; ++r) {
+      if (std::abs(s[r * k + c]) > std::abs(s[pivot_row * k + c]))
+        pivot_row = r;
+    }
+
+    content->schur_pivots[c] = pivot_row;
+    if (s[pivot_row * k + c] == 0.) {
+      content->last_flag = m + c + 1;
+      return SUNLS_LUFACT_FAIL;
+    }
+
+    if (pivot_row != c) {
+      for (sunindextype j = 0; j < k; ++j)
+        std::swap(s[c * k + j], s[pivot_row * k + j]);
+    }
+
+    for (sunindextype r = c + 1; r < k; ++r) {
+      s[r * k + c] /= s[c * k + c];
+      for (sunindextype j = c + 1; j < k; ++j)
+        s[r * k + j] -= s[r * k + c] * s[c * k + j];
+    }
+  }
+
+  content->last_flag = 0;
+  return SUNLS_SUCCESS;
+}
+
+int arrowhead_solve(SUNLinearSolver solver, SUNMatrix matrix, N_Vector v_x,
+                    N_Vector v_b, [[maybe_unused]] sunrealtype tol) {
+  ArrowheadSolverContent* content = solver_content(solver);
+  const ArrowheadMatrixContent* a = SUNArrowheadMatrix_Content(matrix);
+  const sunindextype m = a->num_interior();
+  const sunindextype k = a->num_border();
+  const sunrealtype* b = N_VGetArrayPointer(v_b);
+  sunrealtype* x = N_VGetArrayPointer(v_x);
+
+  std::vector<gp_float>& y = content->interior_work;
+  std::vector<gp_float>& z = content->border_work;
+  for (sunindextype i = 0; i < m; ++i) y[i] = b[a->interior[i]];
+  for (sunindextype j = 0; j < k; ++j) z[j] = b[a->border[j]];
+
+  // y = A^-1 b_interior
+  interior_solve(a, content, y.data(), 1);
+
+  // z = S^-1 (b_border - C y)
+  for (sunindextype j = 0; j < k; ++j) {
+    for (sunindextype i = 0; i < m; ++i) z[j] -= a->bottom[j * m + i] * y[i];
+  }
+
+  const std::vector<gp_float>& s = content->schur;
+  for (sunindextype c = 0; c < k; ++c) {
+    std::swap(z[c], z[content->schur_pivots[c]]);
+    for (sunindextype r = c + 1; r < k; ++r) z[r] -= s[r * k + c] * z[c];
+  }
+  for (sunindextype r = k - 1; r >= 0; --r) {
+    for (sunindextype c = r + 1; c < k; ++c) z[r] -= s[r * k + c] * z[c];
+    z[r] /= s[r * k + r];
+  }
+
+  // x_interior = y - A^-1 B z
+  for (sunindextype i = 0; i < m; ++i) {
+    gp_float value = y[i];
+    for (sunindextype j = 0; j < k; ++j)
+      value -= content->fill[i * k + j] * z[j];
+    x[a->interior[i]] = value;
+  }
+  for (sunindextype j = 0; j < k; ++j) x[a->border[j]] = z[j];
+
+  content->last_flag = 0;
+  return SUNLS_SUCCESS;
+}
+
+sunindextype arrowhead_lastflag(SUNLinearSolver solver) {
+  return solver_content(solver)->last_flag;
+}
+
+SUNErrCode arrowhead_linsol_space(SUNLinearSolver solver, long int* lenrw,
+                                  long int* leniw) {
+  const ArrowheadSolverContent* content = solver_content(solver);
+  *lenrw = content->multipliers.size() + content->pivots.size() +
+           content->fill.size() + content->schur.size() +
+           content->interior_work.size() + content->border_work.size();
+  *leniw = content->schur_pivots.size() + 1;
+  return SUN_SUCCESS;
+}
+
+SUNErrCode arrowhead_free(SUNLinearSolver solver) {
+  if (!solver) return SUN_SUCCESS;
+  delete solver_content(solver);
+  solver->content = nullptr;
+  SUNLinSolFreeEmpty(solver);
+  return SUN_SUCCESS;
+}
+}  // namespace
+
+SUNMatrix SUNArrowheadMatrix(sunindextype size,
+                             const std::vector<sunindextype>& border,
+                             SUNContext sun_context) {
+  SUNMatrix matrix = SUNMatNewEmpty(sun_context);
+  if (!matrix) return nullptr;
+
+  matrix->ops->getid = arrowhead_getid;
+  matrix->ops->clone = arrowhead_clone;
+  matrix->ops->destroy = arrowhead_destroy;
+  matrix->ops->zero = arrowhead_zero;
+  matrix->ops->copy = arrowhead_copy;
+  matrix->ops->scaleadd = arrowhead_scale_add;
+  matrix->ops->scaleaddi = arrowhead_scale_add_identity;
+  matrix->ops->matvec = arrowhead_matvec;
+  matrix->ops->space = arrowhead_space;
+
+  matrix->content = new ArrowheadMatrixContent(size, border);
+  return matrix;
+}
+
+SUNLinearSolver SUNLinSol_Arrowhead(SUNMatrix matrix, SUNContext sun_context) {
+  if (!matrix || SUNMatGetID(matrix) != SUNMATRIX_CUSTOM) return nullptr;
+
+  SUNLinearSolver solver = SUNLinSolNewEmpty(sun_context);
+  if (!solver) return nullptr;
+
+  solver->ops->gettype = arrowhead_gettype;
+  solver->ops->getid = arrowhead_getid;
+  solver->ops->initialize = arrowhead_initialize;
+  solver->ops->setup = arrowhead_setup;
+  solver->ops->solve = arrowhead_solve;
+  solver->ops->lastflag = arrowhead_lastflag;
+  solver->ops->space = arrowhead_linsol_space;
+  solver->ops->free = arrowhead_free;
+
+  const ArrowheadMatrixContent* a = SUNArrowheadMatrix_Content(matrix);
+  const size_t m = a->num_interior();
+  const size_t k = a->num_border();
+
+  ArrowheadSolverContent* content = new ArrowheadSolverContent();
+  content->multipliers = std::vector<gp_float>(m, 0.);
+  content->pivots = std::vector<gp_float>(m, 0.);
+  content->fill = std::vector<gp_float>(m * k, 0.);
+  content->schur = std::vector<gp_float>(k * k, 0.);
+  content->schur_pivots = std::vector<sunindextype>(k, 0);
+  content->interior_work = std::vector<gp_float>(m, 0.);
+  content->border_work = std::vector<gp_float>(k, 0.);
+  solver->content = content;
+
+  return solver;
+}
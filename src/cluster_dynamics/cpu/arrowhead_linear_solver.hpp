@@ -0,0 +1,79 @@
+#ifndef ARROWHEAD_LINEAR_SOLVER_HPP
+#define ARROWHEAD_LINEAR_SOLVER_HPP
+
+#include "utils/diagnostics.hpp"
+
+DIAGNOSTIC_PUSH
+DIAGNOSTIC_DISABLE("-Wunused-parameter")
+#include <sundials/sundials_linearsolver.h>
+#include <sundials/sundials_matrix.h>
+DIAGNOSTIC_POP
+
+#include <vector>
+
+#include "utils/types.hpp"
+
+/** @brief Storage for a bordered tridiagonal ("arrowhead") matrix.
+ *
+ * The rows and columns of the matrix are split into a small set of border
+ * indices and the remaining interior indices. Ordered by their global index,
+ * the interior rows and columns form a tridiagonal block. The border rows and
+ * columns are stored densely.
+ *
+ * \f$
+ *   M = \begin{pmatrix} A & B \\ C & D \end{pmatrix}
+ * \f$
+ *
+ * where A is the interior tridiagonal block, B and C are the border columns
+ * and rows and D is the border corner.
+ */
+struct ArrowheadMatrixContent {
+  ArrowheadMatrixContent(sunindextype size,
+                         const std::vector<sunindextype>& border);
+
+  sunindextype size;  //!< Number of rows and columns of the full matrix.
+  std::vector<sunindextype> border;    //!< Global indices of the border.
+  std::vector<sunindextype> interior;  //!< Global indices of the interior.
+  /// @brief Maps a global index to its interior position, or to -(k + 1) for
+  /// the k-th border index.
+  std::vector<sunindextype> position;
+
+  std::vector<gp_float> lower;     //!< A(i, i - 1), lower[0] is unused.
+  std::vector<gp_float> diagonal;  //!< A(i, i)
+  std::vector<gp_float> upper;     //!< A(i, i + 1), the last entry is unused.
+  std::vector<gp_float> right;     //!< B, interior-major (i * border + k).
+  std::vector<gp_float> bottom;    //!< C, border-major (k * interior + i).
+  std::vector<gp_float> corner;    //!< D, row-major.
+
+  sunindextype num_interior() const { return interior.size(); }
+  sunindextype num_border() const { return border.size(); }
+
+  /** @brief Adds value to the entry at (row, col).
+   *
+   * Returns false if the entry lies outside of the arrowhead structure.
+   */
+  bool add(sunindextype row, sunindextype col, gp_float value);
+};
+
+/** @brief Creates an arrowhead SUNMatrix of the given size with the given
+ * global border indices.
+ */
+SUNMatrix SUNArrowheadMatrix(sunindextype size,
+                             const std::vector<sunindextype>& border,
+                             SUNContext sun_context);
+
+/** @brief Returns the content of an arrowhead SUNMatrix.
+ */
+ArrowheadMatrixContent* SUNArrowheadMatrix_Content(SUNMatrix matrix);
+
+/** @brief Creates a direct SUNLinearSolver for arrowhead matrices.
+ *
+ * The interior block is factored with the Thomas algorithm and the border is
+ * eliminated through its Schur complement, so both setup and solve run in
+ * O(interior * border^2) time and memory. The interior block is factored
+ * without pivoting, which is stable for the diagonally dominant Newton
+ * matrices of the cluster dynamics system.
+ */
+SUNLinearSolver SUNLinSol_Arrowhead(SUNMatrix matrix, SUNContext sun_context);
+
+#endif  // ARROWHEAD_LINEAR_SOLVER_HPP
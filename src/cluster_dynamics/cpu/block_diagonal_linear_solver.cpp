@@ -0,0 +1,284 @@
+#include "block_diagonal_linear_solver.hpp"
+
+DIAGNOSTIC_PUSH
+DIAGNOSTIC_DISABLE("-Wunused-parameter")
+#include <nvector/nvector_serial.h>
+DIAGNOSTIC_POP
+
+
+BlockDiagonalMatrixContent::BlockDiagonalMatrixContent(
+    const std::vector<SUNMatrix>& blocks,
+    const std::vector<sunindextype>& block_sizes, ThreadPool* thread_pool,
+    SUNContext sun_context)
+    : blocks(blocks), offsets(1, 0), thread_pool(thread_pool) {
+  for (sunindextype size : block_sizes) {
+    offsets.push_back(offsets.back() + size);
+    x_views.push_back(N_VMake_Serial(size, nullptr, sun_context));
+    y_views.push_back(N_VMake_Serial(size, nullptr, sun_context));
+  }
+}
+
+BlockDiagonalMatrixContent::~BlockDiagonalMatrixContent() {
+  for (SUNMatrix block : blocks) SUNMatDestroy(block);
+  for (N_Vector v : x_views) N_VDestroy(v);
+  for (N_Vector v : y_views) N_VDestroy(v);
+}
+
+void BlockDiagonalMatrixContent::view(size_t b, N_Vector v_x,
+                                      N_Vector v_y) const {
+  N_VSetArrayPointer(N_VGetArrayPointer(v_x) + offsets[b], x_views[b]);
+  N_VSetArrayPointer(N_VGetArrayPointer(v_y) + offsets[b], y_views[b]);
+}
+
+BlockDiagonalMatrixContent* SUNBlockDiagonalMatrix_Content(SUNMatrix matrix) {
+  return static_cast<BlockDiagonalMatrixContent*>(matrix->content);
+}
+
+namespace {
+// --------------------------------------------------------------------------------------------
+// SUNMatrix operations
+
+SUNMatrix_ID block_diagonal_getid([[maybe_unused]] SUNMatrix matrix) {
+  return SUNMATRIX_CUSTOM;
+}
+
+SUNMatrix block_diagonal_clone(SUNMatrix matrix) {
+  const BlockDiagonalMatrixContent* content =
+      SUNBlockDiagonalMatrix_Content(matrix);
+  std::vector<SUNMatrix> blocks;
+  std::vector<sunindextype> block_sizes;
+  for (size_t b = 0; b < content->num_blocks(); ++b) {
+    blocks.push_back(SUNMatClone(content->blocks[b]));
+    block_sizes.push_back(content->offsets[b + 1] - content->offsets[b]);
+  }
+  return SUNBlockDiagonalMatrix(blocks, block_sizes, content->thread_pool,
+                                matrix->sunctx);
+}
+
+void block_diagonal_destroy(SUNMatrix matrix) {
+  if (!matrix) return;
+  delete SUNBlockDiagonalMatrix_Content(matrix);
+  matrix->content = nullptr;
+  SUNMatFreeEmpty(matrix);
+}
+
+/* Returns the first error of function(b) over the blocks */
+template <typename Function>
+SUNErrCode for_each_block(BlockDiagonalMatrixContent* content,
+                          Function function) {
+  for (size_t b = 0; b < content->num_blocks(); ++b) {
+    const SUNErrCode err = function(b);
+    if (err) return err;
+  }
+  return SUN_SUCCESS;
+}
+
+SUNErrCode block_diagonal_zero(SUNMatrix matrix) {
+  BlockDiagonalMatrixContent* content = SUNBlockDiagonalMatrix_Content(matrix);
+  return for_each_block(
+      content, [&](size_t b) { return SUNMatZero(content->blocks[b]); });
+}
+
+SUNErrCode block_diagonal_copy(SUNMatrix from, SUNMatrix to) {
+  BlockDiagonalMatrixContent* content_from =
+      SUNBlockDiagonalMatrix_Content(from);
+  BlockDiagonalMatrixContent* content_to = SUNBlockDiagonalMatrix_Content(to);
+  return for_each_block(content_from, [&](size_t b) {
+    return SUNMatCopy(content_from->blocks[b], content_to->blocks[b]);
+  });
+}
+
+/* A = c * A + B */
+SUNErrCode block_diagonal_scale_add(sunrealtype c, SUNMatrix a, SUNMatrix b) {
+  BlockDiagonalMatrixContent* content_a = SUNBlockDiagonalMatrix_Content(a);
+  BlockDiagonalMatrixContent* content_b = SUNBlockDiagonalMatrix_Content(b);
+  return for_each_block(content_a, [&](size_t k) {
+    return SUNMatScaleAdd(c, content_a->blocks[k], content_b->blocks[k]);
+  });
+}
+
+/* A = c * A + I */
+SUNErrCode block_diagonal_scale_add_identity(sunrealtype c,
+                                             SUNMatrix matrix) {
+  BlockDiagonalMatrixContent* content = SUNBlockDiagonalMatrix_Content(matrix);
+  return for_each_block(content, [&](size_t b) {
+    return SUNMatScaleAddI(c, content->blocks[b]);
+  });
+}
+
+/* y = A * x */
+SUNErrCode block_diagonal_matvec(SUNMatrix matrix, N_Vector v_x,
+                                 N_Vector v_y) {
+  BlockDiagonalMatrixContent* content = SUNBlockDiagonalMatrix_Content(matrix);
+  return for_each_block(content, [&](size_t b) {
+    content->view(b, v_x, v_y);
+    return SUNMatMatvec(content->blocks[b], content->x_views[b],
+                        content->y_views[b]);
+  });
+}
+
+SUNErrCode block_diagonal_space(SUNMatrix matrix, long int* lenrw,
+                                long int* leniw) {
+  BlockDiagonalMatrixContent* content = SUNBlockDiagonalMatrix_Content(matrix);
+  *lenrw = 0;
+  *leniw = content->offsets.size();
+  return for_each_block(content, [&](size_t b) {
+    long int block_lenrw, block_leniw;
+    const SUNErrCode err =
+        SUNMatSpace(content->blocks[b], &block_lenrw, &block_leniw);
+    *lenrw += block_lenrw;
+    *leniw += block_leniw;
+    return err;
+  });
+}
+
+// --------------------------------------------------------------------------------------------
+// SUNLinearSolver operations
+
+/** @brief The solvers of the blocks.
+ */
+struct BlockDiagonalSolverContent {
+  std::vector<SUNLinearSolver> solvers;  //!< Owned solvers of the blocks.
+  sunindextype last_flag = 0;
+};
+
+BlockDiagonalSolverContent* solver_content(SUNLinearSolver solver) {
+  return static_cast<BlockDiagonalSolverContent*>(solver->content);
+}
+
+/* Runs function(b) for every block, in parallel if the matrix has a thread
+ * pool, and returns the flag of the first block that failed */
+template <typename Function>
+int for_each_block_solver(const BlockDiagonalMatrixContent* matrix,
+                          Function function) {
+  std::vector<int> flags(matrix->num_blocks(), 0);
+  const auto task = [&](size_t b) { flags[b] = function(b); };
+  if (matrix->thread_pool)
+    matrix->thread_pool->parallel_for(matrix->num_blocks(), task);
+  else
+    for (size_t b = 0; b < matrix->num_blocks(); ++b) task(b);
+
+  for (int flag : flags)
+    if (flag) return flag;
+  return SUNLS_SUCCESS;
+}
+
+SUNLinearSolver_Type block_diagonal_gettype(
+    [[maybe_unused]] SUNLinearSolver solver) {
+  return SUNLINEARSOLVER_DIRECT;
+}
+
+SUNLinearSolver_ID block_diagonal_getid(
+    [[maybe_unused]] SUNLinearSolver solver) {
+  return SUNLINEARSOLVER_CUSTOM;
+}
+
+SUNErrCode block_diagonal_initialize(SUNLinearSolver solver) {
+  BlockDiagonalSolverContent* content = solver_content(solver);
+  content->last_flag = 0;
+  for (SUNLinearSolver block_solver : content->solvers) {
+    const SUNErrCode err = SUNLinSolInitialize(block_solver);
+    if (err) return err;
+  }
+  return SUN_SUCCESS;
+}
+
+int block_diagonal_setup(SUNLinearSolver solver, SUNMatrix matrix) {
+  BlockDiagonalSolverContent* content = solver_content(solver);
+  const BlockDiagonalMatrixContent* a = SUNBlockDiagonalMatrix_Content(matrix);
+  content->last_flag = for_each_block_solver(a, [&](size_t b) {
+    return SUNLinSolSetup(content->solvers[b], a->blocks[b]);
+  });
+  return content->last_flag;
+}
+
+int block_diagonal_solve(SUNLinearSolver solver, SUNMatrix matrix,
+                         N_Vector v_x, N_Vector v_b, sunrealtype tol) {
+  BlockDiagonalSolverContent* content = solver_content(solver);
+  const BlockDiagonalMatrixContent* a = SUNBlockDiagonalMatrix_Content(matrix);
+  content->last_flag = for_each_block_solver(a, [&](size_t b) {
+    a->view(b, v_x, v_b);
+    return SUNLinSolSolve(content->solvers[b], a->blocks[b], a->x_views[b],
+                          a->y_views[b], tol);
+  });
+  return content->last_flag;
+}
+
+sunindextype block_diagonal_lastflag(SUNLinearSolver solver) {
+  return solver_content(solver)->last_flag;
+}
+
+SUNErrCode block_diagonal_linsol_space(SUNLinearSolver solver,
+                                       long int* lenrw, long int* leniw) {
+  *lenrw = 0;
+  *leniw = 1;
+  for (SUNLinearSolver block_solver : solver_content(solver)->solvers) {
+    long int block_lenrw, block_leniw;
+    const SUNErrCode err =
+        SUNLinSolSpace(block_solver, &block_lenrw, &block_leniw);
+    if (err) return err;
+    *lenrw += block_lenrw;
+    *leniw += block_leniw;
+  }
+  return SUN_SUCCESS;
+}
+
+SUNErrCode block_diagonal_free(SUNLinearSolver solver) {
+  if (!solver) return SUN_SUCCESS;
+  for (SUNLinearSolver block_solver : solver_content(solver)->solvers)
+    SUNLinSolFree(block_solver);
+  delete solver_content(solver);
+  solver->content = nullptr;
+  SUNLinSolFreeEmpty(solver);
+  return SUN_SUCCESS;
+}
+}  // namespace
+
+SUNMatrix SUNBlockDiagonalMatrix(const std::vector<SUNMatrix>& blocks,
+                                 const std::vector<sunindextype>& block_sizes,
+                                 ThreadPool* thread_pool,
+                                 SUNContext sun_context) {
+  SUNMatrix matrix = SUNMatNewEmpty(sun_context);
+  if (!matrix) return nullptr;
+
+  matrix->ops->getid = block_diagonal_getid;
+  matrix->ops->clone = block_diagonal_clone;
+  matrix->ops->destroy = block_diagonal_destroy;
+  matrix->ops->zero = block_diagonal_zero;
+  matrix->ops->copy = block_diagonal_copy;
+  matrix->ops->scaleadd = block_diagonal_scale_add;
+  matrix->ops->scaleaddi = block_diagonal_scale_add_identity;
+  matrix->ops->matvec = block_diagonal_matvec;
+  matrix->ops->space = block_diagonal_space;
+
+  matrix->content = new BlockDiagonalMatrixContent(blocks, block_sizes,
+                                                   thread_pool, sun_context);
+  return matrix;
+}
+
+SUNLinearSolver SUNLinSol_BlockDiagonal(
+    SUNMatrix matrix, const std::vector<SUNLinearSolver>& block_solvers,
+    SUNContext sun_context) {
+  if (!matrix || SUNMatGetID(matrix) != SUNMATRIX_CUSTOM ||
+      SUNBlockDiagonalMatrix_Content(matrix)->num_blocks() !=
+          block_solvers.size())
+    return nullptr;
+
+  SUNLinearSolver solver = SUNLinSolNewEmpty(sun_context);
+  if (!solver) return nullptr;
+
+  solver->ops->gettype = block_diagonal_gettype;
+  solver->ops->getid = block_diagonal_getid;
+  solver->ops->initialize = block_diagonal_initialize;
+  solver->ops->setup = block_diagonal_setup;
+  solver->ops->solve = block_diagonal_solve;
+  solver->ops->lastflag = block_diagonal_lastflag;
+  solver->ops->space = block_diagonal_linsol_space;
+  solver->ops->free = block_diagonal_free;
+
+  BlockDiagonalSolverContent* content = new BlockDiagonalSolverContent();
+  content->solvers = block_solvers;
+  solver->content = content;
+
+  return solver;
+}
@@ -0,0 +1,74 @@
+#ifndef BLOCK_DIAGONAL_LINEAR_SOLVER_HPP
+#define BLOCK_DIAGONAL_LINEAR_SOLVER_HPP
+
+#include "utils/diagnostics.hpp"
+
+DIAGNOSTIC_PUSH
+DIAGNOSTIC_DISABLE("-Wunused-parameter")
+#include <sundials/sundials_linearsolver.h>
+#include <sundials/sundials_matrix.h>
+#include <sundials/sundials_nvector.h>
+DIAGNOSTIC_POP
+
+#include <vector>
+
+#include "utils/thread_pool.hpp"
+#include "utils/types.hpp"
+
+/** @brief Storage for a block diagonal matrix whose diagonal blocks are
+ * SUNMatrix objects of their own, such as arrowhead matrices.
+ *
+ * \f$
+ *   M = \begin{pmatrix} A_0 & & \\ & \ddots & \\ & & A_{k-1} \end{pmatrix}
+ * \f$
+ *
+ * Each operation is applied to the blocks one by one, on serial vectors
+ * which view the rows of the block.
+ */
+struct BlockDiagonalMatrixContent {
+  std::vector<SUNMatrix> blocks;  //!< Owned diagonal blocks.
+  /// @brief Global index of the first row of each block, followed by the
+  /// size of the matrix.
+  std::vector<sunindextype> offsets;
+  std::vector<N_Vector> x_views;  //!< Views of the rows of each block.
+  std::vector<N_Vector> y_views;  //!< Views of the rows of each block.
+  /// @brief Runs the blocks of the linear solver in parallel, may be null.
+  ThreadPool* thread_pool = nullptr;
+
+  BlockDiagonalMatrixContent(const std::vector<SUNMatrix>& blocks,
+                             const std::vector<sunindextype>& block_sizes,
+                             ThreadPool* thread_pool, SUNContext sun_context);
+  ~BlockDiagonalMatrixContent();
+
+  size_t num_blocks() const { return blocks.size(); }
+
+  /** @brief Points the views of block b at the rows of x and y.
+   */
+  void view(size_t b, N_Vector v_x, N_Vector v_y) const;
+};
+
+/** @brief Creates a block diagonal SUNMatrix which takes ownership of the
+ * given square blocks.
+ *  @param thread_pool Factors and solves the blocks in parallel when not
+ * null, it must outlive the matrix and its solver.
+ */
+SUNMatrix SUNBlockDiagonalMatrix(const std::vector<SUNMatrix>& blocks,
+                                 const std::vector<sunindextype>& block_sizes,
+                                 ThreadPool* thread_pool,
+                                 SUNContext sun_context);
+
+/** @brief Returns the content of a block diagonal SUNMatrix.
+ */
+BlockDiagonalMatrixContent* SUNBlockDiagonalMatrix_Content(SUNMatrix matrix);
+
+/** @brief Creates a direct SUNLinearSolver for block diagonal matrices which
+ * takes ownership of one direct solver per block.
+ *
+ * Setup and solve run the solvers of the blocks independently, so their
+ * cost is the sum of that of the blocks.
+ */
+SUNLinearSolver SUNLinSol_BlockDiagonal(
+    SUNMatrix matrix, const std::vector<SUNLinearSolver>& block_solvers,
+    SUNContext sun_context);
+
+#endif  // BLOCK_DIAGONAL_LINEAR_SOLVER_HPP
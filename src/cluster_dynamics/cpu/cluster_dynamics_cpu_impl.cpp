@@ -2,7 +2,14 @@
 
 #include <stdio.h>
 
+#include <algorithm>
+#include <cstdint>
 #include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <type_traits>
 
 #include "cluster_dynamics/cluster_dynamics.hpp"
 #include "cluster_dynamics/cluster_dynamics_config.hpp"
@@ -95,9 +102,9 @@ gp_float ClusterDynamicsCpuImpl::i1_concentration_derivative() const {
       // // (4)
       - interstitials[1] * i_grain_boundary_annihilation_rate()
       // // (5)
-      - interstitials[1] * i_absorption_rate()
+      - interstitials[1] * i_absorption_rate_val
       // // (6)
-      + i_emission_rate();
+      + i_emission_rate_val;
 }
 
 /** @brief Returns the rate of change in the concentration of size 1 vacancy
@@ -128,9 +135,9 @@ gp_float ClusterDynamicsCpuImpl::v1_concentration_derivative() const {
       // (4)
       - vacancies[1] * v_grain_boundary_annihilation_rate()
       // (5)
-      - vacancies[1] * v_absorption_rate()
+      - vacancies[1] * v_absorption_rate_val
       // (6)
-      + v_emission_rate();
+      + v_emission_rate_val;
 }
 
 // --------------------------------------------------------------------------------------------
@@ -158,17 +165,9 @@ gp_float ClusterDynamicsCpuImpl::v1_concentration_derivative() const {
  * instead.
  */
 gp_float ClusterDynamicsCpuImpl::dislocation_density_derivative() const {
-  gp_float gain = 0.0;
-  for (size_t n = 1; n < max_cluster_size; ++n) {
-    gain += cluster_radius(n) * ii_absorption(n) * interstitials[n] *
-            i_dislocation_loop_unfault_probability(n);
-  }
-
-  gain *= 2. * M_PI / material.atomic_volume;
-
   return
       // (1)
-      gain
+      dislocation_gain_val
       // (2)
       - reactor.dislocation_density_evolution *
             std::pow(material.burgers_vector, 2.) *
@@ -273,11 +272,11 @@ gp_float ClusterDynamicsCpuImpl::v_defect_production(size_t n) const {
 gp_float ClusterDynamicsCpuImpl::i_demotion_rate(size_t n) const {
   return
       // (1)
-      iv_absorption(n) *
+      iv_absorption_val[n] *
           // (2)
           vacancies[1] +
       // (3)
-      ii_emission(n);
+      ii_emission_val[n];
 }
 
 /** @brief Returns the combined rate of emission of an interstitial and
@@ -297,11 +296,11 @@ gp_float ClusterDynamicsCpuImpl::i_demotion_rate(size_t n) const {
 gp_float ClusterDynamicsCpuImpl::v_demotion_rate(size_t n) const {
   return
       // (1)
-      vi_absorption(n) *
+      vi_absorption_val[n] *
           // (2)
           interstitials[1] +
       // (3)
-      vv_emission(n);
+      vv_emission_val[n];
 }
 
 /** @brief Returns the rate that an interstitial cluster of size n can evolve
@@ -324,11 +323,11 @@ gp_float ClusterDynamicsCpuImpl::i_combined_promotion_demotion_rate(
     size_t n) const {
   return
       // (1)
-      iv_absorption(n) * vacancies[1]
+      iv_absorption_val[n] * vacancies[1]
       // (2)
-      + ii_absorption(n) * interstitials[1]
+      + ii_absorption_val[n] * interstitials[1]
       // (3)
-      + ii_emission(n);
+      + ii_emission_val[n];
 }
 
 /** @brief Returns the rate that a vacancy cluster of size n can evolve toward a
@@ -351,11 +350,11 @@ gp_float ClusterDynamicsCpuImpl::v_combined_promotion_demotion_rate(
     size_t n) const {
   return
       // (1)
-      vi_absorption(n) * interstitials[1]
+      vi_absorption_val[n] * interstitials[1]
       // (2)
-      + vv_absorption(n) * vacancies[1]
+      + vv_absorption_val[n] * vacancies[1]
       // (3)
-      + vv_emission(n);
+      + vv_emission_val[n];
 }
 
 /** @brief Returns the rate that an interstitial cluster of size n - 1 can
@@ -388,11 +387,11 @@ gp_float ClusterDynamicsCpuImpl::v_combined_promotion_demotion_rate(
 gp_float ClusterDynamicsCpuImpl::i_promotion_rate(size_t n) const {
   return
       // (1)
-      ii_absorption(n)
+      ii_absorption_val[n]
       // (2)
       * interstitials[1]
       // (3)
-      * (1 - i_dislocation_loop_unfault_probability(n + 1));
+      * i_promotion_factor_val[n];
 }
 
 /** @brief Returns the rate that a vacancy cluster of size n - 1 can evolve into
@@ -412,7 +411,7 @@ gp_float ClusterDynamicsCpuImpl::i_promotion_rate(size_t n) const {
 gp_float ClusterDynamicsCpuImpl::v_promotion_rate(size_t n) const {
   return
       // (1)
-      vv_absorption(n) *
+      vv_absorption_val[n] *
       // (2)
       vacancies[1];
 }
@@ -447,14 +446,14 @@ gp_float ClusterDynamicsCpuImpl::i_emission_rate() const {
   for (size_t in = 3; in < max_cluster_size - 1; ++in) {
     rate +=
         // (1)
-        ii_emission(in) * interstitials[in];
+        ii_emission_val[in] * interstitials[in];
   }
 
   rate +=
       // (2)
-      2. * ii_emission(2) * interstitials[2]
+      2. * ii_emission_val[2] * interstitials[2]
       // (3)
-      + iv_absorption(2) * vacancies[1] * interstitials[2];
+      + iv_absorption_val[2] * vacancies[1] * interstitials[2];
 
   return rate;
 }
@@ -489,14 +488,14 @@ gp_float ClusterDynamicsCpuImpl::v_emission_rate() const {
   for (size_t vn = 3; vn < max_cluster_size - 1; ++vn) {
     rate +=
         // (1)
-        vv_emission(vn) * vacancies[vn];
+        vv_emission_val[vn] * vacancies[vn];
   }
 
   rate +=
       // (2)
-      2. * vv_emission(2) * vacancies[2]
+      2. * vv_emission_val[2] * vacancies[2]
       // (3)
-      + vi_absorption(2) * interstitials[1] * vacancies[2];
+      + vi_absorption_val[2] * interstitials[1] * vacancies[2];
 
   return rate;
 }
@@ -517,13 +516,13 @@ gp_float ClusterDynamicsCpuImpl::v_emission_rate() const {
  */
 gp_float ClusterDynamicsCpuImpl::i_absorption_rate() const {
   gp_float rate = 0.0;
-  rate += ii_absorption(1) * interstitials[1];
+  rate += ii_absorption_val[1] * interstitials[1];
   for (size_t in = 2; in < max_cluster_size - 1; ++in) {
     rate +=
         // (1)
-        ii_absorption(in) * interstitials[in]
+        ii_absorption_val[in] * interstitials[in]
         // (2)
-        + vi_absorption(in) * vacancies[in];
+        + vi_absorption_val[in] * vacancies[in];
   }
 
   return rate;
@@ -543,13 +542,13 @@ gp_float ClusterDynamicsCpuImpl::i_absorption_rate() const {
  *  \f$
  */
 gp_float ClusterDynamicsCpuImpl::v_absorption_rate() const {
-  gp_float rate = vv_absorption(1) * vacancies[1];
+  gp_float rate = vv_absorption_val[1] * vacancies[1];
   for (size_t vn = 2; vn < max_cluster_size - 1; ++vn) {
     rate +=
         // (1)
-        vv_absorption(vn) * vacancies[vn]
+        vv_absorption_val[vn] * vacancies[vn]
         // (2)
-        + iv_absorption(vn) * interstitials[vn];
+        + iv_absorption_val[vn] * interstitials[vn];
   }
 
   return rate;
@@ -843,6 +842,30 @@ gp_float ClusterDynamicsCpuImpl::vi_absorption(size_t n) const {
   return 2. * M_PI * cluster_radius(n) * i_bias_factor(n) * i_diffusion_val;
 }
 
+/** @brief Returns the part of the absorption rates of an interstitial by a
+ * cluster of size (n) which does not depend on the temperature, see
+ * ii_absorption() and vi_absorption().
+ *
+ * \f$
+ *     2 \pi r_i(n) Z_{ic}
+ * \f$
+ */
+gp_float ClusterDynamicsCpuImpl::i_capture(size_t n) const {
+  return 2. * M_PI * cluster_radius(n) * i_bias_factor(n);
+}
+
+/** @brief Returns the part of the absorption rates of a vacancy by a cluster
+ * of size (n) which does not depend on the temperature, see iv_absorption()
+ * and vv_absorption().
+ *
+ * \f$
+ *     2 \pi r_v(n) Z_{vc}
+ * \f$
+ */
+gp_float ClusterDynamicsCpuImpl::v_capture(size_t n) const {
+  return 2. * M_PI * cluster_radius(n) * v_bias_factor(n);
+}
+
 /** @brief Returns the bias factor for an interstitial cluster of size (n).
  *  \todo Document units
  *
@@ -1008,7 +1031,7 @@ gp_float ClusterDynamicsCpuImpl::v_diffusion() const {
 gp_float ClusterDynamicsCpuImpl::mean_dislocation_cell_radius() const {
   gp_float r_0_factor = 0.;
   for (size_t i = 1; i < max_cluster_size; ++i) {
-    r_0_factor += cluster_radius(i) * interstitials[i];
+    r_0_factor += cluster_radius_val[i] * interstitials[i];
   }
 
   // (1)                                           (2)          (3)
@@ -1061,7 +1084,7 @@ gp_float ClusterDynamicsCpuImpl::cluster_radius(size_t n) const {
 gp_float ClusterDynamicsCpuImpl::ii_sum_absorption(size_t nmax) const {
   gp_float emission = 0.;
   for (size_t n = 1; n < nmax; ++n) {
-    emission += ii_absorption(n) * interstitials[n];
+    emission += ii_absorption_val[n] * interstitials[n];
   }
 
   return emission;
@@ -1070,7 +1093,7 @@ gp_float ClusterDynamicsCpuImpl::ii_sum_absorption(size_t nmax) const {
 gp_float ClusterDynamicsCpuImpl::iv_sum_absorption(size_t nmax) const {
   gp_float emission = 0.;
   for (size_t n = 1; n < nmax; ++n) {
-    emission += iv_absorption(n) * interstitials[n];
+    emission += iv_absorption_val[n] * interstitials[n];
   }
 
   return emission;
@@ -1079,7 +1102,7 @@ gp_float ClusterDynamicsCpuImpl::iv_sum_absorption(size_t nmax) const {
 gp_float ClusterDynamicsCpuImpl::vv_sum_absorption(size_t nmax) const {
   gp_float emission = 0.;
   for (size_t n = 1; n < nmax; ++n) {
-    emission += vv_absorption(n) * vacancies[n];
+    emission += vv_absorption_val[n] * vacancies[n];
   }
 
   return emission;
@@ -1088,7 +1111,7 @@ gp_float ClusterDynamicsCpuImpl::vv_sum_absorption(size_t nmax) const {
 gp_float ClusterDynamicsCpuImpl::vi_sum_absorption(size_t nmax) const {
   gp_float emission = 0.;
   for (size_t n = 1; n < nmax; ++n) {
-    emission += vi_absorption(n) * vacancies[n];
+    emission += vi_absorption_val[n] * vacancies[n];
   }
 
   return emission;
@@ -1102,23 +1125,474 @@ gp_float ClusterDynamicsCpuImpl::vi_sum_absorption(size_t nmax) const {
 // --------------------------------------------------------------------------------------------
 // --------------------------------------------------------------------------------------------
 
-void ClusterDynamicsCpuImpl::step_init() {
+namespace {
+// Narrow cells are summed exactly, wide ones with Simpson's rule
+constexpr size_t max_exact_cell_width = 64;
+
+template <typename F>
+gp_float cell_sum(const ContinuumCell& cell, F&& f) {
+  if (cell.last - cell.first < max_exact_cell_width) {
+    gp_float sum = 0.;
+    for (size_t n = cell.first; n <= cell.last; ++n) sum += f(n);
+    return sum;
+  }
+  const size_t mid = cell.first + (cell.last - cell.first) / 2;
+  return cell.width() * (f(cell.first) + 4. * f(mid) + f(cell.last)) / 6.;
+}
+
+/** @brief Returns the positive weight at fraction s of the way from a to b,
+ * interpolated geometrically like GroupSums::interpolate().
+ */
+gp_float interpolate_weight(gp_float a, gp_float b, gp_float s) {
+  if (s == 0.) return a;
+  if (s == 1.) return b;
+  if (!(a > 0.) || !(b > 0.)) return a + s * (b - a);
+  return a * std::pow(b / a, s);
+}
+}  // namespace
+
+/** @brief Precomputes every value which only depends on the material, the
+ * reactor and the cluster size. Must be called whenever either changes.
+ */
+void ClusterDynamicsCpuImpl::coefficient_init() {
+  size_coefficient_init();
+  reactor_coefficient_init();
+}
+
+/** @brief Precomputes the values which only depend on the material and the
+ * cluster size: the radii, capture efficiencies and binding energies of the
+ * tracked sizes, their sums over the groups and cells and the widest spread
+ * of the binding energies within one of them.
+ */
+void ClusterDynamicsCpuImpl::size_coefficient_init() {
+  const size_t table_size = max_cluster_size + 2;
+  cluster_radius_val.assign(table_size, 0.);
+  i_capture_val.assign(table_size, 0.);
+  v_capture_val.assign(table_size, 0.);
+  i_binding_energy_val.assign(table_size, 0.);
+  v_binding_energy_val.assign(table_size, 0.);
+
+  // Size 0 is padding, the bias factors are not defined for it
+  for (size_t n = 1; n < table_size; ++n) {
+    cluster_radius_val[n] = cluster_radius(n);
+    i_capture_val[n] = i_capture(n);
+    v_capture_val[n] = v_capture(n);
+    i_binding_energy_val[n] = i_binding_energy(n);
+    v_binding_energy_val[n] = v_binding_energy(n);
+  }
+
+  // The binding energies are monotone past size 2, so their spread over a
+  // range is that between its ends
+  emission_energy_spread = 0.;
+  auto add_spread = [&](size_t first, size_t last) {
+    emission_energy_spread = std::max(
+        {emission_energy_spread,
+         std::abs(i_binding_energy(first) - i_binding_energy(last)),
+         std::abs(v_binding_energy(first) - v_binding_energy(last))});
+  };
+
+  for (ClusterGroup& group : groups) {
+    add_spread(group.first, group.last);
+    group.cluster_radius = group.i_capture = group.v_capture =
+        group.radius_i_capture = GroupSums();
+
+    for (size_t n = group.first; n <= group.last; ++n) {
+      const gp_float offset = (gp_float)n - group.mean;
+      const gp_float radius = cluster_radius(n);
+      const gp_float i_capture_n = i_capture(n);
+      group.cluster_radius.add(radius, offset);
+      group.i_capture.add(i_capture_n, offset);
+      group.v_capture.add(v_capture(n), offset);
+      group.radius_i_capture.add(radius * i_capture_n, offset);
+    }
+  }
+
+  for (ContinuumCell& cell : continuum_cells) {
+    add_spread(cell.first, cell.last);
+    cell.cluster_radius =
+        cell_sum(cell, [&](size_t n) { return cluster_radius(n); });
+    cell.i_capture = cell_sum(cell, [&](size_t n) { return i_capture(n); });
+    cell.v_capture = cell_sum(cell, [&](size_t n) { return v_capture(n); });
+    cell.radius_i_capture = cell_sum(
+        cell, [&](size_t n) { return cluster_radius(n) * i_capture(n); });
+  }
+}
+
+/** @brief Precomputes the values which depend on the flux and temperature of
+ * the reactor. Must be called whenever the reactor changes.
+ */
+void ClusterDynamicsCpuImpl::reactor_coefficient_init() {
+  emission_weight_bracket_init();
+  temperature_coefficient_init();
+  production_coefficient_init();
+}
+
+/** @brief Sums the group and cell emission weights at the temperature of the
+ * reactor and, during a temperature ramp of the reactor history, at a second
+ * temperature towards the end of the ramp, so system() can follow it through
+ * temperature_coefficient_init() without summing over the sizes of the groups
+ * and cells at every step.
+ *
+ * The second temperature is close enough in 1 / kT to keep the interpolation
+ * error bound of temperature_coefficient_init() under a hundredth of the
+ * relative tolerance.
+ */
+void ClusterDynamicsCpuImpl::emission_weight_bracket_init() {
+  emission_weight_init(0, reactor.temperature);
+  emission_temperatures[1] = reactor.temperature;
+  if (!reactor_ramping) return;
+
+  const gp_float end_temperature =
+      reactor_history.at(reactor_history.next_breakpoint(reactor_time))
+          .temperature;
+  if (end_temperature == reactor.temperature) return;
+
+  const gp_float tolerance = 1e-2 * relative_tolerance;
+  const gp_float max_step = std::sqrt(32. * tolerance) / emission_energy_spread;
+  const gp_float x = 1. / (BOLTZMANN_EV_KELVIN * reactor.temperature);
+  const gp_float end_x = 1. / (BOLTZMANN_EV_KELVIN * end_temperature);
+  const gp_float bracket_x = x + std::clamp(end_x - x, -max_step, max_step);
+  emission_weight_init(1, bracket_x == end_x
+                              ? end_temperature
+                              : 1. / (BOLTZMANN_EV_KELVIN * bracket_x));
+}
+
+/** @brief Sums the capture efficiencies of the sizes of every group and cell
+ * weighted by their Boltzmann factors at the given temperature, into slot
+ * (0 or 1) of their emission weights.
+ */
+void ClusterDynamicsCpuImpl::emission_weight_init(size_t slot,
+                                                  gp_float temperature) {
+  emission_temperatures[slot] = temperature;
+  const gp_float kT = BOLTZMANN_EV_KELVIN * temperature;
+  auto i_weight = [&](size_t n) {
+    return i_capture(n) * std::exp(-i_binding_energy(n) / kT);
+  };
+  auto v_weight = [&](size_t n) {
+    return v_capture(n) * std::exp(-v_binding_energy(n) / kT);
+  };
+
+  for (ClusterGroup& group : groups) {
+    GroupSums& i_sums = group.i_emission_weight[slot] = GroupSums();
+    GroupSums& v_sums = group.v_emission_weight[slot] = GroupSums();
+    for (size_t n = group.first; n <= group.last; ++n) {
+      const gp_float offset = (gp_float)n - group.mean;
+      i_sums.add(i_weight(n), offset);
+      v_sums.add(v_weight(n), offset);
+    }
+  }
+
+  for (ContinuumCell& cell : continuum_cells) {
+    cell.i_emission_weight[slot] = cell_sum(cell, i_weight);
+    cell.v_emission_weight[slot] = cell_sum(cell, v_weight);
+  }
+}
+
+/** @brief Precomputes the values which depend on the temperature: the
+ * diffusion coefficients and the absorption, emission and unfaulting rates of
+ * the tracked sizes, the groups and the cells.
+ *
+ * The rates are the size only values scaled by the diffusion coefficients,
+ * apart from the emission rates of the individually tracked sizes, which take
+ * one exponential each. The unfault probability does not depend on the
+ * size.
+ *
+ * The emission sums of the groups and cells are interpolated in x = 1 / kT
+ * between their emission weights, which is exact at the
+ * emission_temperatures. The logarithm of a sum of Boltzmann factors is convex
+ * in x with a second derivative, the variance of the binding energy, of at
+ * most emission_energy_spread^2 / 4, so the relative error of the geometric
+ * interpolation of s0 is at most (x1 - x0)^2 emission_energy_spread^2 / 32,
+ * and that of the moments about the same on their scale.
+ * emission_weight_bracket_init() keeps the brackets narrow enough, and they
+ * are summed again when the temperature leaves one.
+ */
+void ClusterDynamicsCpuImpl::temperature_coefficient_init() {
   i_diffusion_val = i_diffusion();
   v_diffusion_val = v_diffusion();
-  ii_sum_absorption_val = ii_sum_absorption(max_cluster_size - 1);
-  iv_sum_absorption_val = iv_sum_absorption(max_cluster_size - 1);
-  vi_sum_absorption_val = vi_sum_absorption(max_cluster_size - 1);
-  vv_sum_absorption_val = vv_sum_absorption(max_cluster_size - 1);
-  mean_dislocation_radius_val = mean_dislocation_cell_radius();
+  const gp_float kT = BOLTZMANN_EV_KELVIN * reactor.temperature;
+  const gp_float unfault = i_dislocation_loop_unfault_probability(1);
+
+  const size_t table_size = max_cluster_size + 2;
+  ii_emission_val.assign(table_size, 0.);
+  vv_emission_val.assign(table_size, 0.);
+  ii_absorption_val.assign(table_size, 0.);
+  iv_absorption_val.assign(table_size, 0.);
+  vi_absorption_val.assign(table_size, 0.);
+  vv_absorption_val.assign(table_size, 0.);
+  i_dislocation_loop_unfault_probability_val.assign(table_size, 0.);
+  i_promotion_factor_val.assign(table_size, 0.);
+
+  for (size_t n = 1; n < table_size; ++n) {
+    ii_absorption_val[n] = vi_absorption_val[n] =
+        i_capture_val[n] * i_diffusion_val;
+    iv_absorption_val[n] = vv_absorption_val[n] =
+        v_capture_val[n] * v_diffusion_val;
+    ii_emission_val[n] = ii_absorption_val[n] / material.atomic_volume *
+                         std::exp(-i_binding_energy_val[n] / kT);
+    vv_emission_val[n] =
+        vv_absorption_val[n] * std::exp(-v_binding_energy_val[n] / kT);
+    i_dislocation_loop_unfault_probability_val[n] = unfault;
+    i_promotion_factor_val[n] = 1 - unfault;
+  }
+
+  if (!has_coarse_tail()) return;
+
+  gp_float s = 0.;
+  if (emission_temperatures[1] != emission_temperatures[0])
+    s = (1. / reactor.temperature - 1. / emission_temperatures[0]) /
+        (1. / emission_temperatures[1] - 1. / emission_temperatures[0]);
+  if (s < 0. || s > 1.) {
+    emission_weight_bracket_init();
+    s = 0.;
+  }
+  const gp_float i_emission_factor = i_diffusion_val / material.atomic_volume;
+
+  // The coefficients at the ends, for the fluxes across them, are factored
+  // like the sums so a group of one size cancels exactly
+  auto set_ends = [&](auto& range) {
+    range.i_promotion_last =
+        i_capture(range.last) * (i_diffusion_val * (1 - unfault));
+    range.vv_absorption_last = v_capture(range.last) * v_diffusion_val;
+    range.iv_absorption_first = v_capture(range.first) * v_diffusion_val;
+    range.vi_absorption_first = i_capture(range.first) * i_diffusion_val;
+    range.ii_emission_first = i_capture(range.first) *
+                              std::exp(-i_binding_energy(range.first) / kT) *
+                              i_emission_factor;
+    range.vv_emission_first = v_capture(range.first) *
+                              std::exp(-v_binding_energy(range.first) / kT) *
+                              v_diffusion_val;
+  };
+
+  for (ClusterGroup& group : groups) {
+    group.ii_absorption = group.vi_absorption =
+        group.i_capture.scaled(i_diffusion_val);
+    group.iv_absorption = group.vv_absorption =
+        group.v_capture.scaled(v_diffusion_val);
+    group.ii_emission =
+        GroupSums::interpolate(group.i_emission_weight[0],
+                               group.i_emission_weight[1], s)
+            .scaled(i_emission_factor);
+    group.vv_emission =
+        GroupSums::interpolate(group.v_emission_weight[0],
+                               group.v_emission_weight[1], s)
+            .scaled(v_diffusion_val);
+    group.dislocation_gain =
+        group.radius_i_capture.scaled(i_diffusion_val * unfault);
+    group.i_promotion = group.i_capture.scaled(i_diffusion_val * (1 - unfault));
+    set_ends(group);
+  }
+
+  for (ContinuumCell& cell : continuum_cells) {
+    cell.ii_absorption = cell.vi_absorption = cell.i_capture * i_diffusion_val;
+    cell.iv_absorption = cell.vv_absorption = cell.v_capture * v_diffusion_val;
+    cell.ii_emission = interpolate_weight(cell.i_emission_weight[0],
+                                          cell.i_emission_weight[1], s) *
+                       i_emission_factor;
+    cell.vv_emission = interpolate_weight(cell.v_emission_weight[0],
+                                          cell.v_emission_weight[1], s) *
+                       v_diffusion_val;
+    cell.dislocation_gain = cell.radius_i_capture * i_diffusion_val * unfault;
+    cell.i_unfault_absorption = cell.i_capture * i_diffusion_val * unfault;
+    set_ends(cell);
+  }
+}
+
+/** @brief Precomputes the defect production rates, the only values which
+ * depend on the flux. Only sizes 1 to 4 are produced by the cascades.
+ */
+void ClusterDynamicsCpuImpl::production_coefficient_init() {
+  const size_t table_size = max_cluster_size + 2;
+  i_defect_production_val.assign(table_size, 0.);
+  v_defect_production_val.assign(table_size, 0.);
+  for (size_t n = 1; n < std::min<size_t>(table_size, 5); ++n) {
+    i_defect_production_val[n] =
+        i_defect_production(n) / material.atomic_volume;
+    v_defect_production_val[n] =
+        v_defect_production(n) / material.atomic_volume;
+  }
+}
+
+/** @brief Returns the arguments of the transport kernels for the current
+ * state and tables.
+ */
+TransportKernelArgs ClusterDynamicsCpuImpl::transport_kernel_args() const {
+  return {max_cluster_size,
+          interstitials,
+          vacancies,
+          cluster_radius_val.data(),
+          ii_emission_val.data(),
+          vv_emission_val.data(),
+          ii_absorption_val.data(),
+          iv_absorption_val.data(),
+          vi_absorption_val.data(),
+          vv_absorption_val.data(),
+          i_dislocation_loop_unfault_probability_val.data(),
+          i_defect_production_val.data(),
+          v_defect_production_val.data(),
+          i_promotion_factor_val.data()};
+}
+
+/** @brief Adds the reductions of the cluster sizes in [begin, end) to sums.
+ *
+ * The range is split into blocks of parallel_block_size whose partial sums
+ * are added in block order, with or without threads, so the sums do not
+ * depend on the number of threads. The first block continues sums, which
+ * keeps a single block identical to one pass of the kernel.
+ */
+void ClusterDynamicsCpuImpl::transport_reduce(size_t begin, size_t end,
+                                              TransportSums& sums) const {
+  const TransportKernelArgs args = transport_kernel_args();
+  const size_t num_blocks =
+      (end - begin + parallel_block_size - 1) / parallel_block_size;
+  block_sums.assign(num_blocks, TransportSums());
+  if (num_blocks == 0) return;
+  block_sums[0] = sums;
+  auto reduce_block = [&](size_t block) {
+    const size_t block_begin = begin + block * parallel_block_size;
+    const size_t block_end = std::min(block_begin + parallel_block_size, end);
+    transport_kernel.reduce(args, block_begin, block_end, block_sums[block]);
+  };
+  if (thread_pool) {
+    thread_pool->parallel_for(num_blocks, reduce_block);
+  } else {
+    for (size_t block = 0; block < num_blocks; ++block) reduce_block(block);
+  }
+
+  sums = block_sums[0];
+  for (size_t b = 1; b < num_blocks; ++b) {
+    const TransportSums& block = block_sums[b];
+    sums.ii_sum += block.ii_sum;
+    sums.iv_sum += block.iv_sum;
+    sums.vi_sum += block.vi_sum;
+    sums.vv_sum += block.vv_sum;
+    sums.i_absorption += block.i_absorption;
+    sums.v_absorption += block.v_absorption;
+    sums.i_emission += block.i_emission;
+    sums.v_emission += block.v_emission;
+    sums.radius += block.radius;
+    sums.dislocation_gain += block.dislocation_gain;
+  }
+}
+
+/** @brief Writes the concentration derivatives of the cluster sizes in
+ * [begin, end), split into blocks of parallel_block_size for the threaded
+ * backend.
+ */
+void ClusterDynamicsCpuImpl::transport_stencil(size_t begin, size_t end,
+                                               gp_float* i_derivatives,
+                                               gp_float* v_derivatives) const {
+  const TransportKernelArgs args = transport_kernel_args();
+  if (!thread_pool) {
+    transport_kernel.stencil(args, begin, end, i_derivatives, v_derivatives);
+    return;
+  }
+
+  const size_t num_blocks =
+      (end - begin + parallel_block_size - 1) / parallel_block_size;
+  thread_pool->parallel_for(num_blocks, [&](size_t block) {
+    const size_t block_begin = begin + block * parallel_block_size;
+    const size_t block_end = std::min(block_begin + parallel_block_size, end);
+    transport_kernel.stencil(args, block_begin, block_end, i_derivatives,
+                             v_derivatives);
+  });
+}
+
+/** @brief Precomputes every reduction over the cluster sizes the derivatives
+ * need in a single sweep over the state.
+ *
+ * The bulk of the sweep runs through transport_kernel. With the scalar kernel
+ * each value matches its reference function (ii_sum_absorption(),
+ * i_emission_rate(), i_absorption_rate(), mean_dislocation_cell_radius(),
+ * dislocation_density_derivative(), ...) bit for bit, since every sum is
+ * accumulated in the same order.
+ */
+void ClusterDynamicsCpuImpl::step_init() {
+  // With grouping or the continuum the sums cover every individually tracked
+  // size, the groups or cells continue them above max_cluster_size
+  const size_t N =
+      has_coarse_tail() ? max_cluster_size + 2 : max_cluster_size;
+
+  TransportSums sums;
+  sums.i_absorption = ii_absorption_val[1] * interstitials[1];
+  sums.v_absorption = vv_absorption_val[1] * vacancies[1];
+
+  // The sizes at both ends of the sweep only contribute to some of the sums
+  auto partial_step = [&](size_t n) {
+    const gp_float ci = interstitials[n];
+    const gp_float cv = vacancies[n];
+
+    sums.radius += cluster_radius_val[n] * ci;
+    sums.dislocation_gain += cluster_radius_val[n] * ii_absorption_val[n] *
+                             ci *
+                             i_dislocation_loop_unfault_probability_val[n];
+
+    if (n >= N - 1) return;
+
+    sums.ii_sum += ii_absorption_val[n] * ci;
+    sums.iv_sum += iv_absorption_val[n] * ci;
+    sums.vi_sum += vi_absorption_val[n] * cv;
+    sums.vv_sum += vv_absorption_val[n] * cv;
+
+    if (n < 2) return;
+
+    sums.i_absorption +=
+        ii_absorption_val[n] * ci + vi_absorption_val[n] * cv;
+    sums.v_absorption +=
+        vv_absorption_val[n] * cv + iv_absorption_val[n] * ci;
+  };
+
+  size_t n = 1;
+  for (; n < std::min<size_t>(3, N); ++n) partial_step(n);
+  if (N > 4) {
+    transport_reduce(3, N - 1, sums);
+    n = N - 1;
+  }
+  for (; n < N; ++n) partial_step(n);
+  if (!groups.empty()) group_reductions(sums);
+  if (!continuum_cells.empty()) continuum_reductions(sums);
+
+  ii_sum_absorption_val = sums.ii_sum;
+  iv_sum_absorption_val = sums.iv_sum;
+  vi_sum_absorption_val = sums.vi_sum;
+  vv_sum_absorption_val = sums.vv_sum;
+
+  i_emission_rate_val =
+      sums.i_emission +
+      (2. * ii_emission_val[2] * interstitials[2] +
+       iv_absorption_val[2] * vacancies[1] * interstitials[2]);
+  v_emission_rate_val =
+      sums.v_emission +
+      (2. * vv_emission_val[2] * vacancies[2] +
+       vi_absorption_val[2] * interstitials[1] * vacancies[2]);
+  i_absorption_rate_val = sums.i_absorption;
+  v_absorption_rate_val = sums.v_absorption;
+
+  mean_dislocation_radius_val =
+      1 / std::sqrt((2. * M_PI * M_PI / material.atomic_volume) * sums.radius +
+                    M_PI * (*dislocation_density));
+  dislocation_gain_val =
+      sums.dislocation_gain * (2. * M_PI / material.atomic_volume);
 }
 
-int ClusterDynamicsCpuImpl::system([[maybe_unused]] double t, N_Vector v_state,
+int ClusterDynamicsCpuImpl::system(double t, N_Vector v_state,
                                    N_Vector v_state_derivatives,
                                    void* user_data) {
   ClusterDynamicsCpuImpl* cd = static_cast<ClusterDynamicsCpuImpl*>(user_data);
-  cd->interstitials = N_VGetArrayPointer(v_state);
-  cd->vacancies = cd->interstitials + cd->max_cluster_size + 2;
-  cd->dislocation_density = cd->vacancies + cd->max_cluster_size + 2;
+  ScopedPhase phase(cd->phase_timer, &cd->solver_stats.rhs_time);
+  cd->alias_state(v_state);
+
+  // Along a ramp only the tables of the flux and temperature are followed
+  if (cd->reactor_ramping && t != cd->reactor_time) {
+    const gp_float temperature = cd->reactor.temperature;
+    const ReactorHistoryPoint point = cd->reactor_history.at(t);
+    cd->reactor.flux = point.flux;
+    cd->reactor.temperature = point.temperature;
+    cd->reactor_time = t;
+    if (cd->reactor.temperature != temperature)
+      cd->temperature_coefficient_init();
+    cd->production_coefficient_init();
+  }
 
   cd->step_init();
 
@@ -1126,194 +1600,3043 @@ int ClusterDynamicsCpuImpl::system([[maybe_unused]] double t, N_Vector v_state,
   double* v_derivatives = i_derivatives + cd->max_cluster_size + 2;
   double* dislocation_derivative = v_derivatives + cd->max_cluster_size + 2;
 
-  N_VConst(0.0, v_state_derivatives);
+  // The padding entries never change
+  i_derivatives[0] = 0.;
+  i_derivatives[cd->max_cluster_size + 1] = 0.;
+  v_derivatives[0] = 0.;
+  v_derivatives[cd->max_cluster_size + 1] = 0.;
 
   i_derivatives[1] = cd->i1_concentration_derivative();
-  for (size_t i = 2; i <= cd->max_cluster_size; ++i) {
-    i_derivatives[i] = cd->i_concentration_derivative(i);
-  }
-
   v_derivatives[1] = cd->v1_concentration_derivative();
-  for (size_t i = 2; i <= cd->max_cluster_size; ++i) {
-    v_derivatives[i] = cd->v_concentration_derivative(i);
-  }
+  cd->transport_stencil(2, cd->max_cluster_size + 1, i_derivatives,
+                        v_derivatives);
+
+  if (!cd->groups.empty())
+    cd->group_system(i_derivatives, v_derivatives, dislocation_derivative + 1);
+  if (!cd->continuum_cells.empty())
+    cd->continuum_system(i_derivatives, v_derivatives,
+                         dislocation_derivative + 1 + 4 * cd->groups.size());
+
   *dislocation_derivative = cd->dislocation_density_derivative();
 
   return 0;
 }
 
-void ClusterDynamicsCpuImpl::validate(size_t n) const {
-  if (!data_validation_on) return;
+/** @brief Adds the contributions of the cluster size groups to the reductions
+ * of step_init().
+ */
+void ClusterDynamicsCpuImpl::group_reductions(TransportSums& sums) const {
+  const size_t G = groups.size();
+  const gp_float* i_moments = group_moments;
+  const gp_float* v_moments = group_moments + 2 * G;
 
-  if (std::isnan(interstitials[n]) || std::isnan(vacancies[n]) ||
-      std::isinf(interstitials[n]) || std::isinf(vacancies[n]) ||
-      interstitials[n] < 0. || vacancies[n] < 0.) {
-    throw ClusterDynamicsException(
-        "Simulation Validation Failed For Cluster Size " + std::to_string(n) +
-            ".",
-        ClusterDynamicsState{
-            .time = time,
-            .dpa = time * reactor.flux,
-            .interstitials = std::vector<gp_float>(
-                interstitials, interstitials + max_cluster_size),
-            .vacancies =
-                std::vector<gp_float>(vacancies, vacancies + max_cluster_size),
-            .dislocation_density = (*dislocation_density)});
+  for (size_t g = 0; g < G; ++g) {
+    const ClusterGroup& group = groups[g];
+    const gp_float i_level = group.level(i_moments[2 * g]);
+    const gp_float i_slope = group.slope(i_moments[2 * g + 1]);
+    const gp_float v_level = group.level(v_moments[2 * g]);
+    const gp_float v_slope = group.slope(v_moments[2 * g + 1]);
+
+    const gp_float ii = group.ii_absorption.dot(i_level, i_slope);
+    const gp_float iv = group.iv_absorption.dot(i_level, i_slope);
+    const gp_float vi = group.vi_absorption.dot(v_level, v_slope);
+    const gp_float vv = group.vv_absorption.dot(v_level, v_slope);
+
+    sums.ii_sum += ii;
+    sums.iv_sum += iv;
+    sums.vi_sum += vi;
+    sums.vv_sum += vv;
+    sums.i_absorption += ii + vi;
+    sums.v_absorption += vv + iv;
+    sums.i_emission += group.ii_emission.dot(i_level, i_slope);
+    sums.v_emission += group.vv_emission.dot(v_level, v_slope);
+    sums.radius += group.cluster_radius.dot(i_level, i_slope);
+    sums.dislocation_gain += group.dislocation_gain.dot(i_level, i_slope);
   }
 }
 
-// --------------------------------------------------------------------------------------------
-// --------------------------------------------------------------------------------------------
-/*
- *  PUBLIC INTERFACE FUNCTIONS
+namespace {
+/** @brief Returns the derivatives of the zeroth and first moments of a group
+ * for one defect type.
+ *
+ * Sums \f$w(n) \frac{dC(n)}{dt}\f$ over the sizes of the group, for the
+ * weights \f$w(n) = 1\f$ and \f$w(n) = n - \bar{n}\f$, where
+ *
+ * \f$
+ *   \frac{dC(n)}{dt} = C_1 p(n - 1) C(n - 1) + Q(n + 1) C(n + 1)
+ *   - (C_1 \beta(n) + Q(n)) C(n)
+ * \f$
+ *
+ * is the three point stencil of Pokor Equation 2a with the promotion rate
+ * \f$C_1 p(n)\f$ and the demotion rate \f$Q(n) = C'_1 \beta'(n) +
+ * \alpha(n)\f$. The concentration is linear within the group, so every sum
+ * reduces to the precomputed GroupSums.
+ *
+ * @param inflow_below \f$C_1 p(a - 1) C(a - 1)\f$ for the first size a
+ * @param inflow_above \f$Q(b + 1) C(b + 1)\f$ for the last size b
  */
-// --------------------------------------------------------------------------------------------
-// --------------------------------------------------------------------------------------------
+void group_moment_derivatives(
+    const ClusterGroup& group, gp_float level, gp_float slope,
+    gp_float self_1, const GroupSums& promotion, gp_float promotion_last,
+    const GroupSums& absorption, gp_float other_1,
+    const GroupSums& demotion_absorption, gp_float demotion_absorption_first,
+    const GroupSums& emission, gp_float emission_first, gp_float inflow_below,
+    gp_float inflow_above, gp_float* derivatives) {
+  const gp_float first_offset = (gp_float)group.first - group.mean;
+  const gp_float last_offset = (gp_float)group.last - group.mean;
 
-//!< \todo Clean up the uses of random +1/+2/-1/etc throughout the code
-ClusterDynamicsCpuImpl::ClusterDynamicsCpuImpl(ClusterDynamicsConfig& config)
-    : time(0.0),
-      max_cluster_size(config.max_cluster_size),
-      material(*config.material.impl()),
-      reactor(*config.reactor.impl()) {
-  max_cluster_size = config.max_cluster_size;
-  data_validation_on = config.data_validation_on;
-  relative_tolerance = config.relative_tolerance;
-  absolute_tolerance = config.absolute_tolerance;
-  max_num_integration_steps = config.max_num_integration_steps;
-  min_integration_step = config.min_integration_step;
-  max_integration_step = config.max_integration_step;
+  // The promotions into the group come from [a - 1, b - 1], the demotions
+  // from [a + 1, b + 1]
+  const GroupSums inner_promotion =
+      promotion.without(promotion_last, last_offset);
+  const GroupSums inner_absorption =
+      demotion_absorption.without(demotion_absorption_first, first_offset);
+  const GroupSums inner_emission =
+      emission.without(emission_first, first_offset);
 
-  state_size = 2 * (max_cluster_size + 2) + 1;
+  const gp_float promotion_0 = inner_promotion.dot(level, slope);
+  const gp_float promotion_1 = inner_promotion.first_dot(level, slope);
+  const gp_float demotion_0 = other_1 * inner_absorption.dot(level, slope) +
+                              inner_emission.dot(level, slope);
+  const gp_float demotion_1 =
+      other_1 * inner_absorption.first_dot(level, slope) +
+      inner_emission.first_dot(level, slope);
+  const gp_float loss_0 = self_1 * absorption.dot(level, slope) +
+                          other_1 * demotion_absorption.dot(level, slope) +
+                          emission.dot(level, slope);
+  const gp_float loss_1 =
+      self_1 * absorption.first_dot(level, slope) +
+      other_1 * demotion_absorption.first_dot(level, slope) +
+      emission.first_dot(level, slope);
 
-  /* Create the SUNDIALS context */
-  int sunerr = SUNContext_Create(SUN_COMM_NULL, &sun_context);
-  if (sunerr)
-    throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
-                                   ClusterDynamicsState());
+  derivatives[0] = inflow_below + self_1 * promotion_0 + inflow_above +
+                   demotion_0 - loss_0;
+  derivatives[1] = first_offset * inflow_below +
+                   self_1 * (promotion_1 + promotion_0) +
+                   last_offset * inflow_above + (demotion_1 - demotion_0) -
+                   loss_1;
+}
 
-  /* Create the initial state */
-  /// \todo Check errors
-  state = N_VNew_Serial(state_size, sun_context);
+/** @brief Partial derivatives of group_moment_derivatives() with respect to
+ * the level and slope of the group and the size 1 concentrations, leaving
+ * out those of the inflows. Each array holds the partials of the zeroth and
+ * the first moment derivative.
+ */
+struct GroupMomentPartials {
+  gp_float level[2];
+  gp_float slope[2];
+  gp_float self_1[2];
+  gp_float other_1[2];
+};
 
-  /* Set State Aliases */
-  interstitials = N_VGetArrayPointer(state);
-  vacancies = interstitials + max_cluster_size + 2;
-  dislocation_density = vacancies + max_cluster_size + 2;
+GroupMomentPartials group_moment_partials(
+    const ClusterGroup& group, gp_float level, gp_float slope,
+    gp_float self_1, const GroupSums& promotion, gp_float promotion_last,
+    const GroupSums& absorption, gp_float other_1,
+    const GroupSums& demotion_absorption, gp_float demotion_absorption_first,
+    const GroupSums& emission, gp_float emission_first) {
+  const gp_float first_offset = (gp_float)group.first - group.mean;
+  const gp_float last_offset = (gp_float)group.last - group.mean;
 
-  /* Initialize State Values */
-  for (size_t i = 0; i < max_cluster_size; ++i) {
-    interstitials[i] = config.init_interstitials[i];
-    vacancies[i] = config.init_vacancies[i];
-  }
+  const GroupSums inner_promotion =
+      promotion.without(promotion_last, last_offset);
+  const GroupSums inner_absorption =
+      demotion_absorption.without(demotion_absorption_first, first_offset);
+  const GroupSums inner_emission =
+      emission.without(emission_first, first_offset);
 
-  *dislocation_density = material.dislocation_density_0;
-  interstitials[max_cluster_size + 1] = 0.0;
-  vacancies[max_cluster_size + 1] = 0.0;
+  // Both derivatives are linear in the level and the slope through the
+  // transfers within the group, the losses out of it and, for the first
+  // moment, the size change of each transfer
+  const GroupSums gain = inner_promotion.scaled(self_1)
+                             .plus(inner_absorption.scaled(other_1))
+                             .plus(inner_emission);
+  const GroupSums loss = absorption.scaled(self_1)
+                             .plus(demotion_absorption.scaled(other_1))
+                             .plus(emission);
+  const GroupSums shift = inner_promotion.scaled(self_1)
+                              .plus(inner_absorption.scaled(-other_1))
+                              .plus(inner_emission.scaled(-1.));
 
-  /* Call CVodeCreate to create the solver memory and specify the
-   * Backward Differentiation Formula */
-  cvodes_memory_block = CVodeCreate(CV_BDF, sun_context);
+  GroupMomentPartials partials;
+  partials.level[0] = gain.s0 - loss.s0;
+  partials.slope[0] = gain.s1 - loss.s1;
+  partials.level[1] = gain.s1 - loss.s1 + shift.s0;
+  partials.slope[1] = gain.s2 - loss.s2 + shift.s1;
+  partials.self_1[0] =
+      inner_promotion.dot(level, slope) - absorption.dot(level, slope);
+  partials.self_1[1] = inner_promotion.first_dot(level, slope) +
+                       inner_promotion.dot(level, slope) -
+                       absorption.first_dot(level, slope);
+  partials.other_1[0] = inner_absorption.dot(level, slope) -
+                        demotion_absorption.dot(level, slope);
+  partials.other_1[1] = inner_absorption.first_dot(level, slope) -
+                        inner_absorption.dot(level, slope) -
+                        demotion_absorption.first_dot(level, slope);
+  return partials;
+}
+}  // namespace
 
-  /* Call CVodeInit to initialize the integrator memory and specify the
-   * user's right hand side function in y'=f(t,y), the initial time T0, and
-   * the initial dependent variable vector y. */
-  sunerr = CVodeInit(cvodes_memory_block, system, 0, state);
-  if (sunerr)
-    throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
-                                   ClusterDynamicsState());
+/** @brief Writes the moment derivatives of the cluster size groups and adds
+ * the demotions out of the first group to the largest individually tracked
+ * size.
+ */
+void ClusterDynamicsCpuImpl::group_system(gp_float* i_derivatives,
+                                          gp_float* v_derivatives,
+                                          gp_float* group_derivatives) const {
+  const size_t M = max_cluster_size;
+  const size_t G = groups.size();
+  const gp_float* i_moments = group_moments;
+  const gp_float* v_moments = group_moments + 2 * G;
+  const gp_float i1 = interstitials[1];
+  const gp_float v1 = vacancies[1];
 
-  /* Call CVodeSVtolerances to specify the scalar relative tolerance
-   * and scalar absolute tolerances */
-  sunerr = CVodeSStolerances(cvodes_memory_block, relative_tolerance,
-                             absolute_tolerance);
-  if (sunerr)
-    throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
-                                   ClusterDynamicsState());
+  // Promotions out of the largest individually tracked size
+  gp_float i_inflow_below =
+      i1 * ii_absorption_val[M] * i_promotion_factor_val[M] * interstitials[M];
+  gp_float v_inflow_below = v1 * vv_absorption_val[M] * vacancies[M];
 
-  /* Create dense jacobian matrix */
-  jacobian_matrix = SUNDenseMatrix(state_size, state_size, sun_context);
+  for (size_t g = 0; g < G; ++g) {
+    const ClusterGroup& group = groups[g];
+    const gp_float i_level = group.level(i_moments[2 * g]);
+    const gp_float i_slope = group.slope(i_moments[2 * g + 1]);
+    const gp_float v_level = group.level(v_moments[2 * g]);
+    const gp_float v_slope = group.slope(v_moments[2 * g + 1]);
 
-  /* Create dense SUNLinearSolver object for use by CVode */
-  linear_solver = SUNLinSol_Dense(state, jacobian_matrix, sun_context);
+    if (g == 0) {
+      // Demotions out of the first group
+      i_derivatives[M] +=
+          (group.iv_absorption_first * v1 + group.ii_emission_first) *
+          group.concentration(i_level, i_slope, group.first);
+      v_derivatives[M] +=
+          (group.vi_absorption_first * i1 + group.vv_emission_first) *
+          group.concentration(v_level, v_slope, group.first);
+    }
 
-  sunerr = CVodeSetUserData(cvodes_memory_block, static_cast<void*>(this));
-  if (sunerr)
-    throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
-                                   ClusterDynamicsState());
+    // Clusters growing past the largest size are lost, as without grouping
+    gp_float i_inflow_above = 0.;
+    gp_float v_inflow_above = 0.;
+    if (g + 1 < G) {
+      const ClusterGroup& next = groups[g + 1];
+      i_inflow_above =
+          (next.iv_absorption_first * v1 + next.ii_emission_first) *
+          next.concentration(next.level(i_moments[2 * g + 2]),
+                             next.slope(i_moments[2 * g + 3]), next.first);
+      v_inflow_above =
+          (next.vi_absorption_first * i1 + next.vv_emission_first) *
+          next.concentration(next.level(v_moments[2 * g + 2]),
+                             next.slope(v_moments[2 * g + 3]), next.first);
+    }
 
-  sunerr = CVodeSetMaxNumSteps(cvodes_memory_block, max_num_integration_steps);
-  if (sunerr)
-    throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
-                                   ClusterDynamicsState());
+    group_moment_derivatives(
+        group, i_level, i_slope, i1, group.i_promotion, group.i_promotion_last,
+        group.ii_absorption, v1, group.iv_absorption,
+        group.iv_absorption_first, group.ii_emission, group.ii_emission_first,
+        i_inflow_below, i_inflow_above, group_derivatives + 2 * g);
+    group_moment_derivatives(
+        group, v_level, v_slope, v1, group.vv_absorption,
+        group.vv_absorption_last, group.vv_absorption, i1,
+        group.vi_absorption, group.vi_absorption_first, group.vv_emission,
+        group.vv_emission_first, v_inflow_below, v_inflow_above,
+        group_derivatives + 2 * (G + g));
 
-  sunerr = CVodeSetMinStep(cvodes_memory_block, min_integration_step);
-  if (sunerr)
-    throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
-                                   ClusterDynamicsState());
+    i_inflow_below = i1 * group.i_promotion_last *
+                     group.concentration(i_level, i_slope, group.last);
+    v_inflow_below = v1 * group.vv_absorption_last *
+                     group.concentration(v_level, v_slope, group.last);
+  }
+}
 
-  sunerr = CVodeSetMaxStep(cvodes_memory_block, max_integration_step);
-  if (sunerr)
-    throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
-                                   ClusterDynamicsState());
+/** @brief Adds the contributions of the continuum cells to the reductions of
+ * step_init().
+ */
+void ClusterDynamicsCpuImpl::continuum_reductions(TransportSums& sums) const {
+  const size_t K = continuum_cells.size();
+  const gp_float* i_cells = continuum_concentrations;
+  const gp_float* v_cells = continuum_concentrations + K;
 
-  // TODO - set to time delta?
-  sunerr = CVodeSetInitStep(cvodes_memory_block, 1e-5);
-  if (sunerr)
-    throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
-                                   ClusterDynamicsState());
+  for (size_t k = 0; k < K; ++k) {
+    const ContinuumCell& cell = continuum_cells[k];
+    const gp_float ci = i_cells[k] / cell.width();
+    const gp_float cv = v_cells[k] / cell.width();
 
-  /* Attach the matrix and linear solver */
-  sunerr =
-      CVodeSetLinearSolver(cvodes_memory_block, linear_solver, jacobian_matrix);
-  if (sunerr)
-    throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
-                                   ClusterDynamicsState());
+    const gp_float ii = cell.ii_absorption * ci;
+    const gp_float iv = cell.iv_absorption * ci;
+    const gp_float vi = cell.vi_absorption * cv;
+    const gp_float vv = cell.vv_absorption * cv;
 
-  // CVodeSetInterpolateStopTime(cvodes_memory_block, 1);
+    sums.ii_sum += ii;
+    sums.iv_sum += iv;
+    sums.vi_sum += vi;
+    sums.vv_sum += vv;
+    sums.i_absorption += ii + vi;
+    sums.v_absorption += vv + iv;
+    sums.i_emission += cell.ii_emission * ci;
+    sums.v_emission += cell.vv_emission * cv;
+    sums.radius += cell.cluster_radius * ci;
+    sums.dislocation_gain += cell.dislocation_gain * ci;
+  }
 }
 
-ClusterDynamicsCpuImpl::~ClusterDynamicsCpuImpl() {
-  N_VDestroy_Serial(state);
-  SUNMatDestroy(jacobian_matrix);
-  SUNLinSolFree(linear_solver);
-  CVodeFree(&cvodes_memory_block);
-  SUNContext_Free(&sun_context);
-}
+/** @brief Writes the derivatives of the continuum cells and couples the first
+ * cell to the largest size following the master equation.
+ *
+ * Each cell gains the flux through its lower face and loses the flux through
+ * its upper face, see continuum_flux(), so clusters are conserved across the
+ * interface. Interstitial loops which unfault leave the cells as they leave
+ * the discrete sizes.
+ */
+void ClusterDynamicsCpuImpl::continuum_system(
+    gp_float* i_derivatives, gp_float* v_derivatives,
+    gp_float* cell_derivatives) const {
+  const size_t M = max_cluster_size;
+  const size_t K = continuum_cells.size();
+  const gp_float* i_cells = continuum_concentrations;
+  const gp_float* v_cells = continuum_concentrations + K;
+  gp_float* i_cell_derivatives = cell_derivatives;
+  gp_float* v_cell_derivatives = cell_derivatives + K;
+  const gp_float i1 = interstitials[1];
+  const gp_float v1 = vacancies[1];
 
-ClusterDynamicsState ClusterDynamicsCpuImpl::run(gp_float total_time) {
-  double out_time;
-  const int sunerr = CVode(cvodes_memory_block, time + total_time, state,
-                           &out_time, CV_NORMAL);
-  if (sunerr)
-    throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
-                                   ClusterDynamicsState());
+  // The lower neighbour of the first cell is the largest discrete size
+  gp_float lower_center = (gp_float)M;
+  gp_float i_lower = interstitials[M];
+  gp_float v_lower = vacancies[M];
+  gp_float i_promotion = i1 * ii_absorption_val[M] * i_promotion_factor_val[M];
+  gp_float v_promotion = v1 * vv_absorption_val[M];
 
-  time = out_time;
+  for (size_t k = 0; k < K; ++k) {
+    const ContinuumCell& cell = continuum_cells[k];
+    const gp_float ci = i_cells[k] / cell.width();
+    const gp_float cv = v_cells[k] / cell.width();
+    const gp_float h = cell.center - lower_center;
 
-  interstitials = N_VGetArrayPointer(state);
-  vacancies = interstitials + max_cluster_size + 2;
-  dislocation_density = vacancies + max_cluster_size + 2;
+    const gp_float i_flux = continuum_flux(
+        i_promotion, v1 * cell.iv_absorption_first + cell.ii_emission_first, h,
+        i_lower, ci);
+    const gp_float v_flux = continuum_flux(
+        v_promotion, i1 * cell.vi_absorption_first + cell.vv_emission_first, h,
+        v_lower, cv);
 
-  return ClusterDynamicsState{
-      .time = time,
-      .dpa = time * reactor.flux,
-      .interstitials =
-          std::vector<double>(interstitials, interstitials + max_cluster_size),
-      .vacancies = std::vector<double>(vacancies, vacancies + max_cluster_size),
-      .dislocation_density = *dislocation_density};
-}
+    if (k == 0) {
+      // The stencil already removed the promotions out of the largest size
+      i_derivatives[M] += i_promotion * i_lower - i_flux;
+      v_derivatives[M] += v_promotion * v_lower - v_flux;
+    } else {
+      i_cell_derivatives[k - 1] -= i_flux;
+      v_cell_derivatives[k - 1] -= v_flux;
+    }
+    i_cell_derivatives[k] = i_flux - i1 * cell.i_unfault_absorption * ci;
+    v_cell_derivatives[k] = v_flux;
 
-MaterialImpl ClusterDynamicsCpuImpl::get_material() const { return material; }
+    lower_center = cell.center;
+    i_lower = ci;
+    v_lower = cv;
+    i_promotion = i1 * cell.i_promotion_last;
+    v_promotion = v1 * cell.vv_absorption_last;
+  }
 
-void ClusterDynamicsCpuImpl::set_material(const MaterialImpl& material) {
-  this->material = MaterialImpl(material);
+  // Clusters growing past the largest size are lost, as without the continuum
+  i_cell_derivatives[K - 1] -= i_promotion * i_lower;
+  v_cell_derivatives[K - 1] -= v_promotion * v_lower;
 }
 
-NuclearReactorImpl ClusterDynamicsCpuImpl::get_reactor() const {
-  return reactor;
-}
+namespace {
+/** @brief Accumulates Jacobian entries into a SUNDIALS dense matrix.
+ */
+class DenseJacobianWriter {
+ public:
+  explicit DenseJacobianWriter(SUNMatrix matrix) : matrix(matrix), row(0) {}
 
-void ClusterDynamicsCpuImpl::set_reactor(const NuclearReactorImpl& reactor) {
-  this->reactor = NuclearReactorImpl(reactor);
+  void begin_row(sunindextype r) { row = r; }
+  void entry(sunindextype col, gp_float value) {
+    SM_ELEMENT_D(matrix, row, col) += value;
+  }
+  void finish() {}
+
+ private:
+  SUNMatrix matrix;
+  sunindextype row;
+};
+
+/** @brief Writes Jacobian entries into a SUNDIALS CSR sparse matrix.
+ *
+ * Rows must be visited in increasing order and the columns within a row must
+ * be emitted in increasing order. Consecutive entries for the same column are
+ * summed into a single stored value.
+ */
+class SparseJacobianWriter {
+ public:
+  explicit SparseJacobianWriter(SUNMatrix matrix)
+      : row_ptrs(SUNSparseMatrix_IndexPointers(matrix)),
+        col_vals(SUNSparseMatrix_IndexValues(matrix)),
+        data(SUNSparseMatrix_Data(matrix)),
+        rows(SUNSparseMatrix_Rows(matrix)),
+        next_row(0),
+        nnz(0) {}
+
+  void begin_row(sunindextype r) {
+    while (next_row <= r) row_ptrs[next_row++] = nnz;
+  }
+  void entry(sunindextype col, gp_float value) {
+    if (nnz > row_ptrs[next_row - 1] && col_vals[nnz - 1] == col) {
+      data[nnz - 1] += value;
+      return;
+    }
+    col_vals[nnz] = col;
+    data[nnz++] = value;
+  }
+  void finish() {
+    while (next_row <= rows) row_ptrs[next_row++] = nnz;
+  }
+
+ private:
+  sunindextype* row_ptrs;
+  sunindextype* col_vals;
+  sunrealtype* data;
+  sunindextype rows;
+  sunindextype next_row;
+  sunindextype nnz;
+};
+
+/** @brief Writes Jacobian entries into an arrowhead matrix.
+ *
+ * Records a failure if an entry falls outside of the arrowhead structure.
+ */
+class ArrowheadJacobianWriter {
+ public:
+  explicit ArrowheadJacobianWriter(SUNMatrix matrix)
+      : content(SUNArrowheadMatrix_Content(matrix)), row(0), valid(true) {}
+
+  void begin_row(sunindextype r) { row = r; }
+  void entry(sunindextype col, gp_float value) {
+    valid = content->add(row, col, value) && valid;
+  }
+  void finish() {}
+
+  bool is_valid() const { return valid; }
+
+ private:
+  ArrowheadMatrixContent* content;
+  sunindextype row;
+  bool valid;
+};
+
+/** @brief Writes the tridiagonal cluster transport part of the Jacobian into
+ * an arrowhead matrix, keeping only the diagonal of its border.
+ */
+class TridiagonalJacobianWriter {
+ public:
+  explicit TridiagonalJacobianWriter(SUNMatrix matrix)
+      : content(SUNArrowheadMatrix_Content(matrix)), row(0), valid(true) {}
+
+  void begin_row(sunindextype r) { row = r; }
+  void entry(sunindextype col, gp_float value) {
+    const bool border_row = content->position[row] < 0;
+    const bool border_col = content->position[col] < 0;
+    if ((border_row || border_col) && row != col) return;
+    valid = content->add(row, col, value) && valid;
+  }
+  void finish() {}
+
+  bool is_valid() const { return valid; }
+
+ private:
+  ArrowheadMatrixContent* content;
+  sunindextype row;
+  bool valid;
+};
+
+/** @brief Accumulates the product of the Jacobian with a vector without
+ * storing the Jacobian.
+ */
+class MatvecJacobianWriter {
+ public:
+  MatvecJacobianWriter(const gp_float* v, gp_float* jv)
+      : v(v), jv(jv), row(0) {}
+
+  void begin_row(sunindextype r) { row = r; }
+  void entry(sunindextype col, gp_float value) { jv[row] += value * v[col]; }
+  void finish() {}
+
+ private:
+  const gp_float* v;
+  gp_float* jv;
+  sunindextype row;
+};
+
+/** @brief Accumulates the product of the negated transposed Jacobian with a
+ * vector, the right hand side of the adjoint equations.
+ */
+class AdjointMatvecJacobianWriter {
+ public:
+  AdjointMatvecJacobianWriter(const gp_float* v, gp_float* jtv)
+      : v(v), jtv(jtv), row(0) {}
+
+  void begin_row(sunindextype r) { row = r; }
+  void entry(sunindextype col, gp_float value) { jtv[col] -= value * v[row]; }
+  void finish() {}
+
+ private:
+  const gp_float* v;
+  gp_float* jtv;
+  sunindextype row;
+};
+
+/** @brief Writes the negated transposed Jacobian into an arrowhead matrix,
+ * whose structure is its own transpose.
+ */
+class AdjointArrowheadJacobianWriter {
+ public:
+  explicit AdjointArrowheadJacobianWriter(SUNMatrix matrix)
+      : content(SUNArrowheadMatrix_Content(matrix)), row(0), valid(true) {}
+
+  void begin_row(sunindextype r) { row = r; }
+  void entry(sunindextype col, gp_float value) {
+    valid = content->add(col, row, -value) && valid;
+  }
+  void finish() {}
+
+  bool is_valid() const { return valid; }
+
+ private:
+  ArrowheadMatrixContent* content;
+  sunindextype row;
+  bool valid;
+};
+
+/** @brief Counts the number of stored entries the SparseJacobianWriter would
+ * produce without writing anything.
+ */
+class CountingJacobianWriter {
+ public:
+  CountingJacobianWriter() : last_col(-1), nnz(0) {}
+
+  void begin_row(sunindextype) { last_col = -1; }
+  void entry(sunindextype col, gp_float) {
+    if (col != last_col) ++nnz;
+    last_col = col;
+  }
+  void finish() {}
+
+  sunindextype count() const { return nnz; }
+
+ private:
+  sunindextype last_col;
+  sunindextype nnz;
+};
+}  // namespace
+
+/** @brief Emits the analytic Jacobian of system() for the current state.
+ *
+ * Cluster sizes n > 1 only couple to n - 1, n + 1 and the size 1 defects, so
+ * each of those rows holds at most five entries. The size 1 interstitial and
+ * vacancy rows and the dislocation density row depend on every cluster size.
+ * The rows of the groups or continuum cells follow the last of those rows,
+ * see group_jacobian_entries() and continuum_jacobian_entries().
+ * Entries are emitted row by row in increasing column order, including
+ * structural zeros, so that the sparsity pattern never changes between calls.
+ *
+ * The state aliases and the step_init() values must be current for the state
+ * the Jacobian is evaluated at.
+ */
+template <typename JacobianWriter>
+void ClusterDynamicsCpuImpl::jacobian_entries(JacobianWriter& writer) const {
+  const size_t N = max_cluster_size;
+  const gp_float ci1 = interstitials[1];
+  const gp_float cv1 = vacancies[1];
+  const gp_float rho = *dislocation_density;
+  const gp_float recombination = annihilation_rate();
+
+  // With a coarse tail the sums of step_init() cover every individually
+  // tracked size, without it they stop short of the largest sizes
+  const size_t sum_end = has_coarse_tail() ? N + 1 : N - 1;
+
+  // Derivatives of the square roots in the grain boundary annihilation rates
+  const gp_float i_gb_sqrt = std::sqrt(rho * material.i_dislocation_bias +
+                                       ii_sum_absorption_val +
+                                       vi_sum_absorption_val);
+  const gp_float v_gb_sqrt = std::sqrt(rho * material.v_dislocation_bias +
+                                       vv_sum_absorption_val +
+                                       iv_sum_absorption_val);
+  const gp_float i_gb_slope =
+      i_gb_sqrt > 0. ? 3. * i_diffusion_val / (material.grain_size * i_gb_sqrt)
+                     : 0.;
+  const gp_float v_gb_slope =
+      v_gb_sqrt > 0. ? 3. * v_diffusion_val / (material.grain_size * v_gb_sqrt)
+                     : 0.;
+
+  // Emits the partials of a sum of f(n) C(n) over the groups or cells of one
+  // defect type, for the sums f of each group and cell. The level and the
+  // slope of a group are linear in its moments, so level() and slope() also
+  // carry the partials over to the moments.
+  auto tail_sum_entries = [&](bool vacancy, auto group_sums, auto cell_sum) {
+    for (size_t g = 0; g < groups.size(); ++g) {
+      const ClusterGroup& group = groups[g];
+      const GroupSums f = group_sums(group);
+      const sunindextype index = vacancy ? v_group_index(g) : i_group_index(g);
+      writer.entry(index, group.level(f.s0));
+      writer.entry(index + 1, group.slope(f.s1));
+    }
+    for (size_t k = 0; k < continuum_cells.size(); ++k) {
+      const ContinuumCell& cell = continuum_cells[k];
+      writer.entry(vacancy ? v_cell_index(k) : i_cell_index(k),
+                   cell_sum(cell) / cell.width());
+    }
+  };
+
+  // Emits the partials of the largest size with respect to the first group
+  // or cell
+  auto tail_coupling_entries = [&](const TailCoupling& coupling,
+                                   bool vacancy) {
+    if (!groups.empty()) {
+      const sunindextype index = vacancy ? v_group_index(0) : i_group_index(0);
+      writer.entry(index, coupling.tail[0]);
+      writer.entry(index + 1, coupling.tail[1]);
+    } else if (!continuum_cells.empty()) {
+      writer.entry(vacancy ? v_cell_index(0) : i_cell_index(0),
+                   coupling.tail[0]);
+    }
+  };
+
+  // Padding entries never change
+  writer.begin_row(i_index(0));
+  writer.entry(i_index(0), 0.);
+
+  // dC_i(1)/dt
+  writer.begin_row(i_index(1));
+  writer.entry(i_index(1), -recombination * cv1 -
+                               i_dislocation_annihilation_rate() -
+                               i_grain_boundary_annihilation_rate() -
+                               i_absorption_rate_val -
+                               ci1 * (i_gb_slope + 1.) * ii_absorption_val[1]);
+  for (size_t n = 2; n <= N; ++n) {
+    gp_float value = 0.;
+    if (n < sum_end) value -= ci1 * (i_gb_slope + 1.) * ii_absorption_val[n];
+    if (n == 2) {
+      value += 2. * ii_emission_val[2] + iv_absorption_val[2] * cv1;
+    } else if (n < sum_end) {
+      value += ii_emission_val[n];
+    }
+    writer.entry(i_index(n), value);
+  }
+  writer.entry(v_index(1), -recombination * ci1 -
+                               ci1 * i_gb_slope * vi_absorption_val[1] +
+                               iv_absorption_val[2] * interstitials[2]);
+  for (size_t n = 2; n <= N; ++n) {
+    writer.entry(v_index(n), n < sum_end ? -ci1 * (i_gb_slope + 1.) *
+                                               vi_absorption_val[n]
+                                         : 0.);
+  }
+  writer.entry(dislocation_index(),
+               -ci1 * i_diffusion_val * material.i_dislocation_bias -
+                   ci1 * i_gb_slope * material.i_dislocation_bias);
+  const gp_float i_sum_weight = -ci1 * (i_gb_slope + 1.);
+  tail_sum_entries(
+      false,
+      [&](const ClusterGroup& group) {
+        return group.ii_absorption.scaled(i_sum_weight).plus(group.ii_emission);
+      },
+      [&](const ContinuumCell& cell) {
+        return cell.ii_absorption * i_sum_weight + cell.ii_emission;
+      });
+  tail_sum_entries(
+      true,
+      [&](const ClusterGroup& group) {
+        return group.vi_absorption.scaled(i_sum_weight);
+      },
+      [&](const ContinuumCell& cell) {
+        return cell.vi_absorption * i_sum_weight;
+      });
+
+  // dC_i(n)/dt
+  const TailCoupling i_tail = tail_coupling(false);
+  for (size_t n = 2; n <= N; ++n) {
+    const TailCoupling tail = n == N ? i_tail : TailCoupling();
+    writer.begin_row(i_index(n));
+    writer.entry(i_index(1),
+                 -ii_absorption_val[n] * interstitials[n] +
+                     ii_absorption_val[n - 1] *
+                         (1. - i_dislocation_loop_unfault_probability_val[n]) *
+                         interstitials[n - 1] +
+                     tail.i1);
+    writer.entry(i_index(n - 1), i_promotion_rate(n - 1));
+    writer.entry(i_index(n),
+                 -i_combined_promotion_demotion_rate(n) + tail.largest);
+    writer.entry(i_index(n + 1), i_demotion_rate(n + 1));
+    writer.entry(v_index(1), iv_absorption_val[n + 1] * interstitials[n + 1] -
+                                 iv_absorption_val[n] * interstitials[n] +
+                                 tail.v1);
+    if (n == N) tail_coupling_entries(i_tail, false);
+  }
+
+  writer.begin_row(i_index(N + 1));
+  writer.entry(i_index(N + 1), 0.);
+  writer.begin_row(v_index(0));
+  writer.entry(v_index(0), 0.);
+
+  // dC_v(1)/dt
+  writer.begin_row(v_index(1));
+  writer.entry(i_index(1), -recombination * cv1 -
+                               cv1 * v_gb_slope * iv_absorption_val[1] +
+                               vi_absorption_val[2] * vacancies[2]);
+  for (size_t n = 2; n <= N; ++n) {
+    writer.entry(i_index(n), n < sum_end ? -cv1 * (v_gb_slope + 1.) *
+                                               iv_absorption_val[n]
+                                         : 0.);
+  }
+  writer.entry(v_index(1), -recombination * ci1 -
+                               v_dislocation_annihilation_rate() -
+                               v_grain_boundary_annihilation_rate() -
+                               v_absorption_rate_val -
+                               cv1 * (v_gb_slope + 1.) * vv_absorption_val[1]);
+  for (size_t n = 2; n <= N; ++n) {
+    gp_float value = 0.;
+    if (n < sum_end) value -= cv1 * (v_gb_slope + 1.) * vv_absorption_val[n];
+    if (n == 2) {
+      value += 2. * vv_emission_val[2] + vi_absorption_val[2] * ci1;
+    } else if (n < sum_end) {
+      value += vv_emission_val[n];
+    }
+    writer.entry(v_index(n), value);
+  }
+  writer.entry(dislocation_index(),
+               -cv1 * v_diffusion_val * material.v_dislocation_bias -
+                   cv1 * v_gb_slope * material.v_dislocation_bias);
+  const gp_float v_sum_weight = -cv1 * (v_gb_slope + 1.);
+  tail_sum_entries(
+      false,
+      [&](const ClusterGroup& group) {
+        return group.iv_absorption.scaled(v_sum_weight);
+      },
+      [&](const ContinuumCell& cell) {
+        return cell.iv_absorption * v_sum_weight;
+      });
+  tail_sum_entries(
+      true,
+      [&](const ClusterGroup& group) {
+        return group.vv_absorption.scaled(v_sum_weight).plus(group.vv_emission);
+      },
+      [&](const ContinuumCell& cell) {
+        return cell.vv_absorption * v_sum_weight + cell.vv_emission;
+      });
+
+  // dC_v(n)/dt
+  const TailCoupling v_tail = tail_coupling(true);
+  for (size_t n = 2; n <= N; ++n) {
+    const TailCoupling tail = n == N ? v_tail : TailCoupling();
+    writer.begin_row(v_index(n));
+    writer.entry(i_index(1), vi_absorption_val[n + 1] * vacancies[n + 1] -
+                                 vi_absorption_val[n] * vacancies[n] +
+                                 tail.i1);
+    writer.entry(v_index(1), -vv_absorption_val[n] * vacancies[n] +
+                                 vv_absorption_val[n - 1] * vacancies[n - 1] +
+                                 tail.v1);
+    writer.entry(v_index(n - 1), v_promotion_rate(n - 1));
+    writer.entry(v_index(n),
+                 -v_combined_promotion_demotion_rate(n) + tail.largest);
+    writer.entry(v_index(n + 1), v_demotion_rate(n + 1));
+    if (n == N) tail_coupling_entries(v_tail, true);
+  }
+
+  writer.begin_row(v_index(N + 1));
+  writer.entry(v_index(N + 1), 0.);
+
+  // d(rho)/dt
+  writer.begin_row(dislocation_index());
+  for (size_t n = 1; n <= N; ++n) {
+    const gp_float gain =
+        n <= sum_end ? 2. * M_PI / material.atomic_volume *
+                           cluster_radius_val[n] * ii_absorption_val[n] *
+                           i_dislocation_loop_unfault_probability_val[n]
+                     : 0.;
+    writer.entry(i_index(n), gain);
+  }
+  writer.entry(dislocation_index(),
+               -1.5 * reactor.dislocation_density_evolution *
+                   std::pow(material.burgers_vector, 2.) * std::sqrt(rho));
+  tail_sum_entries(
+      false,
+      [&](const ClusterGroup& group) {
+        return group.dislocation_gain.scaled(2. * M_PI /
+                                             material.atomic_volume);
+      },
+      [&](const ContinuumCell& cell) {
+        return cell.dislocation_gain * (2. * M_PI / material.atomic_volume);
+      });
+
+  if (!groups.empty()) group_jacobian_entries(writer);
+  if (!continuum_cells.empty()) continuum_jacobian_entries(writer);
+
+  writer.finish();
+}
+
+/** @brief Returns the partial derivatives of the coupling of the largest
+ * individually tracked size to the first group or continuum cell, which
+ * group_system() and continuum_system() add to its derivative.
+ */
+ClusterDynamicsCpuImpl::TailCoupling ClusterDynamicsCpuImpl::tail_coupling(
+    bool vacancy) const {
+  const size_t M = max_cluster_size;
+  TailCoupling coupling;
+
+  if (!groups.empty()) {
+    // Demotions out of the first group
+    const ClusterGroup& group = groups[0];
+    const gp_float* moments = group_moments + (vacancy ? 2 * groups.size() : 0);
+    const gp_float first = group.concentration(
+        group.level(moments[0]), group.slope(moments[1]), group.first);
+    const gp_float absorption =
+        vacancy ? group.vi_absorption_first : group.iv_absorption_first;
+    const gp_float rate =
+        vacancy ? absorption * interstitials[1] + group.vv_emission_first
+                : absorption * vacancies[1] + group.ii_emission_first;
+
+    if (vacancy) {
+      coupling.i1 = absorption * first;
+    } else {
+      coupling.v1 = absorption * first;
+    }
+    coupling.tail[0] = group.level(rate);
+    coupling.tail[1] = group.slope(rate * ((gp_float)group.first - group.mean));
+  } else if (!continuum_cells.empty()) {
+    // Promotions out of the largest size less the flux into the first cell
+    const ContinuumFace face = continuum_face(0, vacancy);
+    const gp_float self_1 = vacancy ? vacancies[1] : interstitials[1];
+    const gp_float largest = vacancy ? vacancies[M] : interstitials[M];
+    const gp_float self_partial = face.promotion * (largest - face.flux.p);
+    const gp_float other_partial = -face.demotion * face.flux.q;
+
+    coupling.i1 = vacancy ? other_partial : self_partial;
+    coupling.v1 = vacancy ? self_partial : other_partial;
+    coupling.largest = self_1 * face.promotion - face.flux.left;
+    coupling.tail[0] = -face.flux.right / continuum_cells[0].width();
+  }
+
+  return coupling;
+}
+
+/** @brief Emits the Jacobian rows of the group moments.
+ *
+ * The moments of a group couple to those of its neighbours, through the
+ * fluxes across its ends, and to the size 1 defects.
+ */
+template <typename JacobianWriter>
+void ClusterDynamicsCpuImpl::group_jacobian_entries(
+    JacobianWriter& writer) const {
+  const size_t M = max_cluster_size;
+  const size_t G = groups.size();
+
+  for (const bool vacancy : {false, true}) {
+    const gp_float* moments = group_moments + (vacancy ? 2 * G : 0);
+    const gp_float self_1 = vacancy ? vacancies[1] : interstitials[1];
+    const gp_float other_1 = vacancy ? interstitials[1] : vacancies[1];
+
+    for (size_t g = 0; g < G; ++g) {
+      const ClusterGroup& group = groups[g];
+      const sunindextype index = vacancy ? v_group_index(g) : i_group_index(g);
+      const gp_float level = group.level(moments[2 * g]);
+      const gp_float slope = group.slope(moments[2 * g + 1]);
+      const GroupMomentPartials partials =
+          vacancy
+              ? group_moment_partials(
+                    group, level, slope, self_1, group.vv_absorption,
+                    group.vv_absorption_last, group.vv_absorption, other_1,
+                    group.vi_absorption, group.vi_absorption_first,
+                    group.vv_emission, group.vv_emission_first)
+              : group_moment_partials(
+                    group, level, slope, self_1, group.i_promotion,
+                    group.i_promotion_last, group.ii_absorption, other_1,
+                    group.iv_absorption, group.iv_absorption_first,
+                    group.ii_emission, group.ii_emission_first);
+
+      // Promotions from the size or group below, per size 1 defect
+      gp_float below_rate;
+      gp_float below;
+      if (g == 0) {
+        below_rate = vacancy
+                         ? vv_absorption_val[M]
+                         : ii_absorption_val[M] * i_promotion_factor_val[M];
+        below = vacancy ? vacancies[M] : interstitials[M];
+      } else {
+        const ClusterGroup& previous = groups[g - 1];
+        below_rate =
+            vacancy ? previous.vv_absorption_last : previous.i_promotion_last;
+        below = previous.concentration(previous.level(moments[2 * g - 2]),
+                                       previous.slope(moments[2 * g - 1]),
+                                       previous.last);
+      }
+
+      // Demotions from the group above
+      gp_float above_absorption = 0.;
+      gp_float above_rate = 0.;
+      gp_float above = 0.;
+      if (g + 1 < G) {
+        const ClusterGroup& next = groups[g + 1];
+        above_absorption =
+            vacancy ? next.vi_absorption_first : next.iv_absorption_first;
+        above_rate =
+            above_absorption * other_1 +
+            (vacancy ? next.vv_emission_first : next.ii_emission_first);
+        above = next.concentration(next.level(moments[2 * g + 2]),
+                                   next.slope(moments[2 * g + 3]), next.first);
+      }
+
+      // The inflows enter the first moment at the offsets of the end sizes
+      const gp_float below_offset[2] = {1., (gp_float)group.first - group.mean};
+      const gp_float above_offset[2] = {1., (gp_float)group.last - group.mean};
+      for (size_t r = 0; r < 2; ++r) {
+        const gp_float self_partial =
+            partials.self_1[r] + below_offset[r] * below_rate * below;
+        const gp_float other_partial =
+            partials.other_1[r] + above_offset[r] * above_absorption * above;
+        const gp_float below_partial = below_offset[r] * self_1 * below_rate;
+        const gp_float above_partial = above_offset[r] * above_rate;
+
+        writer.begin_row(index + r);
+        writer.entry(i_index(1), vacancy ? other_partial : self_partial);
+        if (g == 0 && !vacancy) writer.entry(i_index(M), below_partial);
+        writer.entry(v_index(1), vacancy ? self_partial : other_partial);
+        if (g == 0 && vacancy) writer.entry(v_index(M), below_partial);
+        if (g > 0) {
+          const ClusterGroup& previous = groups[g - 1];
+          writer.entry(index - 2, previous.level(below_partial));
+          writer.entry(index - 1,
+                       previous.slope(below_partial * ((gp_float)previous.last -
+                                                       previous.mean)));
+        }
+        writer.entry(index, group.level(partials.level[r]));
+        writer.entry(index + 1, group.slope(partials.slope[r]));
+        if (g + 1 < G) {
+          const ClusterGroup& next = groups[g + 1];
+          writer.entry(index + 2, next.level(above_partial));
+          writer.entry(index + 3,
+                       next.slope(above_partial *
+                                  ((gp_float)next.first - next.mean)));
+        }
+      }
+    }
+  }
+}
+
+/** @brief Returns the flux of one defect type through the lower face of
+ * continuum cell k, or out of the last cell for k equal to the number of
+ * cells, with its partial derivatives.
+ */
+ClusterDynamicsCpuImpl::ContinuumFace ClusterDynamicsCpuImpl::continuum_face(
+    size_t k, bool vacancy) const {
+  const size_t M = max_cluster_size;
+  const size_t K = continuum_cells.size();
+  const gp_float* cells = continuum_concentrations + (vacancy ? K : 0);
+  const gp_float self_1 = vacancy ? vacancies[1] : interstitials[1];
+  const gp_float other_1 = vacancy ? interstitials[1] : vacancies[1];
+
+  ContinuumFace face;
+  gp_float lower_center;
+  gp_float lower;
+  if (k == 0) {
+    // The lower neighbour of the first cell is the largest discrete size
+    face.promotion = vacancy
+                         ? vv_absorption_val[M]
+                         : ii_absorption_val[M] * i_promotion_factor_val[M];
+    lower_center = (gp_float)M;
+    lower = vacancy ? vacancies[M] : interstitials[M];
+  } else {
+    const ContinuumCell& below = continuum_cells[k - 1];
+    face.promotion =
+        vacancy ? below.vv_absorption_last : below.i_promotion_last;
+    lower_center = below.center;
+    lower = cells[k - 1] / below.width();
+  }
+
+  // Clusters growing past the largest size are lost
+  if (k == K) {
+    face.demotion = 0.;
+    face.flux = continuum_flux_partials(self_1 * face.promotion, 0., 1., lower,
+                                        0.);
+    return face;
+  }
+
+  const ContinuumCell& cell = continuum_cells[k];
+  face.demotion = vacancy ? cell.vi_absorption_first : cell.iv_absorption_first;
+  const gp_float emission =
+      vacancy ? cell.vv_emission_first : cell.ii_emission_first;
+  face.flux = continuum_flux_partials(
+      self_1 * face.promotion, other_1 * face.demotion + emission,
+      cell.center - lower_center, lower, cells[k] / cell.width());
+  return face;
+}
+
+/** @brief Emits the Jacobian rows of the continuum cells.
+ *
+ * Each cell couples to its neighbours through the fluxes across its faces,
+ * and to the size 1 defects.
+ */
+template <typename JacobianWriter>
+void ClusterDynamicsCpuImpl::continuum_jacobian_entries(
+    JacobianWriter& writer) const {
+  const size_t M = max_cluster_size;
+  const size_t K = continuum_cells.size();
+
+  for (const bool vacancy : {false, true}) {
+    const gp_float* cells = continuum_concentrations + (vacancy ? K : 0);
+    const gp_float self_1 = vacancy ? vacancies[1] : interstitials[1];
+
+    ContinuumFace lower = continuum_face(0, vacancy);
+    for (size_t k = 0; k < K; ++k) {
+      const ContinuumCell& cell = continuum_cells[k];
+      const sunindextype index = vacancy ? v_cell_index(k) : i_cell_index(k);
+      const ContinuumFace upper = continuum_face(k + 1, vacancy);
+
+      // Interstitial loops which unfault leave the cells
+      const gp_float unfault = vacancy ? 0. : cell.i_unfault_absorption;
+      const gp_float self_partial = lower.promotion * lower.flux.p -
+                                    upper.promotion * upper.flux.p -
+                                    unfault * cells[k] / cell.width();
+      const gp_float other_partial =
+          lower.demotion * lower.flux.q - upper.demotion * upper.flux.q;
+
+      writer.begin_row(index);
+      writer.entry(i_index(1), vacancy ? other_partial : self_partial);
+      if (k == 0 && !vacancy) writer.entry(i_index(M), lower.flux.left);
+      writer.entry(v_index(1), vacancy ? self_partial : other_partial);
+      if (k == 0 && vacancy) writer.entry(v_index(M), lower.flux.left);
+      if (k > 0)
+        writer.entry(index - 1,
+                     lower.flux.left / continuum_cells[k - 1].width());
+      writer.entry(index,
+                   (lower.flux.right - upper.flux.left - self_1 * unfault) /
+                       cell.width());
+      if (k + 1 < K)
+        writer.entry(index + 1,
+                     -upper.flux.right / continuum_cells[k + 1].width());
+
+      lower = upper;
+    }
+  }
+}
+
+/** @brief Returns the number of stored entries in the sparse Jacobian.
+ */
+sunindextype ClusterDynamicsCpuImpl::jacobian_nnz() const {
+  CountingJacobianWriter writer;
+  jacobian_entries(writer);
+  return writer.count();
+}
+
+/** @brief Points the state aliases at the given state vector.
+ */
+void ClusterDynamicsCpuImpl::alias_state(N_Vector v_state) {
+  interstitials = N_VGetArrayPointer(v_state);
+  vacancies = interstitials + max_cluster_size + 2;
+  dislocation_density = vacancies + max_cluster_size + 2;
+  group_moments = dislocation_density + 1;
+  continuum_concentrations = group_moments + 4 * groups.size();
+}
+
+/** @brief Returns the state indices which couple to most of the state: the
+ * size 1 interstitials and vacancies and the dislocation density. Without
+ * them the Jacobian is tridiagonal.
+ *
+ * The moments of a group couple to those of both neighbouring groups and the
+ * first group or cell to the largest size, which no ordering keeps
+ * tridiagonal, so the few entries of the coarse tail join the border.
+ */
+std::vector<sunindextype> ClusterDynamicsCpuImpl::border_indices() const {
+  std::vector<sunindextype> border{i_index(1), v_index(1), dislocation_index()};
+  for (sunindextype index = dislocation_index() + 1;
+       index < (sunindextype)state_size; ++index)
+    border.push_back(index);
+  return border;
+}
+
+int ClusterDynamicsCpuImpl::jacobian([[maybe_unused]] double t,
+                                     N_Vector v_state,
+                                     [[maybe_unused]] N_Vector
+                                         v_state_derivatives,
+                                     SUNMatrix jacobian_matrix,
+                                     void* user_data,
+                                     [[maybe_unused]] N_Vector tmp1,
+                                     [[maybe_unused]] N_Vector tmp2,
+                                     [[maybe_unused]] N_Vector tmp3) {
+  ClusterDynamicsCpuImpl* cd = static_cast<ClusterDynamicsCpuImpl*>(user_data);
+  ScopedPhase phase(cd->phase_timer, &cd->solver_stats.jacobian_time);
+  cd->alias_state(v_state);
+
+  cd->step_init();
+
+  switch (SUNMatGetID(jacobian_matrix)) {
+    case SUNMATRIX_DENSE: {
+      SUNMatZero(jacobian_matrix);
+      DenseJacobianWriter writer(jacobian_matrix);
+      cd->jacobian_entries(writer);
+      break;
+    }
+    case SUNMATRIX_SPARSE: {
+      SparseJacobianWriter writer(jacobian_matrix);
+      cd->jacobian_entries(writer);
+      break;
+    }
+    case SUNMATRIX_CUSTOM: {
+      SUNMatZero(jacobian_matrix);
+      ArrowheadJacobianWriter writer(jacobian_matrix);
+      cd->jacobian_entries(writer);
+      if (!writer.is_valid()) return -1;
+      break;
+    }
+    default:
+      return -1;
+  }
+
+  return 0;
+}
+
+int ClusterDynamicsCpuImpl::jacobian_times_vector(
+    N_Vector v, N_Vector jv, [[maybe_unused]] double t, N_Vector v_state,
+    [[maybe_unused]] N_Vector v_state_derivatives, void* user_data,
+    [[maybe_unused]] N_Vector tmp) {
+  ClusterDynamicsCpuImpl* cd = static_cast<ClusterDynamicsCpuImpl*>(user_data);
+  ScopedPhase phase(cd->phase_timer, &cd->solver_stats.jacobian_time);
+  cd->alias_state(v_state);
+
+  cd->step_init();
+
+  N_VConst(0.0, jv);
+  MatvecJacobianWriter writer(N_VGetArrayPointer(v), N_VGetArrayPointer(jv));
+  cd->jacobian_entries(writer);
+
+  return 0;
+}
+
+/** @brief Builds and factors the preconditioner I - gamma * T, where T is the
+ * tridiagonal cluster transport part of the Jacobian (Pokor Equation 2a) and
+ * the diagonal of the border rows, see border_indices().
+ *
+ * T is only re-evaluated when CVODE signals that the saved copy is stale.
+ */
+int ClusterDynamicsCpuImpl::preconditioner_setup(
+    [[maybe_unused]] double t, N_Vector v_state,
+    [[maybe_unused]] N_Vector v_state_derivatives, sunbooleantype jacobian_ok,
+    sunbooleantype* jacobian_current, double gamma, void* user_data) {
+  ClusterDynamicsCpuImpl* cd = static_cast<ClusterDynamicsCpuImpl*>(user_data);
+
+  if (jacobian_ok) {
+    *jacobian_current = SUNFALSE;
+  } else {
+    ScopedPhase phase(cd->phase_timer, &cd->solver_stats.jacobian_time);
+    cd->alias_state(v_state);
+
+    cd->step_init();
+
+    SUNMatZero(cd->preconditioner_jacobian);
+    TridiagonalJacobianWriter writer(cd->preconditioner_jacobian);
+    cd->jacobian_entries(writer);
+    if (!writer.is_valid()) return -1;
+
+    *jacobian_current = SUNTRUE;
+  }
+
+  if (SUNMatCopy(cd->preconditioner_jacobian, cd->preconditioner_matrix) ||
+      SUNMatScaleAddI(-gamma, cd->preconditioner_matrix))
+    return -1;
+
+  // A failed factorization is recoverable with a smaller step
+  return SUNLinSolSetup(cd->preconditioner_solver, cd->preconditioner_matrix)
+             ? 1
+             : 0;
+}
+
+int ClusterDynamicsCpuImpl::preconditioner_solve(
+    [[maybe_unused]] double t, [[maybe_unused]] N_Vector v_state,
+    [[maybe_unused]] N_Vector v_state_derivatives, N_Vector r, N_Vector z,
+    [[maybe_unused]] double gamma, [[maybe_unused]] double delta,
+    [[maybe_unused]] int lr, void* user_data) {
+  ClusterDynamicsCpuImpl* cd = static_cast<ClusterDynamicsCpuImpl*>(user_data);
+  return SUNLinSolSolve(cd->preconditioner_solver, cd->preconditioner_matrix,
+                        z, r, 0.);
+}
+
+void ClusterDynamicsCpuImpl::validate(size_t n) const {
+  if (!data_validation_on) return;
+
+  if (std::isnan(interstitials[n]) || std::isnan(vacancies[n]) ||
+      std::isinf(interstitials[n]) || std::isinf(vacancies[n]) ||
+      interstitials[n] < 0. || vacancies[n] < 0.) {
+    throw ClusterDynamicsException(
+        "Simulation Validation Failed For Cluster Size " + std::to_string(n) +
+            ".",
+        ClusterDynamicsState{
+            .time = time,
+            .dpa = dose(time),
+            .interstitials = std::vector<gp_float>(
+                interstitials, interstitials + max_cluster_size),
+            .vacancies =
+                std::vector<gp_float>(vacancies, vacancies + max_cluster_size),
+            .dislocation_density = (*dislocation_density),
+            .interstitial_groups = {},
+            .vacancy_groups = {}});
+  }
+}
+
+// --------------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------
+/*
+ *  PUBLIC INTERFACE FUNCTIONS
+ */
+// --------------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------
+
+//!< \todo Clean up the uses of random +1/+2/-1/etc throughout the code
+ClusterDynamicsCpuImpl::ClusterDynamicsCpuImpl(ClusterDynamicsConfig& config,
+                                               size_t num_threads,
+                                               bool create_integrator)
+    : time(0.0),
+      jacobian_matrix(nullptr),
+      linear_solver(nullptr),
+      preconditioner_jacobian(nullptr),
+      preconditioner_matrix(nullptr),
+      preconditioner_solver(nullptr),
+      cvodes_memory_block(nullptr),
+      max_cluster_size(config.max_cluster_size),
+      num_threads(num_threads),
+      material(*config.material.impl()),
+      reactor(*config.reactor.impl()),
+      initial_config(config) {
+  initial_config.init_interstitials = {};
+  initial_config.init_vacancies = {};
+  max_cluster_size = config.max_cluster_size;
+  data_validation_on = config.data_validation_on;
+  relative_tolerance = config.relative_tolerance;
+  absolute_tolerance = config.absolute_tolerance;
+  max_num_integration_steps = config.max_num_integration_steps;
+  min_integration_step = config.min_integration_step;
+  max_integration_step = config.max_integration_step;
+  linear_solver_type = config.linear_solver;
+  krylov_subspace_size = config.krylov_subspace_size;
+  steady_state_max_time = config.steady_state_max_time;
+  transport_kernel = select_transport_kernel(detect_simd_level());
+
+  if (num_threads == 0)
+    throw ClusterDynamicsException("The number of threads must be at least 1.",
+                                   ClusterDynamicsState());
+  if (num_threads > 1) thread_pool = std::make_unique<ThreadPool>(num_threads);
+
+  if (config.group_threshold > 0) {
+    if (config.group_threshold < 4 || config.group_growth < 1.)
+      throw ClusterDynamicsException(
+          "Cluster grouping requires a group threshold of at least 4 and a "
+          "group growth of at least 1.",
+          ClusterDynamicsState());
+
+    // The sizes above the threshold are tracked by groups
+    if (config.group_threshold < config.max_cluster_size) {
+      max_cluster_size = config.group_threshold;
+      groups = make_cluster_groups(max_cluster_size + 1,
+                                   config.max_cluster_size,
+                                   config.group_growth);
+    }
+  }
+
+  if (config.continuum_threshold > 0) {
+    if (config.group_threshold > 0)
+      throw ClusterDynamicsException(
+          "Cluster grouping and the Fokker-Planck continuum are exclusive.",
+          ClusterDynamicsState());
+    if (config.continuum_threshold < 4 || config.continuum_growth < 1.)
+      throw ClusterDynamicsException(
+          "The Fokker-Planck continuum requires a continuum threshold of at "
+          "least 4 and a continuum growth of at least 1.",
+          ClusterDynamicsState());
+
+    // The sizes above the threshold follow the continuum
+    if (config.continuum_threshold < config.max_cluster_size) {
+      max_cluster_size = config.continuum_threshold;
+      continuum_cells = make_continuum_cells(max_cluster_size + 1,
+                                             config.max_cluster_size,
+                                             config.continuum_growth);
+    }
+  }
+
+  if (config.initial_max_cluster_size > 0) {
+    if (has_coarse_tail())
+      throw ClusterDynamicsException(
+          "The adaptive max cluster size is not supported with cluster "
+          "grouping or the Fokker-Planck continuum.",
+          ClusterDynamicsState());
+    if (config.initial_max_cluster_size < 4 || config.tail_threshold <= 0.)
+      throw ClusterDynamicsException(
+          "The adaptive max cluster size requires an initial max cluster size "
+          "of at least 4 and a positive tail threshold.",
+          ClusterDynamicsState());
+
+    if (config.initial_max_cluster_size < config.max_cluster_size) {
+      adaptive_max_cluster_size = true;
+      max_cluster_size_limit = config.max_cluster_size;
+      min_cluster_size_limit = config.initial_max_cluster_size;
+      tail_threshold = config.tail_threshold;
+
+      // Start large enough to hold every significant initial concentration
+      max_cluster_size = config.initial_max_cluster_size;
+      auto significant = [&](const std::vector<gp_float>& init, size_t size) {
+        for (size_t n = size - tail_width(size); n < init.size(); ++n)
+          if (init[n] >= tail_threshold) return true;
+        return false;
+      };
+      while (max_cluster_size < max_cluster_size_limit &&
+             (significant(config.init_interstitials, max_cluster_size) ||
+              significant(config.init_vacancies, max_cluster_size)))
+        max_cluster_size = std::min(growth_factor * max_cluster_size,
+                                    max_cluster_size_limit);
+    }
+  }
+
+  state_size = 2 * (max_cluster_size + 2) + 1 + 4 * groups.size() +
+               2 * continuum_cells.size();
+
+  reactor_history = config.reactor_history;
+  reactor_history.validate();
+  if (!reactor_history.empty()) follow_reactor_history(time);
+
+  coefficient_init();
+
+  /* Create the SUNDIALS context */
+  int sunerr = SUNContext_Create(SUN_COMM_NULL, &sun_context);
+  if (sunerr)
+    throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
+                                   ClusterDynamicsState());
+
+  /* Create the initial state */
+  state = new_state_vector();
+
+  /* Set State Aliases */
+  alias_state(state);
+
+  /* Initialize State Values */
+  const size_t num_exact_sizes =
+      has_coarse_tail() ? max_cluster_size + 1 : max_cluster_size;
+  for (size_t i = 0; i < num_exact_sizes; ++i) {
+    interstitials[i] = config.init_interstitials[i];
+    vacancies[i] = config.init_vacancies[i];
+  }
+
+  *dislocation_density = material.dislocation_density_0;
+  interstitials[max_cluster_size + 1] = 0.0;
+  vacancies[max_cluster_size + 1] = 0.0;
+
+  for (size_t g = 0; g < groups.size(); ++g) {
+    gp_float* i_moments = group_moments + 2 * g;
+    gp_float* v_moments = group_moments + 2 * (groups.size() + g);
+    i_moments[0] = i_moments[1] = v_moments[0] = v_moments[1] = 0.;
+    for (size_t n = groups[g].first; n <= groups[g].last; ++n) {
+      const gp_float offset = (gp_float)n - groups[g].mean;
+      if (n < config.init_interstitials.size()) {
+        i_moments[0] += config.init_interstitials[n];
+        i_moments[1] += offset * config.init_interstitials[n];
+      }
+      if (n < config.init_vacancies.size()) {
+        v_moments[0] += config.init_vacancies[n];
+        v_moments[1] += offset * config.init_vacancies[n];
+      }
+    }
+  }
+
+  const size_t K = continuum_cells.size();
+  for (size_t k = 0; k < K; ++k) {
+    gp_float& i_cell = continuum_concentrations[k];
+    gp_float& v_cell = continuum_concentrations[K + k];
+    i_cell = v_cell = 0.;
+    for (size_t n = continuum_cells[k].first;
+         n <= continuum_cells[k].last && n < config.init_interstitials.size();
+         ++n)
+      i_cell += config.init_interstitials[n];
+    for (size_t n = continuum_cells[k].first;
+         n <= continuum_cells[k].last && n < config.init_vacancies.size(); ++n)
+      v_cell += config.init_vacancies[n];
+  }
+
+  if (create_integrator) solver_init();
+}
+
+/** @brief Creates the integrator and the linear solver for the current state
+ * vector, starting at the current time.
+ */
+void ClusterDynamicsCpuImpl::solver_init() {
+  /* Call CVodeCreate to create the solver memory and specify the
+   * Backward Differentiation Formula */
+  cvodes_memory_block = CVodeCreate(CV_BDF, sun_context);
+
+  /* Call CVodeInit to initialize the integrator memory and specify the
+   * user's right hand side function in y'=f(t,y), the initial time T0, and
+   * the initial dependent variable vector y. */
+  int sunerr = CVodeInit(cvodes_memory_block, system, time, state);
+  if (sunerr)
+    throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
+                                   ClusterDynamicsState());
+
+  /* Call CVodeSVtolerances to specify the scalar relative tolerance
+   * and scalar absolute tolerances */
+  sunerr = CVodeSStolerances(cvodes_memory_block, relative_tolerance,
+                             absolute_tolerance);
+  if (sunerr)
+    throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
+                                   ClusterDynamicsState());
+
+  switch (linear_solver_type) {
+    case LinearSolverType::dense:
+      /* Create dense jacobian matrix */
+      jacobian_matrix = SUNDenseMatrix(state_size, state_size, sun_context);
+
+      /* Create dense SUNLinearSolver object for use by CVode */
+      linear_solver = SUNLinSol_Dense(state, jacobian_matrix, sun_context);
+      break;
+
+    case LinearSolverType::sparse:
+#if defined(GP_HAS_KLU)
+      /* Create the CSR jacobian matrix sized for the fixed sparsity pattern */
+      step_init();
+      jacobian_matrix = SUNSparseMatrix(state_size, state_size, jacobian_nnz(),
+                                        CSR_MAT, sun_context);
+
+      /* Create the KLU sparse direct SUNLinearSolver object for use by CVode */
+      linear_solver = SUNLinSol_KLU(state, jacobian_matrix, sun_context);
+      break;
+#else
+      throw ClusterDynamicsException(
+          "The sparse linear solver requires SUNDIALS to be built with KLU.",
+          ClusterDynamicsState());
+#endif
+
+    case LinearSolverType::arrowhead:
+      /* Create the bordered tridiagonal jacobian matrix */
+      jacobian_matrix =
+          SUNArrowheadMatrix(state_size, border_indices(), sun_context);
+
+      /* Create the linear time arrowhead SUNLinearSolver object */
+      linear_solver = SUNLinSol_Arrowhead(jacobian_matrix, sun_context);
+      break;
+
+    case LinearSolverType::gmres:
+    case LinearSolverType::bicgstab:
+      /* Matrix-free Krylov solvers only store the preconditioner, which is
+       * solved with the arrowhead solver on a border-free matrix */
+      preconditioner_jacobian =
+          SUNArrowheadMatrix(state_size, border_indices(), sun_context);
+      preconditioner_matrix = SUNMatClone(preconditioner_jacobian);
+      preconditioner_solver =
+          SUNLinSol_Arrowhead(preconditioner_matrix, sun_context);
+      if (!preconditioner_solver)
+        throw ClusterDynamicsException("Failed to create the preconditioner.",
+                                       ClusterDynamicsState());
+
+      linear_solver =
+          linear_solver_type == LinearSolverType::gmres
+              ? SUNLinSol_SPGMR(state, SUN_PREC_LEFT,
+                                krylov_subspace_size, sun_context)
+              : SUNLinSol_SPBCGS(state, SUN_PREC_LEFT,
+                                 krylov_subspace_size, sun_context);
+      break;
+  }
+
+  if (!linear_solver || (!jacobian_matrix && !preconditioner_solver))
+    throw ClusterDynamicsException("Failed to create the linear solver.",
+                                   ClusterDynamicsState());
+  linear_solver =
+      SUNLinSol_Timed(linear_solver, &phase_timer,
+                      &solver_stats.linear_setup_time,
+                      &solver_stats.linear_solve_time);
+
+  sunerr = CVodeSetUserData(cvodes_memory_block, static_cast<void*>(this));
+  if (sunerr)
+    throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
+                                   ClusterDynamicsState());
+
+  sunerr = CVodeSetMaxNumSteps(cvodes_memory_block, max_num_integration_steps);
+  if (sunerr)
+    throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
+                                   ClusterDynamicsState());
+
+  sunerr = CVodeSetMinStep(cvodes_memory_block, min_integration_step);
+  if (sunerr)
+    throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
+                                   ClusterDynamicsState());
+
+  sunerr = CVodeSetMaxStep(cvodes_memory_block, max_integration_step);
+  if (sunerr)
+    throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
+                                   ClusterDynamicsState());
+
+  // TODO - set to time delta?
+  sunerr = CVodeSetInitStep(cvodes_memory_block, 1e-5);
+  if (sunerr)
+    throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
+                                   ClusterDynamicsState());
+
+  /* Attach the matrix and linear solver */
+  sunerr =
+      CVodeSetLinearSolver(cvodes_memory_block, linear_solver, jacobian_matrix);
+  if (sunerr)
+    throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
+                                   ClusterDynamicsState());
+
+  if (jacobian_matrix) {
+    /* Use the analytic jacobian instead of difference quotients */
+    sunerr = CVodeSetJacFn(cvodes_memory_block, jacobian);
+    if (sunerr)
+      throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
+                                     ClusterDynamicsState());
+  } else {
+    /* Use analytic jacobian-vector products and the tridiagonal
+     * preconditioner for the matrix-free solvers */
+    sunerr =
+        CVodeSetJacTimes(cvodes_memory_block, nullptr, jacobian_times_vector);
+    if (sunerr)
+      throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
+                                     ClusterDynamicsState());
+
+    sunerr = CVodeSetPreconditioner(cvodes_memory_block, preconditioner_setup,
+                                    preconditioner_solve);
+    if (sunerr)
+      throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
+                                     ClusterDynamicsState());
+  }
+
+  if (adaptive_max_cluster_size) {
+    /* Stop the integration when the tail fills up to grow the state */
+    sunerr = CVodeRootInit(cvodes_memory_block, 1, tail_root);
+    if (sunerr)
+      throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
+                                     ClusterDynamicsState());
+
+    int filling_up = 1;
+    sunerr = CVodeSetRootDirection(cvodes_memory_block, &filling_up);
+    if (sunerr)
+      throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
+                                     ClusterDynamicsState());
+  }
+
+  // CVodeSetInterpolateStopTime(cvodes_memory_block, 1);
+}
+
+/** @brief Releases the integrator and the linear solver.
+ */
+void ClusterDynamicsCpuImpl::solver_free() {
+  SUNMatDestroy(jacobian_matrix);
+  SUNLinSolFree(linear_solver);
+  SUNMatDestroy(preconditioner_jacobian);
+  SUNMatDestroy(preconditioner_matrix);
+  SUNLinSolFree(preconditioner_solver);
+  CVodeFree(&cvodes_memory_block);
+  jacobian_matrix = nullptr;
+  linear_solver = nullptr;
+  preconditioner_jacobian = nullptr;
+  preconditioner_matrix = nullptr;
+  preconditioner_solver = nullptr;
+}
+
+namespace {
+
+/** @brief Returns the sum of term(i) over the entries of v.
+ *
+ * The entries are summed in blocks of parallel_block_size whose partial sums
+ * are added in block order. The OpenMP vector hands the blocks to its threads,
+ * so the sum does not depend on their number, unlike its own reductions.
+ */
+template <typename Term>
+sunrealtype block_sum(N_Vector v, Term term) {
+  static constexpr sunindextype block_size =
+      ClusterDynamicsCpuImpl::parallel_block_size;
+  const sunindextype length = N_VGetLength(v);
+  const sunindextype num_blocks = (length + block_size - 1) / block_size;
+  thread_local std::vector<sunrealtype> partial_sums;
+  partial_sums.assign(num_blocks, 0.);
+  sunrealtype* partials = partial_sums.data();
+
+  [[maybe_unused]] int num_threads = 1;
+#if defined(GP_HAS_NVECOPENMP)
+  if (N_VGetVectorID(v) == SUNDIALS_NVEC_OPENMP)
+    num_threads = NV_NUM_THREADS_OMP(v);
+#endif
+#if defined(_OPENMP)
+#pragma omp parallel for num_threads(num_threads) schedule(static)
+#endif
+  for (sunindextype block = 0; block < num_blocks; ++block) {
+    const sunindextype end = std::min(length, (block + 1) * block_size);
+    sunrealtype sum = 0.;
+    for (sunindextype i = block * block_size; i < end; ++i) sum += term(i);
+    partials[block] = sum;
+  }
+
+  sunrealtype sum = 0.;
+  for (sunindextype block = 0; block < num_blocks; ++block)
+    sum += partials[block];
+  return sum;
+}
+
+sunrealtype block_dot_prod(N_Vector x, N_Vector y) {
+  const sunrealtype* xd = N_VGetArrayPointer(x);
+  const sunrealtype* yd = N_VGetArrayPointer(y);
+  return block_sum(x, [=](sunindextype i) { return xd[i] * yd[i]; });
+}
+
+sunrealtype block_wrms_norm(N_Vector x, N_Vector w) {
+  const sunrealtype* xd = N_VGetArrayPointer(x);
+  const sunrealtype* wd = N_VGetArrayPointer(w);
+  const sunrealtype sum = block_sum(x, [=](sunindextype i) {
+    const sunrealtype weighted = xd[i] * wd[i];
+    return weighted * weighted;
+  });
+  return std::sqrt(sum / (sunrealtype)N_VGetLength(x));
+}
+
+sunrealtype block_wrms_norm_mask(N_Vector x, N_Vector w, N_Vector id) {
+  const sunrealtype* xd = N_VGetArrayPointer(x);
+  const sunrealtype* wd = N_VGetArrayPointer(w);
+  const sunrealtype* idd = N_VGetArrayPointer(id);
+  const sunrealtype sum = block_sum(x, [=](sunindextype i) {
+    const sunrealtype weighted = idd[i] > 0. ? xd[i] * wd[i] : 0.;
+    return weighted * weighted;
+  });
+  return std::sqrt(sum / (sunrealtype)N_VGetLength(x));
+}
+
+sunrealtype block_wl2_norm(N_Vector x, N_Vector w) {
+  const sunrealtype* xd = N_VGetArrayPointer(x);
+  const sunrealtype* wd = N_VGetArrayPointer(w);
+  return std::sqrt(block_sum(x, [=](sunindextype i) {
+    const sunrealtype weighted = xd[i] * wd[i];
+    return weighted * weighted;
+  }));
+}
+
+sunrealtype block_l1_norm(N_Vector x) {
+  const sunrealtype* xd = N_VGetArrayPointer(x);
+  return block_sum(x, [=](sunindextype i) { return std::abs(xd[i]); });
+}
+
+}  // namespace
+
+/** @brief Returns a new state vector of state_size entries.
+ *
+ * The single threaded backend keeps the stock serial vector. For the threaded
+ * backend the sums which CVODE takes the norms and Krylov dot products with
+ * are replaced by block_sum() ones, so that the integration does not depend
+ * on the number of threads. The vectors CVODE clones from it share those.
+ */
+N_Vector ClusterDynamicsCpuImpl::new_state_vector() const {
+  /// \todo Check errors
+  if (num_threads == 1) return N_VNew_Serial(state_size, sun_context);
+
+  N_Vector v_state = nullptr;
+#if defined(GP_HAS_NVECOPENMP)
+  // The threaded backend also spreads the vector operations of CVODE
+  v_state = N_VNew_OpenMP(state_size, num_threads, sun_context);
+#endif
+  if (!v_state) v_state = N_VNew_Serial(state_size, sun_context);
+
+  v_state->ops->nvdotprod = block_dot_prod;
+  v_state->ops->nvwrmsnorm = block_wrms_norm;
+  v_state->ops->nvwrmsnormmask = block_wrms_norm_mask;
+  v_state->ops->nvwl2norm = block_wl2_norm;
+  v_state->ops->nvl1norm = block_l1_norm;
+  // Without the fused operations SUNDIALS falls back on the ones above
+  v_state->ops->nvdotprodmulti = nullptr;
+  v_state->ops->nvdotprodmultilocal = nullptr;
+  v_state->ops->nvwrmsnormvectorarray = nullptr;
+  v_state->ops->nvwrmsnormmaskvectorarray = nullptr;
+  return v_state;
+}
+
+/** @brief Returns the number of largest cluster sizes whose concentrations
+ * are monitored by the adaptive max cluster size.
+ */
+size_t ClusterDynamicsCpuImpl::tail_width(size_t size) {
+  return std::max<size_t>(2, size / 8);
+}
+
+/** @brief Returns the largest concentration among the monitored tail sizes.
+ */
+gp_float ClusterDynamicsCpuImpl::tail_concentration(size_t first_size) const {
+  gp_float tail = 0.;
+  for (size_t n = first_size; n <= max_cluster_size; ++n)
+    tail = std::max({tail, interstitials[n], vacancies[n]});
+  return tail;
+}
+
+/** @brief CVODE root function, which crosses zero once the tail reaches the
+ * tail threshold.
+ */
+int ClusterDynamicsCpuImpl::tail_root([[maybe_unused]] double t,
+                                      N_Vector v_state, double* gout,
+                                      void* user_data) {
+  ClusterDynamicsCpuImpl* cd = static_cast<ClusterDynamicsCpuImpl*>(user_data);
+  cd->alias_state(v_state);
+  const size_t M = cd->max_cluster_size;
+  *gout = cd->tail_concentration(M + 1 - tail_width(M)) - cd->tail_threshold;
+  return 0;
+}
+
+/** @brief Moves the simulation to a new max cluster size at the current time.
+ *
+ * The concentrations of the sizes kept are copied, new sizes start empty.
+ * CVODE cannot change the length of its vectors, so the integrator and the
+ * linear solver are recreated, which restarts the integration at first order.
+ */
+void ClusterDynamicsCpuImpl::resize(size_t new_max_cluster_size) {
+  const size_t kept = std::min(max_cluster_size, new_max_cluster_size);
+  N_Vector old_state = state;
+  const gp_float* old_interstitials = interstitials;
+  const gp_float* old_vacancies = vacancies;
+  const gp_float old_dislocation_density = *dislocation_density;
+
+  max_cluster_size = new_max_cluster_size;
+  state_size = 2 * (max_cluster_size + 2) + 1;
+  state = new_state_vector();
+  N_VConst(0., state);
+  alias_state(state);
+  std::copy(old_interstitials, old_interstitials + kept + 1, interstitials);
+  std::copy(old_vacancies, old_vacancies + kept + 1, vacancies);
+  *dislocation_density = old_dislocation_density;
+  N_VDestroy(old_state);
+
+  perturbed_coefficient_cache.clear();
+  coefficient_init();
+  fold_integrator_stats();
+  solver_free();
+  solver_init();
+}
+
+ClusterDynamicsCpuImpl::~ClusterDynamicsCpuImpl() {
+  N_VDestroy(state);
+  if (adjoint_derivatives) {
+    N_VDestroy(adjoint_derivatives);
+    N_VDestroy(adjoint_parameter_derivatives);
+  }
+  if (sensitivities)
+    N_VDestroyVectorArray(sensitivities, sensitivity_parameters.size());
+  solver_free();
+  SUNContext_Free(&sun_context);
+}
+
+/** @brief Advances the simulation by total_time seconds.
+ *
+ * With a reactor history the integrator stops at every breakpoint before the
+ * end time, so no step straddles a change of the flux or temperature, and
+ * restarts from there with the values of the next segment. A run which ended
+ * on a breakpoint restarts at the beginning of the next run.
+ */
+void ClusterDynamicsCpuImpl::integrate(gp_float total_time) {
+  const gp_float end_time = time + total_time;
+  // The sinks need the integrator to stop at their times or after each step
+  if (!sinks.empty()) {
+    step_through({end_time}, ClusterDynamicsSampleFn());
+    return;
+  }
+
+  ScopedPhase phase(phase_timer, &solver_stats.integrator_time);
+  if (reactor_segment_pending()) start_reactor_segment();
+  while (true) {
+    const gp_float stop_time =
+        std::min(end_time, reactor_history.next_breakpoint(time));
+    if (!reactor_history.empty()) {
+      const int sunerr = CVodeSetStopTime(cvodes_memory_block, stop_time);
+      if (sunerr)
+        throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
+                                       ClusterDynamicsState());
+    }
+
+    double out_time;
+    const int sunerr =
+        CVode(cvodes_memory_block, stop_time, state, &out_time, CV_NORMAL);
+    if (sunerr < 0)
+      throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
+                                     ClusterDynamicsState());
+
+    time = out_time;
+    alias_state(state);
+
+    if (sunerr == CV_ROOT_RETURN) {
+      // The tail filled up, grow the state and carry on to the end time
+      tail_filled();
+      continue;
+    }
+
+    if (time >= end_time || reactor_history.empty()) break;
+    start_reactor_segment();
+  }
+
+  shrink_if_empty();
+}
+
+ClusterDynamicsState ClusterDynamicsCpuImpl::run(gp_float total_time) {
+  integrate(total_time);
+  return current_state(time);
+}
+
+/** @brief Runs the simulation like run() and copies the end state into
+ * state without allocating once its vectors are large enough.
+ */
+void ClusterDynamicsCpuImpl::run_into(gp_float total_time,
+                                      ClusterDynamicsState& state) {
+  integrate(total_time);
+  state_view(time).copy_to(state);
+}
+
+ClusterDynamicsState ClusterDynamicsCpuImpl::sample(
+    const std::vector<gp_float>& sample_times,
+    const ClusterDynamicsSampleFn& on_sample) {
+  sampling_time.reset();
+  if (sample_times.empty()) return current_state(time);
+  if (sample_times.front() < time ||
+      !std::is_sorted(sample_times.begin(), sample_times.end()))
+    throw ClusterDynamicsException(
+        "The sample times must be increasing and not before the current "
+        "time.",
+        current_state(time));
+
+  step_through(sample_times, on_sample);
+  return current_state(time);
+}
+
+/** @brief Runs the simulation in single steps up to the last sample time and
+ * interpolates the samples within the steps with CVodeGetDky().
+ *
+ * The registered sinks are passed the states at their times up to the last
+ * sample time and after every step. on_sample may be empty.
+ */
+void ClusterDynamicsCpuImpl::step_through(
+    const std::vector<gp_float>& sample_times,
+    const ClusterDynamicsSampleFn& on_sample) {
+  ScopedPhase phase(phase_timer, &solver_stats.integrator_time);
+
+  // The integrator also stops at the breakpoints of the reactor history
+  const gp_float end_time = sample_times.back();
+  gp_float stop_time = end_time;
+  auto set_stop_time = [&] {
+    stop_time = std::min(end_time, reactor_history.next_breakpoint(time));
+    const int sunerr = CVodeSetStopTime(cvodes_memory_block, stop_time);
+    if (sunerr)
+      throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
+                                     ClusterDynamicsState());
+  };
+  if (reactor_segment_pending()) start_reactor_segment();
+  set_stop_time();
+
+  std::unique_ptr<_generic_N_Vector, decltype(&N_VDestroy)> interpolated(
+      N_VClone(state), N_VDestroy);
+
+  // Emits every sample and sink time up to the time the integrator has
+  // reached, in order of time
+  const std::vector<gp_float> sink_times =
+      sinks.pending_times(time, end_time);
+  size_t next = 0;
+  size_t next_sink = 0;
+  auto emit_samples = [&] {
+    while (true) {
+      const bool sample_due =
+          next < sample_times.size() && sample_times[next] <= time;
+      const bool sink_due =
+          next_sink < sink_times.size() && sink_times[next_sink] <= time;
+      if (!sample_due && !sink_due) break;
+      gp_float t = sample_due ? sample_times[next] : sink_times[next_sink];
+      if (sample_due && sink_due) t = std::min(t, sink_times[next_sink]);
+
+      // The integrator's own state needs no interpolation, which also covers
+      // samples at the start before any step was taken
+      if (t < time) {
+        const int sunerr =
+            CVodeGetDky(cvodes_memory_block, t, 0, interpolated.get());
+        if (sunerr)
+          throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
+                                         current_state(time));
+        alias_state(interpolated.get());
+      }
+      sampling_time = t;
+      {
+        // The time spent by the callbacks is not the simulation's
+        ScopedPhase paused(phase_timer, nullptr);
+        const ClusterDynamicsStateView view = state_view(t);
+        if (sample_due && sample_times[next] == t) {
+          if (on_sample) {
+            view.copy_to(sample_buffer);
+            on_sample(sample_buffer);
+          }
+          ++next;
+        }
+        if (sink_due && sink_times[next_sink] == t) {
+          sinks.sample(t, view, get_stats());
+          ++next_sink;
+        }
+      }
+      sampling_time.reset();
+      alias_state(state);
+    }
+  };
+
+  emit_samples();
+  while (next < sample_times.size()) {
+    double out_time;
+    const int sunerr =
+        CVode(cvodes_memory_block, stop_time, state, &out_time, CV_ONE_STEP);
+    if (sunerr < 0)
+      throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
+                                     ClusterDynamicsState());
+
+    time = out_time;
+    alias_state(state);
+    emit_samples();
+    if (sinks.has_step_sinks()) {
+      ScopedPhase paused(phase_timer, nullptr);
+      sinks.step(state_view(time), get_stats());
+    }
+
+    if (sunerr == CV_ROOT_RETURN) {
+      // Growing the state restarts the integrator
+      tail_filled();
+      set_stop_time();
+      interpolated.reset(N_VClone(state));
+    } else if (time >= stop_time && time < end_time) {
+      start_reactor_segment();
+      set_stop_time();
+    }
+  }
+
+  shrink_if_empty();
+}
+
+/** @brief Grows the adaptive max cluster size after the tail root was found,
+ * or stops looking for it once the max cluster size limit is reached.
+ */
+void ClusterDynamicsCpuImpl::tail_filled() {
+  if (max_cluster_size < max_cluster_size_limit) {
+    resize(std::min(growth_factor * max_cluster_size, max_cluster_size_limit));
+    return;
+  }
+
+  const int sunerr = CVodeRootInit(cvodes_memory_block, 0, nullptr);
+  if (sunerr)
+    throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
+                                   ClusterDynamicsState());
+}
+
+/** @brief Halves the adaptive max cluster size once the upper half of the
+ * sizes and the tail monitored after shrinking have emptied.
+ */
+void ClusterDynamicsCpuImpl::shrink_if_empty() {
+  if (!adaptive_max_cluster_size) return;
+
+  const size_t half = max_cluster_size / 2;
+  if (half >= min_cluster_size_limit &&
+      tail_concentration(half + 1 - tail_width(half)) <
+          shrink_fraction * tail_threshold)
+    resize(half);
+}
+
+/** @brief Enters the segment of the reactor history at time t, setting the
+ * flux and temperature of the reactor to those at t. The coefficients must be
+ * recomputed after.
+ */
+void ClusterDynamicsCpuImpl::follow_reactor_history(gp_float t) {
+  const ReactorHistoryPoint point = reactor_history.at(t);
+  reactor.flux = point.flux;
+  reactor.temperature = point.temperature;
+  reactor_time = t;
+  reactor_segment_time = t;
+  reactor_ramping = reactor_history.ramps(t);
+}
+
+/** @brief Starts the segment of the reactor history at a breakpoint the
+ * integrator stopped at.
+ *
+ * Only the step history of the integrator is restarted, the linear solver
+ * and its matrices are kept.
+ */
+void ClusterDynamicsCpuImpl::start_reactor_segment() {
+  follow_reactor_history(time);
+  reactor_coefficient_init();
+  fold_integrator_stats();
+  const int sunerr = CVodeReInit(cvodes_memory_block, time, state);
+  if (sunerr)
+    throw ClusterDynamicsException(SUNGetErrMsg(sunerr), current_state(time));
+}
+
+/** @brief Whether the integrator stopped on a breakpoint of the reactor
+ * history at the end of an earlier run, without entering the segment that
+ * starts there.
+ */
+bool ClusterDynamicsCpuImpl::reactor_segment_pending() const {
+  return !reactor_history.empty() && time != reactor_segment_time &&
+         reactor_history.next_breakpoint(reactor_segment_time) <= time;
+}
+
+/** @brief Adds the counters of the integrator to solver_stats before it is
+ * reinitialized or freed, which resets them.
+ */
+void ClusterDynamicsCpuImpl::fold_integrator_stats() {
+  add_integrator_stats(solver_stats, integrator_stats(cvodes_memory_block));
+}
+
+/** @brief Returns the dose in dpa accumulated up to simulation time t.
+ */
+gp_float ClusterDynamicsCpuImpl::dose(gp_float t) const {
+  if (reactor_history.empty()) return t * reactor.flux;
+  return reactor_history.dose(t);
+}
+
+/** @brief Returns a view of the state the aliases point to, at simulation
+ * time t. Only the groups are copied, into interstitial_group_states and
+ * vacancy_group_states.
+ */
+ClusterDynamicsStateView ClusterDynamicsCpuImpl::state_view(gp_float t) const {
+  interstitial_group_states.clear();
+  vacancy_group_states.clear();
+
+  const size_t G = groups.size();
+  for (size_t g = 0; g < G; ++g) {
+    interstitial_group_states.push_back(
+        ClusterGroupState{.first_size = groups[g].first,
+                          .last_size = groups[g].last,
+                          .zeroth_moment = group_moments[2 * g],
+                          .first_moment = group_moments[2 * g + 1]});
+    vacancy_group_states.push_back(
+        ClusterGroupState{.first_size = groups[g].first,
+                          .last_size = groups[g].last,
+                          .zeroth_moment = group_moments[2 * (G + g)],
+                          .first_moment = group_moments[2 * (G + g) + 1]});
+  }
+
+  // Continuum cells are uniform, so they are groups without a first moment
+  const size_t K = continuum_cells.size();
+  for (size_t k = 0; k < K; ++k) {
+    interstitial_group_states.push_back(
+        ClusterGroupState{.first_size = continuum_cells[k].first,
+                          .last_size = continuum_cells[k].last,
+                          .zeroth_moment = continuum_concentrations[k],
+                          .first_moment = 0.});
+    vacancy_group_states.push_back(
+        ClusterGroupState{.first_size = continuum_cells[k].first,
+                          .last_size = continuum_cells[k].last,
+                          .zeroth_moment = continuum_concentrations[K + k],
+                          .first_moment = 0.});
+  }
+
+  // With grouping or the continuum the largest individually tracked size is
+  // returned as well, so the groups follow the last element
+  const size_t num_exact_sizes =
+      has_coarse_tail() ? max_cluster_size + 1 : max_cluster_size;
+  return ClusterDynamicsStateView{
+      .time = t,
+      .dpa = dose(t),
+      .interstitials = {interstitials, num_exact_sizes},
+      .vacancies = {vacancies, num_exact_sizes},
+      .dislocation_density = *dislocation_density,
+      .interstitial_groups = interstitial_group_states,
+      .vacancy_groups = vacancy_group_states};
+}
+
+/** @brief Returns a copy of the state the aliases point to, at simulation
+ * time t.
+ */
+ClusterDynamicsState ClusterDynamicsCpuImpl::current_state(gp_float t) const {
+  return state_view(t).to_state();
+}
+
+/** @brief Solves for the saturated distribution where every derivative
+ * vanishes, starting from the current state.
+ *
+ * The steady state is found with the pseudo-transient Newton iteration of
+ * steady_state_newton(). When it does not converge the simulation is
+ * integrated over growing spans of time, up to steady_state_max_time, and
+ * Newton is retried after each of them. The time is left unchanged when
+ * Newton converges from the current state.
+ */
+ClusterDynamicsState ClusterDynamicsCpuImpl::solve_steady_state() {
+  if (has_coarse_tail())
+    throw ClusterDynamicsException(
+        "The steady state solver is not supported with cluster grouping or "
+        "the Fokker-Planck continuum.",
+        current_state(time));
+  if (!sensitivity_parameters.empty())
+    throw ClusterDynamicsException(
+        "The steady state solver is not supported with sensitivities.",
+        current_state(time));
+  if (!reactor_history.empty())
+    throw ClusterDynamicsException(
+        "The steady state solver is not supported with a reactor history.",
+        current_state(time));
+
+  ScopedPhase phase(phase_timer, &solver_stats.integrator_time);
+
+  // The arrowhead structure holds the whole Jacobian of the ungrouped
+  // system, so it is used whatever the configured linear solver
+  std::unique_ptr<_generic_SUNMatrix, decltype(&SUNMatDestroy)> newton_matrix(
+      SUNArrowheadMatrix(state_size, border_indices(), sun_context),
+      SUNMatDestroy);
+  std::unique_ptr<_generic_SUNLinearSolver, decltype(&SUNLinSolFree)>
+      newton_solver(SUNLinSol_Arrowhead(newton_matrix.get(), sun_context),
+                    SUNLinSolFree);
+  if (!newton_solver)
+    throw ClusterDynamicsException(
+        "Failed to create the steady state linear solver.",
+        current_state(time));
+
+  const gp_float end_time = time + steady_state_max_time;
+  gp_float span = 1.;
+  while (!steady_state_newton(newton_matrix.get(), newton_solver.get())) {
+    if (time >= end_time)
+      throw ClusterDynamicsException(
+          "The steady state was not reached within the steady state max "
+          "time.",
+          current_state(time));
+
+    run(std::min(span, end_time - time));
+    span *= 10.;
+
+    // Growing the adaptive max cluster size changes the state layout
+    if (SUNArrowheadMatrix_Content(newton_matrix.get())->size !=
+        (sunindextype)state_size) {
+      newton_matrix.reset(
+          SUNArrowheadMatrix(state_size, border_indices(), sun_context));
+      newton_solver.reset(
+          SUNLinSol_Arrowhead(newton_matrix.get(), sun_context));
+    }
+  }
+
+  // Restart the integrator from the steady state
+  fold_integrator_stats();
+  const int sunerr = CVodeReInit(cvodes_memory_block, time, state);
+  if (sunerr)
+    throw ClusterDynamicsException(SUNGetErrMsg(sunerr), current_state(time));
+
+  return current_state(time);
+}
+
+/** @brief Returns the largest Newton correction of a single concentration,
+ * estimated from its derivative and the diagonal of the Jacobian, relative to
+ * the integration tolerances. The state is steady once it is at most 1.
+ *
+ * Scaling by the Jacobian keeps the estimate clear of the round off in the
+ * derivatives, which are sums of much larger gain and loss terms.
+ */
+gp_float ClusterDynamicsCpuImpl::steady_state_residual(
+    N_Vector v_state, N_Vector v_derivatives, SUNMatrix v_jacobian) const {
+  const gp_float* u = N_VGetArrayPointer(v_state);
+  const gp_float* f = N_VGetArrayPointer(v_derivatives);
+  const ArrowheadMatrixContent* J = SUNArrowheadMatrix_Content(v_jacobian);
+
+  gp_float residual = 0.;
+  for (size_t i = 0; i < state_size; ++i) {
+    if (f[i] == 0.) continue;
+
+    const sunindextype p = J->position[i];
+    const gp_float diagonal =
+        p >= 0 ? J->diagonal[p]
+               : J->corner[(-p - 1) * (J->num_border() + 1)];
+    const gp_float tolerance =
+        relative_tolerance * std::abs(u[i]) + absolute_tolerance;
+    residual = std::max(residual,
+                        std::abs(f[i]) / (std::abs(diagonal) * tolerance));
+  }
+
+  return residual;
+}
+
+/** @brief Runs the pseudo-transient continuation of the steady state from
+ * the current state, and moves the state there if it converges.
+ *
+ * Each iteration is a backward Euler step of length dt,
+ * \f$(I - dt J) \Delta C = dt f(C)\f$, and dt grows as the residual falls
+ * (switched evolution relaxation), so the iteration starts out following the
+ * time evolution and ends as Newton's method. Steps which make a
+ * concentration negative are retried with a shorter dt.
+ */
+bool ClusterDynamicsCpuImpl::steady_state_newton(
+    SUNMatrix newton_matrix, SUNLinearSolver newton_solver) {
+  std::unique_ptr<_generic_N_Vector, decltype(&N_VDestroy)> u(N_VClone(state),
+                                                              N_VDestroy);
+  std::unique_ptr<_generic_N_Vector, decltype(&N_VDestroy)> f(N_VClone(state),
+                                                              N_VDestroy);
+  std::unique_ptr<_generic_N_Vector, decltype(&N_VDestroy)> rhs(
+      N_VClone(state), N_VDestroy);
+  std::unique_ptr<_generic_N_Vector, decltype(&N_VDestroy)> step(
+      N_VClone(state), N_VDestroy);
+  std::unique_ptr<_generic_N_Vector, decltype(&N_VDestroy)> weights(
+      N_VClone(state), N_VDestroy);
+  N_VScale(1., state, u.get());
+
+  gp_float dt = std::max(min_integration_step, 1e-5);
+  gp_float previous_norm = 0.;
+  bool converged = false;
+  for (size_t k = 0; k < steady_state_max_iterations; ++k) {
+    if (system(time, u.get(), f.get(), this) ||
+        jacobian(time, u.get(), f.get(), newton_matrix, this, nullptr, nullptr,
+                 nullptr))
+      break;
+
+    if (steady_state_residual(u.get(), f.get(), newton_matrix) <= 1.) {
+      converged = true;
+      break;
+    }
+
+    // Switched evolution relaxation of the pseudo time step
+    gp_float* u_data = N_VGetArrayPointer(u.get());
+    gp_float* w_data = N_VGetArrayPointer(weights.get());
+    for (size_t i = 0; i < state_size; ++i)
+      w_data[i] =
+          1. / (relative_tolerance * std::abs(u_data[i]) + absolute_tolerance);
+    const gp_float norm = N_VWrmsNorm(f.get(), weights.get());
+    if (previous_norm > 0.)
+      dt = std::min(dt * std::clamp(2. * previous_norm / norm, .5, 1e3),
+                    max_integration_step);
+    previous_norm = norm;
+
+    // Retry with shorter steps until the concentrations stay positive
+    bool accepted = false;
+    while (!accepted && dt >= min_integration_step) {
+      if (SUNMatScaleAddI(-dt, newton_matrix) ||
+          SUNLinSolSetup(newton_solver, newton_matrix)) {
+        dt *= .1;
+        jacobian(time, u.get(), f.get(), newton_matrix, this, nullptr, nullptr,
+                 nullptr);
+        continue;
+      }
+
+      N_VScale(dt, f.get(), rhs.get());
+      accepted = !SUNLinSolSolve(newton_solver, newton_matrix, step.get(),
+                                 rhs.get(), 0.);
+
+      const gp_float* s = N_VGetArrayPointer(step.get());
+      for (size_t i = 0; accepted && i < state_size; ++i)
+        accepted =
+            std::isfinite(s[i]) && u_data[i] + s[i] >= -absolute_tolerance;
+
+      if (!accepted) {
+        dt *= .1;
+        jacobian(time, u.get(), f.get(), newton_matrix, this, nullptr, nullptr,
+                 nullptr);
+      }
+    }
+    if (!accepted) break;
+
+    N_VLinearSum(1., u.get(), 1., step.get(), u.get());
+    for (size_t i = 0; i < state_size; ++i)
+      u_data[i] = std::max(u_data[i], 0.);
+  }
+
+  if (converged) N_VScale(1., u.get(), state);
+  alias_state(state);
+  return converged;
+}
+
+/** @brief Returns the material or reactor field a sensitivity variable
+ * stands for.
+ */
+gp_float& ClusterDynamicsCpuImpl::sensitivity_parameter(
+    SensitivityVariable variable) {
+  switch (variable) {
+    case SensitivityVariable::interstitial_migration_ev:
+      return material.i_migration;
+    case SensitivityVariable::vacancy_migration_ev:
+      return material.v_migration;
+    case SensitivityVariable::interstitial_formation_ev:
+      return material.i_formation;
+    case SensitivityVariable::vacancy_formation_ev:
+      return material.v_formation;
+    case SensitivityVariable::interstitial_binding_ev:
+      return material.i_binding;
+    case SensitivityVariable::vacancy_binding_ev:
+      return material.v_binding;
+    case SensitivityVariable::initial_dislocation_density_cm:
+      return material.dislocation_density_0;
+    case SensitivityVariable::flux_dpa_s:
+      return reactor.flux;
+    case SensitivityVariable::temperature_kelvin:
+      return reactor.temperature;
+    case SensitivityVariable::dislocation_density_evolution:
+      return reactor.dislocation_density_evolution;
+    default:
+      throw ClusterDynamicsException("Unknown sensitivity variable.",
+                                     ClusterDynamicsState());
+  }
+}
+
+/** @brief Returns the names and fields of every material and reactor
+ * parameter, named like the accessors of Material and NuclearReactor.
+ */
+std::vector<std::pair<std::string, gp_float*>>
+ClusterDynamicsCpuImpl::model_parameters() {
+  return {
+      {"i_migration", &material.i_migration},
+      {"v_migration", &material.v_migration},
+      {"i_diffusion_0", &material.i_diffusion_0},
+      {"v_diffusion_0", &material.v_diffusion_0},
+      {"i_formation", &material.i_formation},
+      {"v_formation", &material.v_formation},
+      {"i_binding", &material.i_binding},
+      {"v_binding", &material.v_binding},
+      {"recombination_radius", &material.recombination_radius},
+      {"i_loop_bias", &material.i_loop_bias},
+      {"i_dislocation_bias", &material.i_dislocation_bias},
+      {"i_dislocation_bias_param", &material.i_dislocation_bias_param},
+      {"v_loop_bias", &material.v_loop_bias},
+      {"v_dislocation_bias", &material.v_dislocation_bias},
+      {"v_dislocation_bias_param", &material.v_dislocation_bias_param},
+      {"dislocation_density_0", &material.dislocation_density_0},
+      {"grain_size", &material.grain_size},
+      {"lattice_param", &material.lattice_param},
+      {"burgers_vector", &material.burgers_vector},
+      {"atomic_volume", &material.atomic_volume},
+      {"flux", &reactor.flux},
+      {"temperature", &reactor.temperature},
+      {"recombination", &reactor.recombination},
+      {"i_bi", &reactor.i_bi},
+      {"i_tri", &reactor.i_tri},
+      {"i_quad", &reactor.i_quad},
+      {"v_bi", &reactor.v_bi},
+      {"v_tri", &reactor.v_tri},
+      {"v_quad", &reactor.v_quad},
+      {"dislocation_density_evolution", &reactor.dislocation_density_evolution},
+  };
+}
+
+/** @brief Returns the coefficient tables the material or reactor field enters.
+ */
+CoefficientDependency ClusterDynamicsCpuImpl::coefficient_dependency(
+    const gp_float* parameter) const {
+  for (const gp_float* field :
+       {&material.recombination_radius, &material.dislocation_density_0,
+        &material.grain_size, &reactor.dislocation_density_evolution}) {
+    if (parameter == field) return CoefficientDependency::none;
+  }
+  for (const gp_float* field :
+       {&reactor.flux, &reactor.recombination, &reactor.i_bi, &reactor.i_tri,
+        &reactor.i_quad, &reactor.v_bi, &reactor.v_tri, &reactor.v_quad}) {
+    if (parameter == field) return CoefficientDependency::production;
+  }
+  for (const gp_float* field :
+       {&material.i_migration, &material.v_migration, &material.i_diffusion_0,
+        &material.v_diffusion_0, &reactor.temperature}) {
+    if (parameter == field) return CoefficientDependency::reactor;
+  }
+
+  // The energies, biases and lengths enter the size only tables
+  return CoefficientDependency::material;
+}
+
+/** @brief Calls f(member, perturbed member) for each coefficient table of the
+ * dependency of perturbed.
+ */
+template <typename F>
+void ClusterDynamicsCpuImpl::visit_coefficients(
+    PerturbedCoefficients& perturbed, F&& f) {
+  if (perturbed.dependency == CoefficientDependency::none) return;
+
+  f(i_defect_production_val, perturbed.i_defect_production_val);
+  f(v_defect_production_val, perturbed.v_defect_production_val);
+  if (perturbed.dependency == CoefficientDependency::production) return;
+
+  f(i_diffusion_val, perturbed.i_diffusion_val);
+  f(v_diffusion_val, perturbed.v_diffusion_val);
+  f(emission_temperatures, perturbed.emission_temperatures);
+  f(ii_emission_val, perturbed.ii_emission_val);
+  f(vv_emission_val, perturbed.vv_emission_val);
+  f(ii_absorption_val, perturbed.ii_absorption_val);
+  f(iv_absorption_val, perturbed.iv_absorption_val);
+  f(vi_absorption_val, perturbed.vi_absorption_val);
+  f(vv_absorption_val, perturbed.vv_absorption_val);
+  f(i_dislocation_loop_unfault_probability_val,
+    perturbed.i_dislocation_loop_unfault_probability_val);
+  f(i_promotion_factor_val, perturbed.i_promotion_factor_val);
+  f(groups, perturbed.groups);
+  f(continuum_cells, perturbed.continuum_cells);
+  if (perturbed.dependency == CoefficientDependency::reactor) return;
+
+  f(cluster_radius_val, perturbed.cluster_radius_val);
+  f(i_capture_val, perturbed.i_capture_val);
+  f(v_capture_val, perturbed.v_capture_val);
+  f(i_binding_energy_val, perturbed.i_binding_energy_val);
+  f(v_binding_energy_val, perturbed.v_binding_energy_val);
+  f(emission_energy_spread, perturbed.emission_energy_spread);
+}
+
+/** @brief Returns the coefficient tables at parameter + delta.
+ *
+ * Only the tables the field enters are rebuilt, once, and kept in
+ * perturbed_coefficient_cache until the material, the reactor or the sizes
+ * change, so each difference quotient only swaps them in.
+ */
+PerturbedCoefficients& ClusterDynamicsCpuImpl::perturbed_coefficients(
+    gp_float& parameter, gp_float delta) {
+  PerturbedCoefficients& perturbed = perturbed_coefficient_cache[&parameter];
+  if (perturbed.delta == delta) return perturbed;
+
+  perturbed.dependency = coefficient_dependency(&parameter);
+  perturbed.delta = delta;
+
+  // Keep the current tables, rebuild them at the perturbed value and swap
+  // the current ones back in
+  visit_coefficients(perturbed, [](auto& current, auto& kept) {
+    kept = current;
+  });
+  const gp_float original = parameter;
+  parameter = original + delta;
+  switch (perturbed.dependency) {
+    case CoefficientDependency::none:
+      break;
+    case CoefficientDependency::production:
+      production_coefficient_init();
+      break;
+    case CoefficientDependency::reactor:
+      reactor_coefficient_init();
+      break;
+    case CoefficientDependency::material:
+      coefficient_init();
+      break;
+  }
+  parameter = original;
+  visit_coefficients(perturbed, [](auto& current, auto& kept) {
+    std::swap(current, kept);
+  });
+
+  return perturbed;
+}
+
+/** @brief Writes the forward difference quotient of system() in one of the
+ * material or reactor fields to v_parameter_derivatives.
+ *
+ * The fields enter system() through the coefficient tables, whose values at
+ * the perturbed field are swapped in from perturbed_coefficients(). The
+ * production rates only enter the derivatives of sizes 1 to 4, whose
+ * quotients are taken from the tables without evaluating system(). The step
+ * is relative to the larger of the field's magnitude and scale.
+ */
+int ClusterDynamicsCpuImpl::parameter_derivative(
+    gp_float& parameter, gp_float scale, double t, N_Vector v_state,
+    N_Vector v_state_derivatives, N_Vector v_parameter_derivatives) {
+  const gp_float original = parameter;
+  const gp_float delta = std::sqrt(std::numeric_limits<gp_float>::epsilon()) *
+                         std::max(std::abs(original), scale);
+  PerturbedCoefficients& perturbed = perturbed_coefficients(parameter, delta);
+
+  if (perturbed.dependency == CoefficientDependency::production) {
+    N_VConst(0., v_parameter_derivatives);
+    gp_float* derivatives = N_VGetArrayPointer(v_parameter_derivatives);
+    for (size_t n = 1; n < std::min<size_t>(max_cluster_size + 1, 5); ++n) {
+      derivatives[i_index(n)] = (perturbed.i_defect_production_val[n] -
+                                 i_defect_production_val[n]) /
+                                delta;
+      derivatives[v_index(n)] = (perturbed.v_defect_production_val[n] -
+                                 v_defect_production_val[n]) /
+                                delta;
+    }
+    return 0;
+  }
+
+  auto swap_tables = [](auto& current, auto& kept) {
+    std::swap(current, kept);
+  };
+  parameter = original + delta;
+  visit_coefficients(perturbed, swap_tables);
+  const int sunerr = system(t, v_state, v_parameter_derivatives, this);
+  visit_coefficients(perturbed, swap_tables);
+  parameter = original;
+  if (sunerr) return sunerr;
+
+  N_VLinearSum(1. / delta, v_parameter_derivatives, -1. / delta,
+               v_state_derivatives, v_parameter_derivatives);
+  return 0;
+}
+
+/** @brief CVODES right hand side of the forward sensitivity equations,
+ * \f$\dot{s} = J s + \partial f / \partial p\f$.
+ *
+ * J s uses the analytic Jacobian and \f$\partial f / \partial p\f$ comes
+ * from parameter_derivative().
+ */
+int ClusterDynamicsCpuImpl::sensitivity_rhs(
+    [[maybe_unused]] int num_sensitivities, double t, N_Vector v_state,
+    N_Vector v_state_derivatives, int s, N_Vector v_sensitivity,
+    N_Vector v_sensitivity_derivatives, void* user_data, N_Vector tmp1,
+    [[maybe_unused]] N_Vector tmp2) {
+  ClusterDynamicsCpuImpl* cd = static_cast<ClusterDynamicsCpuImpl*>(user_data);
+  jacobian_times_vector(v_sensitivity, v_sensitivity_derivatives, t, v_state,
+                        v_state_derivatives, user_data, nullptr);
+
+  // The initial dislocation density only enters the initial state
+  const SensitivityVariable variable = cd->sensitivity_parameters[s];
+  if (variable == SensitivityVariable::initial_dislocation_density_cm)
+    return 0;
+
+  const int sunerr = cd->parameter_derivative(
+      cd->sensitivity_parameter(variable), cd->sensitivity_scales[s], t,
+      v_state, v_state_derivatives, tmp1);
+  if (sunerr) return sunerr;
+
+  N_VLinearSum(1., v_sensitivity_derivatives, 1., tmp1,
+               v_sensitivity_derivatives);
+
+  return 0;
+}
+
+/** @brief Integrates the derivatives of the state with respect to the given
+ * variables along with it from now on.
+ *
+ * The sensitivities start out at zero, apart from that of the dislocation
+ * density to the initial dislocation density at time 0. The integrator
+ * restarts at first order.
+ */
+void ClusterDynamicsCpuImpl::enable_sensitivities(
+    const std::vector<SensitivityVariable>& variables) {
+  if (has_coarse_tail() || adaptive_max_cluster_size)
+    throw ClusterDynamicsException(
+        "Sensitivities are not supported with cluster grouping, the "
+        "Fokker-Planck continuum or the adaptive max cluster size.",
+        current_state(time));
+  if (!reactor_history.empty())
+    throw ClusterDynamicsException(
+        "Sensitivities are not supported with a reactor history.",
+        current_state(time));
+  if (variables.empty())
+    throw ClusterDynamicsException("No sensitivity variables were given.",
+                                   current_state(time));
+
+  std::vector<gp_float> scales;
+  for (SensitivityVariable variable : variables) {
+    const gp_float value = std::abs(sensitivity_parameter(variable));
+    scales.push_back(value > 0. ? value : 1.);
+  }
+
+  if (sensitivities) {
+    CVodeSensFree(cvodes_memory_block);
+    N_VDestroyVectorArray(sensitivities, sensitivity_parameters.size());
+  }
+  sensitivity_parameters = variables;
+  sensitivity_scales = scales;
+  const int num_sensitivities = variables.size();
+  sensitivities = N_VCloneVectorArray(num_sensitivities, state);
+  for (int s = 0; s < num_sensitivities; ++s) {
+    N_VConst(0., sensitivities[s]);
+    if (variables[s] == SensitivityVariable::initial_dislocation_density_cm &&
+        time == 0.)
+      N_VGetArrayPointer(sensitivities[s])[dislocation_index()] = 1.;
+  }
+
+  fold_integrator_stats();
+  int sunerr = CVodeReInit(cvodes_memory_block, time, state);
+  if (sunerr)
+    throw ClusterDynamicsException(SUNGetErrMsg(sunerr), current_state(time));
+
+  sunerr = CVodeSensInit1(cvodes_memory_block, num_sensitivities,
+                          CV_STAGGERED, sensitivity_rhs, sensitivities);
+  if (sunerr)
+    throw ClusterDynamicsException(SUNGetErrMsg(sunerr), current_state(time));
+
+  sunerr = CVodeSetSensParams(cvodes_memory_block, nullptr,
+                              sensitivity_scales.data(), nullptr);
+  if (sunerr)
+    throw ClusterDynamicsException(SUNGetErrMsg(sunerr), current_state(time));
+
+  /* Derive the sensitivity tolerances from the state tolerances and the
+   * parameter magnitudes, and include the sensitivities in the error test */
+  sunerr = CVodeSensEEtolerances(cvodes_memory_block);
+  if (sunerr)
+    throw ClusterDynamicsException(SUNGetErrMsg(sunerr), current_state(time));
+
+  sunerr = CVodeSetSensErrCon(cvodes_memory_block, SUNTRUE);
+  if (sunerr)
+    throw ClusterDynamicsException(SUNGetErrMsg(sunerr), current_state(time));
+}
+
+/** @brief Returns the sensitivities at the current time, or at the sample
+ * time inside a sample() callback.
+ */
+std::vector<ClusterDynamicsSensitivity>
+ClusterDynamicsCpuImpl::get_sensitivities() const {
+  if (sensitivity_parameters.empty())
+    throw ClusterDynamicsException("Sensitivities are not enabled.",
+                                   current_state(time));
+
+  const size_t num_sensitivities = sensitivity_parameters.size();
+  const gp_float t = sampling_time.value_or(time);
+  std::unique_ptr<N_Vector, std::function<void(N_Vector*)>> values(
+      N_VCloneVectorArray(num_sensitivities, state), [&](N_Vector* vectors) {
+        N_VDestroyVectorArray(vectors, num_sensitivities);
+      });
+  const int sunerr = CVodeGetSensDky(cvodes_memory_block, t, 0, values.get());
+  if (sunerr)
+    throw ClusterDynamicsException(SUNGetErrMsg(sunerr), current_state(time));
+
+  std::vector<ClusterDynamicsSensitivity> result;
+  for (size_t s = 0; s < num_sensitivities; ++s) {
+    const gp_float* data = N_VGetArrayPointer(values.get()[s]);
+    const gp_float* i_data = data + i_index(0);
+    const gp_float* v_data = data + v_index(0);
+    result.push_back(ClusterDynamicsSensitivity{
+        .variable = sensitivity_parameters[s],
+        .time = t,
+        .interstitials =
+            std::vector<gp_float>(i_data, i_data + max_cluster_size),
+        .vacancies = std::vector<gp_float>(v_data, v_data + max_cluster_size),
+        .dislocation_density = data[dislocation_index()]});
+  }
+
+  return result;
+}
+
+/** @brief Writes the gradient of a scalar observable with respect to the
+ * state to v_gradient.
+ */
+void ClusterDynamicsCpuImpl::observable_gradient(ScalarObservable observable,
+                                                 N_Vector v_gradient) const {
+  N_VConst(0., v_gradient);
+  gp_float* gradient = N_VGetArrayPointer(v_gradient);
+  switch (observable) {
+    case ScalarObservable::dislocation_density:
+      gradient[dislocation_index()] = 1.;
+      break;
+    case ScalarObservable::vacancy_cluster_volume:
+      for (size_t n = 2; n < max_cluster_size; ++n)
+        gradient[v_index(n)] = (gp_float)n * material.atomic_volume;
+      break;
+  }
+}
+
+/** @brief CVODES right hand side of the adjoint equations,
+ * \f$\dot{\lambda} = -J^T \lambda\f$, along the forward solution.
+ */
+int ClusterDynamicsCpuImpl::adjoint_rhs([[maybe_unused]] double t,
+                                        N_Vector v_state, N_Vector v_adjoint,
+                                        N_Vector v_adjoint_derivatives,
+                                        void* user_data) {
+  ClusterDynamicsCpuImpl* cd = static_cast<ClusterDynamicsCpuImpl*>(user_data);
+  ScopedPhase phase(cd->phase_timer, &cd->solver_stats.rhs_time);
+  cd->alias_state(v_state);
+
+  cd->step_init();
+
+  N_VConst(0.0, v_adjoint_derivatives);
+  AdjointMatvecJacobianWriter writer(N_VGetArrayPointer(v_adjoint),
+                                     N_VGetArrayPointer(v_adjoint_derivatives));
+  cd->jacobian_entries(writer);
+
+  return 0;
+}
+
+/** @brief CVODES Jacobian of adjoint_rhs(), \f$-J^T\f$.
+ */
+int ClusterDynamicsCpuImpl::adjoint_jacobian(
+    [[maybe_unused]] double t, N_Vector v_state,
+    [[maybe_unused]] N_Vector v_adjoint,
+    [[maybe_unused]] N_Vector v_adjoint_derivatives, SUNMatrix jacobian_matrix,
+    void* user_data, [[maybe_unused]] N_Vector tmp1,
+    [[maybe_unused]] N_Vector tmp2, [[maybe_unused]] N_Vector tmp3) {
+  ClusterDynamicsCpuImpl* cd = static_cast<ClusterDynamicsCpuImpl*>(user_data);
+  ScopedPhase phase(cd->phase_timer, &cd->solver_stats.jacobian_time);
+  cd->alias_state(v_state);
+
+  cd->step_init();
+
+  SUNMatZero(jacobian_matrix);
+  AdjointArrowheadJacobianWriter writer(jacobian_matrix);
+  cd->jacobian_entries(writer);
+
+  return writer.is_valid() ? 0 : -1;
+}
+
+/** @brief CVODES right hand side of the gradient quadratures,
+ * \f$-\lambda^T \partial f / \partial p\f$ for each of the
+ * gradient_parameters.
+ *
+ * Integrated backwards from the end time, the quadratures sum up
+ * \f$\int \lambda^T \partial f / \partial p \, dt\f$ over the run.
+ */
+int ClusterDynamicsCpuImpl::adjoint_quadrature(
+    double t, N_Vector v_state, N_Vector v_adjoint,
+    N_Vector v_quadrature_derivatives, void* user_data) {
+  ClusterDynamicsCpuImpl* cd = static_cast<ClusterDynamicsCpuImpl*>(user_data);
+  if (!cd->adjoint_derivatives) {
+    cd->adjoint_derivatives = N_VClone(v_state);
+    cd->adjoint_parameter_derivatives = N_VClone(v_state);
+  }
+  N_Vector derivatives = cd->adjoint_derivatives;
+  N_Vector parameter_derivatives = cd->adjoint_parameter_derivatives;
+
+  int sunerr = system(t, v_state, derivatives, user_data);
+  if (sunerr) return sunerr;
+
+  gp_float* quadrature_derivatives =
+      N_VGetArrayPointer(v_quadrature_derivatives);
+  for (size_t k = 0; k < cd->gradient_parameters.size(); ++k) {
+    gp_float* parameter = cd->gradient_parameters[k].second;
+    // The initial dislocation density only enters the initial state
+    if (parameter == &cd->material.dislocation_density_0) {
+      quadrature_derivatives[k] = 0.;
+      continue;
+    }
+
+    sunerr = cd->parameter_derivative(*parameter, cd->gradient_scales[k], t,
+                                      v_state, derivatives,
+                                      parameter_derivatives);
+    if (sunerr) return sunerr;
+    quadrature_derivatives[k] = -N_VDotProd(v_adjoint, parameter_derivatives);
+  }
+
+  return 0;
+}
+
+/** @brief Runs the simulation for total_time and returns the gradient of an
+ * observable of the end state with respect to every model_parameters() field.
+ *
+ * The forward run stores a checkpoint every adjoint_checkpoint_steps steps.
+ * The adjoint equations and the gradient quadratures are then integrated
+ * back to the start with the arrowhead solver, recomputing the forward
+ * solution between the checkpoints. The initial dislocation density only
+ * enters through the initial state, so it is only covered from time 0. The
+ * integrator restarts at first order from the end state.
+ */
+std::map<std::string, gp_float> ClusterDynamicsCpuImpl::adjoint_gradient(
+    gp_float total_time, ScalarObservable observable) {
+  if (has_coarse_tail() || adaptive_max_cluster_size)
+    throw ClusterDynamicsException(
+        "Adjoint gradients are not supported with cluster grouping, the "
+        "Fokker-Planck continuum or the adaptive max cluster size.",
+        current_state(time));
+  if (!sensitivity_parameters.empty())
+    throw ClusterDynamicsException(
+        "Adjoint gradients can not be combined with forward sensitivities.",
+        current_state(time));
+  if (!reactor_history.empty())
+    throw ClusterDynamicsException(
+        "Adjoint gradients are not supported with a reactor history.",
+        current_state(time));
+
+  ScopedPhase phase(phase_timer, &solver_stats.integrator_time);
+
+  auto check = [&](int sunerr) {
+    if (sunerr)
+      throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
+                                     current_state(time));
+  };
+
+  gradient_parameters = model_parameters();
+  gradient_scales.clear();
+  for (const auto& [name, field] : gradient_parameters)
+    gradient_scales.push_back(*field != 0. ? std::abs(*field) : 1.);
+
+  const size_t num_parameters = gradient_parameters.size();
+  std::unique_ptr<_generic_N_Vector, decltype(&N_VDestroy)> adjoint(
+      N_VClone(state), N_VDestroy);
+  std::unique_ptr<_generic_N_Vector, decltype(&N_VDestroy)> quadrature(
+      N_VNew_Serial(num_parameters, sun_context), N_VDestroy);
+  std::unique_ptr<_generic_SUNMatrix, decltype(&SUNMatDestroy)> matrix(
+      SUNArrowheadMatrix(state_size, border_indices(), sun_context),
+      SUNMatDestroy);
+  std::unique_ptr<_generic_SUNLinearSolver, decltype(&SUNLinSolFree)> solver(
+      SUNLinSol_Arrowhead(matrix.get(), sun_context), SUNLinSolFree);
+
+  // Frees the checkpoints and the adjoint integrator on every exit path,
+  // before the solver they use
+  check(CVodeAdjInit(cvodes_memory_block, adjoint_checkpoint_steps,
+                     CV_HERMITE));
+  std::unique_ptr<void, decltype(&CVodeAdjFree)> adjoint_memory(
+      cvodes_memory_block, CVodeAdjFree);
+
+  const gp_float start_time = time;
+  double out_time;
+  int num_checkpoints;
+  check(CVodeF(cvodes_memory_block, time + total_time, state, &out_time,
+               CV_NORMAL, &num_checkpoints));
+  time = out_time;
+  alias_state(state);
+
+  /* The adjoint starts from the gradient of the observable at the end
+   * state, which the vacancy cluster volume also depends on through the
+   * atomic volume */
+  observable_gradient(observable, adjoint.get());
+  std::map<std::string, gp_float> gradient;
+  if (observable == ScalarObservable::vacancy_cluster_volume)
+    gradient["atomic_volume"] =
+        N_VDotProd(adjoint.get(), state) / material.atomic_volume;
+  N_VConst(0., quadrature.get());
+
+  int which;
+  check(CVodeCreateB(cvodes_memory_block, CV_BDF, &which));
+  check(CVodeInitB(cvodes_memory_block, which, adjoint_rhs, time,
+                   adjoint.get()));
+  check(CVodeSStolerancesB(cvodes_memory_block, which, relative_tolerance,
+                           relative_tolerance * N_VMaxNorm(adjoint.get())));
+  check(CVodeSetUserDataB(cvodes_memory_block, which, this));
+  check(CVodeSetMaxNumStepsB(cvodes_memory_block, which,
+                             max_num_integration_steps));
+  check(CVodeSetMaxStepB(cvodes_memory_block, which, max_integration_step));
+  check(CVodeSetLinearSolverB(cvodes_memory_block, which, solver.get(),
+                              matrix.get()));
+  check(CVodeSetJacFnB(cvodes_memory_block, which, adjoint_jacobian));
+  check(CVodeQuadInitB(cvodes_memory_block, which, adjoint_quadrature,
+                       quadrature.get()));
+
+  check(CVodeB(cvodes_memory_block, start_time, CV_NORMAL));
+  check(CVodeGetB(cvodes_memory_block, which, &out_time, adjoint.get()));
+  check(CVodeGetQuadB(cvodes_memory_block, which, &out_time,
+                      quadrature.get()));
+
+  const gp_float* integrals = N_VGetArrayPointer(quadrature.get());
+  for (size_t k = 0; k < num_parameters; ++k)
+    gradient[gradient_parameters[k].first] += integrals[k];
+  if (start_time == 0.)
+    gradient["dislocation_density_0"] +=
+        N_VGetArrayPointer(adjoint.get())[dislocation_index()];
+  gradient_parameters.clear();
+  gradient_scales.clear();
+
+  // Recomputing the forward solution moved the integrator away from the end
+  adjoint_memory.reset();
+  alias_state(state);
+  fold_integrator_stats();
+  check(CVodeReInit(cvodes_memory_block, time, state));
+
+  return gradient;
+}
+
+MaterialImpl ClusterDynamicsCpuImpl::get_material() const { return material; }
+
+void ClusterDynamicsCpuImpl::set_material(const MaterialImpl& material) {
+  this->material = MaterialImpl(material);
+  perturbed_coefficient_cache.clear();
+  coefficient_init();
+}
+
+NuclearReactorImpl ClusterDynamicsCpuImpl::get_reactor() const {
+  return reactor;
+}
+
+void ClusterDynamicsCpuImpl::set_reactor(const NuclearReactorImpl& reactor) {
+  this->reactor = NuclearReactorImpl(reactor);
+  perturbed_coefficient_cache.clear();
+  if (!reactor_history.empty()) follow_reactor_history(time);
+  reactor_coefficient_init();
+}
+
+gp_float ClusterDynamicsCpuImpl::get_time() const { return time; }
+
+ClusterDynamicsStateView ClusterDynamicsCpuImpl::get_state_view() const {
+  return state_view(sampling_time.value_or(time));
+}
+
+/** @brief Returns the counters of the integrators folded so far plus those of
+ * the current integrator, and the phase times.
+ */
+ClusterDynamicsStats ClusterDynamicsCpuImpl::get_stats() const {
+  ClusterDynamicsStats stats = solver_stats;
+  add_integrator_stats(stats, integrator_stats(cvodes_memory_block));
+  return stats;
+}
+
+// --------------------------------------------------------------------------------------------
+/*
+ *  CHECKPOINTS
+ *
+ *  A checkpoint is a binary file in native byte order holding the checkpoint
+ *  magic and version, the config scalars, the raw material and reactor
+ *  parameters, the reactor history, the integrator position and the state
+ *  vector. It is readable only on a host of the same endianness. Sizes are
+ *  stored as 64 bit integers so the files move between such hosts.
+ */
+// --------------------------------------------------------------------------------------------
+
+namespace {
+
+constexpr char checkpoint_magic[8] = {'G', 'P', 'I', 'E', 'S', 'C', 'K', 'P'};
+constexpr std::uint32_t checkpoint_version = 2;
+
+static_assert(std::is_trivially_copyable_v<MaterialImpl> &&
+                  std::is_trivially_copyable_v<NuclearReactorImpl>,
+              "Checkpoints store the material and reactor parameters raw");
+
+template <typename T>
+void write_value(std::ostream& out, const T& value) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+T read_value(std::istream& in, const std::string& path) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  T value;
+  if (!in.read(reinterpret_cast<char*>(&value), sizeof(T)))
+    throw ClusterDynamicsException("Truncated checkpoint " + path + ".",
+                                   ClusterDynamicsState());
+  return value;
+}
+
+}  // namespace
+
+/** @brief Writes the simulation to a checkpoint file which from_checkpoint()
+ * resumes from.
+ *
+ * The file is written next to path first and then renamed over it, so an
+ * interrupted save leaves the previous checkpoint intact.
+ */
+void ClusterDynamicsCpuImpl::save_checkpoint(const std::string& path) const {
+  gp_float step = 0.;
+  int order = 0;
+  CVodeGetCurrentStep(cvodes_memory_block, &step);
+  CVodeGetCurrentOrder(cvodes_memory_block, &order);
+
+  const std::string temporary_path = path + ".tmp";
+  std::ofstream out(temporary_path, std::ios::binary | std::ios::trunc);
+  if (!out)
+    throw ClusterDynamicsException(
+        "Could not open checkpoint " + temporary_path + " for writing.",
+        current_state(time));
+
+  out.write(checkpoint_magic, sizeof(checkpoint_magic));
+  write_value(out, checkpoint_version);
+  write_value<std::uint8_t>(out, sizeof(gp_float));
+
+  // Config
+  write_value<std::uint64_t>(out, initial_config.max_cluster_size);
+  write_value<std::uint8_t>(out, data_validation_on);
+  write_value(out, relative_tolerance);
+  write_value(out, absolute_tolerance);
+  write_value<std::uint64_t>(out, max_num_integration_steps);
+  write_value(out, min_integration_step);
+  write_value(out, max_integration_step);
+  write_value<std::uint32_t>(out, (std::uint32_t)linear_solver_type);
+  write_value<std::uint64_t>(out, krylov_subspace_size);
+  write_value<std::uint64_t>(out, initial_config.group_threshold);
+  write_value(out, initial_config.group_growth);
+  write_value<std::uint64_t>(out, initial_config.continuum_threshold);
+  write_value(out, initial_config.continuum_growth);
+  write_value<std::uint64_t>(out, initial_config.initial_max_cluster_size);
+  write_value(out, initial_config.tail_threshold);
+  write_value(out, material);
+  write_value(out, reactor);
+  write_value<std::uint32_t>(out,
+                             (std::uint32_t)reactor_history.interpolation);
+  write_value<std::uint64_t>(out, reactor_history.points.size());
+  for (const ReactorHistoryPoint& point : reactor_history.points)
+    write_value(out, point);
+
+  // Integrator position
+  write_value(out, time);
+  write_value(out, step);
+  write_value<std::int32_t>(out, order);
+  write_value<std::uint64_t>(out, max_cluster_size);
+  write_value<std::uint64_t>(out, state_size);
+  out.write(reinterpret_cast<const char*>(N_VGetArrayPointer(state)),
+            state_size * sizeof(gp_float));
+
+  out.close();
+  if (!out)
+    throw ClusterDynamicsException(
+        "Could not write checkpoint " + temporary_path + ".",
+        current_state(time));
+
+  std::error_code error;
+  std::filesystem::rename(temporary_path, path, error);
+  if (error)
+    throw ClusterDynamicsException(
+        "Could not move checkpoint to " + path + ": " + error.message(),
+        current_state(time));
+}
+
+/** @brief Creates a simulation from a checkpoint written by save_checkpoint()
+ * and fills config with the settings it was created with.
+ *
+ * CVODE offers no way to restore its step history, so the integration
+ * restarts at first order. A first order step only meets the tolerance where
+ * the saved order's step would if it is shorter by about
+ * rtol^(1/2 - 1/(order + 1)), so the restart step is the saved step scaled
+ * by that factor, from which CVODE grows the step again within a few steps.
+ */
+std::unique_ptr<ClusterDynamicsCpuImpl> ClusterDynamicsCpuImpl::from_checkpoint(
+    const std::string& path, ClusterDynamicsConfig& config,
+    size_t num_threads) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in)
+    throw ClusterDynamicsException("Could not open checkpoint " + path + ".",
+                                   ClusterDynamicsState());
+
+  char magic[sizeof(checkpoint_magic)];
+  if (!in.read(magic, sizeof(magic)) ||
+      std::memcmp(magic, checkpoint_magic, sizeof(magic)) != 0)
+    throw ClusterDynamicsException(path + " is not a checkpoint.",
+                                   ClusterDynamicsState());
+  if (read_value<std::uint32_t>(in, path) != checkpoint_version ||
+      read_value<std::uint8_t>(in, path) != sizeof(gp_float))
+    throw ClusterDynamicsException(
+        "Checkpoint " + path + " was written by an incompatible build.",
+        ClusterDynamicsState());
+
+  // Config
+  config.max_cluster_size = read_value<std::uint64_t>(in, path);
+  config.data_validation_on = read_value<std::uint8_t>(in, path);
+  config.relative_tolerance = read_value<gp_float>(in, path);
+  config.absolute_tolerance = read_value<gp_float>(in, path);
+  config.max_num_integration_steps = read_value<std::uint64_t>(in, path);
+  config.min_integration_step = read_value<gp_float>(in, path);
+  config.max_integration_step = read_value<gp_float>(in, path);
+  config.linear_solver = (LinearSolverType)read_value<std::uint32_t>(in, path);
+  config.krylov_subspace_size = read_value<std::uint64_t>(in, path);
+  config.group_threshold = read_value<std::uint64_t>(in, path);
+  config.group_growth = read_value<gp_float>(in, path);
+  config.continuum_threshold = read_value<std::uint64_t>(in, path);
+  config.continuum_growth = read_value<gp_float>(in, path);
+  config.initial_max_cluster_size = read_value<std::uint64_t>(in, path);
+  config.tail_threshold = read_value<gp_float>(in, path);
+  *config.material.mutable_impl() = read_value<MaterialImpl>(in, path);
+  *config.reactor.mutable_impl() = read_value<NuclearReactorImpl>(in, path);
+  config.reactor_history.interpolation =
+      (ReactorHistoryInterpolation)read_value<std::uint32_t>(in, path);
+  const size_t num_history_points = read_value<std::uint64_t>(in, path);
+  config.reactor_history.points.clear();
+  for (size_t k = 0; k < num_history_points; ++k)
+    config.reactor_history.points.push_back(
+        read_value<ReactorHistoryPoint>(in, path));
+  const size_t num_sizes = config.max_cluster_size + 1;
+  config.init_interstitials = std::vector<gp_float>(num_sizes, 0.);
+  config.init_vacancies = std::vector<gp_float>(num_sizes, 0.);
+
+  // Integrator position
+  const gp_float saved_time = read_value<gp_float>(in, path);
+  const gp_float saved_step = read_value<gp_float>(in, path);
+  const int saved_order = read_value<std::int32_t>(in, path);
+  const size_t saved_max_cluster_size = read_value<std::uint64_t>(in, path);
+  const size_t saved_state_size = read_value<std::uint64_t>(in, path);
+
+  auto cd = std::make_unique<ClusterDynamicsCpuImpl>(config, num_threads);
+  if (cd->adaptive_max_cluster_size &&
+      cd->max_cluster_size != saved_max_cluster_size)
+    cd->resize(saved_max_cluster_size);
+  if (cd->max_cluster_size != saved_max_cluster_size ||
+      cd->state_size != saved_state_size)
+    throw ClusterDynamicsException(
+        "The state of checkpoint " + path + " does not match its config.",
+        ClusterDynamicsState());
+
+  if (!in.read(reinterpret_cast<char*>(N_VGetArrayPointer(cd->state)),
+               saved_state_size * sizeof(gp_float)))
+    throw ClusterDynamicsException("Truncated checkpoint " + path + ".",
+                                   ClusterDynamicsState());
+
+  cd->time = saved_time;
+  if (!cd->reactor_history.empty()) {
+    cd->follow_reactor_history(saved_time);
+    cd->reactor_coefficient_init();
+  }
+  int sunerr = CVodeReInit(cd->cvodes_memory_block, saved_time, cd->state);
+  if (sunerr)
+    throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
+                                   ClusterDynamicsState());
+  if (saved_step > 0. && saved_order > 0) {
+    const gp_float restart_step =
+        saved_step * std::pow(config.relative_tolerance,
+                              0.5 - 1. / (gp_float)(saved_order + 1));
+    sunerr = CVodeSetInitStep(cd->cvodes_memory_block, restart_step);
+    if (sunerr)
+      throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
+                                     ClusterDynamicsState());
+  }
+
+  return cd;
 }
@@ -7,20 +7,87 @@ DIAGNOSTIC_PUSH
 DIAGNOSTIC_DISABLE("-Wunused-parameter")
 #include <cvodes/cvodes.h>
 #include <nvector/nvector_serial.h>
+#if defined(GP_HAS_NVECOPENMP)
+#include <nvector/nvector_openmp.h>
+#endif
 #include <sunlinsol/sunlinsol_dense.h>
+#include <sunlinsol/sunlinsol_spbcgs.h>
+#include <sunlinsol/sunlinsol_spgmr.h>
 #include <sunmatrix/sunmatrix_dense.h>
+#include <sunmatrix/sunmatrix_sparse.h>
+#if defined(GP_HAS_KLU)
+#include <sunlinsol/sunlinsol_klu.h>
+#endif
 DIAGNOSTIC_POP
 
+#include <array>
 #include <cmath>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "../cluster_dynamics_impl.hpp"
+#include "arrowhead_linear_solver.hpp"
 #include "cluster_dynamics/cluster_dynamics_config.hpp"
 #include "cluster_dynamics/cluster_dynamics_state.hpp"
+#include "cluster_grouping.hpp"
+#include "continuum_grid.hpp"
 #include "material_impl.hpp"
 #include "nuclear_reactor_impl.hpp"
+#include "solver_stats.hpp"
+#include "transport_kernel.hpp"
 #include "utils/constants.hpp"
+#include "utils/thread_pool.hpp"
+
+/** @brief The coefficient tables a material or reactor field enters, each
+ * level including the tables of the previous ones.
+ */
+enum class CoefficientDependency {
+  /// @brief None, the right hand side reads the field directly.
+  none,
+  /// @brief The defect production rates.
+  production,
+  /// @brief The tables rebuilt by reactor_coefficient_init().
+  reactor,
+  /// @brief Every table, rebuilt by coefficient_init().
+  material,
+};
+
+/** @brief Coefficient tables at a perturbed material or reactor field, which
+ * parameter_derivative() swaps in for its difference quotient. Only the
+ * tables of dependency are filled.
+ */
+struct PerturbedCoefficients {
+  CoefficientDependency dependency = CoefficientDependency::none;
+  /// @brief The perturbation of the field, 0 until the tables are built.
+  gp_float delta = 0.;
+
+  gp_float i_diffusion_val;
+  gp_float v_diffusion_val;
+  std::array<gp_float, 2> emission_temperatures;
+  gp_float emission_energy_spread;
+  std::vector<gp_float> cluster_radius_val;
+  std::vector<gp_float> i_capture_val;
+  std::vector<gp_float> v_capture_val;
+  std::vector<gp_float> i_binding_energy_val;
+  std::vector<gp_float> v_binding_energy_val;
+  std::vector<gp_float> ii_emission_val;
+  std::vector<gp_float> vv_emission_val;
+  std::vector<gp_float> ii_absorption_val;
+  std::vector<gp_float> iv_absorption_val;
+  std::vector<gp_float> vi_absorption_val;
+  std::vector<gp_float> vv_absorption_val;
+  std::vector<gp_float> i_dislocation_loop_unfault_probability_val;
+  std::vector<gp_float> i_defect_production_val;
+  std::vector<gp_float> v_defect_production_val;
+  std::vector<gp_float> i_promotion_factor_val;
+  std::vector<ClusterGroup> groups;
+  std::vector<ContinuumCell> continuum_cells;
+};
 
 class ClusterDynamicsCpuImpl : public ClusterDynamicsImpl {
  public:
@@ -31,14 +98,67 @@ class ClusterDynamicsCpuImpl : public ClusterDynamicsImpl {
   SUNContext sun_context;
   SUNMatrix jacobian_matrix;
   SUNLinearSolver linear_solver;
+  /// @brief Saved tridiagonal part of the Jacobian for the preconditioner.
+  SUNMatrix preconditioner_jacobian;
+  /// @brief The preconditioner matrix, I - gamma * preconditioner_jacobian.
+  SUNMatrix preconditioner_matrix;
+  SUNLinearSolver preconditioner_solver;
   void* cvodes_memory_block;
 
   gp_float* interstitials;
   gp_float* vacancies;
   gp_float* dislocation_density;
+  /// @brief Zeroth and first moments of the interstitial groups, followed by
+  /// those of the vacancy groups.
+  gp_float* group_moments;
+  /// @brief Total concentrations of the interstitial continuum cells,
+  /// followed by those of the vacancy cells.
+  gp_float* continuum_concentrations;
 
+  /// @brief Largest cluster size tracked individually. With grouping or the
+  /// continuum the sizes above it are tracked by groups or cells.
   size_t max_cluster_size;
   size_t state_size;
+  LinearSolverType linear_solver_type;
+  size_t krylov_subspace_size;
+  /// @brief Whether max_cluster_size follows the populated range, between
+  /// min_cluster_size_limit and max_cluster_size_limit.
+  bool adaptive_max_cluster_size = false;
+  size_t min_cluster_size_limit = 0;
+  size_t max_cluster_size_limit = 0;
+  /// @brief Tail concentration which grows the adaptive max cluster size.
+  gp_float tail_threshold = 0.;
+  /// @brief Factor applied to the adaptive max cluster size when it grows.
+  static constexpr size_t growth_factor = 2;
+  /// @brief Fraction of the tail threshold below which the upper half of the
+  /// sizes counts as empty, halving the adaptive max cluster size.
+  static constexpr gp_float shrink_fraction = 1e-3;
+  /// @brief Longest time the steady state solver integrates for when its
+  /// Newton iteration does not converge.
+  gp_float steady_state_max_time;
+  /// @brief Pseudo-transient Newton iterations per steady state attempt.
+  static constexpr size_t steady_state_max_iterations = 500;
+  /// @brief Kernels used by step_init() and system(), for the widest
+  /// instruction set the CPU supports.
+  TransportKernel transport_kernel;
+  /// @brief Number of threads evaluating the right hand side.
+  size_t num_threads;
+  /// @brief Workers of the threaded backend, null when single threaded.
+  std::unique_ptr<ThreadPool> thread_pool;
+  /// @brief Number of cluster sizes per task of the threaded backend. Every
+  /// reduction over the state is summed in blocks of this size combined in
+  /// order, also when single threaded, so fixing the block size makes the
+  /// results independent of the number of threads.
+  static constexpr size_t parallel_block_size = 4096;
+  /// @brief Partial sums of the blocks of transport_reduce(), reused between
+  /// calls.
+  mutable std::vector<TransportSums> block_sums;
+  /// @brief Groups of the sizes above max_cluster_size, empty when every
+  /// size is tracked individually.
+  std::vector<ClusterGroup> groups;
+  /// @brief Fokker-Planck cells of the sizes above max_cluster_size, empty
+  /// unless the continuum is enabled.
+  std::vector<ContinuumCell> continuum_cells;
 
   /// @brief Precomputed in step_init() using mean_dislocation_cell_radius()
   gp_float mean_dislocation_radius_val;
@@ -50,11 +170,126 @@ class ClusterDynamicsCpuImpl : public ClusterDynamicsImpl {
   gp_float vv_sum_absorption_val;
   /// @brief Precomputed in step_init() using vi_sum_absorption()
   gp_float vi_sum_absorption_val;
-  gp_float i_diffusion_val;  //!< Precomputed in step_init() using i_diffusion()
-  gp_float v_diffusion_val;  //!< Precomputed in step_init() using v_diffusion()
+  /// @brief Precomputed in step_init() using i_emission_rate()
+  gp_float i_emission_rate_val;
+  /// @brief Precomputed in step_init() using v_emission_rate()
+  gp_float v_emission_rate_val;
+  /// @brief Precomputed in step_init() using i_absorption_rate()
+  gp_float i_absorption_rate_val;
+  /// @brief Precomputed in step_init() using v_absorption_rate()
+  gp_float v_absorption_rate_val;
+  /// @brief Precomputed in step_init(), the gain term of
+  /// dislocation_density_derivative()
+  gp_float dislocation_gain_val;
+  /// @brief Precomputed in temperature_coefficient_init() using i_diffusion()
+  gp_float i_diffusion_val;
+  /// @brief Precomputed in temperature_coefficient_init() using v_diffusion()
+  gp_float v_diffusion_val;
+  /// @brief Temperatures of the Boltzmann factors of the group and cell
+  /// emission weights: that of the reactor and, during a temperature ramp,
+  /// one towards its end.
+  std::array<gp_float, 2> emission_temperatures;
+  /// @brief Precomputed in size_coefficient_init(), the widest spread of the
+  /// binding energies within a group or cell, which bounds the error of the
+  /// interpolated emission sums
+  gp_float emission_energy_spread = 0.;
+
+  // Per cluster size tables indexed by n = 0 .. max_cluster_size + 1
+  /// @brief Precomputed in size_coefficient_init() using cluster_radius()
+  std::vector<gp_float> cluster_radius_val;
+  /// @brief Precomputed in size_coefficient_init() using i_capture()
+  std::vector<gp_float> i_capture_val;
+  /// @brief Precomputed in size_coefficient_init() using v_capture()
+  std::vector<gp_float> v_capture_val;
+  /// @brief Precomputed in size_coefficient_init() using i_binding_energy()
+  std::vector<gp_float> i_binding_energy_val;
+  /// @brief Precomputed in size_coefficient_init() using v_binding_energy()
+  std::vector<gp_float> v_binding_energy_val;
+  /// @brief Precomputed in temperature_coefficient_init() using ii_emission()
+  std::vector<gp_float> ii_emission_val;
+  /// @brief Precomputed in temperature_coefficient_init() using vv_emission()
+  std::vector<gp_float> vv_emission_val;
+  /// @brief Precomputed in temperature_coefficient_init() using
+  /// ii_absorption()
+  std::vector<gp_float> ii_absorption_val;
+  /// @brief Precomputed in temperature_coefficient_init() using
+  /// iv_absorption()
+  std::vector<gp_float> iv_absorption_val;
+  /// @brief Precomputed in temperature_coefficient_init() using
+  /// vi_absorption()
+  std::vector<gp_float> vi_absorption_val;
+  /// @brief Precomputed in temperature_coefficient_init() using
+  /// vv_absorption()
+  std::vector<gp_float> vv_absorption_val;
+  /// @brief Precomputed in temperature_coefficient_init() using
+  /// i_dislocation_loop_unfault_probability()
+  std::vector<gp_float> i_dislocation_loop_unfault_probability_val;
+  /// @brief Precomputed in production_coefficient_init() using
+  /// i_defect_production(), divided by the atomic volume
+  std::vector<gp_float> i_defect_production_val;
+  /// @brief Precomputed in production_coefficient_init() using
+  /// v_defect_production(), divided by the atomic volume
+  std::vector<gp_float> v_defect_production_val;
+  /// @brief Precomputed in temperature_coefficient_init(), the unfaulting
+  /// factor of i_promotion_rate()
+  std::vector<gp_float> i_promotion_factor_val;
+
+  /// @brief Parameters whose forward sensitivities are integrated along with
+  /// the state, empty when sensitivities are off.
+  std::vector<SensitivityVariable> sensitivity_parameters;
+  /// @brief Magnitudes of sensitivity_parameters, which scale the
+  /// sensitivity tolerances and difference quotients.
+  std::vector<gp_float> sensitivity_scales;
+  /// @brief Coefficient tables of parameter_derivative() keyed by the
+  /// perturbed field. Must be cleared whenever the material, the reactor or
+  /// the sizes change.
+  std::map<const gp_float*, PerturbedCoefficients> perturbed_coefficient_cache;
+  /// @brief Initial sensitivities handed to CVODES.
+  N_Vector* sensitivities = nullptr;
+  /// @brief Time of the sample being passed to a sample() callback, which
+  /// get_sensitivities() interpolates to.
+  std::optional<gp_float> sampling_time;
+  /// @brief The state passed to sample() callbacks, reused between samples
+  /// so sampling does not allocate.
+  ClusterDynamicsState sample_buffer;
+  /// @brief Storage of the groups and continuum cells of the last
+  /// state_view(), whose moments are not laid out as ClusterGroupStates in
+  /// the state vector.
+  mutable std::vector<ClusterGroupState> interstitial_group_states;
+  mutable std::vector<ClusterGroupState> vacancy_group_states;
+  /// @brief Names and fields of the parameters whose quadratures the adjoint
+  /// integration of adjoint_gradient() accumulates.
+  std::vector<std::pair<std::string, gp_float*>> gradient_parameters;
+  /// @brief Magnitudes of gradient_parameters, which scale their difference
+  /// quotients.
+  std::vector<gp_float> gradient_scales;
+  /// @brief Scratch vectors of adjoint_quadrature() for the right hand side
+  /// and the parameter derivatives, created on first use.
+  N_Vector adjoint_derivatives = nullptr;
+  N_Vector adjoint_parameter_derivatives = nullptr;
+  /// @brief Integration steps between the checkpoints of the forward
+  /// solution, which the adjoint integration recomputes the steps from.
+  static constexpr long adjoint_checkpoint_steps = 100;
 
   MaterialImpl material;
   NuclearReactorImpl reactor;
+  /// @brief Flux and temperature of the reactor over time, empty when those
+  /// of reactor are fixed.
+  ReactorHistory reactor_history;
+  /// @brief Whether the flux or temperature ramp until the next breakpoint of
+  /// the reactor history, so system() follows them at every evaluation.
+  bool reactor_ramping = false;
+  /// @brief Time the reactor last followed the reactor history to.
+  gp_float reactor_time = 0.;
+  /// @brief Time the current segment of the reactor history was entered at.
+  gp_float reactor_segment_time = 0.;
+  /// @brief Counters of the integrators freed or reinitialized so far and
+  /// the phase times, see get_stats().
+  ClusterDynamicsStats solver_stats;
+  PhaseTimer phase_timer;
+  /// @brief The config the simulation was created with, without the initial
+  /// concentrations, which save_checkpoint() writes out.
+  ClusterDynamicsConfig initial_config;
 
   // Physics Model Functions
   gp_float i_concentration_derivative(size_t) const;
@@ -85,6 +320,8 @@ class ClusterDynamicsCpuImpl : public ClusterDynamicsImpl {
   gp_float iv_absorption(size_t) const;
   gp_float vi_absorption(size_t) const;
   gp_float vv_absorption(size_t) const;
+  gp_float i_capture(size_t) const;
+  gp_float v_capture(size_t) const;
   gp_float i_bias_factor(size_t) const;
   gp_float v_bias_factor(size_t) const;
   gp_float i_binding_energy(size_t) const;
@@ -102,16 +339,170 @@ class ClusterDynamicsCpuImpl : public ClusterDynamicsImpl {
   gp_float vv_sum_absorption(size_t) const;
 
   // Simulation Operation Functions
+  void coefficient_init();
+  void size_coefficient_init();
+  void reactor_coefficient_init();
+  void emission_weight_bracket_init();
+  void emission_weight_init(size_t slot, gp_float temperature);
+  void temperature_coefficient_init();
+  void production_coefficient_init();
   void step_init();
+  TransportKernelArgs transport_kernel_args() const;
+  void transport_reduce(size_t begin, size_t end, TransportSums& sums) const;
+  void transport_stencil(size_t begin, size_t end, gp_float* i_derivatives,
+                         gp_float* v_derivatives) const;
+  void group_reductions(TransportSums& sums) const;
+  void group_system(gp_float* i_derivatives, gp_float* v_derivatives,
+                    gp_float* group_derivatives) const;
+  void continuum_reductions(TransportSums& sums) const;
+  void continuum_system(gp_float* i_derivatives, gp_float* v_derivatives,
+                        gp_float* cell_derivatives) const;
   static int system(double t, N_Vector state, N_Vector state_derivatives,
                     void* user_data);
+  static int jacobian(double t, N_Vector state, N_Vector state_derivatives,
+                      SUNMatrix jacobian_matrix, void* user_data, N_Vector tmp1,
+                      N_Vector tmp2, N_Vector tmp3);
+  static int jacobian_times_vector(N_Vector v, N_Vector jv, double t,
+                                   N_Vector state, N_Vector state_derivatives,
+                                   void* user_data, N_Vector tmp);
+  static int preconditioner_setup(double t, N_Vector state,
+                                  N_Vector state_derivatives,
+                                  sunbooleantype jacobian_ok,
+                                  sunbooleantype* jacobian_current,
+                                  double gamma, void* user_data);
+  static int preconditioner_solve(double t, N_Vector state,
+                                  N_Vector state_derivatives, N_Vector r,
+                                  N_Vector z, double gamma, double delta,
+                                  int lr, void* user_data);
+  template <typename JacobianWriter>
+  void jacobian_entries(JacobianWriter& writer) const;
+  template <typename JacobianWriter>
+  void group_jacobian_entries(JacobianWriter& writer) const;
+  template <typename JacobianWriter>
+  void continuum_jacobian_entries(JacobianWriter& writer) const;
+
+  /// @brief Partial derivatives of the coupling of the largest individually
+  /// tracked size of one defect type to the first group or continuum cell.
+  struct TailCoupling {
+    gp_float i1 = 0.;       //!< With respect to C_i(1)
+    gp_float v1 = 0.;       //!< With respect to C_v(1)
+    gp_float largest = 0.;  //!< With respect to the largest size
+    /// @brief With respect to the moments of the first group, or the total
+    /// of the first cell
+    gp_float tail[2] = {0., 0.};
+  };
+  TailCoupling tail_coupling(bool vacancy) const;
+
+  /// @brief The flux of one defect type through a face of the continuum.
+  struct ContinuumFace {
+    gp_float promotion;  //!< Promotion rate per size 1 defect of the type
+    gp_float demotion;   //!< Demotion rate per size 1 defect of the other
+    ContinuumFluxPartials flux;
+  };
+  ContinuumFace continuum_face(size_t k, bool vacancy) const;
+
+  sunindextype jacobian_nnz() const;
   void validate(size_t) const;
 
+  // State Vector Layout
+  sunindextype i_index(size_t n) const { return n; }
+  sunindextype v_index(size_t n) const { return max_cluster_size + 2 + n; }
+  sunindextype dislocation_index() const { return 2 * (max_cluster_size + 2); }
+  sunindextype i_group_index(size_t g) const {
+    return dislocation_index() + 1 + 2 * g;
+  }
+  sunindextype v_group_index(size_t g) const {
+    return dislocation_index() + 1 + 2 * (groups.size() + g);
+  }
+  sunindextype i_cell_index(size_t k) const {
+    return dislocation_index() + 1 + 4 * groups.size() + k;
+  }
+  sunindextype v_cell_index(size_t k) const {
+    return i_cell_index(continuum_cells.size() + k);
+  }
+  /// @brief Whether the sizes above max_cluster_size are tracked by groups or
+  /// continuum cells.
+  bool has_coarse_tail() const {
+    return !groups.empty() || !continuum_cells.empty();
+  }
+  void alias_state(N_Vector v_state);
+  N_Vector new_state_vector() const;
+  void solver_init();
+  void solver_free();
+  static size_t tail_width(size_t size);
+  gp_float tail_concentration(size_t first_size) const;
+  static int tail_root(double t, N_Vector state, double* gout,
+                       void* user_data);
+  void resize(size_t new_max_cluster_size);
+  void tail_filled();
+  void shrink_if_empty();
+  void follow_reactor_history(gp_float t);
+  void start_reactor_segment();
+  bool reactor_segment_pending() const;
+  void fold_integrator_stats();
+  gp_float dose(gp_float t) const;
+  ClusterDynamicsStateView state_view(gp_float t) const;
+  ClusterDynamicsState current_state(gp_float t) const;
+  void integrate(gp_float total_time);
+  void step_through(const std::vector<gp_float>& sample_times,
+                    const ClusterDynamicsSampleFn& on_sample);
+  gp_float steady_state_residual(N_Vector v_state, N_Vector v_derivatives,
+                                 SUNMatrix v_jacobian) const;
+  bool steady_state_newton(SUNMatrix newton_matrix,
+                           SUNLinearSolver newton_solver);
+  gp_float& sensitivity_parameter(SensitivityVariable variable);
+  std::vector<std::pair<std::string, gp_float*>> model_parameters();
+  CoefficientDependency coefficient_dependency(const gp_float* parameter) const;
+  template <typename F>
+  void visit_coefficients(PerturbedCoefficients& perturbed, F&& f);
+  PerturbedCoefficients& perturbed_coefficients(gp_float& parameter,
+                                                gp_float delta);
+  int parameter_derivative(gp_float& parameter, gp_float scale, double t,
+                           N_Vector state, N_Vector state_derivatives,
+                           N_Vector parameter_derivatives);
+  static int sensitivity_rhs(int num_sensitivities, double t, N_Vector state,
+                             N_Vector state_derivatives, int s,
+                             N_Vector sensitivity,
+                             N_Vector sensitivity_derivatives, void* user_data,
+                             N_Vector tmp1, N_Vector tmp2);
+  void observable_gradient(ScalarObservable observable,
+                           N_Vector gradient) const;
+  static int adjoint_rhs(double t, N_Vector state, N_Vector adjoint,
+                         N_Vector adjoint_derivatives, void* user_data);
+  static int adjoint_jacobian(double t, N_Vector state, N_Vector adjoint,
+                              N_Vector adjoint_derivatives,
+                              SUNMatrix jacobian_matrix, void* user_data,
+                              N_Vector tmp1, N_Vector tmp2, N_Vector tmp3);
+  static int adjoint_quadrature(double t, N_Vector state, N_Vector adjoint,
+                                N_Vector quadrature_derivatives,
+                                void* user_data);
+  std::vector<sunindextype> border_indices() const;
+
   // Interface functions
-  explicit ClusterDynamicsCpuImpl(ClusterDynamicsConfig& config);
+  /** @param create_integrator Whether to create the CVODE integrator, which
+   * the members of a ClusterDynamicsEnsembleImpl share instead.
+   */
+  explicit ClusterDynamicsCpuImpl(ClusterDynamicsConfig& config,
+                                  size_t num_threads = 1,
+                                  bool create_integrator = true);
   ~ClusterDynamicsCpuImpl();
+  static std::unique_ptr<ClusterDynamicsCpuImpl> from_checkpoint(
+      const std::string& path, ClusterDynamicsConfig& config,
+      size_t num_threads = 1);
 
   ClusterDynamicsState run(gp_float total_time);
+  void run_into(gp_float total_time, ClusterDynamicsState& state);
+  ClusterDynamicsState sample(const std::vector<gp_float>& sample_times,
+                              const ClusterDynamicsSampleFn& on_sample);
+  ClusterDynamicsState solve_steady_state();
+  void enable_sensitivities(const std::vector<SensitivityVariable>& variables);
+  std::vector<ClusterDynamicsSensitivity> get_sensitivities() const;
+  std::map<std::string, gp_float> adjoint_gradient(
+      gp_float total_time, ScalarObservable observable);
+  gp_float get_time() const;
+  ClusterDynamicsStateView get_state_view() const;
+  ClusterDynamicsStats get_stats() const;
+  void save_checkpoint(const std::string& path) const;
   MaterialImpl get_material() const;
   void set_material(const MaterialImpl& material);
   NuclearReactorImpl get_reactor() const;
@@ -0,0 +1,344 @@
+#include "cluster_dynamics_ensemble_impl.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "cluster_dynamics/cluster_dynamics.hpp"
+
+namespace {
+
+/** @brief Operations of the ensemble state and its clones, followed by the
+ * ensemble whose members member_norm() takes the norms of.
+ *
+ * The generic operations come first, so that each vector frees its copy of
+ * the table as it would its own operations. SUNDIALS only copies the generic
+ * operations to a clone, so the clone operations hand each clone a copy of
+ * the whole table.
+ */
+struct EnsembleVectorOps {
+  _generic_N_Vector_Ops ops;
+  const ClusterDynamicsEnsembleImpl* ensemble;
+  /// @brief Clone operations of the vector the table replaced those of.
+  N_Vector (*clone)(N_Vector);
+  N_Vector (*clone_empty)(N_Vector);
+};
+
+const EnsembleVectorOps& ensemble_ops(N_Vector v) {
+  return *reinterpret_cast<const EnsembleVectorOps*>(v->ops);
+}
+
+/** @brief Replaces the operations of v by a copy of ops. Returns v, or null
+ * after destroying v when out of memory.
+ */
+N_Vector set_ensemble_ops(N_Vector v, const EnsembleVectorOps& ops) {
+  if (!v) return nullptr;
+  auto* copy =
+      static_cast<EnsembleVectorOps*>(std::malloc(sizeof(EnsembleVectorOps)));
+  if (!copy) {
+    N_VDestroy(v);
+    return nullptr;
+  }
+  *copy = ops;
+  std::free(v->ops);
+  v->ops = &copy->ops;
+  return v;
+}
+
+N_Vector ensemble_clone(N_Vector w) {
+  const EnsembleVectorOps& ops = ensemble_ops(w);
+  return set_ensemble_ops(ops.clone(w), ops);
+}
+
+N_Vector ensemble_clone_empty(N_Vector w) {
+  const EnsembleVectorOps& ops = ensemble_ops(w);
+  return set_ensemble_ops(ops.clone_empty(w), ops);
+}
+
+}  // namespace
+
+template <typename Function>
+int ClusterDynamicsEnsembleImpl::for_each_member(Function function) const {
+  std::vector<int> results(members.size(), 0);
+  const auto task = [&](size_t m) { results[m] = function(m); };
+  if (thread_pool)
+    thread_pool->parallel_for(members.size(), task);
+  else
+    for (size_t m = 0; m < members.size(); ++m) task(m);
+
+  for (int result : results)
+    if (result) return result;
+  return 0;
+}
+
+/** @brief Points the views of member m at its blocks of the given vectors.
+ */
+void ClusterDynamicsEnsembleImpl::view(size_t m, N_Vector v_state,
+                                       N_Vector v_state_derivatives) const {
+  N_VSetArrayPointer(N_VGetArrayPointer(v_state) + offsets[m], state_views[m]);
+  N_VSetArrayPointer(N_VGetArrayPointer(v_state_derivatives) + offsets[m],
+                     derivative_views[m]);
+}
+
+int ClusterDynamicsEnsembleImpl::system(double t, N_Vector v_state,
+                                        N_Vector v_state_derivatives,
+                                        void* user_data) {
+  ClusterDynamicsEnsembleImpl* ensemble =
+      static_cast<ClusterDynamicsEnsembleImpl*>(user_data);
+  return ensemble->for_each_member([&](size_t m) {
+    ensemble->view(m, v_state, v_state_derivatives);
+    return ClusterDynamicsCpuImpl::system(t, ensemble->state_views[m],
+                                          ensemble->derivative_views[m],
+                                          ensemble->members[m].get());
+  });
+}
+
+int ClusterDynamicsEnsembleImpl::jacobian(double t, N_Vector v_state,
+                                          N_Vector v_state_derivatives,
+                                          SUNMatrix jacobian_matrix,
+                                          void* user_data, N_Vector tmp1,
+                                          N_Vector tmp2, N_Vector tmp3) {
+  ClusterDynamicsEnsembleImpl* ensemble =
+      static_cast<ClusterDynamicsEnsembleImpl*>(user_data);
+  const BlockDiagonalMatrixContent* content =
+      SUNBlockDiagonalMatrix_Content(jacobian_matrix);
+  return ensemble->for_each_member([&](size_t m) {
+    ensemble->view(m, v_state, v_state_derivatives);
+    return ClusterDynamicsCpuImpl::jacobian(
+        t, ensemble->state_views[m], ensemble->derivative_views[m],
+        content->blocks[m], ensemble->members[m].get(), tmp1, tmp2, tmp3);
+  });
+}
+
+/** @brief CVODE error weight function, the weights of each member with its
+ * own tolerances.
+ */
+int ClusterDynamicsEnsembleImpl::error_weights(N_Vector v_state,
+                                               N_Vector v_weights,
+                                               void* user_data) {
+  ClusterDynamicsEnsembleImpl* ensemble =
+      static_cast<ClusterDynamicsEnsembleImpl*>(user_data);
+  const gp_float* y = N_VGetArrayPointer(v_state);
+  gp_float* weights = N_VGetArrayPointer(v_weights);
+
+  for (size_t m = 0; m < ensemble->members.size(); ++m) {
+    const ClusterDynamicsCpuImpl& member = *ensemble->members[m];
+    for (sunindextype i = ensemble->offsets[m]; i < ensemble->offsets[m + 1];
+         ++i) {
+      const gp_float tolerance = member.relative_tolerance * std::abs(y[i]) +
+                                 member.absolute_tolerance;
+      if (tolerance <= 0.) return -1;
+      weights[i] = 1. / tolerance;
+    }
+  }
+
+  return 0;
+}
+
+/** @brief Weighted root mean square norm of the ensemble vectors, the largest
+ * of the norms of the members.
+ *
+ * CVODE accepts a step and a Newton iterate when this norm is at most 1. The
+ * norm over the whole state would average the errors of accurate members with
+ * those of inaccurate ones, and any fixed rescaling of it that bounds every
+ * member holds each one to a tighter tolerance the larger the ensemble. The
+ * largest member norm instead holds each member to its own tolerances, as if
+ * it were integrated on its own.
+ */
+sunrealtype ClusterDynamicsEnsembleImpl::member_norm(N_Vector v_x,
+                                                     N_Vector v_weights) {
+  const ClusterDynamicsEnsembleImpl* ensemble = ensemble_ops(v_x).ensemble;
+  const gp_float* x = N_VGetArrayPointer(v_x);
+  const gp_float* weights = N_VGetArrayPointer(v_weights);
+
+  sunrealtype norm = 0.;
+  for (size_t m = 0; m < ensemble->members.size(); ++m) {
+    sunrealtype sum = 0.;
+    for (sunindextype i = ensemble->offsets[m]; i < ensemble->offsets[m + 1];
+         ++i) {
+      const sunrealtype weighted = x[i] * weights[i];
+      sum += weighted * weighted;
+    }
+    const sunindextype size = ensemble->offsets[m + 1] - ensemble->offsets[m];
+    norm = std::max(norm, std::sqrt(sum / (sunrealtype)size));
+  }
+  return norm;
+}
+
+/** @brief Returns the states of the members at the current time.
+ */
+std::vector<ClusterDynamicsState> ClusterDynamicsEnsembleImpl::current_states()
+    const {
+  std::vector<ClusterDynamicsState> states;
+  states.reserve(members.size());
+  for (size_t m = 0; m < members.size(); ++m) {
+    view(m, state, state);
+    members[m]->alias_state(state_views[m]);
+    states.push_back(members[m]->current_state(time));
+  }
+  return states;
+}
+
+ClusterDynamicsEnsembleImpl::ClusterDynamicsEnsembleImpl(
+    std::vector<ClusterDynamicsConfig>& configs, size_t num_threads)
+    : time(0.0),
+      offsets(1, 0),
+      state(nullptr),
+      jacobian_matrix(nullptr),
+      linear_solver(nullptr),
+      cvodes_memory_block(nullptr) {
+  if (configs.empty())
+    throw ClusterDynamicsException("An ensemble needs at least one config.",
+                                   ClusterDynamicsState());
+  if (num_threads == 0)
+    throw ClusterDynamicsException("The number of threads must be at least 1.",
+                                   ClusterDynamicsState());
+
+  for (ClusterDynamicsConfig& config : configs) {
+    auto member = std::make_unique<ClusterDynamicsCpuImpl>(config, 1, false);
+    if (member->has_coarse_tail() || member->adaptive_max_cluster_size ||
+        !member->reactor_history.empty())
+      throw ClusterDynamicsException(
+          "Ensembles do not support cluster grouping, the Fokker-Planck "
+          "continuum, the adaptive max cluster size or a reactor history.",
+          ClusterDynamicsState());
+    offsets.push_back(offsets.back() + member->state_size);
+    members.push_back(std::move(member));
+  }
+
+  const sunindextype ensemble_size = offsets.back();
+
+  if (num_threads > 1 && members.size() > 1)
+    thread_pool = std::make_unique<ThreadPool>(
+        std::min(num_threads, members.size()));
+
+  /* Create the SUNDIALS context */
+  int sunerr = SUNContext_Create(SUN_COMM_NULL, &sun_context);
+  if (sunerr)
+    throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
+                                   ClusterDynamicsState());
+
+  /* Stack the initial states of the members */
+  // CVODE clones its vectors from the state, which share the norm and the
+  // ensemble it is taken over
+  state = N_VNew_Serial(ensemble_size, sun_context);
+  if (state) {
+    EnsembleVectorOps ops{*state->ops, this, state->ops->nvclone,
+                          state->ops->nvcloneempty};
+    ops.ops.nvwrmsnorm = member_norm;
+    ops.ops.nvwrmsnormvectorarray = nullptr;
+    ops.ops.nvclone = ensemble_clone;
+    ops.ops.nvcloneempty = ensemble_clone_empty;
+    state = set_ensemble_ops(state, ops);
+  }
+  if (!state)
+    throw ClusterDynamicsException("Failed to create the state vector.",
+                                   ClusterDynamicsState());
+  gp_float* data = N_VGetArrayPointer(state);
+  std::vector<SUNMatrix> blocks;
+  std::vector<SUNLinearSolver> block_solvers;
+  std::vector<sunindextype> block_sizes;
+  for (size_t m = 0; m < members.size(); ++m) {
+    ClusterDynamicsCpuImpl& member = *members[m];
+    const gp_float* member_state = N_VGetArrayPointer(member.state);
+    std::copy(member_state, member_state + member.state_size,
+              data + offsets[m]);
+    state_views.push_back(
+        N_VMake_Serial(member.state_size, data + offsets[m], sun_context));
+    derivative_views.push_back(
+        N_VMake_Serial(member.state_size, data + offsets[m], sun_context));
+
+    /* Each member keeps its bordered tridiagonal jacobian and solver */
+    blocks.push_back(SUNArrowheadMatrix(member.state_size,
+                                        member.border_indices(), sun_context));
+    block_solvers.push_back(SUNLinSol_Arrowhead(blocks.back(), sun_context));
+    block_sizes.push_back(member.state_size);
+  }
+
+  jacobian_matrix = SUNBlockDiagonalMatrix(blocks, block_sizes,
+                                           thread_pool.get(), sun_context);
+  linear_solver =
+      SUNLinSol_BlockDiagonal(jacobian_matrix, block_solvers, sun_context);
+  if (!linear_solver)
+    throw ClusterDynamicsException("Failed to create the linear solver.",
+                                   ClusterDynamicsState());
+
+  /* The integrator settings are those of the first config */
+  const ClusterDynamicsCpuImpl& first = *members.front();
+  cvodes_memory_block = CVodeCreate(CV_BDF, sun_context);
+
+  sunerr = CVodeInit(cvodes_memory_block, system, time, state);
+  if (sunerr)
+    throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
+                                   ClusterDynamicsState());
+
+  sunerr = CVodeWFtolerances(cvodes_memory_block, error_weights);
+  if (sunerr)
+    throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
+                                   ClusterDynamicsState());
+
+  sunerr = CVodeSetUserData(cvodes_memory_block, static_cast<void*>(this));
+  if (sunerr)
+    throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
+                                   ClusterDynamicsState());
+
+  sunerr =
+      CVodeSetMaxNumSteps(cvodes_memory_block, first.max_num_integration_steps);
+  if (sunerr)
+    throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
+                                   ClusterDynamicsState());
+
+  sunerr = CVodeSetMinStep(cvodes_memory_block, first.min_integration_step);
+  if (sunerr)
+    throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
+                                   ClusterDynamicsState());
+
+  sunerr = CVodeSetMaxStep(cvodes_memory_block, first.max_integration_step);
+  if (sunerr)
+    throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
+                                   ClusterDynamicsState());
+
+  sunerr = CVodeSetInitStep(cvodes_memory_block, 1e-5);
+  if (sunerr)
+    throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
+                                   ClusterDynamicsState());
+
+  /* Attach the block diagonal matrix and linear solver */
+  sunerr =
+      CVodeSetLinearSolver(cvodes_memory_block, linear_solver, jacobian_matrix);
+  if (sunerr)
+    throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
+                                   ClusterDynamicsState());
+
+  sunerr = CVodeSetJacFn(cvodes_memory_block, jacobian);
+  if (sunerr)
+    throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
+                                   ClusterDynamicsState());
+}
+
+ClusterDynamicsEnsembleImpl::~ClusterDynamicsEnsembleImpl() {
+  CVodeFree(&cvodes_memory_block);
+  SUNLinSolFree(linear_solver);
+  SUNMatDestroy(jacobian_matrix);
+  for (N_Vector v : state_views) N_VDestroy(v);
+  for (N_Vector v : derivative_views) N_VDestroy(v);
+  N_VDestroy(state);
+  SUNContext_Free(&sun_context);
+}
+
+std::vector<ClusterDynamicsState> ClusterDynamicsEnsembleImpl::run(
+    gp_float total_time) {
+  const gp_float end_time = time + total_time;
+  double out_time;
+  const int sunerr =
+      CVode(cvodes_memory_block, end_time, state, &out_time, CV_NORMAL);
+  if (sunerr < 0)
+    throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
+                                   ClusterDynamicsState());
+
+  time = out_time;
+
+  return current_states();
+}
+
+gp_float ClusterDynamicsEnsembleImpl::get_time() const { return time; }
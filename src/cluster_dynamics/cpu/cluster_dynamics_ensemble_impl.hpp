@@ -0,0 +1,70 @@
+#ifndef CLUSTER_DYNAMICS_ENSEMBLE_IMPL_HPP
+#define CLUSTER_DYNAMICS_ENSEMBLE_IMPL_HPP
+
+#include <memory>
+#include <vector>
+
+#include "block_diagonal_linear_solver.hpp"
+#include "cluster_dynamics/cluster_dynamics_config.hpp"
+#include "cluster_dynamics/cluster_dynamics_state.hpp"
+#include "cluster_dynamics_cpu_impl.hpp"
+#include "utils/thread_pool.hpp"
+
+/** @brief Integrates the simulations of many configs as one block diagonal
+ * system with a single CVODE integrator.
+ *
+ * The states of the members are stored one after the other in a single
+ * vector. The right hand side, the Jacobian and the linear solves are those
+ * of the members, applied to their blocks, so they keep the vectorized
+ * kernels and arrowhead solver of a single simulation while the integrator
+ * overhead is paid once per step for the whole ensemble.
+ */
+class ClusterDynamicsEnsembleImpl {
+ public:
+  gp_float time;
+
+  /// @brief Simulations of the configs, without integrators of their own.
+  std::vector<std::unique_ptr<ClusterDynamicsCpuImpl>> members;
+  /// @brief Index of the first state entry of each member, followed by the
+  /// size of the ensemble state.
+  std::vector<sunindextype> offsets;
+
+  SUNContext sun_context;
+  N_Vector state;
+  /// @brief Views of the blocks of the state passed to the member functions.
+  std::vector<N_Vector> state_views;
+  /// @brief Views of the blocks of the derivatives passed to the member
+  /// functions.
+  std::vector<N_Vector> derivative_views;
+  SUNMatrix jacobian_matrix;
+  SUNLinearSolver linear_solver;
+  void* cvodes_memory_block;
+  /// @brief Workers running the members in parallel, null when single
+  /// threaded.
+  std::unique_ptr<ThreadPool> thread_pool;
+
+  /** @brief Calls function(m) for every member m, in parallel when there is
+   * a thread pool, and returns the first nonzero result.
+   */
+  template <typename Function>
+  int for_each_member(Function function) const;
+  void view(size_t m, N_Vector v_state, N_Vector v_state_derivatives) const;
+  static int system(double t, N_Vector state, N_Vector state_derivatives,
+                    void* user_data);
+  static int jacobian(double t, N_Vector state, N_Vector state_derivatives,
+                      SUNMatrix jacobian_matrix, void* user_data,
+                      N_Vector tmp1, N_Vector tmp2, N_Vector tmp3);
+  static int error_weights(N_Vector state, N_Vector weights, void* user_data);
+  static sunrealtype member_norm(N_Vector x, N_Vector weights);
+  std::vector<ClusterDynamicsState> current_states() const;
+
+  // Interface functions
+  explicit ClusterDynamicsEnsembleImpl(
+      std::vector<ClusterDynamicsConfig>& configs, size_t num_threads = 1);
+  ~ClusterDynamicsEnsembleImpl();
+
+  std::vector<ClusterDynamicsState> run(gp_float total_time);
+  gp_float get_time() const;
+};
+
+#endif  // CLUSTER_DYNAMICS_ENSEMBLE_IMPL_HPP
@@ -0,0 +1,38 @@
+#include "cluster_grouping.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+GroupSums GroupSums::interpolate(const GroupSums& a, const GroupSums& b,
+                                 gp_float s) {
+  if (s == 0.) return a;
+  if (s == 1.) return b;
+  if (!(a.s0 > 0.) || !(b.s0 > 0.)) return a.scaled(1. - s).plus(b.scaled(s));
+  const gp_float s0 = a.s0 * std::pow(b.s0 / a.s0, s);
+  const gp_float mean_offset = a.s1 / a.s0 + s * (b.s1 / b.s0 - a.s1 / a.s0);
+  const gp_float second_moment = a.s2 / a.s0 + s * (b.s2 / b.s0 - a.s2 / a.s0);
+  return {s0, s0 * mean_offset, s0 * second_moment};
+}
+
+std::vector<ClusterGroup> make_cluster_groups(size_t first, size_t last,
+                                              gp_float growth) {
+  std::vector<ClusterGroup> groups;
+  gp_float target_width = 1.;
+  while (first <= last) {
+    const size_t width =
+        std::min(std::max<size_t>(1, (size_t)std::floor(target_width)),
+                 last - first + 1);
+
+    ClusterGroup group{};
+    group.first = first;
+    group.last = first + width - 1;
+    group.mean = .5 * (gp_float)(group.first + group.last);
+    group.spread = (gp_float)width * ((gp_float)width * width - 1.) / 12.;
+    groups.push_back(group);
+
+    first += width;
+    target_width *= growth;
+  }
+
+  return groups;
+}
@@ -0,0 +1,142 @@
+#ifndef CLUSTER_GROUPING_HPP
+#define CLUSTER_GROUPING_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "utils/types.hpp"
+
+/** @brief Sums of a per size coefficient f(n) over the sizes of a group.
+ */
+struct GroupSums {
+  gp_float s0 = 0.;  //!< \f$\sum_n f(n)\f$
+  gp_float s1 = 0.;  //!< \f$\sum_n f(n) (n - \bar{n})\f$
+  gp_float s2 = 0.;  //!< \f$\sum_n f(n) (n - \bar{n})^2\f$
+
+  void add(gp_float f, gp_float offset) {
+    s0 += f;
+    s1 += f * offset;
+    s2 += f * offset * offset;
+  }
+
+  /** @brief Returns the sums without the size at the given offset, where the
+   * coefficient is f.
+   */
+  GroupSums without(gp_float f, gp_float offset) const {
+    return {s0 - f, s1 - f * offset, s2 - f * offset * offset};
+  }
+
+  /** @brief Returns \f$\sum_n f(n) C(n)\f$ for the linear concentration
+   * \f$C(n) = a + b (n - \bar{n})\f$.
+   */
+  gp_float dot(gp_float a, gp_float b) const { return a * s0 + b * s1; }
+
+  /** @brief Returns \f$\sum_n f(n) (n - \bar{n}) C(n)\f$ for the linear
+   * concentration \f$C(n) = a + b (n - \bar{n})\f$.
+   */
+  gp_float first_dot(gp_float a, gp_float b) const { return a * s1 + b * s2; }
+
+  /** @brief Returns the sums of f(n) + g(n), where other are the sums of g.
+   */
+  GroupSums plus(const GroupSums& other) const {
+    return {s0 + other.s0, s1 + other.s1, s2 + other.s2};
+  }
+
+  /** @brief Returns the sums of factor f(n).
+   */
+  GroupSums scaled(gp_float factor) const {
+    return {s0 * factor, s1 * factor, s2 * factor};
+  }
+
+  /** @brief Returns the sums of a positive coefficient at fraction s of the
+   * way between its sums a and b, for a coefficient which varies
+   * exponentially in s like the Boltzmann factors do in 1 / T.
+   *
+   * s0 is interpolated geometrically, the mean offset s1 / s0 and the second
+   * moment s2 / s0 linearly, which is exact at both ends. Sums whose s0 is
+   * 0, a weight which underflowed, have no logarithm and are interpolated
+   * linearly instead.
+   */
+  static GroupSums interpolate(const GroupSums& a, const GroupSums& b,
+                               gp_float s);
+};
+
+/** @brief A group of consecutive cluster sizes [first, last] whose
+ * concentrations are represented by their zeroth and first moments, after
+ * Golubov et al. / Philosophical Magazine A 81 (2001).
+ *
+ * The coefficient sums only depend on the material and the reactor and are
+ * filled by ClusterDynamicsCpuImpl::coefficient_init().
+ */
+struct ClusterGroup {
+  size_t first;
+  size_t last;
+  gp_float mean;    //!< \f$\bar{n}\f$
+  gp_float spread;  //!< \f$\sigma^2 = \sum_n (n - \bar{n})^2\f$
+
+  GroupSums ii_absorption;
+  GroupSums iv_absorption;
+  GroupSums vi_absorption;
+  GroupSums vv_absorption;
+  GroupSums ii_emission;
+  GroupSums vv_emission;
+  GroupSums cluster_radius;
+  /// @brief \f$r_i(n) \beta_{i,i}(n) P_{unf}(n)\f$
+  GroupSums dislocation_gain;
+  /// @brief \f$\beta_{i,i}(n) (1 - P_{unf}(n + 1))\f$
+  GroupSums i_promotion;
+
+  // Sums which only depend on the material, the rates above are scaled from
+  // them for each temperature
+  /// @brief \f$2 \pi r_i(n) Z_{ic}(n)\f$
+  GroupSums i_capture;
+  /// @brief \f$2 \pi r_v(n) Z_{vc}(n)\f$
+  GroupSums v_capture;
+  /// @brief \f$r_i(n) 2 \pi r_i(n) Z_{ic}(n)\f$
+  GroupSums radius_i_capture;
+  /// @brief i_capture and v_capture weighted by the Boltzmann factors
+  /// \f$e^{-E_b(n) / kT}\f$ at the two temperatures of
+  /// ClusterDynamicsCpuImpl::emission_temperatures, which the emission sums
+  /// are interpolated between
+  GroupSums i_emission_weight[2];
+  GroupSums v_emission_weight[2];
+
+  // Coefficients at the ends of the group, for the fluxes across them
+  gp_float i_promotion_last;
+  gp_float vv_absorption_last;
+  gp_float iv_absorption_first;
+  gp_float ii_emission_first;
+  gp_float vi_absorption_first;
+  gp_float vv_emission_first;
+
+  gp_float width() const { return (gp_float)(last - first + 1); }
+
+  /** @brief Returns the constant term of the linear concentration of the
+   * group with the given moments.
+   */
+  gp_float level(gp_float zeroth_moment) const {
+    return zeroth_moment / width();
+  }
+
+  /** @brief Returns the slope of the linear concentration of the group with
+   * the given moments.
+   */
+  gp_float slope(gp_float first_moment) const {
+    return spread > 0. ? first_moment / spread : 0.;
+  }
+
+  /** @brief Returns the concentration of size n for the given level and
+   * slope.
+   */
+  gp_float concentration(gp_float level, gp_float slope, size_t n) const {
+    return level + slope * ((gp_float)n - mean);
+  }
+};
+
+/** @brief Splits the cluster sizes [first, last] into groups whose widths grow
+ * geometrically by growth, starting from a width of 1.
+ */
+std::vector<ClusterGroup> make_cluster_groups(size_t first, size_t last,
+                                              gp_float growth);
+
+#endif  // CLUSTER_GROUPING_HPP
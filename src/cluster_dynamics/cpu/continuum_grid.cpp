@@ -0,0 +1,82 @@
+#include "continuum_grid.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+std::vector<ContinuumCell> make_continuum_cells(size_t first, size_t last,
+                                                gp_float growth) {
+  std::vector<ContinuumCell> cells;
+  gp_float target_width = 1.;
+  while (first <= last) {
+    const size_t width =
+        std::min(std::max<size_t>(1, (size_t)std::floor(target_width)),
+                 last - first + 1);
+
+    ContinuumCell cell{};
+    cell.first = first;
+    cell.last = first + width - 1;
+    cell.center = .5 * (gp_float)(cell.first + cell.last);
+    cells.push_back(cell);
+
+    first += width;
+    target_width *= growth;
+  }
+
+  return cells;
+}
+
+gp_float continuum_flux(gp_float p, gp_float q, gp_float h, gp_float left,
+                        gp_float right) {
+  if (q <= 0.) return p * left;
+  if (p <= 0.) return -q * right;
+
+  const gp_float z = h * std::log(p / q);
+  if (std::abs(z) < 1e-8) return .5 * (p + q) * (left - right) / h;
+
+  // Written so neither weight overflows for large |z|
+  if (z > 0.) {
+    const gp_float left_weight = (p - q) / -std::expm1(-z);
+    return left_weight * (left - std::exp(-z) * right);
+  }
+
+  const gp_float right_weight = (p - q) / std::expm1(z);
+  return right_weight * (std::exp(z) * left - right);
+}
+
+ContinuumFluxPartials continuum_flux_partials(gp_float p, gp_float q,
+                                              gp_float h, gp_float left,
+                                              gp_float right) {
+  // At a vanishing rate the partial with respect to it is the one sided
+  // limit, which only keeps the master equation form for h = 1
+  if (q <= 0.) return {left, h > 1. ? -left : -right, p, 0.};
+  if (p <= 0.) return {h > 1. ? right : left, -right, 0., -q};
+
+  const gp_float z = h * std::log(p / q);
+  if (std::abs(z) < 1e-8) {
+    const gp_float rate = .5 * (left - right) / h;
+    const gp_float weight = .5 * (p + q) / h;
+    return {rate, rate, weight, -weight};
+  }
+
+  gp_float left_weight;
+  gp_float right_weight;
+  gp_float growth;  // e^z / (e^z - 1)^2
+  if (z > 0.) {
+    const gp_float decay = std::exp(-z);
+    const gp_float denominator = -std::expm1(-z);
+    left_weight = (p - q) / denominator;
+    right_weight = left_weight * decay;
+    growth = decay / (denominator * denominator);
+  } else {
+    const gp_float decay = std::exp(z);
+    const gp_float denominator = std::expm1(z);
+    right_weight = (p - q) / denominator;
+    left_weight = right_weight * decay;
+    growth = decay / (denominator * denominator);
+  }
+
+  // J = (p - q) A(z) with dz/dp = h / p and dz/dq = -h / q
+  const gp_float a = (left_weight * left - right_weight * right) / (p - q);
+  const gp_float flux_z = (p - q) * growth * (right - left) * h;
+  return {a + flux_z / p, -a - flux_z / q, left_weight, -right_weight};
+}
@@ -0,0 +1,101 @@
+#ifndef CONTINUUM_GRID_HPP
+#define CONTINUUM_GRID_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "utils/types.hpp"
+
+/** @brief A finite volume cell [first, last] of the Fokker-Planck continuum
+ * which replaces the master equation for large cluster sizes.
+ *
+ * The state holds the total concentration of the sizes in the cell, the
+ * concentration per size is taken to be uniform across it. The coefficient
+ * sums only depend on the material and the reactor and are filled by
+ * ClusterDynamicsCpuImpl::coefficient_init().
+ */
+struct ContinuumCell {
+  size_t first;
+  size_t last;
+  gp_float center;  //!< \f$x_k = (first + last) / 2\f$
+
+  // Sums of the per size coefficients over the sizes of the cell
+  gp_float ii_absorption;
+  gp_float iv_absorption;
+  gp_float vi_absorption;
+  gp_float vv_absorption;
+  gp_float ii_emission;
+  gp_float vv_emission;
+  gp_float cluster_radius;
+  /// @brief \f$\sum_n r_i(n) \beta_{i,i}(n) P_{unf}(n)\f$
+  gp_float dislocation_gain;
+  /// @brief \f$\sum_n \beta_{i,i}(n) P_{unf}(n + 1)\f$, the absorptions
+  /// which unfault the loop instead of growing it
+  gp_float i_unfault_absorption;
+
+  // Sums which only depend on the material, the rates above are scaled from
+  // them for each temperature
+  gp_float i_capture;         //!< \f$\sum_n 2 \pi r_i(n) Z_{ic}(n)\f$
+  gp_float v_capture;         //!< \f$\sum_n 2 \pi r_v(n) Z_{vc}(n)\f$
+  gp_float radius_i_capture;  //!< \f$\sum_n r_i(n) 2 \pi r_i(n) Z_{ic}(n)\f$
+  /// @brief i_capture and v_capture weighted by the Boltzmann factors
+  /// \f$e^{-E_b(n) / kT}\f$ at the two temperatures of
+  /// ClusterDynamicsCpuImpl::emission_temperatures, which the emission sums
+  /// are interpolated between
+  gp_float i_emission_weight[2];
+  gp_float v_emission_weight[2];
+
+  // Coefficients at the ends of the cell, for the fluxes across its faces
+  gp_float i_promotion_last;
+  gp_float vv_absorption_last;
+  gp_float iv_absorption_first;
+  gp_float ii_emission_first;
+  gp_float vi_absorption_first;
+  gp_float vv_emission_first;
+
+  gp_float width() const { return (gp_float)(last - first + 1); }
+};
+
+/** @brief Splits the cluster sizes [first, last] into cells whose widths grow
+ * geometrically by growth, starting from a width of 1.
+ */
+std::vector<ContinuumCell> make_continuum_cells(size_t first, size_t last,
+                                                gp_float growth);
+
+/** @brief Returns the flux of clusters from size x to size x + h, where the
+ * per size concentrations are left and right, for the promotion rate p and
+ * the demotion rate q.
+ *
+ * This is the Scharfetter-Gummel discretization of the Fokker-Planck flux
+ * \f$J = (p - q) C - \frac{1}{2} \frac{\partial (p + q) C}{\partial x}\f$,
+ * fitted to the exact steady flux of the master equation with constant rates
+ * over h sizes:
+ *
+ * \f$
+ *   J = (p - q) \frac{r^h C_l - C_r}{r^h - 1}, \quad r = p / q
+ * \f$
+ *
+ * For h = 1 it reduces to the master equation flux \f$p C_l - q C_r\f$, and
+ * both weights stay positive for any h.
+ */
+gp_float continuum_flux(gp_float p, gp_float q, gp_float h, gp_float left,
+                        gp_float right);
+
+/** @brief Partial derivatives of continuum_flux() with respect to each of its
+ * arguments but h.
+ */
+struct ContinuumFluxPartials {
+  gp_float p;
+  gp_float q;
+  gp_float left;
+  gp_float right;
+};
+
+/** @brief Returns the partial derivatives of continuum_flux(p, q, h, left,
+ * right).
+ */
+ContinuumFluxPartials continuum_flux_partials(gp_float p, gp_float q,
+                                              gp_float h, gp_float left,
+                                              gp_float right);
+
+#endif  // CONTINUUM_GRID_HPP
@@ -0,0 +1,132 @@
+#include "transport_kernel.hpp"
+
+#if defined(GP_HAS_X86_SIMD) && defined(_MSC_VER)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+const char* simd_level_name(SimdLevel level) {
+  switch (level) {
+    case SimdLevel::avx512:
+      return "avx512";
+    case SimdLevel::avx2:
+      return "avx2";
+    default:
+      break;
+  }
+
+  return "scalar";
+}
+
+SimdLevel detect_simd_level() {
+#if defined(GP_HAS_X86_SIMD) && (defined(__GNUC__) || defined(__clang__))
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) return SimdLevel::avx512;
+  if (__builtin_cpu_supports("avx2")) return SimdLevel::avx2;
+#elif defined(GP_HAS_X86_SIMD) && defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 1);
+  // The OS has to save the extended registers for them to be usable
+  const bool osxsave = (info[2] & (1 << 27)) != 0;
+  if (!osxsave) return SimdLevel::scalar;
+  const unsigned long long xcr0 = _xgetbv(0);
+
+  __cpuidex(info, 7, 0);
+  const bool avx2 = (info[1] & (1 << 5)) != 0 && (xcr0 & 0x6) == 0x6;
+  const bool avx512 = (info[1] & (1 << 16)) != 0 && (xcr0 & 0xe6) == 0xe6;
+  if (avx512) return SimdLevel::avx512;
+  if (avx2) return SimdLevel::avx2;
+#endif
+
+  return SimdLevel::scalar;
+}
+
+TransportKernel select_transport_kernel(SimdLevel level) {
+#if defined(GP_HAS_X86_SIMD)
+  const SimdLevel supported = detect_simd_level();
+  if (level == SimdLevel::avx512 && supported == SimdLevel::avx512) {
+    return {SimdLevel::avx512, transport_reduce_avx512,
+            transport_stencil_avx512};
+  }
+  if (level != SimdLevel::scalar && supported != SimdLevel::scalar) {
+    return {SimdLevel::avx2, transport_reduce_avx2, transport_stencil_avx2};
+  }
+#else
+  (void)level;
+#endif
+
+  return {SimdLevel::scalar, transport_reduce_scalar,
+          transport_stencil_scalar};
+}
+
+/** @brief Accumulates the sums in order of increasing cluster size, which
+ * makes the results identical to the reference functions of
+ * ClusterDynamicsCpuImpl (ii_sum_absorption(), i_emission_rate(), ...).
+ */
+void transport_reduce_scalar(const TransportKernelArgs& args, size_t begin,
+                             size_t end, TransportSums& sums) {
+  const gp_float* ci = args.interstitials;
+  const gp_float* cv = args.vacancies;
+
+  for (size_t n = begin; n < end; ++n) {
+    sums.radius += args.cluster_radius[n] * ci[n];
+    sums.dislocation_gain += args.cluster_radius[n] * args.ii_absorption[n] *
+                             ci[n] *
+                             args.i_dislocation_loop_unfault_probability[n];
+
+    sums.ii_sum += args.ii_absorption[n] * ci[n];
+    sums.iv_sum += args.iv_absorption[n] * ci[n];
+    sums.vi_sum += args.vi_absorption[n] * cv[n];
+    sums.vv_sum += args.vv_absorption[n] * cv[n];
+
+    sums.i_absorption +=
+        args.ii_absorption[n] * ci[n] + args.vi_absorption[n] * cv[n];
+    sums.v_absorption +=
+        args.vv_absorption[n] * cv[n] + args.iv_absorption[n] * ci[n];
+
+    sums.i_emission += args.ii_emission[n] * ci[n];
+    sums.v_emission += args.vv_emission[n] * cv[n];
+  }
+}
+
+/** @brief Evaluates the stencil with the same operations, in the same order,
+ * as ClusterDynamicsCpuImpl::i_concentration_derivative() and
+ * ClusterDynamicsCpuImpl::v_concentration_derivative().
+ */
+void transport_stencil_scalar(const TransportKernelArgs& args, size_t begin,
+                              size_t end, gp_float* i_derivatives,
+                              gp_float* v_derivatives) {
+  const gp_float* ci = args.interstitials;
+  const gp_float* cv = args.vacancies;
+  const gp_float i1 = ci[1];
+  const gp_float v1 = cv[1];
+
+  for (size_t n = begin; n < end; ++n) {
+    i_derivatives[n] =
+        // (1)
+        args.i_defect_production[n]
+        // (2)
+        + (args.iv_absorption[n + 1] * v1 + args.ii_emission[n + 1]) *
+              ci[n + 1]
+        // (3)
+        - (args.iv_absorption[n] * v1 + args.ii_absorption[n] * i1 +
+           args.ii_emission[n]) *
+              ci[n]
+        // (4)
+        + args.ii_absorption[n - 1] * i1 * args.i_promotion_factor[n - 1] *
+              ci[n - 1];
+
+    v_derivatives[n] =
+        // (1)
+        args.v_defect_production[n]
+        // (2)
+        + (args.vi_absorption[n + 1] * i1 + args.vv_emission[n + 1]) *
+              cv[n + 1]
+        // (3)
+        - (args.vi_absorption[n] * i1 + args.vv_absorption[n] * v1 +
+           args.vv_emission[n]) *
+              cv[n]
+        // (4)
+        + args.vv_absorption[n - 1] * v1 * cv[n - 1];
+  }
+}
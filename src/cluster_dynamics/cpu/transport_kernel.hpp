@@ -0,0 +1,115 @@
+#ifndef TRANSPORT_KERNEL_HPP
+#define TRANSPORT_KERNEL_HPP
+
+#include <cstddef>
+
+#include "utils/types.hpp"
+
+/** @brief Instruction set used by a TransportKernel.
+ */
+enum class SimdLevel { scalar, avx2, avx512 };
+
+/** @brief Returns a printable name for the instruction set.
+ */
+const char* simd_level_name(SimdLevel level);
+
+/** @brief Returns the widest instruction set supported by both this build and
+ * the CPU it is running on.
+ */
+SimdLevel detect_simd_level();
+
+/** @brief The state and per cluster size tables read by the transport kernels.
+ *
+ * Every table is indexed by the cluster size n = 0 .. max_cluster_size + 1,
+ * as laid out by ClusterDynamicsCpuImpl::coefficient_init().
+ */
+struct TransportKernelArgs {
+  size_t max_cluster_size;
+  const gp_float* interstitials;
+  const gp_float* vacancies;
+
+  const gp_float* cluster_radius;
+  const gp_float* ii_emission;
+  const gp_float* vv_emission;
+  const gp_float* ii_absorption;
+  const gp_float* iv_absorption;
+  const gp_float* vi_absorption;
+  const gp_float* vv_absorption;
+  const gp_float* i_dislocation_loop_unfault_probability;
+  /// @brief \f$G_i(n)/\Omega\f$
+  const gp_float* i_defect_production;
+  /// @brief \f$G_v(n)/\Omega\f$
+  const gp_float* v_defect_production;
+  /// @brief \f$1 - P_{unf}(n + 1)\f$
+  const gp_float* i_promotion_factor;
+};
+
+/** @brief Partial sums of the reductions needed by
+ * ClusterDynamicsCpuImpl::step_init().
+ */
+struct TransportSums {
+  gp_float ii_sum = 0.;        //!< \f$\sum \beta_{i,i}(n) C_i(n)\f$
+  gp_float iv_sum = 0.;        //!< \f$\sum \beta_{i,v}(n) C_i(n)\f$
+  gp_float vi_sum = 0.;        //!< \f$\sum \beta_{v,i}(n) C_v(n)\f$
+  gp_float vv_sum = 0.;        //!< \f$\sum \beta_{v,v}(n) C_v(n)\f$
+  gp_float i_absorption = 0.;  //!< \f$\sum \beta_{i,i}C_i + \beta_{v,i}C_v\f$
+  gp_float v_absorption = 0.;  //!< \f$\sum \beta_{v,v}C_v + \beta_{i,v}C_i\f$
+  gp_float i_emission = 0.;    //!< \f$\sum \alpha_{i,i}(n) C_i(n)\f$
+  gp_float v_emission = 0.;    //!< \f$\sum \alpha_{v,v}(n) C_v(n)\f$
+  gp_float radius = 0.;        //!< \f$\sum r_i(n) C_i(n)\f$
+  /// @brief \f$\sum r_i(n) \beta_{i,i}(n) C_i(n) P_{unf}(n)\f$
+  gp_float dislocation_gain = 0.;
+};
+
+/** @brief Adds every reduction term of the cluster sizes in [begin, end) to
+ * sums.
+ */
+using TransportReduceFn = void (*)(const TransportKernelArgs& args,
+                                   size_t begin, size_t end,
+                                   TransportSums& sums);
+
+/** @brief Writes the concentration derivatives of the cluster sizes in
+ * [begin, end), 2 <= begin and end <= max_cluster_size + 1.
+ *
+ * Evaluates the three point stencil of
+ * ClusterDynamicsCpuImpl::i_concentration_derivative() and
+ * ClusterDynamicsCpuImpl::v_concentration_derivative().
+ */
+using TransportStencilFn = void (*)(const TransportKernelArgs& args,
+                                    size_t begin, size_t end,
+                                    gp_float* i_derivatives,
+                                    gp_float* v_derivatives);
+
+/** @brief The reduction and stencil kernels of the right hand side for one
+ * instruction set.
+ */
+struct TransportKernel {
+  SimdLevel level;
+  TransportReduceFn reduce;
+  TransportStencilFn stencil;
+};
+
+/** @brief Returns the kernels for the given instruction set.
+ *
+ * Levels which are not supported fall back to the widest supported one, so
+ * the result is always safe to call.
+ */
+TransportKernel select_transport_kernel(SimdLevel level);
+
+// Per instruction set implementations, only defined when built
+void transport_reduce_scalar(const TransportKernelArgs&, size_t, size_t,
+                             TransportSums&);
+void transport_stencil_scalar(const TransportKernelArgs&, size_t, size_t,
+                              gp_float*, gp_float*);
+#if defined(GP_HAS_X86_SIMD)
+void transport_reduce_avx2(const TransportKernelArgs&, size_t, size_t,
+                           TransportSums&);
+void transport_stencil_avx2(const TransportKernelArgs&, size_t, size_t,
+                            gp_float*, gp_float*);
+void transport_reduce_avx512(const TransportKernelArgs&, size_t, size_t,
+                             TransportSums&);
+void transport_stencil_avx512(const TransportKernelArgs&, size_t, size_t,
+                              gp_float*, gp_float*);
+#endif
+
+#endif  // TRANSPORT_KERNEL_HPP
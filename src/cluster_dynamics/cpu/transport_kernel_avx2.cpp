@@ -0,0 +1,39 @@
+// Compiled with AVX2 enabled, see src/cluster_dynamics/CMakeLists.txt
+#if defined(GP_HAS_X86_SIMD)
+
+#include <immintrin.h>
+
+#include "transport_kernel_simd.hpp"
+
+namespace {
+struct Avx2Ops {
+  using Reg = __m256d;
+  static constexpr size_t width = 4;
+
+  static Reg zero() { return _mm256_setzero_pd(); }
+  static Reg set1(gp_float x) { return _mm256_set1_pd(x); }
+  static Reg load(const gp_float* p) { return _mm256_loadu_pd(p); }
+  static void store(gp_float* p, Reg x) { _mm256_storeu_pd(p, x); }
+  static Reg add(Reg a, Reg b) { return _mm256_add_pd(a, b); }
+  static Reg sub(Reg a, Reg b) { return _mm256_sub_pd(a, b); }
+  static Reg mul(Reg a, Reg b) { return _mm256_mul_pd(a, b); }
+  static gp_float sum(Reg x) {
+    __m128d low = _mm_add_pd(_mm256_castpd256_pd128(x),
+                             _mm256_extractf128_pd(x, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(low, _mm_unpackhi_pd(low, low)));
+  }
+};
+}  // namespace
+
+void transport_reduce_avx2(const TransportKernelArgs& args, size_t begin,
+                           size_t end, TransportSums& sums) {
+  simd_reduce<Avx2Ops>(args, begin, end, sums);
+}
+
+void transport_stencil_avx2(const TransportKernelArgs& args, size_t begin,
+                            size_t end, gp_float* i_derivatives,
+                            gp_float* v_derivatives) {
+  simd_stencil<Avx2Ops>(args, begin, end, i_derivatives, v_derivatives);
+}
+
+#endif  // GP_HAS_X86_SIMD
@@ -0,0 +1,41 @@
+// Compiled with AVX-512 enabled, see src/cluster_dynamics/CMakeLists.txt
+#if defined(GP_HAS_X86_SIMD)
+
+#include <immintrin.h>
+
+#include "transport_kernel_simd.hpp"
+
+namespace {
+struct Avx512Ops {
+  using Reg = __m512d;
+  static constexpr size_t width = 8;
+
+  static Reg zero() { return _mm512_setzero_pd(); }
+  static Reg set1(gp_float x) { return _mm512_set1_pd(x); }
+  static Reg load(const gp_float* p) { return _mm512_loadu_pd(p); }
+  static void store(gp_float* p, Reg x) { _mm512_storeu_pd(p, x); }
+  static Reg add(Reg a, Reg b) { return _mm512_add_pd(a, b); }
+  static Reg sub(Reg a, Reg b) { return _mm512_sub_pd(a, b); }
+  static Reg mul(Reg a, Reg b) { return _mm512_mul_pd(a, b); }
+  static gp_float sum(Reg x) {
+    // _mm512_reduce_add_pd trips -Wuninitialized in some GCC versions
+    gp_float lanes[width];
+    _mm512_storeu_pd(lanes, x);
+    return ((lanes[0] + lanes[4]) + (lanes[2] + lanes[6])) +
+           ((lanes[1] + lanes[5]) + (lanes[3] + lanes[7]));
+  }
+};
+}  // namespace
+
+void transport_reduce_avx512(const TransportKernelArgs& args, size_t begin,
+                             size_t end, TransportSums& sums) {
+  simd_reduce<Avx512Ops>(args, begin, end, sums);
+}
+
+void transport_stencil_avx512(const TransportKernelArgs& args, size_t begin,
+                              size_t end, gp_float* i_derivatives,
+                              gp_float* v_derivatives) {
+  simd_stencil<Avx512Ops>(args, begin, end, i_derivatives, v_derivatives);
+}
+
+#endif  // GP_HAS_X86_SIMD
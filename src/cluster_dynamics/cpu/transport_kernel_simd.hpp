@@ -0,0 +1,156 @@
+#ifndef TRANSPORT_KERNEL_SIMD_HPP
+#define TRANSPORT_KERNEL_SIMD_HPP
+
+// Shared implementation of the vectorized transport kernels. Only include it
+// from the per instruction set translation units, which are compiled with the
+// matching target flags. Everything lives in an anonymous namespace so no
+// code built for a wider instruction set can leak into the rest of the
+// library through the linker.
+
+#include <type_traits>
+
+#include "transport_kernel.hpp"
+
+static_assert(std::is_same_v<gp_float, double>,
+              "The vectorized transport kernels are double precision only");
+
+namespace {
+/** @brief Vectorized TransportReduceFn over the Ops register abstraction.
+ *
+ * Each lane accumulates its own partial sums, so the result differs from the
+ * scalar kernel by rounding only.
+ */
+template <typename Ops>
+void simd_reduce(const TransportKernelArgs& args, size_t begin, size_t end,
+                 TransportSums& sums) {
+  using Reg = typename Ops::Reg;
+  const gp_float* ci = args.interstitials;
+  const gp_float* cv = args.vacancies;
+
+  Reg ii_sum = Ops::zero();
+  Reg iv_sum = Ops::zero();
+  Reg vi_sum = Ops::zero();
+  Reg vv_sum = Ops::zero();
+  Reg i_absorption = Ops::zero();
+  Reg v_absorption = Ops::zero();
+  Reg i_emission = Ops::zero();
+  Reg v_emission = Ops::zero();
+  Reg radius = Ops::zero();
+  Reg dislocation_gain = Ops::zero();
+
+  size_t n = begin;
+  for (; n + Ops::width <= end; n += Ops::width) {
+    const Reg i = Ops::load(ci + n);
+    const Reg v = Ops::load(cv + n);
+    const Reg r = Ops::load(args.cluster_radius + n);
+    const Reg ii = Ops::load(args.ii_absorption + n);
+    const Reg iv = Ops::load(args.iv_absorption + n);
+    const Reg vi = Ops::load(args.vi_absorption + n);
+    const Reg vv = Ops::load(args.vv_absorption + n);
+
+    const Reg ii_i = Ops::mul(ii, i);
+    const Reg iv_i = Ops::mul(iv, i);
+    const Reg vi_v = Ops::mul(vi, v);
+    const Reg vv_v = Ops::mul(vv, v);
+
+    radius = Ops::add(radius, Ops::mul(r, i));
+    dislocation_gain = Ops::add(
+        dislocation_gain,
+        Ops::mul(
+            Ops::mul(Ops::mul(r, ii), i),
+            Ops::load(args.i_dislocation_loop_unfault_probability + n)));
+
+    ii_sum = Ops::add(ii_sum, ii_i);
+    iv_sum = Ops::add(iv_sum, iv_i);
+    vi_sum = Ops::add(vi_sum, vi_v);
+    vv_sum = Ops::add(vv_sum, vv_v);
+
+    i_absorption = Ops::add(i_absorption, Ops::add(ii_i, vi_v));
+    v_absorption = Ops::add(v_absorption, Ops::add(vv_v, iv_i));
+
+    i_emission = Ops::add(i_emission,
+                          Ops::mul(Ops::load(args.ii_emission + n), i));
+    v_emission = Ops::add(v_emission,
+                          Ops::mul(Ops::load(args.vv_emission + n), v));
+  }
+
+  sums.ii_sum += Ops::sum(ii_sum);
+  sums.iv_sum += Ops::sum(iv_sum);
+  sums.vi_sum += Ops::sum(vi_sum);
+  sums.vv_sum += Ops::sum(vv_sum);
+  sums.i_absorption += Ops::sum(i_absorption);
+  sums.v_absorption += Ops::sum(v_absorption);
+  sums.i_emission += Ops::sum(i_emission);
+  sums.v_emission += Ops::sum(v_emission);
+  sums.radius += Ops::sum(radius);
+  sums.dislocation_gain += Ops::sum(dislocation_gain);
+
+  transport_reduce_scalar(args, n, end, sums);
+}
+
+/** @brief Vectorized TransportStencilFn over the Ops register abstraction.
+ *
+ * Performs the same operations in the same order as the scalar kernel.
+ */
+template <typename Ops>
+void simd_stencil(const TransportKernelArgs& args, size_t begin, size_t end,
+                  gp_float* i_derivatives, gp_float* v_derivatives) {
+  using Reg = typename Ops::Reg;
+  const gp_float* ci = args.interstitials;
+  const gp_float* cv = args.vacancies;
+  const Reg i1 = Ops::set1(ci[1]);
+  const Reg v1 = Ops::set1(cv[1]);
+
+  size_t n = begin;
+  for (; n + Ops::width <= end; n += Ops::width) {
+    // (2)
+    const Reg i_demotion = Ops::mul(
+        Ops::add(Ops::mul(Ops::load(args.iv_absorption + n + 1), v1),
+                 Ops::load(args.ii_emission + n + 1)),
+        Ops::load(ci + n + 1));
+    // (3)
+    const Reg i_combined = Ops::mul(
+        Ops::add(Ops::add(Ops::mul(Ops::load(args.iv_absorption + n), v1),
+                          Ops::mul(Ops::load(args.ii_absorption + n), i1)),
+                 Ops::load(args.ii_emission + n)),
+        Ops::load(ci + n));
+    // (4)
+    const Reg i_promotion = Ops::mul(
+        Ops::mul(Ops::mul(Ops::load(args.ii_absorption + n - 1), i1),
+                 Ops::load(args.i_promotion_factor + n - 1)),
+        Ops::load(ci + n - 1));
+    Ops::store(i_derivatives + n,
+               Ops::add(Ops::sub(Ops::add(Ops::load(
+                                              args.i_defect_production + n),
+                                          i_demotion),
+                                 i_combined),
+                        i_promotion));
+
+    // (2)
+    const Reg v_demotion = Ops::mul(
+        Ops::add(Ops::mul(Ops::load(args.vi_absorption + n + 1), i1),
+                 Ops::load(args.vv_emission + n + 1)),
+        Ops::load(cv + n + 1));
+    // (3)
+    const Reg v_combined = Ops::mul(
+        Ops::add(Ops::add(Ops::mul(Ops::load(args.vi_absorption + n), i1),
+                          Ops::mul(Ops::load(args.vv_absorption + n), v1)),
+                 Ops::load(args.vv_emission + n)),
+        Ops::load(cv + n));
+    // (4)
+    const Reg v_promotion =
+        Ops::mul(Ops::mul(Ops::load(args.vv_absorption + n - 1), v1),
+                 Ops::load(cv + n - 1));
+    Ops::store(v_derivatives + n,
+               Ops::add(Ops::sub(Ops::add(Ops::load(
+                                              args.v_defect_production + n),
+                                          v_demotion),
+                                 v_combined),
+                        v_promotion));
+  }
+
+  transport_stencil_scalar(args, n, end, i_derivatives, v_derivatives);
+}
+}  // namespace
+
+#endif  // TRANSPORT_KERNEL_SIMD_HPP
@@ -815,6 +815,11 @@ ClusterDynamicsCudaImpl::ClusterDynamicsCudaImpl(ClusterDynamicsConfig &config)
   min_integration_step = config.min_integration_step;
   max_integration_step = config.max_integration_step;
 
+  if (!config.reactor_history.empty())
+    throw ClusterDynamicsException(
+        "Reactor histories are not supported by the CUDA backend.",
+        ClusterDynamicsState());
+
   dislocation_density = material.dislocation_density_0;
 
   state_size = 2 * (max_cluster_size + 2) + 1;
@@ -911,10 +916,32 @@ ClusterDynamicsCudaImpl::ClusterDynamicsCudaImpl(ClusterDynamicsConfig &config)
   thrust::sequence(indices.begin(), indices.end(), 1);
 }
 
-ClusterDynamicsState ClusterDynamicsCudaImpl::run(gp_float total_time) {
+// The integrator is stopped at the times of the sinks, it does not expose
+// its steps
+void ClusterDynamicsCudaImpl::integrate(gp_float total_time) {
+  if (sinks.has_step_sinks())
+    throw ClusterDynamicsException(
+        "Step sinks are not supported by the CUDA backend.",
+        ClusterDynamicsState());
+
+  const gp_float end_time = time + total_time;
+  if (sinks.empty()) {
+    integrate_to(end_time);
+    return;
+  }
+
+  for (gp_float sink_time : sinks.pending_times(time, end_time)) {
+    if (sink_time > time) integrate_to(sink_time);
+    sinks.sample(sink_time, get_state_view(), get_stats());
+  }
+  if (time < end_time) integrate_to(end_time);
+}
+
+// Leaves the end state in the host vectors
+void ClusterDynamicsCudaImpl::integrate_to(gp_float end_time) {
   gp_float out_time;
-  const int sunerr = CVode(cvodes_memory_block, time + total_time, state,
-                           &out_time, CV_NORMAL);
+  const int sunerr =
+      CVode(cvodes_memory_block, end_time, state, &out_time, CV_NORMAL);
   if (sunerr)
     throw ClusterDynamicsException(SUNGetErrMsg(sunerr),
                                    ClusterDynamicsState());
@@ -926,15 +953,84 @@ ClusterDynamicsState ClusterDynamicsCudaImpl::run(gp_float total_time) {
   dislocation_density = *(v_state + max_cluster_size + 2);
   thrust::copy(i_state, i_state + max_cluster_size, host_interstitials.begin());
   thrust::copy(v_state, v_state + max_cluster_size, host_vacancies.begin());
+}
+
+ClusterDynamicsState ClusterDynamicsCudaImpl::run(gp_float total_time) {
+  integrate(total_time);
+  return get_state_view().to_state();
+}
+
+void ClusterDynamicsCudaImpl::run_into(gp_float total_time,
+                                       ClusterDynamicsState &state) {
+  integrate(total_time);
+  get_state_view().copy_to(state);
+}
+
+// The CUDA backend restarts the integration for every sample
+ClusterDynamicsState ClusterDynamicsCudaImpl::sample(
+    const std::vector<gp_float> &sample_times,
+    const ClusterDynamicsSampleFn &on_sample) {
+  ClusterDynamicsState state;
+  for (gp_float sample_time : sample_times) {
+    run_into(sample_time - time, state);
+    on_sample(state);
+  }
+  return state;
+}
+
+ClusterDynamicsState ClusterDynamicsCudaImpl::solve_steady_state() {
+  throw ClusterDynamicsException(
+      "The steady state solver is not supported by the CUDA backend.",
+      ClusterDynamicsState());
+}
+
+void ClusterDynamicsCudaImpl::enable_sensitivities(
+    const std::vector<SensitivityVariable> &) {
+  throw ClusterDynamicsException(
+      "Sensitivities are not supported by the CUDA backend.",
+      ClusterDynamicsState());
+}
+
+std::vector<ClusterDynamicsSensitivity>
+ClusterDynamicsCudaImpl::get_sensitivities() const {
+  throw ClusterDynamicsException(
+      "Sensitivities are not supported by the CUDA backend.",
+      ClusterDynamicsState());
+}
 
-  return ClusterDynamicsState{
+std::map<std::string, gp_float> ClusterDynamicsCudaImpl::adjoint_gradient(
+    gp_float, ScalarObservable) {
+  throw ClusterDynamicsException(
+      "Adjoint gradients are not supported by the CUDA backend.",
+      ClusterDynamicsState());
+}
+
+gp_float ClusterDynamicsCudaImpl::get_time() const { return time; }
+
+// The host vectors hold one more size than the state
+ClusterDynamicsStateView ClusterDynamicsCudaImpl::get_state_view() const {
+  return ClusterDynamicsStateView{
       .time = time,
       .dpa = time * reactor.flux,
-      .interstitials = std::vector<gp_float>(host_interstitials.begin(),
-                                             host_interstitials.end() - 1),
-      .vacancies = std::vector<gp_float>(host_vacancies.begin(),
-                                         host_vacancies.end() - 1),
-      .dislocation_density = dislocation_density};
+      .interstitials = {host_interstitials.data(),
+                        host_interstitials.size() - 1},
+      .vacancies = {host_vacancies.data(), host_vacancies.size() - 1},
+      .dislocation_density = dislocation_density,
+      .interstitial_groups = {},
+      .vacancy_groups = {}};
+}
+
+/** @brief Returns the counters of the integrator. The phases are not timed
+ * on the GPU, so the phase times are 0.
+ */
+ClusterDynamicsStats ClusterDynamicsCudaImpl::get_stats() const {
+  return integrator_stats(cvodes_memory_block);
+}
+
+void ClusterDynamicsCudaImpl::save_checkpoint(const std::string &) const {
+  throw ClusterDynamicsException(
+      "Checkpoints are not supported by the CUDA backend.",
+      ClusterDynamicsState());
 }
 
 MaterialImpl ClusterDynamicsCudaImpl::get_material() const { return material; }
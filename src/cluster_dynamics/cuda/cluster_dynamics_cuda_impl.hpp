@@ -13,12 +13,15 @@
 #include <thrust/transform_reduce.h>
 
 #include <cmath>
+#include <map>
+#include <string>
 #include <vector>
 
 #include "cluster_dynamics/cluster_dynamics_config.hpp"
 #include "cluster_dynamics/cluster_dynamics_state.hpp"
 #include "material_impl.hpp"
 #include "nuclear_reactor_impl.hpp"
+#include "solver_stats.hpp"
 #include "utils/constants.hpp"
 
 #include "../cluster_dynamics_impl.hpp"
@@ -123,7 +126,21 @@ class ClusterDynamicsCudaImpl : public ClusterDynamicsImpl {
   explicit ClusterDynamicsCudaImpl(ClusterDynamicsConfig& config);
   ~ClusterDynamicsCudaImpl();
 
+  void integrate(gp_float total_time);
+  void integrate_to(gp_float end_time);
   ClusterDynamicsState run(gp_float total_time);
+  void run_into(gp_float total_time, ClusterDynamicsState& state);
+  ClusterDynamicsState sample(const std::vector<gp_float>& sample_times,
+                              const ClusterDynamicsSampleFn& on_sample);
+  ClusterDynamicsState solve_steady_state();
+  void enable_sensitivities(const std::vector<SensitivityVariable>& variables);
+  std::vector<ClusterDynamicsSensitivity> get_sensitivities() const;
+  std::map<std::string, gp_float> adjoint_gradient(
+      gp_float total_time, ScalarObservable observable);
+  gp_float get_time() const;
+  ClusterDynamicsStateView get_state_view() const;
+  ClusterDynamicsStats get_stats() const;
+  void save_checkpoint(const std::string& path) const;
   MaterialImpl get_material() const;
   void set_material(const MaterialImpl& material);
   NuclearReactorImpl get_reactor() const;
@@ -0,0 +1,376 @@
+#include "cluster_dynamics/global_sensitivity.hpp"
+
+#include <algorithm>
+#include <array>
+#include <exception>
+#include <numeric>
+#include <random>
+
+#include "cluster_dynamics/cluster_dynamics.hpp"
+#include "utils/thread_pool.hpp"
+
+gp_float sensitivity_variable_value(const ClusterDynamicsConfig &config,
+                                    SensitivityVariable variable) {
+  switch (variable) {
+    case SensitivityVariable::interstitial_migration_ev:
+      return config.material.get_i_migration();
+    case SensitivityVariable::vacancy_migration_ev:
+      return config.material.get_v_migration();
+    case SensitivityVariable::interstitial_formation_ev:
+      return config.material.get_i_formation();
+    case SensitivityVariable::vacancy_formation_ev:
+      return config.material.get_v_formation();
+    case SensitivityVariable::interstitial_binding_ev:
+      return config.material.get_i_binding();
+    case SensitivityVariable::vacancy_binding_ev:
+      return config.material.get_v_binding();
+    case SensitivityVariable::initial_dislocation_density_cm:
+      return config.material.get_dislocation_density_0();
+    case SensitivityVariable::flux_dpa_s:
+      return config.reactor.get_flux();
+    case SensitivityVariable::temperature_kelvin:
+      return config.reactor.get_temperature();
+    case SensitivityVariable::dislocation_density_evolution:
+      return config.reactor.get_dislocation_density_evolution();
+    default:
+      break;
+  }
+
+  return 0.;
+}
+
+void set_sensitivity_variable(ClusterDynamicsConfig &config,
+                              SensitivityVariable variable, gp_float value) {
+  switch (variable) {
+    case SensitivityVariable::interstitial_migration_ev:
+      config.material.set_i_migration(value);
+      break;
+    case SensitivityVariable::vacancy_migration_ev:
+      config.material.set_v_migration(value);
+      break;
+    case SensitivityVariable::interstitial_formation_ev:
+      config.material.set_i_formation(value);
+      break;
+    case SensitivityVariable::vacancy_formation_ev:
+      config.material.set_v_formation(value);
+      break;
+    case SensitivityVariable::interstitial_binding_ev:
+      config.material.set_i_binding(value);
+      break;
+    case SensitivityVariable::vacancy_binding_ev:
+      config.material.set_v_binding(value);
+      break;
+    case SensitivityVariable::initial_dislocation_density_cm:
+      config.material.set_dislocation_density_0(value);
+      break;
+    case SensitivityVariable::flux_dpa_s:
+      config.reactor.set_flux(value);
+      break;
+    case SensitivityVariable::temperature_kelvin:
+      config.reactor.set_temperature(value);
+      break;
+    case SensitivityVariable::dislocation_density_evolution:
+      config.reactor.set_dislocation_density_evolution(value);
+      break;
+    default:
+      break;
+  }
+}
+
+gp_float observable_value(const ClusterDynamicsConfig &config,
+                          const ClusterDynamicsState &state,
+                          ScalarObservable observable) {
+  switch (observable) {
+    case ScalarObservable::dislocation_density:
+      return state.dislocation_density;
+    case ScalarObservable::vacancy_cluster_volume: {
+      const std::vector<gp_float> vacancies = state.expanded().vacancies;
+      gp_float volume = 0.;
+      for (size_t n = 2; n < vacancies.size(); ++n)
+        volume += (gp_float)n * vacancies[n];
+      return config.material.get_atomic_volume() * volume;
+    }
+  }
+
+  return 0.;
+}
+
+// --------------------------------------------------------------------------------------------
+// SaltelliSampler
+
+namespace {
+/* Sobol' direction numbers of dimensions 2 and up from S. Joe and F. Y. Kuo,
+ * SIAM J. Sci. Comput. 30 (2008), new-joe-kuo-6.21201: the degree s of the
+ * primitive polynomial, its inner coefficients a and the initial m_1..m_s */
+struct SobolPolynomial {
+  uint32_t s;
+  uint32_t a;
+  std::array<uint32_t, 7> m;
+};
+
+constexpr std::array<SobolPolynomial,
+                     SaltelliSampler::max_sobol_dimensions - 1>
+    sobol_polynomials{{{1, 0, {1}},
+                       {2, 1, {1, 3}},
+                       {3, 1, {1, 3, 1}},
+                       {3, 2, {1, 1, 1}},
+                       {4, 1, {1, 1, 3, 3}},
+                       {4, 4, {1, 3, 5, 13}},
+                       {5, 2, {1, 1, 5, 5, 17}},
+                       {5, 4, {1, 1, 5, 5, 5}},
+                       {5, 7, {1, 1, 7, 11, 19}},
+                       {5, 11, {1, 1, 5, 1, 1}},
+                       {5, 13, {1, 1, 1, 3, 11}},
+                       {5, 14, {1, 3, 5, 5, 31}},
+                       {6, 1, {1, 3, 3, 9, 7, 49}},
+                       {6, 13, {1, 1, 1, 15, 21, 21}},
+                       {6, 16, {1, 3, 1, 13, 27, 49}},
+                       {6, 19, {1, 1, 1, 15, 7, 5}},
+                       {6, 22, {1, 3, 1, 15, 13, 25}},
+                       {6, 25, {1, 1, 5, 5, 19, 61}},
+                       {7, 1, {1, 3, 7, 11, 23, 15, 103}},
+                       {7, 4, {1, 3, 7, 13, 13, 15, 69}}}};
+
+constexpr size_t sobol_bits = 32;
+}  // namespace
+
+SaltelliSampler::SaltelliSampler(SamplingMethod method, size_t num_samples,
+                                 size_t num_parameters, uint64_t seed)
+    : method(method), num_samples(num_samples), num_parameters(num_parameters) {
+  const size_t dimensions = 2 * num_parameters;
+
+  if (method == SamplingMethod::sobol) {
+    if (dimensions > max_sobol_dimensions)
+      throw ClusterDynamicsException(
+          "The Sobol' sequence supports at most " +
+              std::to_string(max_sobol_dimensions / 2) + " parameters.",
+          ClusterDynamicsState());
+
+    directions.resize(dimensions * sobol_bits);
+    for (size_t d = 0; d < dimensions; ++d) {
+      std::array<uint32_t, sobol_bits + 1> m;
+      if (d == 0) {
+        m.fill(1);
+      } else {
+        const SobolPolynomial &p = sobol_polynomials[d - 1];
+        for (uint32_t i = 1; i <= sobol_bits; ++i) {
+          if (i <= p.s) {
+            m[i] = p.m[i - 1];
+            continue;
+          }
+          m[i] = m[i - p.s] ^ (m[i - p.s] << p.s);
+          for (uint32_t k = 1; k < p.s; ++k)
+            if ((p.a >> (p.s - 1 - k)) & 1) m[i] ^= m[i - k] << k;
+        }
+      }
+      for (uint32_t i = 1; i <= sobol_bits; ++i)
+        directions[d * sobol_bits + i - 1] = m[i] << (sobol_bits - i);
+    }
+  } else {
+    // Each column visits the strata of [0, 1) in its own random order
+    std::mt19937_64 generator(seed);
+    std::uniform_real_distribution<gp_float> offset(0., 1.);
+    std::vector<size_t> strata(num_samples);
+    points.resize(num_samples * dimensions);
+    for (size_t d = 0; d < dimensions; ++d) {
+      std::iota(strata.begin(), strata.end(), 0);
+      std::shuffle(strata.begin(), strata.end(), generator);
+      for (size_t j = 0; j < num_samples; ++j)
+        points[j * dimensions + d] =
+            ((gp_float)strata[j] + offset(generator)) / (gp_float)num_samples;
+    }
+  }
+}
+
+void SaltelliSampler::sample(size_t j, std::vector<gp_float> &a,
+                             std::vector<gp_float> &b) const {
+  a.resize(num_parameters);
+  b.resize(num_parameters);
+
+  if (method == SamplingMethod::sobol) {
+    // Point j + 1 in Gray code order, the first point is the origin
+    const uint64_t index = j + 1;
+    const uint64_t gray = index ^ (index >> 1);
+    for (size_t d = 0; d < 2 * num_parameters; ++d) {
+      uint32_t x = 0;
+      for (size_t bit = 0; bit < sobol_bits && (gray >> bit); ++bit)
+        if ((gray >> bit) & 1) x ^= directions[d * sobol_bits + bit];
+      const gp_float u = (gp_float)x / 4294967296.;
+      (d < num_parameters ? a[d] : b[d - num_parameters]) = u;
+    }
+  } else {
+    const gp_float *row = points.data() + j * 2 * num_parameters;
+    std::copy(row, row + num_parameters, a.begin());
+    std::copy(row + num_parameters, row + 2 * num_parameters, b.begin());
+  }
+}
+
+// --------------------------------------------------------------------------------------------
+// SobolAccumulator
+
+SobolAccumulator::SobolAccumulator(size_t num_parameters)
+    : n(0),
+      mean_val(0.),
+      squared_deviations(0.),
+      first_order_sums(num_parameters, 0.),
+      total_sums(num_parameters, 0.) {}
+
+void SobolAccumulator::add(gp_float f_a, gp_float f_b,
+                           const std::vector<gp_float> &f_ab) {
+  ++n;
+  for (size_t k = 0; k < 2; ++k) {
+    const gp_float f = k == 0 ? f_a : f_b;
+    const gp_float delta = f - mean_val;
+    mean_val += delta / (gp_float)(2 * n - 1 + k);
+    squared_deviations += delta * (f - mean_val);
+  }
+
+  for (size_t i = 0; i < first_order_sums.size(); ++i) {
+    first_order_sums[i] += f_b * (f_ab[i] - f_a);
+    total_sums[i] += (f_a - f_ab[i]) * (f_a - f_ab[i]);
+  }
+}
+
+size_t SobolAccumulator::num_samples() const { return n; }
+
+gp_float SobolAccumulator::mean() const { return mean_val; }
+
+gp_float SobolAccumulator::variance() const {
+  return n ? squared_deviations / (gp_float)(2 * n) : 0.;
+}
+
+gp_float SobolAccumulator::first_order(size_t i) const {
+  const gp_float v = variance();
+  return v > 0. ? first_order_sums[i] / (gp_float)n / v : 0.;
+}
+
+gp_float SobolAccumulator::total(size_t i) const {
+  const gp_float v = variance();
+  return v > 0. ? .5 * total_sums[i] / (gp_float)n / v : 0.;
+}
+
+// --------------------------------------------------------------------------------------------
+// GlobalSensitivityAnalysis
+
+GlobalSensitivityAnalysis::GlobalSensitivityAnalysis(
+    const ClusterDynamicsConfig &config,
+    const std::vector<ParameterRange> &ranges,
+    const std::vector<ScalarObservable> &observables, SamplingMethod method,
+    size_t num_samples, uint64_t seed)
+    : config(config),
+      ranges(ranges),
+      observables(observables),
+      num_samples(num_samples),
+      sampler(method, num_samples, ranges.size(), seed) {
+  if (ranges.empty())
+    throw ClusterDynamicsException(
+        "A global sensitivity analysis needs at least one parameter range.",
+        ClusterDynamicsState());
+  if (observables.empty())
+    throw ClusterDynamicsException(
+        "A global sensitivity analysis needs at least one observable.",
+        ClusterDynamicsState());
+  if (num_samples == 0)
+    throw ClusterDynamicsException(
+        "A global sensitivity analysis needs at least one sample.",
+        ClusterDynamicsState());
+
+  for (const ParameterRange &range : ranges) {
+    if (range.variable == SensitivityVariable::NONE)
+      throw ClusterDynamicsException("Unknown sensitivity variable.",
+                                     ClusterDynamicsState());
+    if (!(range.min <= range.max))
+      throw ClusterDynamicsException(
+          "The minimum of a parameter range must not exceed its maximum.",
+          ClusterDynamicsState());
+  }
+}
+
+size_t GlobalSensitivityAnalysis::num_simulations() const {
+  return num_samples * (ranges.size() + 2);
+}
+
+std::vector<GlobalSensitivity> GlobalSensitivityAnalysis::run(
+    const Simulation &simulate, size_t num_threads,
+    const std::function<void(size_t)> &progress) const {
+  if (num_threads == 0)
+    throw ClusterDynamicsException("The number of threads must be at least 1.",
+                                   ClusterDynamicsState());
+
+  const size_t num_parameters = ranges.size();
+  // Rows of A, B and the A_B^(i) of a sample
+  const size_t runs_per_sample = num_parameters + 2;
+  const size_t batch_size = std::min(num_threads, num_samples);
+
+  std::vector<SobolAccumulator> accumulators(
+      observables.size(), SobolAccumulator(num_parameters));
+  // Observables of the runs of the current batch
+  std::vector<gp_float> values(batch_size * runs_per_sample *
+                               observables.size());
+  std::vector<std::exception_ptr> errors(batch_size * runs_per_sample);
+  ThreadPool pool(std::min(num_threads, batch_size * runs_per_sample));
+
+  auto run_one = [&](size_t first_sample, size_t k) {
+    const size_t j = first_sample + k / runs_per_sample;
+    const size_t r = k % runs_per_sample;
+    try {
+      std::vector<gp_float> a, b;
+      sampler.sample(j, a, b);
+      const std::vector<gp_float> &u = r == 1 ? b : a;
+
+      ClusterDynamicsConfig run_config = config;
+      for (size_t i = 0; i < num_parameters; ++i) {
+        const gp_float u_i = r >= 2 && i == r - 2 ? b[i] : u[i];
+        set_sensitivity_variable(
+            run_config, ranges[i].variable,
+            ranges[i].min + u_i * (ranges[i].max - ranges[i].min));
+      }
+
+      const ClusterDynamicsState state = simulate(run_config);
+      for (size_t o = 0; o < observables.size(); ++o)
+        values[k * observables.size() + o] =
+            observable_value(run_config, state, observables[o]);
+    } catch (...) {
+      errors[k] = std::current_exception();
+    }
+  };
+
+  std::vector<gp_float> f_ab(num_parameters);
+  for (size_t first = 0; first < num_samples; first += batch_size) {
+    const size_t count = std::min(batch_size, num_samples - first);
+    pool.parallel_for(count * runs_per_sample,
+                      [&](size_t k) { run_one(first, k); });
+
+    for (size_t k = 0; k < count * runs_per_sample; ++k)
+      if (errors[k]) std::rethrow_exception(errors[k]);
+
+    // Fold the batch in sample order
+    for (size_t s = 0; s < count; ++s) {
+      for (size_t o = 0; o < observables.size(); ++o) {
+        auto f = [&](size_t r) {
+          return values[(s * runs_per_sample + r) * observables.size() + o];
+        };
+        for (size_t i = 0; i < num_parameters; ++i) f_ab[i] = f(i + 2);
+        accumulators[o].add(f(0), f(1), f_ab);
+      }
+    }
+
+    if (progress) progress((first + count) * runs_per_sample);
+  }
+
+  std::vector<GlobalSensitivity> result;
+  for (size_t o = 0; o < observables.size(); ++o) {
+    GlobalSensitivity sensitivity{.observable = observables[o],
+                                  .mean = accumulators[o].mean(),
+                                  .variance = accumulators[o].variance(),
+                                  .indices = {}};
+    for (size_t i = 0; i < num_parameters; ++i)
+      sensitivity.indices.push_back(
+          SobolIndices{.variable = ranges[i].variable,
+                       .first_order = accumulators[o].first_order(i),
+                       .total = accumulators[o].total(i)});
+    result.push_back(sensitivity);
+  }
+
+  return result;
+}
@@ -37,7 +37,9 @@ gp_float Material::get_i_migration() const { return _impl->i_migration; }
 /** @brief Sets the single interstitial migration energy.
  *  @param val Migration energy in units of eV.
  * */
-void Material::set_i_migration(const gp_float val) { _impl->i_migration = val; }
+void Material::set_i_migration(const gp_float val) {
+  mutable_impl()->i_migration = val;
+}
 
 /// @brief Returns the single vacancy migration energy in eV.
 gp_float Material::get_v_migration() const { return _impl->v_migration; }
@@ -45,7 +47,9 @@ gp_float Material::get_v_migration() const { return _impl->v_migration; }
 /** @brief Sets the single vacancy migration energy.
  *  @param val Migration energy in units of eV.
  * */
-void Material::set_v_migration(const gp_float val) { _impl->v_migration = val; }
+void Material::set_v_migration(const gp_float val) {
+  mutable_impl()->v_migration = val;
+}
 
 /// @brief Returns the single interstitial preexponential diffusion constant in
 /// cm^2/s.
@@ -55,7 +59,7 @@ gp_float Material::get_i_diffusion_0() const { return _impl->i_diffusion_0; }
  *  @param val Preexponential diffusion constant in units of cm^2/s.
  * */
 void Material::set_i_diffusion_0(const gp_float val) {
-  _impl->i_diffusion_0 = val;
+  mutable_impl()->i_diffusion_0 = val;
 }
 
 /// @brief Returns the single vacancy preexponential diffusion constant in
@@ -66,7 +70,7 @@ gp_float Material::get_v_diffusion_0() const { return _impl->v_diffusion_0; }
  *  @param val Preexponential diffusion constant in units of cm^2/s.
  * */
 void Material::set_v_diffusion_0(const gp_float val) {
-  _impl->v_diffusion_0 = val;
+  mutable_impl()->v_diffusion_0 = val;
 }
 
 /// @brief Returns the interstitial formation energy in eV.
@@ -75,7 +79,9 @@ gp_float Material::get_i_formation() const { return _impl->i_formation; }
 /** @brief Sets the the interstitial formation energy.
  *  @param val Formation energy in units of eV.
  * */
-void Material::set_i_formation(const gp_float val) { _impl->i_formation = val; }
+void Material::set_i_formation(const gp_float val) {
+  mutable_impl()->i_formation = val;
+}
 
 /// @brief Returns the vacancy formation energy in eV.
 gp_float Material::get_v_formation() const { return _impl->v_formation; }
@@ -83,7 +89,9 @@ gp_float Material::get_v_formation() const { return _impl->v_formation; }
 /** @brief Sets the the vacancy formation energy.
  *  @param val Formation energy in units of eV.
  * */
-void Material::set_v_formation(const gp_float val) { _impl->v_formation = val; }
+void Material::set_v_formation(const gp_float val) {
+  mutable_impl()->v_formation = val;
+}
 
 /// @brief Binding energy for size 2 interstitials in eV.
 gp_float Material::get_i_binding() const { return _impl->i_binding; }
@@ -91,7 +99,9 @@ gp_float Material::get_i_binding() const { return _impl->i_binding; }
 /** @brief Sets the the vacancy formation energy.
  *  @param val Binding energy in units of eV.
  * */
-void Material::set_i_binding(const gp_float val) { _impl->i_binding = val; }
+void Material::set_i_binding(const gp_float val) {
+  mutable_impl()->i_binding = val;
+}
 
 /// @brief Binding energy for size 2 vacancies in eV.
 gp_float Material::get_v_binding() const { return _impl->v_binding; }
@@ -99,7 +109,9 @@ gp_float Material::get_v_binding() const { return _impl->v_binding; }
 /** @brief Sets the the binding energy for size 2 vacancies.
  *  @param val Binding energy in units of eV.
  * */
-void Material::set_v_binding(const gp_float val) { _impl->v_binding = val; }
+void Material::set_v_binding(const gp_float val) {
+  mutable_impl()->v_binding = val;
+}
 
 /// @brief Recombination radius of point defects in cm.
 gp_float Material::get_recombination_radius() const {
@@ -108,7 +120,7 @@ gp_float Material::get_recombination_radius() const {
 /// @brief Sets the recombination radius of point defects.
 /// @param val Recombination radius in units of cm
 void Material::set_recombination_radius(const gp_float val) {
-  _impl->recombination_radius = val;
+  mutable_impl()->recombination_radius = val;
 }
 
 /// @brief Returns the interstitial loop bias factor.
@@ -116,7 +128,9 @@ gp_float Material::get_i_loop_bias() const { return _impl->i_loop_bias; }
 
 /// @brief Sets the interstitial loop bias factor.
 /// @param val Interstitial loop bias factor.
-void Material::set_i_loop_bias(const gp_float val) { _impl->i_loop_bias = val; }
+void Material::set_i_loop_bias(const gp_float val) {
+  mutable_impl()->i_loop_bias = val;
+}
 
 //!< \todo Get better descriptions for the bias factors
 /// @brief Returns the interstitial dislocation bias factor.
@@ -127,7 +141,7 @@ gp_float Material::get_i_dislocation_bias() const {
 /// @brief Sets the interstitial dislocation bias factor.
 /// @param val Interstitial dislocation bias factor.
 void Material::set_i_dislocation_bias(const gp_float val) {
-  _impl->i_dislocation_bias = val;
+  mutable_impl()->i_dislocation_bias = val;
 }
 
 /// @brief Returns the interstitial dislocation bias parameter.
@@ -138,7 +152,7 @@ gp_float Material::get_i_dislocation_bias_param() const {
 /// @brief Sets the interstitial dislocation bias parameter.
 /// @param val Interstitial dislocation bias parameter.
 void Material::set_i_dislocation_bias_param(const gp_float val) {
-  _impl->i_dislocation_bias_param = val;
+  mutable_impl()->i_dislocation_bias_param = val;
 }
 
 /// @brief Returns the vacancy loop bias factor.
@@ -146,7 +160,9 @@ gp_float Material::get_v_loop_bias() const { return _impl->v_loop_bias; }
 
 /// @brief Sets the vacancy loop bias factor.
 /// @param val Vacancy loop bias factor.
-void Material::set_v_loop_bias(const gp_float val) { _impl->v_loop_bias = val; }
+void Material::set_v_loop_bias(const gp_float val) {
+  mutable_impl()->v_loop_bias = val;
+}
 
 /// @brief Returns the vacancy dislocation bias factor.
 gp_float Material::get_v_dislocation_bias() const {
@@ -156,7 +172,7 @@ gp_float Material::get_v_dislocation_bias() const {
 /// @brief Sets the vacancy dislocation bias factor.
 /// @param val Dislocation bias factor.
 void Material::set_v_dislocation_bias(const gp_float val) {
-  _impl->v_dislocation_bias = val;
+  mutable_impl()->v_dislocation_bias = val;
 }
 
 /// @brief Returns the vacancy dislocation bias parameter.
@@ -167,7 +183,7 @@ gp_float Material::get_v_dislocation_bias_param() const {
 /// @brief Sets the vacancy dislocation bias parameter.
 /// @param val Vacancy dislocation bias parameter.
 void Material::set_v_dislocation_bias_param(const gp_float val) {
-  _impl->v_dislocation_bias_param = val;
+  mutable_impl()->v_dislocation_bias_param = val;
 }
 
 /// @brief Returns the initial dislocation network density in cm^-2.
@@ -178,7 +194,7 @@ gp_float Material::get_dislocation_density_0() const {
 /// @brief Sets the initial dislocation network density.
 /// @param val Initial dislocation network density in cm^-2.
 void Material::set_dislocation_density_0(const gp_float val) {
-  _impl->dislocation_density_0 = val;
+  mutable_impl()->dislocation_density_0 = val;
 }
 
 /// @brief Returns the grain size in cm.
@@ -186,7 +202,9 @@ gp_float Material::get_grain_size() const { return _impl->grain_size; }
 
 /// @brief Sets the grain size.
 /// @param val Grain size in cm.
-void Material::set_grain_size(const gp_float val) { _impl->grain_size = val; }
+void Material::set_grain_size(const gp_float val) {
+  mutable_impl()->grain_size = val;
+}
 
 /// @brief Returns the lattice parameter in cm.
 gp_float Material::get_lattice_param() const { return _impl->lattice_param; }
@@ -194,9 +212,10 @@ gp_float Material::get_lattice_param() const { return _impl->lattice_param; }
 /// @brief Sets the lattice parameter.
 /// @param val Lattice parameter in cm.
 void Material::set_lattice_param(const gp_float val) {
-  _impl->lattice_param = val;
-  _impl->burgers_vector = _impl->lattice_param / std::sqrt(2.);
-  _impl->atomic_volume = std::pow(_impl->lattice_param, 3) / 4.;  // cm^3
+  MaterialImpl &impl = *mutable_impl();
+  impl.lattice_param = val;
+  impl.burgers_vector = impl.lattice_param / std::sqrt(2.);
+  impl.atomic_volume = std::pow(impl.lattice_param, 3) / 4.;  // cm^3
 }
 
 /// @brief Returns the magnitude of the burgers vector.
@@ -205,7 +224,7 @@ gp_float Material::get_burgers_vector() const { return _impl->burgers_vector; }
 /// @brief Sets the magnitude of the burgers vector.
 /// @param val Magnitude of the burgers vector.
 void Material::set_burgers_vector(const gp_float val) {
-  _impl->burgers_vector = val;
+  mutable_impl()->burgers_vector = val;
 }
 
 /// @brief Returns the average volume of a single atom in the material lattice
@@ -215,11 +234,19 @@ gp_float Material::get_atomic_volume() const { return _impl->atomic_volume; }
 /// @brief Sets the average volume of a single atom in the material lattice.
 /// @param val Atomic volume in cm^3.
 void Material::set_atomic_volume(const gp_float val) {
-  _impl->atomic_volume = val;
+  mutable_impl()->atomic_volume = val;
 }
 
 /// @brief Returns a raw pointer to the underlying MaterialImpl object.
-MaterialImpl *Material::impl() { return _impl.get(); }
+const MaterialImpl *Material::impl() const { return _impl.get(); }
+
+/** @brief Returns a raw pointer to the underlying MaterialImpl object for
+ * writing, which is first copied if other Materials share it.
+ */
+MaterialImpl *Material::mutable_impl() {
+  if (_impl.use_count() > 1) _impl = std::make_shared<MaterialImpl>(*_impl);
+  return _impl.get();
+}
 
 namespace materials {
 
@@ -232,78 +259,81 @@ void SA304(Material &material) {
   gp_float lattice_param = lattice_params::fcc_nickel;
 
   material.species = "SA304";
-  material._impl->i_migration = .45;             // eV
-  material._impl->v_migration = 1.35;            // eV
-  material._impl->i_diffusion_0 = 1e-3;          // cm^2/s
-  material._impl->v_diffusion_0 = .6;            // cm^2/s
-  material._impl->i_formation = 4.1;             // eV
-  material._impl->v_formation = 1.7;             // eV
-  material._impl->i_binding = .6;                // eV
-  material._impl->v_binding = .5;                // eV
-  material._impl->recombination_radius = .7e-7;  // cm
-  material._impl->i_loop_bias = 63.;
-  material._impl->i_dislocation_bias = .8;
-  material._impl->i_dislocation_bias_param = 1.1;
-  material._impl->v_loop_bias = 33.;
-  material._impl->v_dislocation_bias = .65;
-  material._impl->v_dislocation_bias_param = 1.;
-  material._impl->dislocation_density_0 = 1. / (gp_float)M_CM_CONV(10e10);
-  material._impl->grain_size = 4e-3;
-  material._impl->lattice_param = lattice_param;  // cm
-  material._impl->burgers_vector = lattice_param / std::sqrt(2.);
-  material._impl->atomic_volume = std::pow(lattice_param, 3) / 4.;  // cm^3
+  MaterialImpl &impl = *material.mutable_impl();
+  impl.i_migration = .45;             // eV
+  impl.v_migration = 1.35;            // eV
+  impl.i_diffusion_0 = 1e-3;          // cm^2/s
+  impl.v_diffusion_0 = .6;            // cm^2/s
+  impl.i_formation = 4.1;             // eV
+  impl.v_formation = 1.7;             // eV
+  impl.i_binding = .6;                // eV
+  impl.v_binding = .5;                // eV
+  impl.recombination_radius = .7e-7;  // cm
+  impl.i_loop_bias = 63.;
+  impl.i_dislocation_bias = .8;
+  impl.i_dislocation_bias_param = 1.1;
+  impl.v_loop_bias = 33.;
+  impl.v_dislocation_bias = .65;
+  impl.v_dislocation_bias_param = 1.;
+  impl.dislocation_density_0 = 1. / (gp_float)M_CM_CONV(10e10);
+  impl.grain_size = 4e-3;
+  impl.lattice_param = lattice_param;  // cm
+  impl.burgers_vector = lattice_param / std::sqrt(2.);
+  impl.atomic_volume = std::pow(lattice_param, 3) / 4.;  // cm^3
 }
 
 void CW316(Material &material) {
   gp_float lattice_param = lattice_params::chromium;
 
   material.species = "CW316";
-  material._impl->i_migration = .43;             // eV
-  material._impl->v_migration = 1.35;            // eV
-  material._impl->i_diffusion_0 = 1e-3;          // cm^2/s
-  material._impl->v_diffusion_0 = .6;            // cm^2/s
-  material._impl->i_formation = 4.1;             // eV
-  material._impl->v_formation = 1.7;             // eV
-  material._impl->i_binding = .6;                // eV
-  material._impl->v_binding = .5;                // eV
-  material._impl->recombination_radius = .7e-7;  // cm
-  material._impl->i_loop_bias = 63.;
-  material._impl->i_dislocation_bias = .8;
-  material._impl->i_dislocation_bias_param = 1.1;
-  material._impl->v_loop_bias = 33.;
-  material._impl->v_dislocation_bias = .65;
-  material._impl->v_dislocation_bias_param = 1.;
-  material._impl->dislocation_density_0 = 1. / (gp_float)M_CM_CONV(10e10);
-  material._impl->grain_size = 4e-3;
-  material._impl->lattice_param = lattice_param;  // cm
-  material._impl->burgers_vector = lattice_param / std::sqrt(2.);
-  material._impl->atomic_volume = std::pow(lattice_param, 3) / 4.;  // cm^3
+  MaterialImpl &impl = *material.mutable_impl();
+  impl.i_migration = .43;             // eV
+  impl.v_migration = 1.35;            // eV
+  impl.i_diffusion_0 = 1e-3;          // cm^2/s
+  impl.v_diffusion_0 = .6;            // cm^2/s
+  impl.i_formation = 4.1;             // eV
+  impl.v_formation = 1.7;             // eV
+  impl.i_binding = .6;                // eV
+  impl.v_binding = .5;                // eV
+  impl.recombination_radius = .7e-7;  // cm
+  impl.i_loop_bias = 63.;
+  impl.i_dislocation_bias = .8;
+  impl.i_dislocation_bias_param = 1.1;
+  impl.v_loop_bias = 33.;
+  impl.v_dislocation_bias = .65;
+  impl.v_dislocation_bias_param = 1.;
+  impl.dislocation_density_0 = 1. / (gp_float)M_CM_CONV(10e10);
+  impl.grain_size = 4e-3;
+  impl.lattice_param = lattice_param;  // cm
+  impl.burgers_vector = lattice_param / std::sqrt(2.);
+  impl.atomic_volume = std::pow(lattice_param, 3) / 4.;  // cm^3
 }
 
 void CW316Ti(Material &material) {
   gp_float lattice_param = lattice_params::chromium;
 
   material.species = "CW316Ti";
-  material._impl->i_migration = .43;             // eV
-  material._impl->v_migration = 1.35;            // eV
-  material._impl->i_diffusion_0 = 1e-3;          // cm^2/s
-  material._impl->v_diffusion_0 = .6;            // cm^2/s
-  material._impl->i_formation = 4.1;             // eV
-  material._impl->v_formation = 1.7;             // eV
-  material._impl->i_binding = .6;                // eV
-  material._impl->v_binding = .5;                // eV
-  material._impl->recombination_radius = .7e-7;  // cm
-  material._impl->i_loop_bias = 63.;
-  material._impl->i_dislocation_bias = .8;
-  material._impl->i_dislocation_bias_param = 1.1;
-  material._impl->v_loop_bias = 33.;
-  material._impl->v_dislocation_bias = .65;
-  material._impl->v_dislocation_bias_param = 1.;
-  material._impl->dislocation_density_0 = 1. / (gp_float)M_CM_CONV(10e10);
-  material._impl->grain_size = 4e-3;
-  material._impl->lattice_param = lattice_param;  // cm
-  material._impl->burgers_vector = lattice_param / std::sqrt(2.);
-  material._impl->atomic_volume = std::pow(lattice_param, 3) / 4.;  // cm^3
+  MaterialImpl &impl = *material.mutable_impl();
+  impl.i_migration = .43;             // eV
+  impl.v_migration = 1.35;            // eV
+  impl.i_diffusion_0 = 1e-3;          // cm^2/s
+  impl.v_diffusion_0 = .6;            // cm^2/s
+  impl.i_formation = 4.1;             // eV
+  impl.v_formation = 1.7;             // eV
+  impl.i_binding = .6;                // eV
+  impl.v_binding = .5;                // eV
+  impl.recombination_radius = .7e-7;  // cm
+  impl.i_loop_bias = 63.;
+  impl.i_dislocation_bias = .8;
+  impl.i_dislocation_bias_param = 1.1;
+  impl.v_loop_bias = 33.;
+  impl.v_dislocation_bias = .65;
+  impl.v_dislocation_bias_param = 1.;
+  impl.dislocation_density_0 = 1. / (gp_float)M_CM_CONV(10e10);
+  impl.grain_size = 4e-3;
+  impl.lattice_param = lattice_param;  // cm
+  impl.burgers_vector = lattice_param / std::sqrt(2.);
+  impl.atomic_volume = std::pow(lattice_param, 3) / 4.;  // cm^3
 }
 
 }  // namespace materials
@@ -36,7 +36,9 @@ gp_float NuclearReactor::get_flux() const { return _impl->flux; }
 
 /// @brief Sets the neutron flux through the material.
 /// @param val Neutron flux in dpa/s
-void NuclearReactor::set_flux(const gp_float val) { _impl->flux = val; }
+void NuclearReactor::set_flux(const gp_float val) {
+  mutable_impl()->flux = val;
+}
 
 /// @brief Returns the temperature in Kelvin.
 gp_float NuclearReactor::get_temperature() const { return _impl->temperature; }
@@ -44,7 +46,7 @@ gp_float NuclearReactor::get_temperature() const { return _impl->temperature; }
 /// @brief Sets the temperature.
 /// @param val Temperature in Kelvin
 void NuclearReactor::set_temperature(const gp_float val) {
-  _impl->temperature = val;
+  mutable_impl()->temperature = val;
 }
 
 /// @brief Returns the recombination factor for collision cascades.
@@ -55,7 +57,7 @@ gp_float NuclearReactor::get_recombination() const {
 /// @brief Sets the recombination factor for collision cascades.
 /// @param val Recombination factor
 void NuclearReactor::set_recombination(const gp_float val) {
-  _impl->recombination = val;
+  mutable_impl()->recombination = val;
 }
 
 /// @brief Returns the fraction of generated interstitial clusters which are
@@ -65,7 +67,9 @@ gp_float NuclearReactor::get_i_bi() const { return _impl->i_bi; }
 /// @brief Sets the fraction of generated interstitial clusters which are
 /// size 2.
 /// @param val Fraction of generated interstitial clusters which are size 2
-void NuclearReactor::set_i_bi(const gp_float val) { _impl->i_bi = val; }
+void NuclearReactor::set_i_bi(const gp_float val) {
+  mutable_impl()->i_bi = val;
+}
 
 /// @brief Returns the fraction of generated interstitial clusters which are
 /// size 3.
@@ -74,7 +78,9 @@ gp_float NuclearReactor::get_i_tri() const { return _impl->i_tri; }
 /// @brief Sets the fraction of generated interstitial clusters which are
 /// size 3.
 /// @param val Fraction of generated interstitial clusters which are size 3
-void NuclearReactor::set_i_tri(const gp_float val) { _impl->i_tri = val; }
+void NuclearReactor::set_i_tri(const gp_float val) {
+  mutable_impl()->i_tri = val;
+}
 
 /// @brief Returns the fraction of generated interstitial clusters which are
 /// size 4.
@@ -83,28 +89,36 @@ gp_float NuclearReactor::get_i_quad() const { return _impl->i_quad; }
 /// @brief Sets the fraction of generated interstitial clusters which are
 /// size 4.
 /// @param val Fraction of generated interstitial clusters which are size 4.
-void NuclearReactor::set_i_quad(const gp_float val) { _impl->i_quad = val; }
+void NuclearReactor::set_i_quad(const gp_float val) {
+  mutable_impl()->i_quad = val;
+}
 
 /// @brief Returns the fraction of generated vacancy clusters which are size 2.
 gp_float NuclearReactor::get_v_bi() const { return _impl->v_bi; }
 
 /// @brief Sets the fraction of generated vacancy clusters which are size 2.
 /// @param val Fraction of generated vacancy clusters which are size 2.
-void NuclearReactor::set_v_bi(const gp_float val) { _impl->v_bi = val; }
+void NuclearReactor::set_v_bi(const gp_float val) {
+  mutable_impl()->v_bi = val;
+}
 
 /// @brief Returns the fraction of generated vacancy clusters which are size 3.
 gp_float NuclearReactor::get_v_tri() const { return _impl->v_tri; }
 
 /// @brief Sets the fraction of generated vacancy clusters which are size 3.
 /// @param val Fraction of generated vacancy clusters which are size 3.
-void NuclearReactor::set_v_tri(const gp_float val) { _impl->v_tri = val; }
+void NuclearReactor::set_v_tri(const gp_float val) {
+  mutable_impl()->v_tri = val;
+}
 
 /// @brief Returns the fraction of generated vacancy clusters which are size 4.
 gp_float NuclearReactor::get_v_quad() const { return _impl->v_quad; }
 
 /// @brief Sets the fraction of generated vacancy clusters which are size 4.
 /// @param val Fraction of generated vacancy clusters which are size 4.
-void NuclearReactor::set_v_quad(const gp_float val) { _impl->v_quad = val; }
+void NuclearReactor::set_v_quad(const gp_float val) {
+  mutable_impl()->v_quad = val;
+}
 
 /// @brief Returns the parameter of dislocation network evolution.
 gp_float NuclearReactor::get_dislocation_density_evolution() const {
@@ -114,10 +128,20 @@ gp_float NuclearReactor::get_dislocation_density_evolution() const {
 /// @brief Sets the parameter of dislocation network evolution.
 /// @param val The parameter of dislocation network evolution.
 void NuclearReactor::set_dislocation_density_evolution(const gp_float val) {
-  _impl->dislocation_density_evolution = val;
+  mutable_impl()->dislocation_density_evolution = val;
 }
 
-NuclearReactorImpl *NuclearReactor::impl() { return _impl.get(); }
+/// @brief Returns a raw pointer to the underlying NuclearReactorImpl object.
+const NuclearReactorImpl *NuclearReactor::impl() const { return _impl.get(); }
+
+/** @brief Returns a raw pointer to the underlying NuclearReactorImpl object
+ * for writing, which is first copied if other NuclearReactors share it.
+ */
+NuclearReactorImpl *NuclearReactor::mutable_impl() {
+  if (_impl.use_count() > 1)
+    _impl = std::make_shared<NuclearReactorImpl>(*_impl);
+  return _impl.get();
+}
 
 namespace nuclear_reactors {
 /** @brief A function which fills a NuclearReactor object with parameters that
@@ -127,43 +151,46 @@ namespace nuclear_reactors {
  */
 void OSIRIS(NuclearReactor &reactor) {
   reactor.species = "OSIRIS";
-  reactor._impl->flux = 2.9e-7;
-  reactor._impl->temperature = CELCIUS_KELVIN_CONV(330.);
-  reactor._impl->recombination = .3;
-  reactor._impl->i_bi = .5;
-  reactor._impl->i_tri = .2;
-  reactor._impl->i_quad = .06;
-  reactor._impl->v_bi = .06;
-  reactor._impl->v_tri = .03;
-  reactor._impl->v_quad = .02;
-  reactor._impl->dislocation_density_evolution = 300.;
+  NuclearReactorImpl &impl = *reactor.mutable_impl();
+  impl.flux = 2.9e-7;
+  impl.temperature = CELCIUS_KELVIN_CONV(330.);
+  impl.recombination = .3;
+  impl.i_bi = .5;
+  impl.i_tri = .2;
+  impl.i_quad = .06;
+  impl.v_bi = .06;
+  impl.v_tri = .03;
+  impl.v_quad = .02;
+  impl.dislocation_density_evolution = 300.;
 }
 
 void BOR60(NuclearReactor &reactor) {
   reactor.species = "BOR-60";
-  reactor._impl->flux = 9.4e-7;
-  reactor._impl->temperature = CELCIUS_KELVIN_CONV(375.);
-  reactor._impl->recombination = .15;
-  reactor._impl->i_bi = .5;
-  reactor._impl->i_tri = .2;
-  reactor._impl->i_quad = .06;
-  reactor._impl->v_bi = .06;
-  reactor._impl->v_tri = .03;
-  reactor._impl->v_quad = .02;
-  reactor._impl->dislocation_density_evolution = 970.;
+  NuclearReactorImpl &impl = *reactor.mutable_impl();
+  impl.flux = 9.4e-7;
+  impl.temperature = CELCIUS_KELVIN_CONV(375.);
+  impl.recombination = .15;
+  impl.i_bi = .5;
+  impl.i_tri = .2;
+  impl.i_quad = .06;
+  impl.v_bi = .06;
+  impl.v_tri = .03;
+  impl.v_quad = .02;
+  impl.dislocation_density_evolution = 970.;
 }
 
 void EBRII(NuclearReactor &reactor) {
   reactor.species = "EBR-II";
-  reactor._impl->flux = 1.4e-6;
-  reactor._impl->temperature = CELCIUS_KELVIN_CONV(330.);
-  reactor._impl->recombination = .15;
-  reactor._impl->i_bi = .5;
-  reactor._impl->i_tri = .2;
-  reactor._impl->i_quad = .06;
-  reactor._impl->v_bi = .15;
-  reactor._impl->v_tri = .7;
-  reactor._impl->v_quad = .15;
-  reactor._impl->dislocation_density_evolution = 14400.;
+  NuclearReactorImpl &impl = *reactor.mutable_impl();
+  impl.flux = 1.4e-6;
+  impl.temperature = CELCIUS_KELVIN_CONV(330.);
+  impl.recombination = .15;
+  impl.i_bi = .5;
+  impl.i_tri = .2;
+  impl.i_quad = .06;
+  impl.v_bi = .15;
+  impl.v_tri = .7;
+  impl.v_quad = .15;
+  impl.dislocation_density_evolution = 14400.;
 }
 }  // namespace nuclear_reactors
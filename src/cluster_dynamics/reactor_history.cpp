@@ -0,0 +1,106 @@
+#include "cluster_dynamics/reactor_history.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "cluster_dynamics/cluster_dynamics.hpp"
+
+namespace {
+
+/** @brief Returns the first point after time t.
+ */
+std::vector<ReactorHistoryPoint>::const_iterator first_after(
+    const std::vector<ReactorHistoryPoint> &points, gp_float t) {
+  return std::upper_bound(points.begin(), points.end(), t,
+                          [](gp_float t, const ReactorHistoryPoint &point) {
+                            return t < point.time;
+                          });
+}
+
+}  // namespace
+
+void ReactorHistory::validate() const {
+  for (size_t k = 0; k < points.size(); ++k) {
+    const ReactorHistoryPoint &point = points[k];
+    if (!std::isfinite(point.time) || !(point.flux >= 0.) ||
+        !(point.temperature > 0.))
+      throw ClusterDynamicsException(
+          "Reactor history point " + std::to_string(k) +
+              " needs a finite time, a flux of at least 0 and a positive "
+              "temperature.",
+          ClusterDynamicsState());
+    if (k > 0 && point.time <= points[k - 1].time)
+      throw ClusterDynamicsException(
+          "The times of the reactor history must increase.",
+          ClusterDynamicsState());
+  }
+}
+
+ReactorHistoryPoint ReactorHistory::at(gp_float t) const {
+  const auto after = first_after(points, t);
+  if (after == points.begin()) return {t, after->flux, after->temperature};
+
+  const ReactorHistoryPoint &before = *(after - 1);
+  if (after == points.end() ||
+      interpolation == ReactorHistoryInterpolation::constant)
+    return {t, before.flux, before.temperature};
+
+  const gp_float weight = (t - before.time) / (after->time - before.time);
+  return {t, before.flux + weight * (after->flux - before.flux),
+          before.temperature +
+              weight * (after->temperature - before.temperature)};
+}
+
+gp_float ReactorHistory::flux_integral(gp_float t) const {
+  const ReactorHistoryPoint &first = points.front();
+  if (t <= first.time) return first.flux * (t - first.time);
+
+  const bool linear = interpolation == ReactorHistoryInterpolation::linear;
+  gp_float integral = 0.;
+  for (size_t k = 0; k + 1 < points.size(); ++k) {
+    const ReactorHistoryPoint &begin = points[k];
+    const ReactorHistoryPoint &end = points[k + 1];
+    if (t < end.time) {
+      const gp_float dt = t - begin.time;
+      if (!linear) return integral + begin.flux * dt;
+      const gp_float slope = (end.flux - begin.flux) / (end.time - begin.time);
+      return integral + dt * (begin.flux + .5 * slope * dt);
+    }
+    const gp_float flux = linear ? .5 * (begin.flux + end.flux) : begin.flux;
+    integral += flux * (end.time - begin.time);
+  }
+
+  return integral + points.back().flux * (t - points.back().time);
+}
+
+gp_float ReactorHistory::dose(gp_float t) const {
+  if (points.empty()) return 0.;
+  return flux_integral(t) - flux_integral(0.);
+}
+
+gp_float ReactorHistory::next_breakpoint(gp_float t) const {
+  const auto after = first_after(points, t);
+  if (after == points.end()) return std::numeric_limits<gp_float>::infinity();
+  return after->time;
+}
+
+bool ReactorHistory::ramps(gp_float t) const {
+  if (interpolation != ReactorHistoryInterpolation::linear) return false;
+  const auto after = first_after(points, t);
+  if (after == points.begin() || after == points.end()) return false;
+
+  const ReactorHistoryPoint &before = *(after - 1);
+  return before.flux != after->flux ||
+         before.temperature != after->temperature;
+}
+
+ReactorHistory ReactorHistory::repeat(size_t count, gp_float period) const {
+  ReactorHistory repeated{interpolation, {}};
+  repeated.points.reserve(count * points.size());
+  for (size_t cycle = 0; cycle < count; ++cycle)
+    for (const ReactorHistoryPoint &point : points)
+      repeated.points.push_back({point.time + (gp_float)cycle * period,
+                                 point.flux, point.temperature});
+  return repeated;
+}
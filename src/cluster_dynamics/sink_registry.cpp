@@ -0,0 +1,72 @@
+#include "sink_registry.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include "cluster_dynamics/cluster_dynamics.hpp"
+
+size_t SinkRegistry::add(const std::vector<gp_float>& sample_times,
+                         gp_float time, ClusterDynamicsSinkFn sink) {
+  if (!std::is_sorted(sample_times.begin(), sample_times.end()))
+    throw ClusterDynamicsException("The sink times must be increasing.",
+                                   ClusterDynamicsState());
+
+  const size_t next_time =
+      std::lower_bound(sample_times.begin(), sample_times.end(), time) -
+      sample_times.begin();
+  sinks.push_back(Sink{.id = next_id,
+                       .every_step = false,
+                       .times = sample_times,
+                       .next_time = next_time,
+                       .fn = std::move(sink)});
+  return next_id++;
+}
+
+size_t SinkRegistry::add_step(ClusterDynamicsSinkFn sink) {
+  sinks.push_back(Sink{.id = next_id,
+                       .every_step = true,
+                       .times = {},
+                       .next_time = 0,
+                       .fn = std::move(sink)});
+  return next_id++;
+}
+
+void SinkRegistry::remove(size_t id) {
+  std::erase_if(sinks, [&](const Sink& sink) { return sink.id == id; });
+}
+
+bool SinkRegistry::has_step_sinks() const {
+  return std::any_of(sinks.begin(), sinks.end(),
+                     [](const Sink& sink) { return sink.every_step; });
+}
+
+std::vector<gp_float> SinkRegistry::pending_times(gp_float start,
+                                                  gp_float end) const {
+  std::vector<gp_float> times;
+  for (const Sink& sink : sinks) {
+    for (size_t i = sink.next_time;
+         i < sink.times.size() && sink.times[i] <= end; ++i)
+      if (sink.times[i] >= start) times.push_back(sink.times[i]);
+  }
+  std::sort(times.begin(), times.end());
+  times.erase(std::unique(times.begin(), times.end()), times.end());
+  return times;
+}
+
+void SinkRegistry::sample(gp_float t, const ClusterDynamicsStateView& state,
+                          const ClusterDynamicsStats& stats) {
+  for (Sink& sink : sinks) {
+    bool due = false;
+    for (; sink.next_time < sink.times.size() &&
+           sink.times[sink.next_time] <= t;
+         ++sink.next_time)
+      due = due || sink.times[sink.next_time] == t;
+    if (due) sink.fn(state, stats);
+  }
+}
+
+void SinkRegistry::step(const ClusterDynamicsStateView& state,
+                        const ClusterDynamicsStats& stats) {
+  for (Sink& sink : sinks)
+    if (sink.every_step) sink.fn(state, stats);
+}
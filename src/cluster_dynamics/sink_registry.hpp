@@ -0,0 +1,60 @@
+#ifndef SINK_REGISTRY_HPP
+#define SINK_REGISTRY_HPP
+
+#include <vector>
+
+#include "cluster_dynamics/cluster_dynamics_state.hpp"
+#include "utils/types.hpp"
+
+/** @brief The sinks registered with ClusterDynamics::add_sink() and
+ * ClusterDynamics::add_step_sink(), which the backends invoke as they
+ * integrate.
+ */
+class SinkRegistry {
+ public:
+  /** @brief Registers a sink invoked at sample_times, skipping those before
+   * time, and returns its id.
+   */
+  size_t add(const std::vector<gp_float>& sample_times, gp_float time,
+             ClusterDynamicsSinkFn sink);
+  /** @brief Registers a sink invoked after every accepted step and returns
+   * its id.
+   */
+  size_t add_step(ClusterDynamicsSinkFn sink);
+  /** @brief Unregisters a sink, ids which are not registered are ignored.
+   */
+  void remove(size_t id);
+
+  bool empty() const { return sinks.empty(); }
+  bool has_step_sinks() const;
+
+  /** @brief Returns the times in [start, end] at which a sink is still to be
+   * invoked, in increasing order and without duplicates.
+   */
+  std::vector<gp_float> pending_times(gp_float start, gp_float end) const;
+
+  /** @brief Invokes the sinks due at time t, which must be passed in
+   * increasing order, and moves them on to their next time.
+   */
+  void sample(gp_float t, const ClusterDynamicsStateView& state,
+              const ClusterDynamicsStats& stats);
+
+  /** @brief Invokes the step sinks after a step to state.time.
+   */
+  void step(const ClusterDynamicsStateView& state,
+            const ClusterDynamicsStats& stats);
+
+ private:
+  struct Sink {
+    size_t id;
+    bool every_step;
+    std::vector<gp_float> times;
+    size_t next_time;  //!< Index of the first time not yet passed.
+    ClusterDynamicsSinkFn fn;
+  };
+
+  std::vector<Sink> sinks;
+  size_t next_id = 1;
+};
+
+#endif  // SINK_REGISTRY_HPP
@@ -0,0 +1,195 @@
+#include "solver_stats.hpp"
+
+DIAGNOSTIC_PUSH
+DIAGNOSTIC_DISABLE("-Wunused-parameter")
+#include <cvodes/cvodes.h>
+DIAGNOSTIC_POP
+
+gp_float* PhaseTimer::enter(gp_float* phase) {
+  const std::chrono::steady_clock::time_point now =
+      std::chrono::steady_clock::now();
+  if (current)
+    *current += std::chrono::duration<gp_float>(now - since).count();
+
+  gp_float* previous = current;
+  current = phase;
+  since = now;
+  return previous;
+}
+
+ClusterDynamicsStats integrator_stats(void* cvodes_memory_block) {
+  ClusterDynamicsStats stats;
+  if (!cvodes_memory_block) return stats;
+
+  sunrealtype first_step = 0.;
+  sunrealtype time = 0.;
+  sunrealtype last_step = 0.;
+  sunrealtype current_step = 0.;
+  CVodeGetIntegratorStats(cvodes_memory_block, &stats.steps,
+                          &stats.rhs_evaluations, &stats.linear_solver_setups,
+                          &stats.error_test_failures, &stats.last_order,
+                          &stats.current_order, &first_step, &last_step,
+                          &current_step, &time);
+  stats.last_step = last_step;
+  stats.current_step = current_step;
+  CVodeGetNonlinSolvStats(cvodes_memory_block, &stats.nonlinear_iterations,
+                          &stats.nonlinear_failures);
+
+  // Matrix based solvers count Jacobians, matrix free ones preconditioners
+  long jacobian_evaluations = 0;
+  long preconditioner_evaluations = 0;
+  long difference_quotient_evaluations = 0;
+  CVodeGetNumJacEvals(cvodes_memory_block, &jacobian_evaluations);
+  CVodeGetNumPrecEvals(cvodes_memory_block, &preconditioner_evaluations);
+  CVodeGetNumLinRhsEvals(cvodes_memory_block,
+                         &difference_quotient_evaluations);
+  CVodeGetNumLinIters(cvodes_memory_block, &stats.linear_iterations);
+  stats.jacobian_evaluations = jacobian_evaluations + preconditioner_evaluations;
+  stats.rhs_evaluations += difference_quotient_evaluations;
+
+  return stats;
+}
+
+void add_integrator_stats(ClusterDynamicsStats& total,
+                          const ClusterDynamicsStats& integrator) {
+  total.steps += integrator.steps;
+  total.rhs_evaluations += integrator.rhs_evaluations;
+  total.jacobian_evaluations += integrator.jacobian_evaluations;
+  total.linear_solver_setups += integrator.linear_solver_setups;
+  total.linear_iterations += integrator.linear_iterations;
+  total.nonlinear_iterations += integrator.nonlinear_iterations;
+  total.error_test_failures += integrator.error_test_failures;
+  total.nonlinear_failures += integrator.nonlinear_failures;
+
+  if (integrator.steps == 0) return;
+  total.last_step = integrator.last_step;
+  total.current_step = integrator.current_step;
+  total.last_order = integrator.last_order;
+  total.current_order = integrator.current_order;
+}
+
+namespace {
+struct TimedSolverContent {
+  SUNLinearSolver solver;
+  PhaseTimer* timer;
+  gp_float* setup_phase;
+  gp_float* solve_phase;
+};
+
+TimedSolverContent* solver_content(SUNLinearSolver solver) {
+  return static_cast<TimedSolverContent*>(solver->content);
+}
+
+SUNLinearSolver inner(SUNLinearSolver solver) {
+  return solver_content(solver)->solver;
+}
+
+SUNLinearSolver_Type timed_gettype(SUNLinearSolver solver) {
+  return SUNLinSolGetType(inner(solver));
+}
+
+SUNLinearSolver_ID timed_getid(SUNLinearSolver solver) {
+  return SUNLinSolGetID(inner(solver));
+}
+
+SUNErrCode timed_setatimes(SUNLinearSolver solver, void* data,
+                           SUNATimesFn atimes) {
+  return inner(solver)->ops->setatimes(inner(solver), data, atimes);
+}
+
+SUNErrCode timed_setpreconditioner(SUNLinearSolver solver, void* data,
+                                   SUNPSetupFn setup, SUNPSolveFn solve) {
+  return inner(solver)->ops->setpreconditioner(inner(solver), data, setup,
+                                               solve);
+}
+
+SUNErrCode timed_setscalingvectors(SUNLinearSolver solver, N_Vector s1,
+                                   N_Vector s2) {
+  return inner(solver)->ops->setscalingvectors(inner(solver), s1, s2);
+}
+
+SUNErrCode timed_setzeroguess(SUNLinearSolver solver,
+                              sunbooleantype zero_guess) {
+  return inner(solver)->ops->setzeroguess(inner(solver), zero_guess);
+}
+
+SUNErrCode timed_initialize(SUNLinearSolver solver) {
+  return SUNLinSolInitialize(inner(solver));
+}
+
+int timed_setup(SUNLinearSolver solver, SUNMatrix matrix) {
+  const TimedSolverContent* content = solver_content(solver);
+  ScopedPhase phase(*content->timer, content->setup_phase);
+  return SUNLinSolSetup(content->solver, matrix);
+}
+
+int timed_solve(SUNLinearSolver solver, SUNMatrix matrix, N_Vector x,
+                N_Vector b, sunrealtype tol) {
+  const TimedSolverContent* content = solver_content(solver);
+  ScopedPhase phase(*content->timer, content->solve_phase);
+  return SUNLinSolSolve(content->solver, matrix, x, b, tol);
+}
+
+int timed_numiters(SUNLinearSolver solver) {
+  return inner(solver)->ops->numiters(inner(solver));
+}
+
+sunrealtype timed_resnorm(SUNLinearSolver solver) {
+  return inner(solver)->ops->resnorm(inner(solver));
+}
+
+sunindextype timed_lastflag(SUNLinearSolver solver) {
+  return inner(solver)->ops->lastflag(inner(solver));
+}
+
+SUNErrCode timed_space(SUNLinearSolver solver, long int* lenrw,
+                       long int* leniw) {
+  return SUNLinSolSpace(inner(solver), lenrw, leniw);
+}
+
+N_Vector timed_resid(SUNLinearSolver solver) {
+  return inner(solver)->ops->resid(inner(solver));
+}
+
+SUNErrCode timed_free(SUNLinearSolver solver) {
+  if (!solver) return SUN_SUCCESS;
+  SUNLinSolFree(inner(solver));
+  delete solver_content(solver);
+  solver->content = nullptr;
+  SUNLinSolFreeEmpty(solver);
+  return SUN_SUCCESS;
+}
+}  // namespace
+
+SUNLinearSolver SUNLinSol_Timed(SUNLinearSolver solver, PhaseTimer* timer,
+                                gp_float* setup_phase, gp_float* solve_phase) {
+  if (!solver) return nullptr;
+
+  SUNLinearSolver timed = SUNLinSolNewEmpty(solver->sunctx);
+  if (!timed) return nullptr;
+
+  // Only forward the operations the wrapped solver has, SUNDIALS checks for
+  // their presence to tell matrix based and iterative solvers apart
+  const SUNLinearSolver_Ops ops = solver->ops;
+  timed->ops->gettype = timed_gettype;
+  timed->ops->getid = timed_getid;
+  if (ops->setatimes) timed->ops->setatimes = timed_setatimes;
+  if (ops->setpreconditioner)
+    timed->ops->setpreconditioner = timed_setpreconditioner;
+  if (ops->setscalingvectors)
+    timed->ops->setscalingvectors = timed_setscalingvectors;
+  if (ops->setzeroguess) timed->ops->setzeroguess = timed_setzeroguess;
+  if (ops->initialize) timed->ops->initialize = timed_initialize;
+  if (ops->setup) timed->ops->setup = timed_setup;
+  timed->ops->solve = timed_solve;
+  if (ops->numiters) timed->ops->numiters = timed_numiters;
+  if (ops->resnorm) timed->ops->resnorm = timed_resnorm;
+  if (ops->lastflag) timed->ops->lastflag = timed_lastflag;
+  if (ops->space) timed->ops->space = timed_space;
+  if (ops->resid) timed->ops->resid = timed_resid;
+  timed->ops->free = timed_free;
+
+  timed->content =
+      new TimedSolverContent{solver, timer, setup_phase, solve_phase};
+  return timed;
+}
@@ -0,0 +1,69 @@
+#ifndef SOLVER_STATS_HPP
+#define SOLVER_STATS_HPP
+
+#include "utils/diagnostics.hpp"
+
+DIAGNOSTIC_PUSH
+DIAGNOSTIC_DISABLE("-Wunused-parameter")
+#include <sundials/sundials_linearsolver.h>
+DIAGNOSTIC_POP
+
+#include <chrono>
+
+#include "cluster_dynamics/cluster_dynamics_state.hpp"
+#include "utils/types.hpp"
+
+/** @brief Splits wall time between exclusive phases, each summed into a
+ * field of ClusterDynamicsStats.
+ */
+class PhaseTimer {
+ public:
+  /** @brief Adds the time since the last switch to the current phase and
+   * makes phase the current one. Time in a null phase is not counted.
+   *  @return The previous phase.
+   */
+  gp_float* enter(gp_float* phase);
+
+ private:
+  gp_float* current = nullptr;
+  std::chrono::steady_clock::time_point since;
+};
+
+/** @brief Enters a phase of a PhaseTimer for the lifetime of the object and
+ * returns to the enclosing phase when destroyed.
+ */
+class ScopedPhase {
+ public:
+  ScopedPhase(PhaseTimer& timer, gp_float* phase)
+      : timer(timer), enclosing(timer.enter(phase)) {}
+  ~ScopedPhase() { timer.enter(enclosing); }
+
+  ScopedPhase(const ScopedPhase&) = delete;
+  ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+ private:
+  PhaseTimer& timer;
+  gp_float* enclosing;
+};
+
+/** @brief Returns the counters, step sizes and orders of a CVODE integrator
+ * since it was last initialized, or empty stats for a null integrator.
+ */
+ClusterDynamicsStats integrator_stats(void* cvodes_memory_block);
+
+/** @brief Adds the counters of an integrator to total. Its step sizes and
+ * orders replace those of total once it has taken a step.
+ */
+void add_integrator_stats(ClusterDynamicsStats& total,
+                          const ClusterDynamicsStats& integrator);
+
+/** @brief Wraps a SUNLinearSolver so the time of its setups and solves is
+ * counted in the setup and solve phases of timer.
+ *
+ * The wrapper forwards every operation and owns the wrapped solver, which it
+ * frees along with itself.
+ */
+SUNLinearSolver SUNLinSol_Timed(SUNLinearSolver solver, PhaseTimer* timer,
+                                gp_float* setup_phase, gp_float* solve_phase);
+
+#endif  // SOLVER_STATS_HPP
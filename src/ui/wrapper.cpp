@@ -5,10 +5,14 @@
 #include <array>
 #include <cmath>
 #include <iostream>
+#include <map>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 #include "cluster_dynamics/cluster_dynamics.hpp"
+#include "cluster_dynamics/cluster_dynamics_config.hpp"
 #include "model/material.hpp"
 #include "model/nuclear_reactor.hpp"
 #include "timer.hpp"
@@ -174,9 +178,7 @@ struct Simulation {
         delta_time(delta_time) {
     main_sim_reactor = Sim_Reactor();
     main_sim_material = Sim_Material();
-    cd = std::make_unique<ClusterDynamics>(concentration_boundary,
-                                           main_sim_reactor.get_reactor(),
-                                           main_sim_material.get_material());
+    create_cd();
   }
 
   // Overloaded Constructor
@@ -187,12 +189,32 @@ struct Simulation {
         delta_time(delta_time) {
     main_sim_material = material;
     main_sim_reactor = reactor;
-    cd = std::make_unique<ClusterDynamics>(
-        concentration_boundary, reactor.get_reactor(), material.get_material());
+    create_cd();
+  }
+
+  // Starts a CPU simulation from an empty lattice
+  void create_cd() {
+    ClusterDynamicsConfig config;
+    config.max_cluster_size = concentration_boundary;
+    config.material = main_sim_material.get_material();
+    config.reactor = main_sim_reactor.get_reactor();
+    config.init_interstitials =
+        std::vector<gp_float>(concentration_boundary, 0.);
+    config.init_vacancies = std::vector<gp_float>(concentration_boundary, 0.);
+    cd = std::make_unique<ClusterDynamics>(ClusterDynamics::cpu(config));
   }
 
   void run() { state = (*cd).run(delta_time, sample_interval); }
 
+  // Runs for delta_time and returns the derivatives of the observable with
+  // respect to every material and reactor parameter, keyed by name
+  std::map<std::string, gp_float> adjoint_gradient(
+      const std::string& observable) {
+    if (!scalar_observables.count(observable))
+      throw std::invalid_argument("Unknown observable " + observable);
+    return (*cd).adjoint_gradient(delta_time, scalar_observables[observable]);
+  }
+
   void print_state() {
     fprintf(stdout, "\nTime=%g", state.time);
     if (state.interstitials.size() != concentration_boundary ||
@@ -259,6 +281,7 @@ PYBIND11_MODULE(pyclusterdynamics, m) {
       .def(py::init<size_t, double, double>())
       .def(py::init<size_t, double, double, Sim_Material, Sim_Reactor>())
       .def("run", &Simulation::run)
+      .def("adjoint_gradient", &Simulation::adjoint_gradient)
       .def("print_state", &Simulation::print_state)
       .def("string_state", &Simulation::string_state)
       .def("get_state_time", &Simulation::get_state_time)
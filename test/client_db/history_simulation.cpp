@@ -46,6 +46,26 @@ void HistorySimulationDescriptor::assert_equal(HistorySimulation &first,
                                    ignore_sqlite_id);
   nuclear_reactor_descriptor.assert_equal(first.reactor, second.reactor,
                                           ignore_sqlite_id);
+  ASSERT_EQ(first.stats.steps, second.stats.steps);
+  ASSERT_EQ(first.stats.rhs_evaluations, second.stats.rhs_evaluations);
+  ASSERT_EQ(first.stats.jacobian_evaluations,
+            second.stats.jacobian_evaluations);
+  ASSERT_EQ(first.stats.linear_solver_setups,
+            second.stats.linear_solver_setups);
+  ASSERT_EQ(first.stats.linear_iterations, second.stats.linear_iterations);
+  ASSERT_EQ(first.stats.nonlinear_iterations,
+            second.stats.nonlinear_iterations);
+  ASSERT_EQ(first.stats.error_test_failures, second.stats.error_test_failures);
+  ASSERT_EQ(first.stats.nonlinear_failures, second.stats.nonlinear_failures);
+  ASSERT_EQ(first.stats.last_step, second.stats.last_step);
+  ASSERT_EQ(first.stats.current_step, second.stats.current_step);
+  ASSERT_EQ(first.stats.last_order, second.stats.last_order);
+  ASSERT_EQ(first.stats.current_order, second.stats.current_order);
+  ASSERT_EQ(first.stats.rhs_time, second.stats.rhs_time);
+  ASSERT_EQ(first.stats.jacobian_time, second.stats.jacobian_time);
+  ASSERT_EQ(first.stats.linear_setup_time, second.stats.linear_setup_time);
+  ASSERT_EQ(first.stats.linear_solve_time, second.stats.linear_solve_time);
+  ASSERT_EQ(first.stats.integrator_time, second.stats.integrator_time);
 }
 
 ENTITY_TEST(HistorySimulation, CreateAndRead_Success)
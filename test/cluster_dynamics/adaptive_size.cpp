@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "cluster_dynamics/cluster_dynamics.hpp"
+#include "cluster_dynamics/cluster_dynamics_config.hpp"
+#include "cpu/cluster_dynamics_cpu_impl.hpp"
+#include "model/material.hpp"
+#include "model/nuclear_reactor.hpp"
+
+class AdaptiveSizeTest : public ::testing::Test {
+ protected:
+  static constexpr size_t max_cluster_size = 1000;
+  static constexpr size_t initial_max_cluster_size = 16;
+
+  void SetUp() override {
+    materials::SA304(config.material);
+    nuclear_reactors::OSIRIS(config.reactor);
+    config.max_cluster_size = max_cluster_size;
+    config.initial_max_cluster_size = initial_max_cluster_size;
+    config.init_interstitials = std::vector<gp_float>(max_cluster_size, 0.);
+    config.init_vacancies = std::vector<gp_float>(max_cluster_size, 0.);
+  }
+
+  std::vector<gp_float> derivatives(ClusterDynamicsCpuImpl& cd) {
+    N_Vector v_derivatives = N_VClone(cd.state);
+    ClusterDynamicsCpuImpl::system(0., cd.state, v_derivatives, &cd);
+    const gp_float* d = N_VGetArrayPointer(v_derivatives);
+    std::vector<gp_float> result(d, d + cd.state_size);
+    N_VDestroy(v_derivatives);
+    return result;
+  }
+
+  ClusterDynamicsConfig config;
+};
+
+TEST_F(AdaptiveSizeTest, EmptyTail_StartsAtInitialSize) {
+  ClusterDynamicsCpuImpl cd(config);
+  EXPECT_EQ(cd.max_cluster_size, initial_max_cluster_size);
+  EXPECT_EQ(cd.state_size, 2 * (initial_max_cluster_size + 2) + 1);
+}
+
+TEST_F(AdaptiveSizeTest, PopulatedInitialState_StartsLargeEnough) {
+  config.init_interstitials[100] = 1e6;
+  ClusterDynamicsCpuImpl cd(config);
+  EXPECT_GE(cd.max_cluster_size, 100u + cd.tail_width(cd.max_cluster_size));
+  EXPECT_EQ(cd.interstitials[100], 1e6);
+}
+
+TEST_F(AdaptiveSizeTest, TailRoot_CrossesZeroAtThreshold) {
+  ClusterDynamicsCpuImpl cd(config);
+  gp_float g;
+  ClusterDynamicsCpuImpl::tail_root(0., cd.state, &g, &cd);
+  EXPECT_LT(g, 0.);
+
+  cd.vacancies[initial_max_cluster_size] = 2. * config.tail_threshold;
+  ClusterDynamicsCpuImpl::tail_root(0., cd.state, &g, &cd);
+  EXPECT_GT(g, 0.);
+}
+
+// A grown state must behave exactly like a simulation built at that size.
+TEST_F(AdaptiveSizeTest, Resize_MatchesFixedSizeSystem) {
+  ClusterDynamicsCpuImpl cd(config);
+  for (size_t n = 1; n <= initial_max_cluster_size; ++n) {
+    cd.interstitials[n] = 1e12 / (gp_float)(n * n);
+    cd.vacancies[n] = 3e11 / (gp_float)n;
+  }
+  *cd.dislocation_density = 1e10;
+
+  cd.resize(64);
+  ASSERT_EQ(cd.max_cluster_size, 64u);
+
+  config.initial_max_cluster_size = 0;
+  config.max_cluster_size = 64;
+  ClusterDynamicsCpuImpl fixed(config);
+  N_VConst(0., fixed.state);
+  for (size_t n = 1; n <= initial_max_cluster_size; ++n) {
+    fixed.interstitials[n] = cd.interstitials[n];
+    fixed.vacancies[n] = cd.vacancies[n];
+  }
+  *fixed.dislocation_density = 1e10;
+
+  EXPECT_EQ(derivatives(cd), derivatives(fixed));
+}
+
+TEST_F(AdaptiveSizeTest, Run_ShrinksEmptyState) {
+  ClusterDynamicsCpuImpl cd(config);
+  cd.resize(64);
+  const ClusterDynamicsState state = cd.run(1e-6);
+  EXPECT_EQ(cd.max_cluster_size, 32u);
+  EXPECT_EQ(state.interstitials.size(), 32u);
+}
+
+TEST_F(AdaptiveSizeTest, WithGrouping_Throws) {
+  config.group_threshold = 100;
+  EXPECT_THROW(ClusterDynamicsCpuImpl cd(config), ClusterDynamicsException);
+}
@@ -0,0 +1,214 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "cluster_dynamics/cluster_dynamics.hpp"
+#include "cluster_dynamics/cluster_dynamics_config.hpp"
+#include "cpu/cluster_dynamics_cpu_impl.hpp"
+#include "model/material.hpp"
+#include "model/nuclear_reactor.hpp"
+
+class AdjointTest : public ::testing::Test {
+ protected:
+  static constexpr size_t max_cluster_size = 50;
+
+  void SetUp() override {
+    materials::SA304(config.material);
+    nuclear_reactors::OSIRIS(config.reactor);
+    config.max_cluster_size = max_cluster_size;
+    config.relative_tolerance = 1e-8;
+    config.init_interstitials = std::vector<gp_float>(max_cluster_size, 0.);
+    config.init_vacancies = std::vector<gp_float>(max_cluster_size, 0.);
+    for (size_t n = 1; n < max_cluster_size; ++n) {
+      config.init_interstitials[n] = 1e12 / (gp_float)(n * n);
+      config.init_vacancies[n] = 3e11 / (gp_float)n;
+    }
+  }
+
+  // A vector without structure, to probe the transposed Jacobian with
+  static void fill(N_Vector v, gp_float seed) {
+    gp_float* data = N_VGetArrayPointer(v);
+    for (sunindextype i = 0; i < N_VGetLength(v); ++i)
+      data[i] = std::sin(seed * (gp_float)(i + 1));
+  }
+
+  ClusterDynamicsConfig config;
+};
+
+// lambda^T (J v) = (J^T lambda)^T v
+TEST_F(AdjointTest, AdjointRhs_IsNegatedTransposedJacobian) {
+  ClusterDynamicsCpuImpl cd(config);
+  *cd.dislocation_density = 1e10;
+
+  N_Vector v = N_VClone(cd.state);
+  N_Vector jv = N_VClone(cd.state);
+  N_Vector adjoint = N_VClone(cd.state);
+  N_Vector adjoint_derivatives = N_VClone(cd.state);
+  fill(v, 1.);
+  fill(adjoint, 2.);
+
+  ClusterDynamicsCpuImpl::jacobian_times_vector(v, jv, 0., cd.state, nullptr,
+                                                &cd, nullptr);
+  ClusterDynamicsCpuImpl::adjoint_rhs(0., cd.state, adjoint,
+                                      adjoint_derivatives, &cd);
+
+  const gp_float expected = N_VDotProd(adjoint, jv);
+  EXPECT_NEAR(-N_VDotProd(adjoint_derivatives, v), expected,
+              1e-12 * std::abs(expected));
+
+  for (N_Vector vector : {v, jv, adjoint, adjoint_derivatives})
+    N_VDestroy(vector);
+}
+
+TEST_F(AdjointTest, AdjointJacobian_MatchesAdjointRhs) {
+  ClusterDynamicsCpuImpl cd(config);
+  *cd.dislocation_density = 1e10;
+
+  N_Vector adjoint = N_VClone(cd.state);
+  N_Vector expected = N_VClone(cd.state);
+  N_Vector actual = N_VClone(cd.state);
+  fill(adjoint, 3.);
+  SUNMatrix matrix =
+      SUNArrowheadMatrix(cd.state_size, cd.border_indices(), cd.sun_context);
+
+  ClusterDynamicsCpuImpl::adjoint_rhs(0., cd.state, adjoint, expected, &cd);
+  ASSERT_EQ(ClusterDynamicsCpuImpl::adjoint_jacobian(
+                0., cd.state, adjoint, expected, matrix, &cd, nullptr,
+                nullptr, nullptr),
+            0);
+  SUNMatMatvec(matrix, adjoint, actual);
+
+  const gp_float* e = N_VGetArrayPointer(expected);
+  const gp_float* a = N_VGetArrayPointer(actual);
+  for (size_t i = 0; i < cd.state_size; ++i)
+    EXPECT_NEAR(a[i], e[i], 1e-12 * std::abs(e[i]) + 1e-30) << "index " << i;
+
+  SUNMatDestroy(matrix);
+  for (N_Vector vector : {adjoint, expected, actual}) N_VDestroy(vector);
+}
+
+// The quadratures are -lambda^T df/dp, checked against central differences
+TEST_F(AdjointTest, AdjointQuadrature_MatchesCentralDifferences) {
+  ClusterDynamicsCpuImpl cd(config);
+  *cd.dislocation_density = 1e10;
+  cd.gradient_parameters = cd.model_parameters();
+  for (const auto& [name, field] : cd.gradient_parameters)
+    cd.gradient_scales.push_back(*field != 0. ? std::abs(*field) : 1.);
+
+  const size_t num_parameters = cd.gradient_parameters.size();
+  N_Vector adjoint = N_VClone(cd.state);
+  N_Vector derivatives = N_VClone(cd.state);
+  N_Vector quadrature = N_VNew_Serial(num_parameters, cd.sun_context);
+  fill(adjoint, 4.);
+
+  ClusterDynamicsCpuImpl::adjoint_quadrature(0., cd.state, adjoint,
+                                             quadrature, &cd);
+  const gp_float* actual = N_VGetArrayPointer(quadrature);
+
+  auto observed = [&]() {
+    cd.coefficient_init();
+    ClusterDynamicsCpuImpl::system(0., cd.state, derivatives, &cd);
+    return N_VDotProd(adjoint, derivatives);
+  };
+  for (size_t k = 0; k < num_parameters; ++k) {
+    const auto& [name, field] = cd.gradient_parameters[k];
+    if (name != "flux" && name != "temperature" && name != "i_migration" &&
+        name != "v_binding" && name != "atomic_volume")
+      continue;
+
+    const gp_float original = *field;
+    const gp_float epsilon = 1e-5 * std::abs(original);
+    *field = original + epsilon;
+    const gp_float upper = observed();
+    *field = original - epsilon;
+    const gp_float lower = observed();
+    *field = original;
+    cd.coefficient_init();
+
+    const gp_float expected = -(upper - lower) / (2. * epsilon);
+    EXPECT_NEAR(actual[k], expected, 1e-4 * std::abs(expected)) << name;
+  }
+
+  for (N_Vector vector : {adjoint, derivatives, quadrature})
+    N_VDestroy(vector);
+}
+
+TEST_F(AdjointTest, AdjointGradient_CoversEveryParameter) {
+  ClusterDynamics cd = ClusterDynamics::cpu(config);
+  const std::map<std::string, gp_float> gradient =
+      cd.adjoint_gradient(1e2, ScalarObservable::dislocation_density);
+  EXPECT_EQ(gradient.size(), 30u);
+  EXPECT_EQ(cd.get_time(), 1e2);
+  EXPECT_TRUE(gradient.count("i_migration"));
+  EXPECT_TRUE(gradient.count("dislocation_density_evolution"));
+}
+
+TEST_F(AdjointTest, AdjointGradient_MatchesFiniteDifferences) {
+  const gp_float total_time = 1e2;
+  auto vacancy_cluster_volume = [&](const ClusterDynamicsState& state) {
+    gp_float volume = 0.;
+    for (size_t n = 2; n < state.vacancies.size(); ++n)
+      volume += (gp_float)n * state.vacancies[n];
+    return volume * config.material.get_atomic_volume();
+  };
+
+  for (ScalarObservable observable :
+       {ScalarObservable::dislocation_density,
+        ScalarObservable::vacancy_cluster_volume}) {
+    ClusterDynamics cd = ClusterDynamics::cpu(config);
+    const std::map<std::string, gp_float> gradient =
+        cd.adjoint_gradient(total_time, observable);
+
+    auto observed = [&]() {
+      const ClusterDynamicsState state =
+          ClusterDynamics::cpu(config).run(0., total_time);
+      return observable == ScalarObservable::dislocation_density
+                 ? state.dislocation_density
+                 : vacancy_cluster_volume(state);
+    };
+
+    // Central differences of whole runs in a few of the parameters
+    auto check = [&](const std::string& name, gp_float value, auto set) {
+      const gp_float epsilon = 1e-4 * std::abs(value);
+      set(value + epsilon);
+      const gp_float upper = observed();
+      set(value - epsilon);
+      const gp_float lower = observed();
+      set(value);
+
+      const gp_float expected = (upper - lower) / (2. * epsilon);
+      EXPECT_NEAR(gradient.at(name), expected,
+                  1e-2 * std::abs(expected) + 1e-12 * std::abs(upper))
+          << name;
+    };
+    check("dislocation_density_0",
+          config.material.get_dislocation_density_0(), [&](gp_float value) {
+            config.material.set_dislocation_density_0(value);
+          });
+    check("atomic_volume", config.material.get_atomic_volume(),
+          [&](gp_float value) { config.material.set_atomic_volume(value); });
+    check("i_migration", config.material.get_i_migration(),
+          [&](gp_float value) { config.material.set_i_migration(value); });
+    check("flux", config.reactor.get_flux(),
+          [&](gp_float value) { config.reactor.set_flux(value); });
+    check("temperature", config.reactor.get_temperature(),
+          [&](gp_float value) { config.reactor.set_temperature(value); });
+  }
+}
+
+TEST_F(AdjointTest, WithGrouping_Throws) {
+  config.group_threshold = 20;
+  ClusterDynamics cd = ClusterDynamics::cpu(config);
+  EXPECT_THROW(cd.adjoint_gradient(1., ScalarObservable::dislocation_density),
+               ClusterDynamicsException);
+}
+
+TEST_F(AdjointTest, WithForwardSensitivities_Throws) {
+  ClusterDynamics cd = ClusterDynamics::cpu(config);
+  cd.enable_sensitivities({SensitivityVariable::flux_dpa_s});
+  EXPECT_THROW(cd.adjoint_gradient(1., ScalarObservable::dislocation_density),
+               ClusterDynamicsException);
+}
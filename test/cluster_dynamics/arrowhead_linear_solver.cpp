@@ -0,0 +1,102 @@
+#include "cpu/arrowhead_linear_solver.hpp"
+
+#include <gtest/gtest.h>
+#include <nvector/nvector_serial.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+class ArrowheadLinearSolverTest : public ::testing::Test {
+ protected:
+  static constexpr sunindextype size = 41;
+
+  void SetUp() override {
+    SUNContext_Create(SUN_COMM_NULL, &sun_context);
+    matrix = SUNArrowheadMatrix(size, border, sun_context);
+
+    // A diagonally dominant matrix filling every entry of the structure
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<gp_float> distribution(-1., 1.);
+    ArrowheadMatrixContent* content = SUNArrowheadMatrix_Content(matrix);
+    for (sunindextype r = 0; r < size; ++r) {
+      const bool border_row = std::count(border.begin(), border.end(), r);
+      for (sunindextype c = 0; c < size; ++c) {
+        const bool border_col = std::count(border.begin(), border.end(), c);
+        const sunindextype offset =
+            content->position[c] - content->position[r];
+        if (border_row || border_col || std::abs(offset) <= 1)
+          content->add(r, c, distribution(generator));
+      }
+      content->add(r, r, 4. * size);
+    }
+  }
+
+  void TearDown() override {
+    SUNMatDestroy(matrix);
+    SUNContext_Free(&sun_context);
+  }
+
+  const std::vector<sunindextype> border{1, 20, 40};
+  SUNContext sun_context;
+  SUNMatrix matrix;
+};
+
+TEST_F(ArrowheadLinearSolverTest, OutOfStructureEntry_Rejected) {
+  ArrowheadMatrixContent* content = SUNArrowheadMatrix_Content(matrix);
+  EXPECT_TRUE(content->add(5, 7, 0.));
+  EXPECT_FALSE(content->add(5, 7, 1.));
+  EXPECT_TRUE(content->add(5, 20, 1.));
+  EXPECT_TRUE(content->add(20, 5, 1.));
+}
+
+TEST_F(ArrowheadLinearSolverTest, Solve_RecoversSolution) {
+  SUNLinearSolver solver = SUNLinSol_Arrowhead(matrix, sun_context);
+  ASSERT_NE(solver, nullptr);
+  EXPECT_EQ(SUNLinSolGetType(solver), SUNLINEARSOLVER_DIRECT);
+
+  N_Vector expected = N_VNew_Serial(size, sun_context);
+  N_Vector rhs = N_VNew_Serial(size, sun_context);
+  N_Vector x = N_VNew_Serial(size, sun_context);
+  for (sunindextype i = 0; i < size; ++i)
+    N_VGetArrayPointer(expected)[i] = std::sin((gp_float)i);
+  SUNMatMatvec(matrix, expected, rhs);
+
+  ASSERT_EQ(SUNLinSolInitialize(solver), 0);
+  ASSERT_EQ(SUNLinSolSetup(solver, matrix), 0);
+  ASSERT_EQ(SUNLinSolSolve(solver, matrix, x, rhs, 0.), 0);
+
+  for (sunindextype i = 0; i < size; ++i)
+    EXPECT_NEAR(N_VGetArrayPointer(x)[i], N_VGetArrayPointer(expected)[i],
+                1e-12);
+
+  N_VDestroy_Serial(expected);
+  N_VDestroy_Serial(rhs);
+  N_VDestroy_Serial(x);
+  SUNLinSolFree(solver);
+}
+
+TEST_F(ArrowheadLinearSolverTest, ScaleAddIdentity_MatchesDefinition) {
+  SUNMatrix copy = SUNMatClone(matrix);
+  SUNMatCopy(matrix, copy);
+  SUNMatScaleAddI(-0.5, copy);
+
+  N_Vector x = N_VNew_Serial(size, sun_context);
+  N_Vector ax = N_VNew_Serial(size, sun_context);
+  N_Vector bx = N_VNew_Serial(size, sun_context);
+  for (sunindextype i = 0; i < size; ++i)
+    N_VGetArrayPointer(x)[i] = std::cos((gp_float)i);
+  SUNMatMatvec(matrix, x, ax);
+  SUNMatMatvec(copy, x, bx);
+
+  for (sunindextype i = 0; i < size; ++i)
+    EXPECT_NEAR(N_VGetArrayPointer(bx)[i],
+                -0.5 * N_VGetArrayPointer(ax)[i] + N_VGetArrayPointer(x)[i],
+                1e-12);
+
+  N_VDestroy_Serial(x);
+  N_VDestroy_Serial(ax);
+  N_VDestroy_Serial(bx);
+  SUNMatDestroy(copy);
+}
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "cluster_dynamics/cluster_dynamics.hpp"
+#include "cluster_dynamics/cluster_dynamics_config.hpp"
+#include "model/material.hpp"
+#include "model/nuclear_reactor.hpp"
+
+class CheckpointTest : public ::testing::Test {
+ protected:
+  static constexpr size_t max_cluster_size = 50;
+
+  void SetUp() override {
+    materials::SA304(config.material);
+    nuclear_reactors::OSIRIS(config.reactor);
+    config.max_cluster_size = max_cluster_size;
+    config.init_interstitials = std::vector<gp_float>(max_cluster_size, 0.);
+    config.init_vacancies = std::vector<gp_float>(max_cluster_size, 0.);
+    path = ::testing::TempDir() + "cluster_dynamics_checkpoint_test.ckpt";
+  }
+
+  void TearDown() override { std::remove(path.c_str()); }
+
+  ClusterDynamicsConfig config;
+  std::string path;
+};
+
+TEST_F(CheckpointTest, FromCheckpoint_RestoresState) {
+  config.relative_tolerance = 1e-7;
+  ClusterDynamics cd = ClusterDynamics::cpu(config);
+  const ClusterDynamicsState saved = cd.run(0., 1e3);
+  cd.save_checkpoint(path);
+
+  ClusterDynamics resumed = ClusterDynamics::from_checkpoint(path);
+  EXPECT_EQ(resumed.get_time(), saved.time);
+  EXPECT_EQ(resumed.get_material().get_i_migration(),
+            config.material.get_i_migration());
+  EXPECT_EQ(resumed.get_reactor().get_flux(), config.reactor.get_flux());
+
+  // The first sample of a resumed simulation is the saved state itself
+  const ClusterDynamicsState state = resumed.sample({saved.time}).front();
+  EXPECT_EQ(state.interstitials, saved.interstitials);
+  EXPECT_EQ(state.vacancies, saved.vacancies);
+  EXPECT_EQ(state.dislocation_density, saved.dislocation_density);
+}
+
+TEST_F(CheckpointTest, FromCheckpoint_RestoresAdaptiveSize) {
+  config.max_cluster_size = 1000;
+  config.initial_max_cluster_size = 16;
+  config.init_interstitials = std::vector<gp_float>(1000, 0.);
+  config.init_vacancies = std::vector<gp_float>(1000, 0.);
+  config.init_interstitials[100] = 1e6;
+  ClusterDynamics cd = ClusterDynamics::cpu(config);
+  cd.save_checkpoint(path);
+
+  ClusterDynamics resumed = ClusterDynamics::from_checkpoint(path);
+  const ClusterDynamicsState state = resumed.sample({0.}).front();
+  ASSERT_GT(state.interstitials.size(), 100u);
+  EXPECT_EQ(state.interstitials[100], 1e6);
+}
+
+TEST_F(CheckpointTest, FromCheckpoint_RestoresReactorHistory) {
+  const gp_float flux = config.reactor.get_flux();
+  config.reactor_history = {ReactorHistoryInterpolation::linear,
+                            {{0., flux, 600.}, {1e3, 0., 300.}}};
+  ClusterDynamics cd = ClusterDynamics::cpu(config);
+  cd.run(0., 5e2);
+  cd.save_checkpoint(path);
+
+  ClusterDynamicsConfig resumed_config;
+  ClusterDynamics resumed =
+      ClusterDynamics::from_checkpoint(path, resumed_config);
+  const ReactorHistory& history = resumed_config.reactor_history;
+  EXPECT_EQ(history.interpolation, ReactorHistoryInterpolation::linear);
+  ASSERT_EQ(history.points.size(), 2u);
+  EXPECT_EQ(history.points[1].time, 1e3);
+  EXPECT_EQ(history.points[1].temperature, 300.);
+
+  const ClusterDynamicsState state = resumed.run(0., 1e3);
+  EXPECT_DOUBLE_EQ(state.dpa, flux * 5e2);
+}
+
+TEST_F(CheckpointTest, MissingFile_Throws) {
+  EXPECT_THROW(ClusterDynamics::from_checkpoint(path),
+               ClusterDynamicsException);
+}
+
+TEST_F(CheckpointTest, NotACheckpoint_Throws) {
+  std::ofstream(path) << "not a checkpoint";
+  EXPECT_THROW(ClusterDynamics::from_checkpoint(path),
+               ClusterDynamicsException);
+}
+
+TEST_F(CheckpointTest, TruncatedCheckpoint_Throws) {
+  ClusterDynamics cd = ClusterDynamics::cpu(config);
+  cd.save_checkpoint(path);
+
+  std::ifstream in(path, std::ios::binary);
+  std::string contents((std::istreambuf_iterator<char>(in)),
+                       std::istreambuf_iterator<char>());
+  in.close();
+  std::ofstream(path, std::ios::binary | std::ios::trunc)
+      .write(contents.data(), contents.size() / 2);
+
+  EXPECT_THROW(ClusterDynamics::from_checkpoint(path),
+               ClusterDynamicsException);
+}
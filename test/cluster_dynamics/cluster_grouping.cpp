@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "cluster_dynamics/cluster_dynamics.hpp"
+#include "cluster_dynamics/cluster_dynamics_config.hpp"
+#include "cpu/cluster_dynamics_cpu_impl.hpp"
+#include "model/material.hpp"
+#include "model/nuclear_reactor.hpp"
+
+class ClusterGroupingTest : public ::testing::Test {
+ protected:
+  static constexpr size_t max_cluster_size = 60;
+  static constexpr size_t group_threshold = 20;
+
+  void SetUp() override {
+    materials::SA304(config.material);
+    nuclear_reactors::OSIRIS(config.reactor);
+    config.max_cluster_size = max_cluster_size;
+    config.init_interstitials = std::vector<gp_float>(max_cluster_size + 1, 0.);
+    config.init_vacancies = std::vector<gp_float>(max_cluster_size + 1, 0.);
+
+    // The ungrouped sums stop short of the largest sizes, leave them empty
+    // so both modes see the same clusters
+    for (size_t n = 1; n < max_cluster_size - 1; ++n) {
+      config.init_interstitials[n] = 1e12 / (gp_float)(n * n);
+      config.init_vacancies[n] = 3e11 / (gp_float)n;
+    }
+  }
+
+  std::vector<gp_float> derivatives(ClusterDynamicsCpuImpl& cd) {
+    N_Vector v_derivatives = N_VClone(cd.state);
+    ClusterDynamicsCpuImpl::system(0., cd.state, v_derivatives, &cd);
+    const gp_float* d = N_VGetArrayPointer(v_derivatives);
+    std::vector<gp_float> result(d, d + cd.state_size);
+    N_VDestroy(v_derivatives);
+    return result;
+  }
+
+  ClusterDynamicsConfig config;
+};
+
+TEST_F(ClusterGroupingTest, MakeClusterGroups_CoversEverySizeOnce) {
+  const std::vector<ClusterGroup> groups = make_cluster_groups(21, 500, 1.2);
+
+  size_t next = 21;
+  for (const ClusterGroup& group : groups) {
+    EXPECT_EQ(group.first, next);
+    EXPECT_GE(group.last, group.first);
+    next = group.last + 1;
+  }
+  EXPECT_EQ(next, 501u);
+  EXPECT_LT(groups.size(), 480u);
+}
+
+// Groups of a single size hold exactly that size's concentration, so the
+// grouped system must reproduce the ungrouped one.
+TEST_F(ClusterGroupingTest, SingleSizeGroups_MatchUngroupedSystem) {
+  ClusterDynamicsCpuImpl ungrouped(config);
+  *ungrouped.dislocation_density = 1e10;
+  ungrouped.interstitials[max_cluster_size] = 0.;
+  ungrouped.vacancies[max_cluster_size] = 0.;
+
+  config.group_threshold = group_threshold;
+  config.group_growth = 1.;
+  ClusterDynamicsCpuImpl grouped(config);
+  *grouped.dislocation_density = 1e10;
+
+  ASSERT_EQ(grouped.groups.size(), max_cluster_size - group_threshold);
+
+  const std::vector<gp_float> expected = derivatives(ungrouped);
+  const std::vector<gp_float> actual = derivatives(grouped);
+
+  auto expect_close = [](gp_float a, gp_float b) {
+    EXPECT_NEAR(a, b, 1e-10 * std::max(std::abs(a), std::abs(b)) + 1e-30);
+  };
+
+  for (size_t n = 1; n <= group_threshold; ++n) {
+    expect_close(actual[grouped.i_index(n)], expected[ungrouped.i_index(n)]);
+    expect_close(actual[grouped.v_index(n)], expected[ungrouped.v_index(n)]);
+  }
+  for (size_t g = 0; g < grouped.groups.size(); ++g) {
+    const size_t n = grouped.groups[g].first;
+    expect_close(actual[grouped.i_group_index(g)],
+                 expected[ungrouped.i_index(n)]);
+    expect_close(actual[grouped.v_group_index(g)],
+                 expected[ungrouped.v_index(n)]);
+    EXPECT_EQ(actual[grouped.i_group_index(g) + 1], 0.);
+  }
+  expect_close(actual[grouped.dislocation_index()],
+               expected[ungrouped.dislocation_index()]);
+}
+
+TEST_F(ClusterGroupingTest, Expanded_ReconstructsLinearProfile) {
+  for (size_t n = 1; n <= max_cluster_size; ++n) {
+    config.init_interstitials[n] = 1e6 + 2e3 * (gp_float)n;
+    config.init_vacancies[n] = 5e5 - 1e3 * (gp_float)n;
+  }
+  config.group_threshold = group_threshold;
+  config.group_growth = 1.5;
+  ClusterDynamicsCpuImpl cd(config);
+
+  ClusterDynamicsState state;
+  state.interstitials.assign(cd.interstitials,
+                             cd.interstitials + group_threshold + 1);
+  state.vacancies.assign(cd.vacancies, cd.vacancies + group_threshold + 1);
+  const size_t G = cd.groups.size();
+  for (size_t g = 0; g < G; ++g) {
+    state.interstitial_groups.push_back(
+        {cd.groups[g].first, cd.groups[g].last, cd.group_moments[2 * g],
+         cd.group_moments[2 * g + 1]});
+    state.vacancy_groups.push_back(
+        {cd.groups[g].first, cd.groups[g].last, cd.group_moments[2 * (G + g)],
+         cd.group_moments[2 * (G + g) + 1]});
+  }
+
+  const ClusterDynamicsState expanded = state.expanded();
+  ASSERT_EQ(expanded.interstitials.size(), max_cluster_size + 1);
+  ASSERT_EQ(expanded.vacancies.size(), max_cluster_size + 1);
+  EXPECT_TRUE(expanded.interstitial_groups.empty());
+  for (size_t n = 1; n <= max_cluster_size; ++n) {
+    EXPECT_NEAR(expanded.interstitials[n], config.init_interstitials[n], 1e-6);
+    EXPECT_NEAR(expanded.vacancies[n], config.init_vacancies[n], 1e-6);
+  }
+}
+
+// The analytic jacobian covers the group moments, so every linear solver
+// follows the same solution
+TEST_F(ClusterGroupingTest, LinearSolvers_Agree) {
+  config.group_threshold = group_threshold;
+  ClusterDynamics dense = ClusterDynamics::cpu(config);
+  const ClusterDynamicsState expected = dense.run(0., 1e3);
+
+  for (const LinearSolverType type :
+       {LinearSolverType::arrowhead, LinearSolverType::gmres}) {
+    config.linear_solver = type;
+    ClusterDynamics cd = ClusterDynamics::cpu(config);
+    const ClusterDynamicsState state = cd.run(0., 1e3);
+    ASSERT_EQ(state.interstitials.size(), expected.interstitials.size());
+    for (size_t n = 1; n < state.interstitials.size(); ++n) {
+      EXPECT_NEAR(state.interstitials[n], expected.interstitials[n],
+                  1e-3 * std::abs(expected.interstitials[n]) + 1e-6);
+      EXPECT_NEAR(state.vacancies[n], expected.vacancies[n],
+                  1e-3 * std::abs(expected.vacancies[n]) + 1e-6);
+    }
+  }
+}
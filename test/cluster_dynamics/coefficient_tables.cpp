@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "../gtest_helpers.hpp"
+#include "cluster_dynamics/cluster_dynamics_config.hpp"
+#include "cpu/cluster_dynamics_cpu_impl.hpp"
+#include "model/material.hpp"
+#include "model/nuclear_reactor.hpp"
+
+class CoefficientTablesTest : public ::testing::Test {
+ protected:
+  static constexpr size_t max_cluster_size = 50;
+
+  void SetUp() override {
+    materials::SA304(config.material);
+    nuclear_reactors::OSIRIS(config.reactor);
+    config.max_cluster_size = max_cluster_size;
+    config.init_interstitials = std::vector<gp_float>(max_cluster_size, 0.);
+    config.init_vacancies = std::vector<gp_float>(max_cluster_size, 0.);
+
+    cd = std::make_unique<ClusterDynamicsCpuImpl>(config);
+  }
+
+  void expect_tables_current() {
+    ASSERT_EQ(cd->ii_emission_val.size(), max_cluster_size + 2);
+    for (size_t n = 1; n <= max_cluster_size + 1; ++n) {
+      GP_EXPECT_NEAR(cd->cluster_radius_val[n], cd->cluster_radius(n));
+      GP_EXPECT_NEAR(cd->ii_emission_val[n], cd->ii_emission(n));
+      GP_EXPECT_NEAR(cd->vv_emission_val[n], cd->vv_emission(n));
+      GP_EXPECT_NEAR(cd->ii_absorption_val[n], cd->ii_absorption(n));
+      GP_EXPECT_NEAR(cd->iv_absorption_val[n], cd->iv_absorption(n));
+      GP_EXPECT_NEAR(cd->vi_absorption_val[n], cd->vi_absorption(n));
+      GP_EXPECT_NEAR(cd->vv_absorption_val[n], cd->vv_absorption(n));
+      GP_EXPECT_NEAR(cd->i_dislocation_loop_unfault_probability_val[n],
+                     cd->i_dislocation_loop_unfault_probability(n));
+    }
+  }
+
+  ClusterDynamicsConfig config;
+  std::unique_ptr<ClusterDynamicsCpuImpl> cd;
+};
+
+TEST_F(CoefficientTablesTest, Constructor_BuildsTables) {
+  expect_tables_current();
+}
+
+TEST_F(CoefficientTablesTest, SetReactor_RebuildsTables) {
+  const gp_float emission = cd->ii_emission_val[10];
+
+  NuclearReactorImpl reactor = cd->get_reactor();
+  reactor.temperature += 100.;
+  cd->set_reactor(reactor);
+
+  EXPECT_NE(cd->ii_emission_val[10], emission);
+  expect_tables_current();
+}
+
+TEST_F(CoefficientTablesTest, SetMaterial_RebuildsTables) {
+  const gp_float absorption = cd->vv_absorption_val[10];
+
+  MaterialImpl material = cd->get_material();
+  material.lattice_param *= 1.1;
+  cd->set_material(material);
+
+  EXPECT_NE(cd->vv_absorption_val[10], absorption);
+  expect_tables_current();
+}
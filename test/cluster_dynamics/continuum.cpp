@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "cluster_dynamics/cluster_dynamics.hpp"
+#include "cluster_dynamics/cluster_dynamics_config.hpp"
+#include "cpu/cluster_dynamics_cpu_impl.hpp"
+#include "model/material.hpp"
+#include "model/nuclear_reactor.hpp"
+
+class ContinuumTest : public ::testing::Test {
+ protected:
+  static constexpr size_t max_cluster_size = 60;
+  static constexpr size_t continuum_threshold = 20;
+
+  void SetUp() override {
+    materials::SA304(config.material);
+    nuclear_reactors::OSIRIS(config.reactor);
+    config.max_cluster_size = max_cluster_size;
+    config.init_interstitials = std::vector<gp_float>(max_cluster_size + 1, 0.);
+    config.init_vacancies = std::vector<gp_float>(max_cluster_size + 1, 0.);
+
+    // The ungrouped sums stop short of the largest sizes, leave them empty
+    // so both modes see the same clusters
+    for (size_t n = 1; n < max_cluster_size - 1; ++n) {
+      config.init_interstitials[n] = 1e12 / (gp_float)(n * n);
+      config.init_vacancies[n] = 3e11 / (gp_float)n;
+    }
+  }
+
+  std::vector<gp_float> derivatives(ClusterDynamicsCpuImpl& cd) {
+    N_Vector v_derivatives = N_VClone(cd.state);
+    ClusterDynamicsCpuImpl::system(0., cd.state, v_derivatives, &cd);
+    const gp_float* d = N_VGetArrayPointer(v_derivatives);
+    std::vector<gp_float> result(d, d + cd.state_size);
+    N_VDestroy(v_derivatives);
+    return result;
+  }
+
+  ClusterDynamicsConfig config;
+};
+
+TEST_F(ContinuumTest, Flux_ReducesToMasterEquationForUnitSpacing) {
+  EXPECT_NEAR(continuum_flux(3., 2., 1., 5., 7.), 3. * 5. - 2. * 7., 1e-12);
+  EXPECT_NEAR(continuum_flux(2., 3., 1., 5., 7.), 2. * 5. - 3. * 7., 1e-12);
+  EXPECT_NEAR(continuum_flux(2., 2., 1., 5., 7.), 2. * 5. - 2. * 7., 1e-12);
+  EXPECT_EQ(continuum_flux(2., 0., 1., 5., 7.), 2. * 5.);
+  EXPECT_EQ(continuum_flux(0., 3., 1., 5., 7.), -3. * 7.);
+}
+
+TEST_F(ContinuumTest, Flux_WeightsStayPositiveForWideSpacing) {
+  for (gp_float h : {1., 10., 1e3, 1e6}) {
+    for (gp_float ratio : {.5, .999, 1.001, 2.}) {
+      const gp_float left = continuum_flux(ratio, 1., h, 1., 0.);
+      const gp_float right = continuum_flux(ratio, 1., h, 0., 1.);
+      EXPECT_TRUE(std::isfinite(left));
+      EXPECT_TRUE(std::isfinite(right));
+      EXPECT_GE(left, 0.);
+      EXPECT_LE(right, 0.);
+    }
+  }
+}
+
+// Cells of a single size hold exactly that size's concentration, so the
+// hybrid system must reproduce the master equation.
+TEST_F(ContinuumTest, SingleSizeCells_MatchMasterEquation) {
+  ClusterDynamicsCpuImpl discrete(config);
+  *discrete.dislocation_density = 1e10;
+  discrete.interstitials[max_cluster_size] = 0.;
+  discrete.vacancies[max_cluster_size] = 0.;
+
+  config.continuum_threshold = continuum_threshold;
+  config.continuum_growth = 1.;
+  ClusterDynamicsCpuImpl hybrid(config);
+  *hybrid.dislocation_density = 1e10;
+
+  ASSERT_EQ(hybrid.continuum_cells.size(),
+            max_cluster_size - continuum_threshold);
+
+  const std::vector<gp_float> expected = derivatives(discrete);
+  const std::vector<gp_float> actual = derivatives(hybrid);
+
+  auto expect_close = [](gp_float a, gp_float b) {
+    EXPECT_NEAR(a, b, 1e-9 * std::max(std::abs(a), std::abs(b)) + 1e-30);
+  };
+
+  for (size_t n = 1; n <= continuum_threshold; ++n) {
+    expect_close(actual[hybrid.i_index(n)], expected[discrete.i_index(n)]);
+    expect_close(actual[hybrid.v_index(n)], expected[discrete.v_index(n)]);
+  }
+  for (size_t k = 0; k < hybrid.continuum_cells.size(); ++k) {
+    const size_t n = hybrid.continuum_cells[k].first;
+    expect_close(actual[hybrid.i_cell_index(k)],
+                 expected[discrete.i_index(n)]);
+    expect_close(actual[hybrid.v_cell_index(k)],
+                 expected[discrete.v_index(n)]);
+  }
+  expect_close(actual[hybrid.dislocation_index()],
+               expected[discrete.dislocation_index()]);
+}
+
+TEST_F(ContinuumTest, WideCells_CoverLargeSizesWithFewEquations) {
+  config.max_cluster_size = 10000000;
+  config.continuum_threshold = continuum_threshold;
+  ClusterDynamicsCpuImpl cd(config);
+
+  EXPECT_LT(cd.state_size, 1000u);
+  EXPECT_EQ(cd.continuum_cells.back().last, config.max_cluster_size);
+
+  const std::vector<gp_float> d = derivatives(cd);
+  for (gp_float value : d) EXPECT_TRUE(std::isfinite(value));
+}
+
+TEST_F(ContinuumTest, WithGrouping_Throws) {
+  config.continuum_threshold = continuum_threshold;
+  config.group_threshold = continuum_threshold;
+  EXPECT_THROW(ClusterDynamicsCpuImpl cd(config), ClusterDynamicsException);
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "cluster_dynamics/cluster_dynamics_config.hpp"
+#include "model/material.hpp"
+#include "model/nuclear_reactor.hpp"
+
+class CopyOnWriteTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    materials::SA304(config.material);
+    nuclear_reactors::OSIRIS(config.reactor);
+  }
+
+  ClusterDynamicsConfig config;
+};
+
+TEST_F(CopyOnWriteTest, Copies_ShareParametersUntilWritten) {
+  ClusterDynamicsConfig copy = config;
+  EXPECT_EQ(copy.material.impl(), config.material.impl());
+  EXPECT_EQ(copy.reactor.impl(), config.reactor.impl());
+
+  copy.material.set_i_migration(config.material.get_i_migration() + 0.1);
+  copy.reactor.set_flux(config.reactor.get_flux() * 2.);
+  EXPECT_NE(copy.material.impl(), config.material.impl());
+  EXPECT_NE(copy.reactor.impl(), config.reactor.impl());
+}
+
+TEST_F(CopyOnWriteTest, WritingACopy_LeavesTheOriginal) {
+  const gp_float i_migration = config.material.get_i_migration();
+  const gp_float flux = config.reactor.get_flux();
+
+  Material material = config.material;
+  NuclearReactor reactor = config.reactor;
+  materials::SA304(material);
+  nuclear_reactors::OSIRIS(reactor);
+  material.set_i_migration(i_migration + 0.1);
+  reactor.set_flux(flux * 2.);
+
+  EXPECT_EQ(config.material.get_i_migration(), i_migration);
+  EXPECT_EQ(config.reactor.get_flux(), flux);
+  EXPECT_EQ(material.get_i_migration(), i_migration + 0.1);
+  EXPECT_EQ(reactor.get_flux(), flux * 2.);
+}
+
+TEST_F(CopyOnWriteTest, UnsharedParameters_AreWrittenInPlace) {
+  const MaterialImpl* material = config.material.impl();
+  const NuclearReactorImpl* reactor = config.reactor.impl();
+  config.material.set_i_migration(0.5);
+  config.reactor.set_flux(1e-6);
+  EXPECT_EQ(config.material.impl(), material);
+  EXPECT_EQ(config.reactor.impl(), reactor);
+}
+
+// Threads copying one shared config and changing their copies each see
+// their own values
+TEST_F(CopyOnWriteTest, ConcurrentCopies_AreIndependent) {
+  constexpr size_t num_threads = 8;
+  constexpr size_t iterations = 1000;
+  const gp_float flux = config.reactor.get_flux();
+  std::vector<int> mismatches(num_threads, 0);
+
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < num_threads; ++t)
+    threads.emplace_back([&, t] {
+      for (size_t i = 0; i < iterations; ++i) {
+        ClusterDynamicsConfig copy = config;
+        const gp_float value = flux * (gp_float)(t + 1);
+        copy.reactor.set_flux(value);
+        copy.material.set_i_migration((gp_float)t);
+        if (copy.reactor.get_flux() != value ||
+            copy.material.get_i_migration() != (gp_float)t)
+          ++mismatches[t];
+      }
+    });
+  for (std::thread& thread : threads) thread.join();
+
+  for (size_t t = 0; t < num_threads; ++t) EXPECT_EQ(mismatches[t], 0);
+  EXPECT_EQ(config.reactor.get_flux(), flux);
+}
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "cluster_dynamics/cluster_dynamics.hpp"
+#include "cluster_dynamics/cluster_dynamics_config.hpp"
+#include "model/material.hpp"
+#include "model/nuclear_reactor.hpp"
+
+class DenseOutputTest : public ::testing::Test {
+ protected:
+  static constexpr size_t max_cluster_size = 50;
+
+  void SetUp() override {
+    materials::SA304(config.material);
+    nuclear_reactors::OSIRIS(config.reactor);
+    config.max_cluster_size = max_cluster_size;
+    config.init_interstitials = std::vector<gp_float>(max_cluster_size, 0.);
+    config.init_vacancies = std::vector<gp_float>(max_cluster_size, 0.);
+  }
+
+  ClusterDynamicsConfig config;
+};
+
+TEST_F(DenseOutputTest, Sample_ReturnsRequestedTimesInOrder) {
+  ClusterDynamics cd = ClusterDynamics::cpu(config);
+  const std::vector<gp_float> times = {1e-2, 1., 1e2, 1e2, 1e4};
+
+  std::vector<gp_float> sampled;
+  const ClusterDynamicsState end =
+      cd.sample(times, [&](const ClusterDynamicsState& state) {
+        sampled.push_back(state.time);
+      });
+
+  EXPECT_EQ(sampled, times);
+  EXPECT_EQ(end.time, times.back());
+}
+
+TEST_F(DenseOutputTest, Sample_MatchesRun) {
+  ClusterDynamics sampled_cd = ClusterDynamics::cpu(config);
+  ClusterDynamics run_cd = ClusterDynamics::cpu(config);
+  const std::vector<gp_float> times = {1e2, 1e3, 1e4};
+
+  const std::vector<ClusterDynamicsState> samples = sampled_cd.sample(times);
+  ASSERT_EQ(samples.size(), times.size());
+
+  gp_float previous = 0.;
+  for (size_t s = 0; s < times.size(); ++s) {
+    const ClusterDynamicsState state = run_cd.run(0., times[s] - previous);
+    previous = times[s];
+
+    ASSERT_EQ(samples[s].interstitials.size(), state.interstitials.size());
+    for (size_t n = 1; n < state.interstitials.size(); ++n) {
+      EXPECT_NEAR(samples[s].interstitials[n], state.interstitials[n],
+                  1e-3 * std::abs(state.interstitials[n]) + 1e2);
+      EXPECT_NEAR(samples[s].vacancies[n], state.vacancies[n],
+                  1e-3 * std::abs(state.vacancies[n]) + 1e2);
+    }
+  }
+}
+
+TEST_F(DenseOutputTest, Sample_ResumesFromEndTime) {
+  ClusterDynamics cd = ClusterDynamics::cpu(config);
+  cd.sample({1., 2.});
+  const std::vector<ClusterDynamicsState> samples = cd.sample({2., 3.});
+  ASSERT_EQ(samples.size(), 2u);
+  EXPECT_EQ(samples[0].time, 2.);
+  EXPECT_EQ(samples[1].time, 3.);
+}
+
+TEST_F(DenseOutputTest, UnorderedTimes_Throw) {
+  ClusterDynamics cd = ClusterDynamics::cpu(config);
+  EXPECT_THROW(cd.sample({2., 1.}), ClusterDynamicsException);
+
+  cd.run(0., 5.);
+  EXPECT_THROW(cd.sample({1.}), ClusterDynamicsException);
+}
@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "cluster_dynamics/cluster_dynamics.hpp"
+#include "cluster_dynamics/cluster_dynamics_config.hpp"
+#include "cluster_dynamics/cluster_dynamics_ensemble.hpp"
+#include "cpu/cluster_dynamics_cpu_impl.hpp"
+#include "cpu/cluster_dynamics_ensemble_impl.hpp"
+#include "model/material.hpp"
+#include "model/nuclear_reactor.hpp"
+
+class EnsembleTest : public ::testing::Test {
+ protected:
+  static constexpr size_t max_cluster_size = 50;
+
+  void SetUp() override {
+    // Members differ in their parameters and sizes
+    for (size_t m = 0; m < 3; ++m) {
+      ClusterDynamicsConfig config;
+      materials::SA304(config.material);
+      nuclear_reactors::OSIRIS(config.reactor);
+      config.reactor.set_flux(config.reactor.get_flux() * (gp_float)(m + 1));
+      config.material.set_i_migration(config.material.get_i_migration() +
+                                      0.05 * (gp_float)m);
+      config.max_cluster_size = max_cluster_size + 10 * m;
+      config.relative_tolerance = 1e-8;
+      config.init_interstitials =
+          std::vector<gp_float>(config.max_cluster_size, 0.);
+      config.init_vacancies =
+          std::vector<gp_float>(config.max_cluster_size, 0.);
+      for (size_t n = 1; n < config.max_cluster_size; ++n) {
+        config.init_interstitials[n] = 1e12 / (gp_float)(n * n);
+        config.init_vacancies[n] = 3e11 / (gp_float)n;
+      }
+      configs.push_back(config);
+    }
+  }
+
+  std::vector<ClusterDynamicsConfig> configs;
+};
+
+TEST_F(EnsembleTest, System_MatchesMemberSystems) {
+  ClusterDynamicsEnsembleImpl ensemble(configs);
+  N_Vector derivatives = N_VClone(ensemble.state);
+  ClusterDynamicsEnsembleImpl::system(0., ensemble.state, derivatives,
+                                      &ensemble);
+  const gp_float* actual = N_VGetArrayPointer(derivatives);
+
+  for (size_t m = 0; m < configs.size(); ++m) {
+    ClusterDynamicsCpuImpl cd(configs[m]);
+    N_Vector expected = N_VClone(cd.state);
+    ClusterDynamicsCpuImpl::system(0., cd.state, expected, &cd);
+    const gp_float* e = N_VGetArrayPointer(expected);
+    ASSERT_EQ(ensemble.offsets[m + 1] - ensemble.offsets[m],
+              (sunindextype)cd.state_size);
+    for (size_t i = 0; i < cd.state_size; ++i)
+      EXPECT_EQ(actual[ensemble.offsets[m] + i], e[i])
+          << "member " << m << " index " << i;
+    N_VDestroy(expected);
+  }
+
+  N_VDestroy(derivatives);
+}
+
+// Solves (I - gamma J) x = b and checks the residual, serially and threaded
+TEST_F(EnsembleTest, BlockDiagonalSolver_SolvesNewtonSystem) {
+  for (size_t n_threads : {1, 3}) {
+    ClusterDynamicsEnsembleImpl ensemble(configs, n_threads);
+    N_Vector b = N_VClone(ensemble.state);
+    N_Vector x = N_VClone(ensemble.state);
+    N_Vector residual = N_VClone(ensemble.state);
+    gp_float* b_data = N_VGetArrayPointer(b);
+    for (sunindextype i = 0; i < N_VGetLength(b); ++i)
+      b_data[i] = std::sin((gp_float)(i + 1));
+
+    ASSERT_EQ(ClusterDynamicsEnsembleImpl::jacobian(
+                  0., ensemble.state, residual, ensemble.jacobian_matrix,
+                  &ensemble, nullptr, nullptr, nullptr),
+              0);
+    SUNMatScaleAddI(-1e-6, ensemble.jacobian_matrix);
+    ASSERT_EQ(SUNLinSolSetup(ensemble.linear_solver, ensemble.jacobian_matrix),
+              0);
+    ASSERT_EQ(SUNLinSolSolve(ensemble.linear_solver, ensemble.jacobian_matrix,
+                             x, b, 0.),
+              0);
+    SUNMatMatvec(ensemble.jacobian_matrix, x, residual);
+
+    const gp_float* r = N_VGetArrayPointer(residual);
+    for (sunindextype i = 0; i < N_VGetLength(b); ++i)
+      EXPECT_NEAR(r[i], b_data[i], 1e-9) << "index " << i;
+
+    for (N_Vector v : {b, x, residual}) N_VDestroy(v);
+  }
+}
+
+TEST_F(EnsembleTest, Run_MatchesIndividualRuns) {
+  ClusterDynamicsEnsemble ensemble(configs, 2);
+  ASSERT_EQ(ensemble.size(), configs.size());
+  const std::vector<ClusterDynamicsState> states = ensemble.run(1e2);
+  EXPECT_EQ(ensemble.get_time(), 1e2);
+  ASSERT_EQ(states.size(), configs.size());
+
+  for (size_t m = 0; m < configs.size(); ++m) {
+    const ClusterDynamicsState expected =
+        ClusterDynamics::cpu(configs[m]).run(0., 1e2);
+    EXPECT_EQ(states[m].time, expected.time);
+    ASSERT_EQ(states[m].interstitials.size(), expected.interstitials.size());
+    EXPECT_NEAR(states[m].dislocation_density, expected.dislocation_density,
+                1e-5 * expected.dislocation_density);
+    for (size_t n = 1; n < expected.interstitials.size(); ++n) {
+      EXPECT_NEAR(states[m].interstitials[n], expected.interstitials[n],
+                  1e-5 * std::abs(expected.interstitials[n]) + 1e-3)
+          << "member " << m << " size " << n;
+      EXPECT_NEAR(states[m].vacancies[n], expected.vacancies[n],
+                  1e-5 * std::abs(expected.vacancies[n]) + 1e-3)
+          << "member " << m << " size " << n;
+    }
+  }
+}
+
+TEST_F(EnsembleTest, UnsupportedConfigs_Throw) {
+  std::vector<ClusterDynamicsConfig> none;
+  EXPECT_THROW(ClusterDynamicsEnsemble{none}, ClusterDynamicsException);
+
+  configs[1].group_threshold = 20;
+  EXPECT_THROW(ClusterDynamicsEnsemble{configs}, ClusterDynamicsException);
+}
+
+// Each member is held to its own tolerances, however many members there are
+TEST_F(EnsembleTest, Norm_IsTheLargestMemberNorm) {
+  ClusterDynamicsEnsembleImpl ensemble(configs);
+  N_Vector weights = N_VClone(ensemble.state);
+  ASSERT_EQ(ClusterDynamicsEnsembleImpl::error_weights(ensemble.state, weights,
+                                                       &ensemble),
+            0);
+  // A clone of a clone, as CVODE makes of its vectors
+  N_Vector error = N_VClone(weights);
+  gp_float* e = N_VGetArrayPointer(error);
+  for (sunindextype i = 0; i < N_VGetLength(error); ++i)
+    e[i] = 1e-9 * std::abs(std::sin((gp_float)(i + 1)));
+
+  gp_float largest = 0.;
+  for (size_t m = 0; m < configs.size(); ++m) {
+    ClusterDynamicsCpuImpl cd(configs[m]);
+    N_Vector member_error = N_VClone(cd.state);
+    N_Vector member_weights = N_VClone(cd.state);
+    std::copy(e + ensemble.offsets[m], e + ensemble.offsets[m + 1],
+              N_VGetArrayPointer(member_error));
+    for (size_t i = 0; i < cd.state_size; ++i)
+      N_VGetArrayPointer(member_weights)[i] =
+          1. / (cd.relative_tolerance *
+                    std::abs(N_VGetArrayPointer(cd.state)[i]) +
+                cd.absolute_tolerance);
+    largest = std::max(largest, N_VWrmsNorm(member_error, member_weights));
+    N_VDestroy(member_error);
+    N_VDestroy(member_weights);
+  }
+
+  EXPECT_DOUBLE_EQ(N_VWrmsNorm(error, weights), largest);
+  N_VDestroy(error);
+  N_VDestroy(weights);
+}
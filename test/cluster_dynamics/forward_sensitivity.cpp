@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "cluster_dynamics/cluster_dynamics.hpp"
+#include "cluster_dynamics/cluster_dynamics_config.hpp"
+#include "cpu/cluster_dynamics_cpu_impl.hpp"
+#include "model/material.hpp"
+#include "model/nuclear_reactor.hpp"
+
+class ForwardSensitivityTest : public ::testing::Test {
+ protected:
+  static constexpr size_t max_cluster_size = 50;
+
+  void SetUp() override {
+    materials::SA304(config.material);
+    nuclear_reactors::OSIRIS(config.reactor);
+    config.max_cluster_size = max_cluster_size;
+    config.init_interstitials = std::vector<gp_float>(max_cluster_size, 0.);
+    config.init_vacancies = std::vector<gp_float>(max_cluster_size, 0.);
+    for (size_t n = 1; n < max_cluster_size; ++n) {
+      config.init_interstitials[n] = 1e12 / (gp_float)(n * n);
+      config.init_vacancies[n] = 3e11 / (gp_float)n;
+    }
+  }
+
+  std::vector<gp_float> derivatives(ClusterDynamicsCpuImpl& cd,
+                                    N_Vector v_state) {
+    N_Vector v_derivatives = N_VClone(v_state);
+    ClusterDynamicsCpuImpl::system(0., v_state, v_derivatives, &cd);
+    const gp_float* d = N_VGetArrayPointer(v_derivatives);
+    std::vector<gp_float> result(d, d + cd.state_size);
+    N_VDestroy(v_derivatives);
+    cd.alias_state(cd.state);
+    return result;
+  }
+
+  ClusterDynamicsConfig config;
+};
+
+// The sensitivity right hand side is the derivative of f along (s, 1) in
+// (state, parameter), checked against a central difference of f.
+TEST_F(ForwardSensitivityTest, SensitivityRhs_MatchesDirectionalDerivative) {
+  const std::vector<SensitivityVariable> variables = {
+      SensitivityVariable::interstitial_migration_ev,
+      SensitivityVariable::vacancy_binding_ev,
+      SensitivityVariable::flux_dpa_s,
+      SensitivityVariable::temperature_kelvin,
+      SensitivityVariable::dislocation_density_evolution};
+
+  ClusterDynamicsCpuImpl cd(config);
+  *cd.dislocation_density = 1e10;
+  cd.enable_sensitivities(variables);
+
+  for (size_t s = 0; s < variables.size(); ++s) {
+    gp_float& parameter = cd.sensitivity_parameter(variables[s]);
+    const gp_float original = parameter;
+
+    // A direction which scales the state with the parameter
+    N_Vector v_sensitivity = N_VClone(cd.state);
+    N_VScale(1. / original, cd.state, v_sensitivity);
+
+    N_Vector v_derivatives = N_VClone(cd.state);
+    N_Vector v_sensitivity_derivatives = N_VClone(cd.state);
+    N_Vector tmp1 = N_VClone(cd.state);
+    N_Vector tmp2 = N_VClone(cd.state);
+    ClusterDynamicsCpuImpl::system(0., cd.state, v_derivatives, &cd);
+    ClusterDynamicsCpuImpl::sensitivity_rhs(
+        variables.size(), 0., cd.state, v_derivatives, s, v_sensitivity,
+        v_sensitivity_derivatives, &cd, tmp1, tmp2);
+    EXPECT_EQ(parameter, original);
+
+    const gp_float epsilon = 1e-5 * original;
+    N_Vector v_shifted = N_VClone(cd.state);
+    N_VLinearSum(1., cd.state, epsilon, v_sensitivity, v_shifted);
+    parameter = original + epsilon;
+    cd.coefficient_init();
+    const std::vector<gp_float> upper = derivatives(cd, v_shifted);
+
+    N_VLinearSum(1., cd.state, -epsilon, v_sensitivity, v_shifted);
+    parameter = original - epsilon;
+    cd.coefficient_init();
+    const std::vector<gp_float> lower = derivatives(cd, v_shifted);
+
+    parameter = original;
+    cd.coefficient_init();
+
+    const gp_float* actual = N_VGetArrayPointer(v_sensitivity_derivatives);
+    for (size_t i = 0; i < cd.state_size; ++i) {
+      const gp_float expected = (upper[i] - lower[i]) / (2. * epsilon);
+      EXPECT_NEAR(actual[i], expected,
+                  1e-4 * (std::abs(upper[i]) + std::abs(lower[i])) /
+                          std::abs(original) +
+                      1e-30)
+          << "variable " << s << " index " << i;
+    }
+
+    for (N_Vector v : {v_sensitivity, v_derivatives, v_sensitivity_derivatives,
+                       tmp1, tmp2, v_shifted})
+      N_VDestroy(v);
+  }
+}
+
+// The tables kept for each field give the difference quotient of a full
+// rebuild at the perturbed value, and leave the current tables as they were
+TEST_F(ForwardSensitivityTest, ParameterDerivative_MatchesFullRebuild) {
+  ClusterDynamicsCpuImpl cd(config);
+  *cd.dislocation_density = 1e10;
+  const std::vector<gp_float> emission = cd.ii_emission_val;
+  const std::vector<gp_float> f = derivatives(cd, cd.state);
+  const gp_float step = std::sqrt(std::numeric_limits<gp_float>::epsilon());
+
+  N_Vector v_derivatives = N_VClone(cd.state);
+  N_Vector v_parameter_derivatives = N_VClone(cd.state);
+  ClusterDynamicsCpuImpl::system(0., cd.state, v_derivatives, &cd);
+  for (const auto& [name, parameter] : cd.model_parameters()) {
+    const gp_float original = *parameter;
+    const gp_float scale = original != 0. ? std::abs(original) : 1.;
+    const gp_float delta = step * scale;
+
+    // The second call reuses the tables of the first
+    for (int call = 0; call < 2; ++call) {
+      ASSERT_EQ(cd.parameter_derivative(*parameter, scale, 0., cd.state,
+                                        v_derivatives,
+                                        v_parameter_derivatives),
+                0);
+    }
+    EXPECT_EQ(*parameter, original);
+    EXPECT_EQ(cd.ii_emission_val, emission) << name;
+
+    *parameter = original + delta;
+    cd.coefficient_init();
+    const std::vector<gp_float> upper = derivatives(cd, cd.state);
+    *parameter = original;
+    cd.coefficient_init();
+
+    const gp_float* actual = N_VGetArrayPointer(v_parameter_derivatives);
+    for (size_t i = 0; i < cd.state_size; ++i) {
+      const gp_float expected = (upper[i] - f[i]) / delta;
+      EXPECT_NEAR(actual[i], expected,
+                  1e-6 * std::abs(expected) + 1e-7 * std::abs(f[i]) / scale +
+                      1e-30)
+          << name << " index " << i;
+    }
+  }
+  EXPECT_EQ(cd.perturbed_coefficient_cache.size(),
+            cd.model_parameters().size());
+
+  N_VDestroy(v_derivatives);
+  N_VDestroy(v_parameter_derivatives);
+}
+
+TEST_F(ForwardSensitivityTest, InitialDislocationDensity_SeedsInitialState) {
+  ClusterDynamics cd = ClusterDynamics::cpu(config);
+  cd.enable_sensitivities(
+      {SensitivityVariable::initial_dislocation_density_cm,
+       SensitivityVariable::temperature_kelvin});
+
+  const std::vector<ClusterDynamicsSensitivity> sensitivities =
+      cd.get_sensitivities();
+  ASSERT_EQ(sensitivities.size(), 2u);
+  EXPECT_EQ(sensitivities[0].variable,
+            SensitivityVariable::initial_dislocation_density_cm);
+  EXPECT_EQ(sensitivities[0].dislocation_density, 1.);
+  EXPECT_EQ(sensitivities[0].interstitials.size(), max_cluster_size);
+  EXPECT_EQ(sensitivities[1].dislocation_density, 0.);
+}
+
+TEST_F(ForwardSensitivityTest, NotEnabled_Throws) {
+  ClusterDynamics cd = ClusterDynamics::cpu(config);
+  EXPECT_THROW(cd.get_sensitivities(), ClusterDynamicsException);
+  EXPECT_THROW(cd.enable_sensitivities({SensitivityVariable::NONE}),
+               ClusterDynamicsException);
+}
+
+TEST_F(ForwardSensitivityTest, WithGrouping_Throws) {
+  config.group_threshold = 20;
+  ClusterDynamics cd = ClusterDynamics::cpu(config);
+  EXPECT_THROW(cd.enable_sensitivities({SensitivityVariable::flux_dpa_s}),
+               ClusterDynamicsException);
+}
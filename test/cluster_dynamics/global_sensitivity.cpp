@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "cluster_dynamics/cluster_dynamics.hpp"
+#include "cluster_dynamics/cluster_dynamics_config.hpp"
+#include "cluster_dynamics/global_sensitivity.hpp"
+#include "model/material.hpp"
+#include "model/nuclear_reactor.hpp"
+
+class GlobalSensitivityTest : public ::testing::Test {
+ protected:
+  static constexpr size_t max_cluster_size = 50;
+
+  void SetUp() override {
+    materials::SA304(config.material);
+    nuclear_reactors::OSIRIS(config.reactor);
+    config.max_cluster_size = max_cluster_size;
+    config.init_interstitials = std::vector<gp_float>(max_cluster_size, 0.);
+    config.init_vacancies = std::vector<gp_float>(max_cluster_size, 0.);
+  }
+
+  // The Ishigami function of the migration and formation energies, whose
+  // indices are known analytically
+  static ClusterDynamicsState ishigami(ClusterDynamicsConfig &config) {
+    const gp_float x1 = config.material.get_i_migration();
+    const gp_float x2 = config.material.get_v_migration();
+    const gp_float x3 = config.material.get_i_formation();
+    ClusterDynamicsState state;
+    state.dislocation_density = std::sin(x1) +
+                                7. * std::sin(x2) * std::sin(x2) +
+                                .1 * std::pow(x3, 4) * std::sin(x1);
+    return state;
+  }
+
+  std::vector<ParameterRange> ishigami_ranges() const {
+    return {{SensitivityVariable::interstitial_migration_ev, -M_PI, M_PI},
+            {SensitivityVariable::vacancy_migration_ev, -M_PI, M_PI},
+            {SensitivityVariable::interstitial_formation_ev, -M_PI, M_PI}};
+  }
+
+  ClusterDynamicsConfig config;
+};
+
+TEST_F(GlobalSensitivityTest, SobolSampler_FollowsTheSequence) {
+  SaltelliSampler sampler(SamplingMethod::sobol, 3, 1);
+  std::vector<gp_float> a, b;
+  const std::vector<std::vector<gp_float>> expected{
+      {.5, .5}, {.75, .25}, {.25, .75}};
+  for (size_t j = 0; j < expected.size(); ++j) {
+    sampler.sample(j, a, b);
+    EXPECT_EQ(a[0], expected[j][0]) << "sample " << j;
+    EXPECT_EQ(b[0], expected[j][1]) << "sample " << j;
+  }
+
+  EXPECT_THROW(SaltelliSampler(SamplingMethod::sobol, 3, 11),
+               ClusterDynamicsException);
+}
+
+TEST_F(GlobalSensitivityTest, LatinHypercube_DrawsEveryStratumOnce) {
+  constexpr size_t num_samples = 64;
+  SaltelliSampler sampler(SamplingMethod::latin_hypercube, num_samples, 3, 7);
+  std::vector<std::vector<int>> counts(6, std::vector<int>(num_samples, 0));
+  std::vector<gp_float> a, b;
+  for (size_t j = 0; j < num_samples; ++j) {
+    sampler.sample(j, a, b);
+    for (size_t i = 0; i < 3; ++i) {
+      ASSERT_GE(a[i], 0.);
+      ASSERT_LT(a[i], 1.);
+      ASSERT_GE(b[i], 0.);
+      ASSERT_LT(b[i], 1.);
+      ++counts[i][(size_t)(a[i] * num_samples)];
+      ++counts[3 + i][(size_t)(b[i] * num_samples)];
+    }
+  }
+
+  for (const std::vector<int> &column : counts)
+    for (int count : column) EXPECT_EQ(count, 1);
+}
+
+TEST_F(GlobalSensitivityTest, Ishigami_MatchesAnalyticIndices) {
+  // S_1, S_2, S_3 and S_T1, S_T2, S_T3 of the Ishigami function with a = 7,
+  // b = 0.1
+  const std::vector<gp_float> first_order{0.3139, 0.4424, 0.};
+  const std::vector<gp_float> total{0.5576, 0.4424, 0.2437};
+
+  for (SamplingMethod method :
+       {SamplingMethod::sobol, SamplingMethod::latin_hypercube}) {
+    const GlobalSensitivityAnalysis analysis(
+        config, ishigami_ranges(), {ScalarObservable::dislocation_density},
+        method, 8192, 3);
+    EXPECT_EQ(analysis.num_simulations(), 8192u * 5u);
+
+    const std::vector<GlobalSensitivity> result = analysis.run(ishigami, 2);
+    ASSERT_EQ(result.size(), 1u);
+    EXPECT_NEAR(result[0].mean, 3.5, .1);
+    ASSERT_EQ(result[0].indices.size(), 3u);
+    for (size_t i = 0; i < 3; ++i) {
+      EXPECT_EQ(result[0].indices[i].variable, ishigami_ranges()[i].variable);
+      EXPECT_NEAR(result[0].indices[i].first_order, first_order[i], .04)
+          << "parameter " << i;
+      EXPECT_NEAR(result[0].indices[i].total, total[i], .04)
+          << "parameter " << i;
+    }
+  }
+}
+
+TEST_F(GlobalSensitivityTest, Results_DoNotDependOnTheNumberOfThreads) {
+  const GlobalSensitivityAnalysis analysis(
+      config, ishigami_ranges(), {ScalarObservable::dislocation_density},
+      SamplingMethod::latin_hypercube, 100, 11);
+
+  size_t last_progress = 0;
+  const std::vector<GlobalSensitivity> serial =
+      analysis.run(ishigami, 1, [&](size_t done) { last_progress = done; });
+  EXPECT_EQ(last_progress, analysis.num_simulations());
+
+  const std::vector<GlobalSensitivity> threaded = analysis.run(ishigami, 3);
+  EXPECT_EQ(serial[0].mean, threaded[0].mean);
+  EXPECT_EQ(serial[0].variance, threaded[0].variance);
+  for (size_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(serial[0].indices[i].first_order,
+              threaded[0].indices[i].first_order);
+    EXPECT_EQ(serial[0].indices[i].total, threaded[0].indices[i].total);
+  }
+}
+
+TEST_F(GlobalSensitivityTest, ClusterDynamicsRuns_GiveIndices) {
+  config.simulation_time = 1e2;
+  const std::vector<ParameterRange> ranges{
+      {SensitivityVariable::flux_dpa_s, 2e-7, 4e-7},
+      {SensitivityVariable::temperature_kelvin, 573.15, 633.15}};
+  const GlobalSensitivityAnalysis analysis(
+      config, ranges,
+      {ScalarObservable::dislocation_density,
+       ScalarObservable::vacancy_cluster_volume},
+      SamplingMethod::sobol, 4);
+
+  const std::vector<GlobalSensitivity> result = analysis.run(
+      [](ClusterDynamicsConfig &run_config) {
+        return ClusterDynamics::cpu(run_config)
+            .run(run_config.time_delta, run_config.simulation_time);
+      },
+      2);
+
+  ASSERT_EQ(result.size(), 2u);
+  for (const GlobalSensitivity &sensitivity : result) {
+    EXPECT_TRUE(std::isfinite(sensitivity.mean));
+    EXPECT_GE(sensitivity.variance, 0.);
+    ASSERT_EQ(sensitivity.indices.size(), ranges.size());
+    for (const SobolIndices &indices : sensitivity.indices) {
+      EXPECT_TRUE(std::isfinite(indices.first_order));
+      EXPECT_GE(indices.total, 0.);
+    }
+  }
+}
+
+TEST_F(GlobalSensitivityTest, InvalidAnalyses_Throw) {
+  const std::vector<ScalarObservable> observables{
+      ScalarObservable::dislocation_density};
+  EXPECT_THROW(GlobalSensitivityAnalysis(config, {}, observables,
+                                         SamplingMethod::sobol, 16),
+               ClusterDynamicsException);
+  EXPECT_THROW(GlobalSensitivityAnalysis(config, ishigami_ranges(), {},
+                                         SamplingMethod::sobol, 16),
+               ClusterDynamicsException);
+  EXPECT_THROW(GlobalSensitivityAnalysis(
+                   config, {{SensitivityVariable::flux_dpa_s, 1., 0.}},
+                   observables, SamplingMethod::sobol, 16),
+               ClusterDynamicsException);
+
+  const GlobalSensitivityAnalysis analysis(
+      config, ishigami_ranges(), observables, SamplingMethod::sobol, 16);
+  EXPECT_THROW(analysis.run(
+                   [](ClusterDynamicsConfig &) -> ClusterDynamicsState {
+                     throw std::runtime_error("simulation failed");
+                   },
+                   2),
+               std::runtime_error);
+}
@@ -0,0 +1,275 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "cluster_dynamics/cluster_dynamics_config.hpp"
+#include "cpu/cluster_dynamics_cpu_impl.hpp"
+#include "model/material.hpp"
+#include "model/nuclear_reactor.hpp"
+
+class JacobianTest : public ::testing::Test {
+ protected:
+  static constexpr size_t max_cluster_size = 20;
+
+  void SetUp() override {
+    materials::SA304(config.material);
+    nuclear_reactors::OSIRIS(config.reactor);
+    config.max_cluster_size = max_cluster_size;
+    create();
+  }
+
+  /** @brief Creates the solver for config in a non-trivial state, so that
+   * every coupling term contributes. The groups and cells take their moments
+   * from the initial concentrations.
+   */
+  void create() {
+    config.init_interstitials.assign(config.max_cluster_size + 1, 0.);
+    config.init_vacancies.assign(config.max_cluster_size + 1, 0.);
+    for (size_t n = 1; n <= config.max_cluster_size; ++n) {
+      config.init_interstitials[n] = 1e12 / (gp_float)(n * n);
+      config.init_vacancies[n] = 3e11 / (gp_float)n;
+    }
+
+    cd = std::make_unique<ClusterDynamicsCpuImpl>(config);
+
+    for (size_t n = 1; n <= cd->max_cluster_size; ++n) {
+      cd->interstitials[n] = config.init_interstitials[n];
+      cd->vacancies[n] = config.init_vacancies[n];
+    }
+    cd->interstitials[0] = cd->vacancies[0] = 0.;
+    cd->interstitials[cd->max_cluster_size + 1] = 0.;
+    cd->vacancies[cd->max_cluster_size + 1] = 0.;
+    *cd->dislocation_density = 1e10;
+  }
+
+  /** @brief Evaluates system() for a copy of the current state.
+   */
+  std::vector<gp_float> rhs(const std::vector<gp_float>& y) {
+    N_Vector v_y = N_VNew_Serial(cd->state_size, cd->sun_context);
+    N_Vector v_dydt = N_VNew_Serial(cd->state_size, cd->sun_context);
+    std::copy(y.begin(), y.end(), N_VGetArrayPointer(v_y));
+
+    ClusterDynamicsCpuImpl::system(0., v_y, v_dydt, cd.get());
+    std::vector<gp_float> dydt(N_VGetArrayPointer(v_dydt),
+                               N_VGetArrayPointer(v_dydt) + cd->state_size);
+
+    N_VDestroy_Serial(v_y);
+    N_VDestroy_Serial(v_dydt);
+    return dydt;
+  }
+
+  /** @brief Evaluates the analytic jacobian into a dense matrix.
+   */
+  std::vector<gp_float> analytic_jacobian(SUNMatrix matrix) {
+    N_Vector v_y = N_VClone(cd->state);
+    N_VScale(1., cd->state, v_y);
+    ClusterDynamicsCpuImpl::jacobian(0., v_y, nullptr, matrix, cd.get(),
+                                     nullptr, nullptr, nullptr);
+    N_VDestroy(v_y);
+
+    std::vector<gp_float> dense(cd->state_size * cd->state_size, 0.);
+    if (SUNMatGetID(matrix) == SUNMATRIX_DENSE) {
+      for (size_t r = 0; r < cd->state_size; ++r)
+        for (size_t c = 0; c < cd->state_size; ++c)
+          dense[r * cd->state_size + c] = SM_ELEMENT_D(matrix, r, c);
+    } else if (SUNMatGetID(matrix) == SUNMATRIX_CUSTOM) {
+      N_Vector unit = N_VNew_Serial(cd->state_size, cd->sun_context);
+      N_Vector column = N_VNew_Serial(cd->state_size, cd->sun_context);
+      for (size_t c = 0; c < cd->state_size; ++c) {
+        N_VConst(0., unit);
+        N_VGetArrayPointer(unit)[c] = 1.;
+        SUNMatMatvec(matrix, unit, column);
+        for (size_t r = 0; r < cd->state_size; ++r)
+          dense[r * cd->state_size + c] = N_VGetArrayPointer(column)[r];
+      }
+      N_VDestroy_Serial(unit);
+      N_VDestroy_Serial(column);
+    } else {
+      const sunindextype* row_ptrs = SUNSparseMatrix_IndexPointers(matrix);
+      const sunindextype* cols = SUNSparseMatrix_IndexValues(matrix);
+      const sunrealtype* data = SUNSparseMatrix_Data(matrix);
+      for (size_t r = 0; r < cd->state_size; ++r)
+        for (sunindextype k = row_ptrs[r]; k < row_ptrs[r + 1]; ++k)
+          dense[r * cd->state_size + cols[k]] += data[k];
+    }
+    return dense;
+  }
+
+  /** @brief Checks the dense analytic jacobian against central differences
+   * of system().
+   */
+  void expect_dense_matches_finite_differences() {
+    const size_t size = cd->state_size;
+    SUNMatrix matrix = SUNDenseMatrix(size, size, cd->sun_context);
+    const std::vector<gp_float> analytic = analytic_jacobian(matrix);
+    SUNMatDestroy(matrix);
+
+    const std::vector<gp_float> y(N_VGetArrayPointer(cd->state),
+                                  N_VGetArrayPointer(cd->state) + size);
+
+    // Central differences, one column at a time. The rounding error of each
+    // quotient is bounded by the magnitude of the terms making up the row.
+    const std::vector<gp_float> f = rhs(y);
+    std::vector<gp_float> numeric(size * size, 0.);
+    std::vector<gp_float> noise(size * size, 0.);
+    for (size_t c = 0; c < size; ++c) {
+      const gp_float h = y[c] != 0. ? std::abs(y[c]) * 1e-4 : 1e-4;
+      std::vector<gp_float> y_plus = y;
+      std::vector<gp_float> y_minus = y;
+      y_plus[c] += h;
+      y_minus[c] -= h;
+      const std::vector<gp_float> f_plus = rhs(y_plus);
+      const std::vector<gp_float> f_minus = rhs(y_minus);
+      for (size_t r = 0; r < size; ++r) {
+        numeric[r * size + c] = (f_plus[r] - f_minus[r]) / (2. * h);
+        noise[r * size + c] = 1e-10 *
+                              std::max({std::abs(f[r]), std::abs(f_plus[r]),
+                                        std::abs(f_minus[r])}) /
+                              h;
+      }
+    }
+
+    for (size_t r = 0; r < size; ++r) {
+      for (size_t c = 0; c < size; ++c) {
+        const gp_float a = analytic[r * size + c];
+        const gp_float n = numeric[r * size + c];
+        EXPECT_NEAR(a, n, 1e-6 * std::abs(n) + noise[r * size + c])
+            << "row " << r << ", column " << c;
+      }
+    }
+  }
+
+  /** @brief Checks that the sparse writer stores the dense jacobian.
+   */
+  void expect_sparse_matches_dense() {
+    const size_t size = cd->state_size;
+    SUNMatrix dense_matrix = SUNDenseMatrix(size, size, cd->sun_context);
+    SUNMatrix sparse_matrix = SUNSparseMatrix(size, size, cd->jacobian_nnz(),
+                                              CSR_MAT, cd->sun_context);
+
+    const std::vector<gp_float> dense = analytic_jacobian(dense_matrix);
+    const std::vector<gp_float> sparse = analytic_jacobian(sparse_matrix);
+
+    EXPECT_EQ(SUNSparseMatrix_IndexPointers(sparse_matrix)[size],
+              cd->jacobian_nnz());
+    for (size_t i = 0; i < size * size; ++i) EXPECT_EQ(dense[i], sparse[i]);
+
+    SUNMatDestroy(dense_matrix);
+    SUNMatDestroy(sparse_matrix);
+  }
+
+  /** @brief Checks that the arrowhead writer stores the dense jacobian.
+   */
+  void expect_arrowhead_matches_dense() {
+    const size_t size = cd->state_size;
+    SUNMatrix dense_matrix = SUNDenseMatrix(size, size, cd->sun_context);
+    SUNMatrix arrowhead_matrix =
+        SUNArrowheadMatrix(size, cd->border_indices(), cd->sun_context);
+
+    const std::vector<gp_float> dense = analytic_jacobian(dense_matrix);
+    const std::vector<gp_float> arrowhead = analytic_jacobian(arrowhead_matrix);
+
+    for (size_t i = 0; i < size * size; ++i) EXPECT_EQ(dense[i], arrowhead[i]);
+
+    SUNMatDestroy(dense_matrix);
+    SUNMatDestroy(arrowhead_matrix);
+  }
+
+  ClusterDynamicsConfig config;
+  std::unique_ptr<ClusterDynamicsCpuImpl> cd;
+};
+
+TEST_F(JacobianTest, DenseMatchesFiniteDifferences) {
+  expect_dense_matches_finite_differences();
+}
+
+TEST_F(JacobianTest, SparseMatchesDense) { expect_sparse_matches_dense(); }
+
+TEST_F(JacobianTest, ArrowheadMatchesDense) {
+  expect_arrowhead_matches_dense();
+}
+
+TEST_F(JacobianTest, JacobianTimesVectorMatchesDense) {
+  const size_t size = cd->state_size;
+  SUNMatrix matrix = SUNDenseMatrix(size, size, cd->sun_context);
+  const std::vector<gp_float> dense = analytic_jacobian(matrix);
+  SUNMatDestroy(matrix);
+
+  N_Vector y = N_VClone(cd->state);
+  N_Vector v = N_VClone(cd->state);
+  N_Vector jv = N_VClone(cd->state);
+  N_VScale(1., cd->state, y);
+  for (size_t i = 0; i < size; ++i)
+    N_VGetArrayPointer(v)[i] = std::cos((gp_float)i);
+
+  ClusterDynamicsCpuImpl::jacobian_times_vector(v, jv, 0., y, nullptr,
+                                                cd.get(), nullptr);
+
+  for (size_t r = 0; r < size; ++r) {
+    gp_float expected = 0.;
+    for (size_t c = 0; c < size; ++c)
+      expected += dense[r * size + c] * N_VGetArrayPointer(v)[c];
+    EXPECT_NEAR(N_VGetArrayPointer(jv)[r], expected,
+                1e-12 * std::abs(expected));
+  }
+
+  N_VDestroy(y);
+  N_VDestroy(v);
+  N_VDestroy(jv);
+}
+
+// The groups or cells cover the sizes above max_cluster_size
+class CoarseTailJacobianTest : public JacobianTest {
+ protected:
+  void SetUp() override {
+    JacobianTest::SetUp();
+    config.max_cluster_size = 80;
+  }
+};
+
+TEST_F(CoarseTailJacobianTest, Groups_DenseMatchesFiniteDifferences) {
+  config.group_threshold = max_cluster_size;
+  config.group_growth = 1.5;
+  create();
+  ASSERT_FALSE(cd->groups.empty());
+  expect_dense_matches_finite_differences();
+}
+
+TEST_F(CoarseTailJacobianTest, Groups_SparseMatchesDense) {
+  config.group_threshold = max_cluster_size;
+  config.group_growth = 1.5;
+  create();
+  expect_sparse_matches_dense();
+}
+
+TEST_F(CoarseTailJacobianTest, Groups_ArrowheadMatchesDense) {
+  config.group_threshold = max_cluster_size;
+  config.group_growth = 1.5;
+  create();
+  expect_arrowhead_matches_dense();
+}
+
+TEST_F(CoarseTailJacobianTest, Continuum_DenseMatchesFiniteDifferences) {
+  config.continuum_threshold = max_cluster_size;
+  config.continuum_growth = 1.5;
+  create();
+  ASSERT_FALSE(cd->continuum_cells.empty());
+  expect_dense_matches_finite_differences();
+}
+
+TEST_F(CoarseTailJacobianTest, Continuum_SparseMatchesDense) {
+  config.continuum_threshold = max_cluster_size;
+  config.continuum_growth = 1.5;
+  create();
+  expect_sparse_matches_dense();
+}
+
+TEST_F(CoarseTailJacobianTest, Continuum_ArrowheadMatchesDense) {
+  config.continuum_threshold = max_cluster_size;
+  config.continuum_growth = 1.5;
+  create();
+  expect_arrowhead_matches_dense();
+}
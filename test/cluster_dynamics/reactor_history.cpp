@@ -0,0 +1,271 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "cluster_dynamics/cluster_dynamics.hpp"
+#include "cluster_dynamics/cluster_dynamics_config.hpp"
+#include "cluster_dynamics/cluster_dynamics_ensemble.hpp"
+#include "cluster_dynamics/reactor_history.hpp"
+#include "cpu/cluster_dynamics_cpu_impl.hpp"
+#include "model/material.hpp"
+#include "model/nuclear_reactor.hpp"
+
+class ReactorHistoryTest : public ::testing::Test {
+ protected:
+  static constexpr size_t max_cluster_size = 50;
+
+  void SetUp() override {
+    materials::SA304(config.material);
+    nuclear_reactors::OSIRIS(config.reactor);
+    config.max_cluster_size = max_cluster_size;
+    config.init_interstitials = std::vector<gp_float>(max_cluster_size, 0.);
+    config.init_vacancies = std::vector<gp_float>(max_cluster_size, 0.);
+
+    flux = config.reactor.get_flux();
+    temperature = config.reactor.get_temperature();
+  }
+
+  // Full power followed by an outage
+  ReactorHistory power_cycle() const {
+    return {ReactorHistoryInterpolation::constant,
+            {{0., flux, temperature}, {1e3, 0., 300.}}};
+  }
+
+  ClusterDynamicsConfig config;
+  gp_float flux;
+  gp_float temperature;
+};
+
+TEST_F(ReactorHistoryTest, At_HoldsOrInterpolatesThePoints) {
+  ReactorHistory history{ReactorHistoryInterpolation::constant,
+                         {{10., 1., 400.}, {20., 3., 600.}}};
+  EXPECT_EQ(history.at(0.).flux, 1.);
+  EXPECT_EQ(history.at(15.).flux, 1.);
+  EXPECT_EQ(history.at(20.).flux, 3.);
+  EXPECT_EQ(history.at(1e9).temperature, 600.);
+  EXPECT_FALSE(history.ramps(15.));
+
+  history.interpolation = ReactorHistoryInterpolation::linear;
+  EXPECT_EQ(history.at(0.).flux, 1.);
+  EXPECT_EQ(history.at(15.).flux, 2.);
+  EXPECT_EQ(history.at(15.).temperature, 500.);
+  EXPECT_EQ(history.at(1e9).flux, 3.);
+  EXPECT_TRUE(history.ramps(15.));
+  EXPECT_FALSE(history.ramps(20.));
+}
+
+TEST_F(ReactorHistoryTest, Dose_IntegratesTheFluxFromTimeZero) {
+  ReactorHistory history{ReactorHistoryInterpolation::constant,
+                         {{10., 1., 400.}, {20., 3., 600.}}};
+  EXPECT_DOUBLE_EQ(history.dose(0.), 0.);
+  EXPECT_DOUBLE_EQ(history.dose(15.), 15.);
+  EXPECT_DOUBLE_EQ(history.dose(30.), 10. + 10. + 30.);
+
+  history.interpolation = ReactorHistoryInterpolation::linear;
+  EXPECT_DOUBLE_EQ(history.dose(15.), 10. + 5. * 1.5);
+  EXPECT_DOUBLE_EQ(history.dose(30.), 10. + 10. * 2. + 30.);
+}
+
+TEST_F(ReactorHistoryTest, Repeat_ShiftsEachCycle) {
+  const ReactorHistory history = power_cycle().repeat(60, 2e3);
+  ASSERT_EQ(history.points.size(), 120u);
+  EXPECT_EQ(history.points[2].time, 2e3);
+  EXPECT_EQ(history.points[119].time, 59. * 2e3 + 1e3);
+  EXPECT_EQ(history.next_breakpoint(0.), 1e3);
+  EXPECT_EQ(history.next_breakpoint(1e3), 2e3);
+  EXPECT_EQ(history.next_breakpoint(1e6),
+            std::numeric_limits<gp_float>::infinity());
+  EXPECT_NO_THROW(history.validate());
+}
+
+TEST_F(ReactorHistoryTest, InvalidHistories_Throw) {
+  config.reactor_history = {ReactorHistoryInterpolation::constant,
+                            {{0., flux, temperature}, {0., 0., 300.}}};
+  EXPECT_THROW(ClusterDynamics::cpu(config), ClusterDynamicsException);
+
+  config.reactor_history.points[1].time = 1e3;
+  config.reactor_history.points[1].flux = -1.;
+  EXPECT_THROW(ClusterDynamics::cpu(config), ClusterDynamicsException);
+
+  config.reactor_history.points[1].flux = 0.;
+  config.reactor_history.points[1].temperature = 0.;
+  EXPECT_THROW(ClusterDynamics::cpu(config), ClusterDynamicsException);
+}
+
+TEST_F(ReactorHistoryTest, Run_ReportsTheDoseOfTheHistory) {
+  config.reactor_history = power_cycle();
+  ClusterDynamics cd = ClusterDynamics::cpu(config);
+  const ClusterDynamicsState state = cd.run(0., 3e3);
+  EXPECT_EQ(state.time, 3e3);
+  EXPECT_DOUBLE_EQ(state.dpa, flux * 1e3);
+}
+
+// The breakpoints restart the integrator without reallocating the linear
+// solver
+TEST_F(ReactorHistoryTest, Breakpoints_KeepTheLinearSolver) {
+  config.reactor_history = power_cycle().repeat(60, 2e3);
+  ClusterDynamicsCpuImpl cd(config);
+  const SUNLinearSolver linear_solver = cd.linear_solver;
+  const SUNMatrix jacobian_matrix = cd.jacobian_matrix;
+  const void* cvodes_memory_block = cd.cvodes_memory_block;
+
+  cd.run(60. * 2e3);
+  EXPECT_EQ(cd.time, 60. * 2e3);
+  EXPECT_EQ(cd.linear_solver, linear_solver);
+  EXPECT_EQ(cd.jacobian_matrix, jacobian_matrix);
+  EXPECT_EQ(cd.cvodes_memory_block, cvodes_memory_block);
+
+  // The run ends in the outage of the last cycle
+  EXPECT_EQ(cd.reactor.flux, 0.);
+  EXPECT_EQ(cd.reactor.temperature, 300.);
+}
+
+// Stopping at the outage gives the same result as changing the reactor
+// between two runs
+TEST_F(ReactorHistoryTest, History_MatchesSetReactorBetweenRuns) {
+  config.relative_tolerance = 1e-8;
+  ClusterDynamics stepped = ClusterDynamics::cpu(config);
+  stepped.run(0., 1e3);
+  NuclearReactor outage = config.reactor;
+  outage.set_flux(0.);
+  outage.set_temperature(300.);
+  stepped.set_reactor(outage);
+  const ClusterDynamicsState expected = stepped.run(0., 2e3);
+
+  config.reactor_history = power_cycle();
+  const ClusterDynamicsState state =
+      ClusterDynamics::cpu(config).run(0., 3e3);
+
+  EXPECT_EQ(state.time, expected.time);
+  EXPECT_NEAR(state.dislocation_density, expected.dislocation_density,
+              1e-4 * expected.dislocation_density);
+  for (size_t n = 1; n < 5; ++n) {
+    EXPECT_NEAR(state.interstitials[n], expected.interstitials[n],
+                1e-3 * expected.interstitials[n] + 1e-6)
+        << "size " << n;
+    EXPECT_NEAR(state.vacancies[n], expected.vacancies[n],
+                1e-3 * expected.vacancies[n] + 1e-6)
+        << "size " << n;
+  }
+}
+
+// A run which ends on a breakpoint leaves the next segment to the next run,
+// which starts it before taking a step
+TEST_F(ReactorHistoryTest, RunsEndingOnABreakpoint_MatchOneRun) {
+  config.reactor_history = power_cycle();
+  ClusterDynamicsCpuImpl expected(config);
+  expected.run(3e3);
+
+  ClusterDynamicsCpuImpl cd(config);
+  cd.run(1e3);
+  const ClusterDynamicsState state = cd.run(2e3);
+
+  EXPECT_EQ(cd.reactor.flux, expected.reactor.flux);
+  EXPECT_EQ(cd.reactor.temperature, expected.reactor.temperature);
+  const ClusterDynamicsState expected_state = expected.current_state(3e3);
+  EXPECT_EQ(state.time, expected_state.time);
+  EXPECT_EQ(state.dpa, expected_state.dpa);
+  EXPECT_EQ(state.interstitials, expected_state.interstitials);
+  EXPECT_EQ(state.vacancies, expected_state.vacancies);
+  EXPECT_EQ(state.dislocation_density, expected_state.dislocation_density);
+
+  // Sampling up to the breakpoint stops there too
+  ClusterDynamicsCpuImpl sampled(config);
+  sampled.sample({5e2, 1e3}, ClusterDynamicsSampleFn());
+  sampled.sample({3e3}, ClusterDynamicsSampleFn());
+  EXPECT_EQ(sampled.reactor.flux, expected.reactor.flux);
+  EXPECT_EQ(sampled.reactor.temperature, expected.reactor.temperature);
+}
+
+// Along a ramp system() only follows the tables of the flux and temperature
+// and interpolates the group and cell emission sums, which must match the
+// coefficients rebuilt from scratch at the same time
+TEST_F(ReactorHistoryTest, Ramp_InterpolatesTheEmissionWithinItsBound) {
+  config.max_cluster_size = 100000;
+  config.reactor_history = {
+      ReactorHistoryInterpolation::linear,
+      {{0., flux, temperature}, {1e3, 2. * flux, temperature + 50.}}};
+
+  for (const bool continuum : {false, true}) {
+    ClusterDynamicsConfig tail_config = config;
+    if (continuum) {
+      tail_config.continuum_threshold = 20;
+    } else {
+      tail_config.group_threshold = 20;
+      tail_config.group_growth = 1.5;
+    }
+    ClusterDynamicsCpuImpl cd(tail_config);
+    ClusterDynamicsCpuImpl exact(tail_config);
+    ASSERT_TRUE(cd.has_coarse_tail());
+    exact.reactor_ramping = false;
+
+    // The bound emission_weight_bracket_init() keeps the interpolation under,
+    // with the rounding of the sums
+    const gp_float tolerance = 1e-2 * cd.relative_tolerance + 1e-12;
+    N_Vector v_derivatives = N_VClone(cd.state);
+    size_t interpolated = 0;
+    for (gp_float t = 400.; t < 420.; t += .5) {
+      ClusterDynamicsCpuImpl::system(t, cd.state, v_derivatives, &cd);
+      if (cd.reactor.temperature != cd.emission_temperatures[0] &&
+          cd.reactor.temperature != cd.emission_temperatures[1])
+        ++interpolated;
+      exact.reactor.temperature = cd.reactor.temperature;
+      exact.reactor_coefficient_init();
+
+      for (size_t g = 0; g < cd.groups.size(); ++g) {
+        const GroupSums& ramped = cd.groups[g].vv_emission;
+        const GroupSums& rebuilt = exact.groups[g].vv_emission;
+        const gp_float width = exact.groups[g].width();
+        EXPECT_NEAR(ramped.s0, rebuilt.s0, tolerance * rebuilt.s0)
+            << "group " << g << " at " << t;
+        EXPECT_NEAR(ramped.s1, rebuilt.s1, tolerance * rebuilt.s0 * width)
+            << "group " << g << " at " << t;
+        EXPECT_NEAR(ramped.s2, rebuilt.s2,
+                    tolerance * rebuilt.s0 * width * width / 4.)
+            << "group " << g << " at " << t;
+      }
+      for (size_t k = 0; k < cd.continuum_cells.size(); ++k) {
+        const gp_float rebuilt = exact.continuum_cells[k].vv_emission;
+        EXPECT_NEAR(cd.continuum_cells[k].vv_emission, rebuilt,
+                    tolerance * rebuilt)
+            << "cell " << k << " at " << t;
+      }
+    }
+    N_VDestroy(v_derivatives);
+
+    // The times span a few brackets, most fall inside one
+    EXPECT_GT(interpolated, 20u) << (continuum ? "with the continuum" : "");
+  }
+}
+
+TEST_F(ReactorHistoryTest, Sample_StopsAtTheBreakpoints) {
+  config.reactor_history = power_cycle();
+  ClusterDynamics cd = ClusterDynamics::cpu(config);
+  const std::vector<gp_float> times{0., 5e2, 1e3, 1.5e3, 3e3};
+  const std::vector<ClusterDynamicsState> states = cd.sample(times);
+
+  ASSERT_EQ(states.size(), times.size());
+  for (size_t k = 0; k < times.size(); ++k) {
+    EXPECT_EQ(states[k].time, times[k]);
+    EXPECT_DOUBLE_EQ(states[k].dpa, config.reactor_history.dose(times[k]));
+  }
+  EXPECT_EQ(cd.get_time(), 3e3);
+}
+
+TEST_F(ReactorHistoryTest, UnsupportedCombinations_Throw) {
+  config.reactor_history = power_cycle();
+  EXPECT_THROW(ClusterDynamics::cpu(config).solve_steady_state(),
+               ClusterDynamicsException);
+  EXPECT_THROW(ClusterDynamics::cpu(config).enable_sensitivities(
+                   {SensitivityVariable::flux_dpa_s}),
+               ClusterDynamicsException);
+  EXPECT_THROW(ClusterDynamics::cpu(config).adjoint_gradient(
+                   1e3, ScalarObservable::dislocation_density),
+               ClusterDynamicsException);
+
+  std::vector<ClusterDynamicsConfig> configs{config};
+  EXPECT_THROW(ClusterDynamicsEnsemble ensemble(configs),
+               ClusterDynamicsException);
+}
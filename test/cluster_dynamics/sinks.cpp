@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "cluster_dynamics/async_sink.hpp"
+#include "cluster_dynamics/cluster_dynamics.hpp"
+#include "cluster_dynamics/cluster_dynamics_config.hpp"
+#include "model/material.hpp"
+#include "model/nuclear_reactor.hpp"
+
+class SinksTest : public ::testing::Test {
+ protected:
+  static constexpr size_t max_cluster_size = 50;
+
+  void SetUp() override {
+    materials::SA304(config.material);
+    nuclear_reactors::OSIRIS(config.reactor);
+    config.max_cluster_size = max_cluster_size;
+    config.init_interstitials = std::vector<gp_float>(max_cluster_size, 0.);
+    config.init_vacancies = std::vector<gp_float>(max_cluster_size, 0.);
+  }
+
+  ClusterDynamicsConfig config;
+  const std::vector<gp_float> times{1e2, 5e2, 1e3};
+};
+
+TEST_F(SinksTest, AddSink_MatchesSample) {
+  ClusterDynamics sampled = ClusterDynamics::cpu(config);
+  const std::vector<ClusterDynamicsState> expected = sampled.sample(times);
+
+  ClusterDynamics cd = ClusterDynamics::cpu(config);
+  std::vector<ClusterDynamicsState> states;
+  cd.add_sink(times, [&](const ClusterDynamicsStateView& state,
+                         const ClusterDynamicsStats&) {
+    states.push_back(state.to_state());
+  });
+  cd.run(0., 1e3);
+
+  ASSERT_EQ(states.size(), expected.size());
+  for (size_t i = 0; i < states.size(); ++i) {
+    EXPECT_EQ(states[i].time, expected[i].time);
+    EXPECT_EQ(states[i].interstitials, expected[i].interstitials);
+    EXPECT_EQ(states[i].vacancies, expected[i].vacancies);
+    EXPECT_EQ(states[i].dislocation_density, expected[i].dislocation_density);
+  }
+}
+
+// Each time is passed once even when the simulation stops on it, and the
+// sample() callback comes first at the same time
+TEST_F(SinksTest, AddSink_RunsAlongSample) {
+  ClusterDynamics cd = ClusterDynamics::cpu(config);
+  std::vector<std::pair<char, gp_float>> calls;
+  cd.add_sink(times, [&](const ClusterDynamicsStateView& state,
+                         const ClusterDynamicsStats&) {
+    calls.emplace_back('k', state.time);
+  });
+  cd.sample({5e2}, [&](const ClusterDynamicsState& state) {
+    calls.emplace_back('s', state.time);
+  });
+  cd.run(0., 5e2);
+
+  const std::vector<std::pair<char, gp_float>> expected{
+      {'k', 1e2}, {'s', 5e2}, {'k', 5e2}, {'k', 1e3}};
+  EXPECT_EQ(calls, expected);
+}
+
+TEST_F(SinksTest, RemoveSink_StopsTheCalls) {
+  ClusterDynamics cd = ClusterDynamics::cpu(config);
+  cd.run(0., 2e2);
+
+  size_t calls = 0;
+  const size_t id = cd.add_sink(
+      times, [&](const ClusterDynamicsStateView&, const ClusterDynamicsStats&) {
+        ++calls;
+      });
+  cd.run(0., 4e2);
+  // The time before the sink was added is skipped
+  EXPECT_EQ(calls, 1u);
+
+  cd.remove_sink(id);
+  cd.run(0., 1e3);
+  EXPECT_EQ(calls, 1u);
+}
+
+TEST_F(SinksTest, AddSink_UnsortedTimes_Throws) {
+  ClusterDynamics cd = ClusterDynamics::cpu(config);
+  EXPECT_THROW(cd.add_sink({2., 1.}, [](const ClusterDynamicsStateView&,
+                                        const ClusterDynamicsStats&) {}),
+               ClusterDynamicsException);
+}
+
+TEST_F(SinksTest, StepSink_FollowsEveryStep) {
+  ClusterDynamics cd = ClusterDynamics::cpu(config);
+  std::vector<gp_float> step_times;
+  cd.add_step_sink([&](const ClusterDynamicsStateView& state,
+                       const ClusterDynamicsStats& stats) {
+    EXPECT_EQ(state.interstitials.size(), max_cluster_size);
+    EXPECT_GE(stats.steps, 0);
+    step_times.push_back(state.time);
+  });
+  cd.run(0., 1e3);
+
+  ASSERT_FALSE(step_times.empty());
+  EXPECT_TRUE(std::is_sorted(step_times.begin(), step_times.end()));
+  EXPECT_EQ(step_times.back(), 1e3);
+}
+
+TEST_F(SinksTest, AsyncSink_PassesEveryStateInOrder) {
+  std::vector<gp_float> received;
+  std::thread::id sink_thread;
+  {
+    AsyncSink async({[&](const ClusterDynamicsStateView& state,
+                         const ClusterDynamicsStats&) {
+                      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                      sink_thread = std::this_thread::get_id();
+                      received.push_back(state.time);
+                    }},
+                    1);
+    ClusterDynamics cd = ClusterDynamics::cpu(config);
+    cd.add_sink(times, async.sink());
+    cd.run(0., 1e3);
+    async.flush();
+    EXPECT_EQ(async.get_dropped(), 0u);
+  }
+
+  EXPECT_EQ(received, times);
+  EXPECT_NE(sink_thread, std::this_thread::get_id());
+}
+
+TEST_F(SinksTest, AsyncSink_Drop_NeverWaits) {
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+  size_t received = 0;
+  AsyncSink async({[&](const ClusterDynamicsStateView&,
+                       const ClusterDynamicsStats&) {
+                    released.wait();
+                    ++received;
+                  }},
+                  1, SinkOverflow::drop);
+
+  ClusterDynamics cd = ClusterDynamics::cpu(config);
+  cd.add_sink(times, async.sink());
+  cd.run(0., 1e3);
+  release.set_value();
+  async.flush();
+
+  // The slot of the state held by the blocked sink stays taken
+  EXPECT_EQ(received, 1u);
+  EXPECT_EQ(async.get_dropped(), times.size() - 1);
+}
+
+TEST_F(SinksTest, AsyncSink_RethrowsSinkErrors) {
+  AsyncSink async({[](const ClusterDynamicsStateView&,
+                      const ClusterDynamicsStats&) {
+    throw std::runtime_error("disk full");
+  }});
+
+  ClusterDynamics cd = ClusterDynamics::cpu(config);
+  cd.add_sink({1e2}, async.sink());
+  cd.run(0., 1e2);
+  EXPECT_THROW(async.flush(), std::runtime_error);
+}
@@ -0,0 +1,159 @@
+#include "solver_stats.hpp"
+
+#include <gtest/gtest.h>
+#include <nvector/nvector_serial.h>
+
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include "cluster_dynamics/cluster_dynamics.hpp"
+#include "cluster_dynamics/cluster_dynamics_config.hpp"
+#include "cpu/arrowhead_linear_solver.hpp"
+#include "model/material.hpp"
+#include "model/nuclear_reactor.hpp"
+
+class SolverStatsTest : public ::testing::Test {
+ protected:
+  static constexpr size_t max_cluster_size = 50;
+
+  void SetUp() override {
+    materials::SA304(config.material);
+    nuclear_reactors::OSIRIS(config.reactor);
+    config.max_cluster_size = max_cluster_size;
+    config.init_interstitials = std::vector<gp_float>(max_cluster_size, 0.);
+    config.init_vacancies = std::vector<gp_float>(max_cluster_size, 0.);
+  }
+
+  static gp_float seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<gp_float>(std::chrono::steady_clock::now() -
+                                           start)
+        .count();
+  }
+
+  static void expect_counters_at_least(const ClusterDynamicsStats& stats,
+                                       const ClusterDynamicsStats& before) {
+    EXPECT_GE(stats.steps, before.steps);
+    EXPECT_GE(stats.rhs_evaluations, before.rhs_evaluations);
+    EXPECT_GE(stats.jacobian_evaluations, before.jacobian_evaluations);
+    EXPECT_GE(stats.linear_solver_setups, before.linear_solver_setups);
+    EXPECT_GE(stats.linear_iterations, before.linear_iterations);
+    EXPECT_GE(stats.nonlinear_iterations, before.nonlinear_iterations);
+    EXPECT_GE(stats.error_test_failures, before.error_test_failures);
+    EXPECT_GE(stats.nonlinear_failures, before.nonlinear_failures);
+    EXPECT_GE(stats.rhs_time, before.rhs_time);
+    EXPECT_GE(stats.jacobian_time, before.jacobian_time);
+    EXPECT_GE(stats.linear_setup_time, before.linear_setup_time);
+    EXPECT_GE(stats.linear_solve_time, before.linear_solve_time);
+    EXPECT_GE(stats.integrator_time, before.integrator_time);
+  }
+
+  ClusterDynamicsConfig config;
+};
+
+TEST_F(SolverStatsTest, PhaseTimer_CountsNestedTimeOnce) {
+  ClusterDynamicsStats stats;
+  PhaseTimer timer;
+  const auto start = std::chrono::steady_clock::now();
+  {
+    ScopedPhase outer(timer, &stats.integrator_time);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    {
+      ScopedPhase inner(timer, &stats.rhs_time);
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    {
+      ScopedPhase paused(timer, nullptr);
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+  }
+  const gp_float elapsed = seconds_since(start);
+
+  EXPECT_GE(stats.integrator_time, 1e-2);
+  EXPECT_GE(stats.rhs_time, 1e-2);
+  EXPECT_LE(stats.wall_time(), elapsed - 2e-2);
+}
+
+TEST_F(SolverStatsTest, TimedLinearSolver_ForwardsToTheWrappedSolver) {
+  constexpr sunindextype size = 8;
+  SUNContext sun_context;
+  SUNContext_Create(SUN_COMM_NULL, &sun_context);
+  SUNMatrix matrix = SUNArrowheadMatrix(size, {size - 1}, sun_context);
+  for (sunindextype i = 0; i < size; ++i)
+    SUNArrowheadMatrix_Content(matrix)->add(i, i, 2. + i);
+
+  ClusterDynamicsStats stats;
+  PhaseTimer timer;
+  SUNLinearSolver solver = SUNLinSol_Timed(
+      SUNLinSol_Arrowhead(matrix, sun_context), &timer,
+      &stats.linear_setup_time, &stats.linear_solve_time);
+  ASSERT_NE(solver, nullptr);
+  EXPECT_EQ(SUNLinSolGetType(solver), SUNLINEARSOLVER_DIRECT);
+  EXPECT_EQ(solver->ops->setatimes, nullptr);
+
+  N_Vector rhs = N_VNew_Serial(size, sun_context);
+  N_Vector x = N_VNew_Serial(size, sun_context);
+  N_VConst(1., rhs);
+  ASSERT_EQ(SUNLinSolInitialize(solver), 0);
+  ASSERT_EQ(SUNLinSolSetup(solver, matrix), 0);
+  ASSERT_EQ(SUNLinSolSolve(solver, matrix, x, rhs, 0.), 0);
+
+  for (sunindextype i = 0; i < size; ++i)
+    EXPECT_NEAR(N_VGetArrayPointer(x)[i], 1. / (2. + i), 1e-14);
+  EXPECT_GT(stats.linear_setup_time, 0.);
+  EXPECT_GT(stats.linear_solve_time, 0.);
+  EXPECT_EQ(stats.rhs_time, 0.);
+
+  N_VDestroy_Serial(rhs);
+  N_VDestroy_Serial(x);
+  SUNLinSolFree(solver);
+  SUNMatDestroy(matrix);
+  SUNContext_Free(&sun_context);
+}
+
+TEST_F(SolverStatsTest, Run_AccumulatesStats) {
+  ClusterDynamics cd = ClusterDynamics::cpu(config);
+  const ClusterDynamicsStats initial = cd.get_stats();
+  EXPECT_EQ(initial.steps, 0);
+  EXPECT_EQ(initial.wall_time(), 0.);
+
+  cd.run(0., 1e3);
+  const ClusterDynamicsStats first = cd.get_stats();
+  expect_counters_at_least(first, initial);
+  EXPECT_GT(first.integrator_time, 0.);
+  EXPECT_DOUBLE_EQ(first.wall_time(),
+                   first.rhs_time + first.jacobian_time +
+                       first.linear_setup_time + first.linear_solve_time +
+                       first.integrator_time);
+
+  cd.run(0., 1e3);
+  expect_counters_at_least(cd.get_stats(), first);
+}
+
+// The counters of the integrator carry over the restarts at the breakpoints
+// of a reactor history
+TEST_F(SolverStatsTest, Restarts_KeepTheCounters) {
+  config.reactor_history = {
+      ReactorHistoryInterpolation::constant,
+      {{0., config.reactor.get_flux(), config.reactor.get_temperature()},
+       {1e3, 0., 300.}}};
+  ClusterDynamics cd = ClusterDynamics::cpu(config);
+  cd.run(0., 1e3);
+  const ClusterDynamicsStats first = cd.get_stats();
+
+  cd.run(0., 2e3);
+  expect_counters_at_least(cd.get_stats(), first);
+}
+
+TEST_F(SolverStatsTest, Sample_ExcludesTheCallback) {
+  ClusterDynamics cd = ClusterDynamics::cpu(config);
+  const std::vector<gp_float> times{0., 1e2, 1e3};
+  const auto start = std::chrono::steady_clock::now();
+  cd.sample(times, [](const ClusterDynamicsState&) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  });
+  const gp_float elapsed = seconds_since(start);
+
+  EXPECT_LE(cd.get_stats().wall_time(), elapsed - 3e-2);
+}
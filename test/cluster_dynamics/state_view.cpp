@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "cluster_dynamics/cluster_dynamics.hpp"
+#include "cluster_dynamics/cluster_dynamics_config.hpp"
+#include "model/material.hpp"
+#include "model/nuclear_reactor.hpp"
+
+class StateViewTest : public ::testing::Test {
+ protected:
+  static constexpr size_t max_cluster_size = 50;
+
+  void SetUp() override {
+    materials::SA304(config.material);
+    nuclear_reactors::OSIRIS(config.reactor);
+    config.max_cluster_size = max_cluster_size;
+    config.init_interstitials = std::vector<gp_float>(max_cluster_size, 0.);
+    config.init_vacancies = std::vector<gp_float>(max_cluster_size, 0.);
+    for (size_t n = 1; n < max_cluster_size; ++n) {
+      config.init_interstitials[n] = 1e6 / (gp_float)(n * n);
+      config.init_vacancies[n] = 3e5 / (gp_float)n;
+    }
+  }
+
+  static void expect_equal(const ClusterDynamicsStateView& view,
+                           const ClusterDynamicsState& state) {
+    EXPECT_EQ(view.time, state.time);
+    EXPECT_EQ(view.dpa, state.dpa);
+    EXPECT_EQ(view.dislocation_density, state.dislocation_density);
+    EXPECT_EQ(std::vector<gp_float>(view.interstitials.begin(),
+                                    view.interstitials.end()),
+              state.interstitials);
+    EXPECT_EQ(std::vector<gp_float>(view.vacancies.begin(),
+                                    view.vacancies.end()),
+              state.vacancies);
+    EXPECT_EQ(view.interstitial_groups.size(),
+              state.interstitial_groups.size());
+    EXPECT_EQ(view.vacancy_groups.size(), state.vacancy_groups.size());
+  }
+
+  ClusterDynamicsConfig config;
+};
+
+TEST_F(StateViewTest, RunInto_MatchesRun) {
+  ClusterDynamics cd = ClusterDynamics::cpu(config);
+  ClusterDynamics cd_into = ClusterDynamics::cpu(config);
+
+  ClusterDynamicsState state;
+  for (int i = 0; i < 3; ++i) {
+    const ClusterDynamicsState expected = cd.run(0., 1e2);
+    cd_into.run_into(0., 1e2, state);
+    expect_equal(state.view(), expected);
+  }
+}
+
+TEST_F(StateViewTest, RunInto_ReusesTheVectors) {
+  ClusterDynamics cd = ClusterDynamics::cpu(config);
+  ClusterDynamicsState state;
+  cd.run_into(0., 1e2, state);
+  const gp_float* interstitials = state.interstitials.data();
+  const gp_float* vacancies = state.vacancies.data();
+
+  cd.run_into(0., 1e2, state);
+  EXPECT_EQ(state.interstitials.data(), interstitials);
+  EXPECT_EQ(state.vacancies.data(), vacancies);
+}
+
+TEST_F(StateViewTest, GetStateView_IsTheCurrentState) {
+  ClusterDynamics cd = ClusterDynamics::cpu(config);
+  expect_equal(cd.get_state_view(), cd.run(0., 0.));
+
+  const ClusterDynamicsState state = cd.run(0., 1e3);
+  const ClusterDynamicsStateView view = cd.get_state_view();
+  expect_equal(view, state);
+  expect_equal(view, view.to_state());
+}
+
+TEST_F(StateViewTest, GetStateView_InSampleIsTheSample) {
+  ClusterDynamics cd = ClusterDynamics::cpu(config);
+  size_t samples = 0;
+  cd.sample({1e2, 5e2, 1e3}, [&](const ClusterDynamicsState& sample) {
+    expect_equal(cd.get_state_view(), sample);
+    ++samples;
+  });
+  EXPECT_EQ(samples, 3u);
+}
+
+// The printers read the concentrations of grouped sizes from the view
+// instead of expanding the state
+TEST_F(StateViewTest, Concentration_MatchesExpanded) {
+  config.init_interstitials.push_back(0.);
+  config.init_vacancies.push_back(0.);
+  for (size_t n = 1; n <= max_cluster_size; ++n) {
+    config.init_interstitials[n] = 1e6 + 2e3 * (gp_float)n;
+    config.init_vacancies[n] = 5e5 - 1e3 * (gp_float)n;
+  }
+  config.group_threshold = 20;
+  config.group_growth = 1.5;
+  ClusterDynamics cd = ClusterDynamics::cpu(config);
+
+  const ClusterDynamicsState state = cd.run(0., 1e2);
+  const ClusterDynamicsStateView view = state.view();
+  ASSERT_FALSE(view.interstitial_groups.empty());
+  const ClusterDynamicsState expanded = state.expanded();
+  ASSERT_EQ(view.size(), expanded.interstitials.size());
+  for (size_t n = 0; n < view.size(); ++n) {
+    EXPECT_EQ(view.interstitial(n), expanded.interstitials[n]);
+    EXPECT_EQ(view.vacancy(n), expanded.vacancies[n]);
+  }
+  EXPECT_EQ(view.interstitial(view.size()), 0.);
+}
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "cluster_dynamics/cluster_dynamics.hpp"
+#include "cluster_dynamics/cluster_dynamics_config.hpp"
+#include "cpu/cluster_dynamics_cpu_impl.hpp"
+#include "model/material.hpp"
+#include "model/nuclear_reactor.hpp"
+
+class SteadyStateTest : public ::testing::Test {
+ protected:
+  static constexpr size_t max_cluster_size = 50;
+
+  void SetUp() override {
+    materials::SA304(config.material);
+    nuclear_reactors::OSIRIS(config.reactor);
+    config.max_cluster_size = max_cluster_size;
+    config.init_interstitials = std::vector<gp_float>(max_cluster_size, 0.);
+    config.init_vacancies = std::vector<gp_float>(max_cluster_size, 0.);
+  }
+
+  // The solver's own convergence measure, evaluated afresh at the state
+  gp_float residual(ClusterDynamicsCpuImpl& cd) {
+    N_Vector v_derivatives = N_VClone(cd.state);
+    SUNMatrix v_jacobian =
+        SUNArrowheadMatrix(cd.state_size, cd.border_indices(), cd.sun_context);
+    ClusterDynamicsCpuImpl::system(0., cd.state, v_derivatives, &cd);
+    ClusterDynamicsCpuImpl::jacobian(0., cd.state, v_derivatives, v_jacobian,
+                                     &cd, nullptr, nullptr, nullptr);
+    const gp_float result =
+        cd.steady_state_residual(cd.state, v_derivatives, v_jacobian);
+    SUNMatDestroy(v_jacobian);
+    N_VDestroy(v_derivatives);
+    return result;
+  }
+
+  ClusterDynamicsConfig config;
+};
+
+TEST_F(SteadyStateTest, Newton_ReachesSteadyState) {
+  ClusterDynamicsCpuImpl cd(config);
+  EXPECT_GT(residual(cd), 1.);
+
+  const ClusterDynamicsState state = cd.solve_steady_state();
+
+  // Newton converges from the start, without integrating
+  EXPECT_EQ(state.time, 0.);
+  EXPECT_LE(residual(cd), 1.);
+  EXPECT_GT(state.interstitials[1], 0.);
+  EXPECT_GT(state.vacancies[1], 0.);
+  EXPECT_GT(state.dislocation_density, 0.);
+}
+
+TEST_F(SteadyStateTest, SteadyState_IndependentOfStart) {
+  ClusterDynamicsCpuImpl cd(config);
+  const ClusterDynamicsState expected = cd.solve_steady_state();
+
+  N_VScale(3., cd.state, cd.state);
+  const ClusterDynamicsState state = cd.solve_steady_state();
+
+  for (size_t n = 1; n < max_cluster_size; ++n) {
+    EXPECT_NEAR(state.interstitials[n], expected.interstitials[n],
+                1e-4 * expected.interstitials[n] + config.absolute_tolerance);
+    EXPECT_NEAR(state.vacancies[n], expected.vacancies[n],
+                1e-4 * expected.vacancies[n] + config.absolute_tolerance);
+  }
+}
+
+TEST_F(SteadyStateTest, SteadyState_IsAFixedPoint) {
+  ClusterDynamics cd = ClusterDynamics::cpu(config);
+  const ClusterDynamicsState first = cd.solve_steady_state();
+  const ClusterDynamicsState second = cd.solve_steady_state();
+  EXPECT_EQ(first.interstitials, second.interstitials);
+  EXPECT_EQ(first.vacancies, second.vacancies);
+}
+
+TEST_F(SteadyStateTest, WithGrouping_Throws) {
+  config.group_threshold = 20;
+  ClusterDynamics cd = ClusterDynamics::cpu(config);
+  EXPECT_THROW(cd.solve_steady_state(), ClusterDynamicsException);
+}
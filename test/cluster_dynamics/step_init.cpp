@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "cluster_dynamics/cluster_dynamics_config.hpp"
+#include "cpu/cluster_dynamics_cpu_impl.hpp"
+#include "model/material.hpp"
+#include "model/nuclear_reactor.hpp"
+
+class StepInitTest : public ::testing::Test {
+ protected:
+  static constexpr size_t max_cluster_size = 50;
+
+  void SetUp() override {
+    materials::SA304(config.material);
+    nuclear_reactors::OSIRIS(config.reactor);
+    config.max_cluster_size = max_cluster_size;
+    config.init_interstitials = std::vector<gp_float>(max_cluster_size, 0.);
+    config.init_vacancies = std::vector<gp_float>(max_cluster_size, 0.);
+
+    cd = std::make_unique<ClusterDynamicsCpuImpl>(config);
+
+    for (size_t n = 1; n <= max_cluster_size; ++n) {
+      cd->interstitials[n] = 1e12 / (gp_float)(n * n);
+      cd->vacancies[n] = 3e11 / (gp_float)n;
+    }
+    *cd->dislocation_density = 1e10;
+  }
+
+  ClusterDynamicsConfig config;
+  std::unique_ptr<ClusterDynamicsCpuImpl> cd;
+};
+
+// The fused sweep accumulates in the same order as the reference functions,
+// so the results must be identical, not just close.
+TEST_F(StepInitTest, FusedSweep_MatchesReferenceFunctions) {
+  cd->transport_kernel = select_transport_kernel(SimdLevel::scalar);
+  cd->step_init();
+
+  const size_t N = max_cluster_size;
+  EXPECT_EQ(cd->ii_sum_absorption_val, cd->ii_sum_absorption(N - 1));
+  EXPECT_EQ(cd->iv_sum_absorption_val, cd->iv_sum_absorption(N - 1));
+  EXPECT_EQ(cd->vi_sum_absorption_val, cd->vi_sum_absorption(N - 1));
+  EXPECT_EQ(cd->vv_sum_absorption_val, cd->vv_sum_absorption(N - 1));
+  EXPECT_EQ(cd->i_emission_rate_val, cd->i_emission_rate());
+  EXPECT_EQ(cd->v_emission_rate_val, cd->v_emission_rate());
+  EXPECT_EQ(cd->i_absorption_rate_val, cd->i_absorption_rate());
+  EXPECT_EQ(cd->v_absorption_rate_val, cd->v_absorption_rate());
+  EXPECT_EQ(cd->mean_dislocation_radius_val,
+            cd->mean_dislocation_cell_radius());
+
+  gp_float gain = 0.;
+  for (size_t n = 1; n < N; ++n) {
+    gain += cd->cluster_radius(n) * cd->ii_absorption(n) *
+            cd->interstitials[n] *
+            cd->i_dislocation_loop_unfault_probability(n);
+  }
+  gain *= 2. * M_PI / cd->material.atomic_volume;
+  EXPECT_DOUBLE_EQ(cd->dislocation_gain_val, gain);
+}
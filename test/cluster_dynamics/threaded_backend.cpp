@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "cluster_dynamics/cluster_dynamics.hpp"
+#include "cluster_dynamics/cluster_dynamics_config.hpp"
+#include "cpu/cluster_dynamics_cpu_impl.hpp"
+#include "model/material.hpp"
+#include "model/nuclear_reactor.hpp"
+
+class ThreadedBackendTest : public ::testing::Test {
+ protected:
+  // Several blocks, the last one partial
+  static constexpr size_t max_cluster_size =
+      3 * ClusterDynamicsCpuImpl::parallel_block_size + 17;
+
+  void SetUp() override {
+    materials::SA304(config.material);
+    nuclear_reactors::OSIRIS(config.reactor);
+    config.max_cluster_size = max_cluster_size;
+    config.init_interstitials = std::vector<gp_float>(max_cluster_size, 0.);
+    config.init_vacancies = std::vector<gp_float>(max_cluster_size, 0.);
+    for (size_t n = 1; n < max_cluster_size; ++n) {
+      config.init_interstitials[n] = 1e12 / (gp_float)(n * n);
+      config.init_vacancies[n] = 3e11 / (gp_float)n;
+    }
+    config.linear_solver = LinearSolverType::arrowhead;
+  }
+
+  /** @brief Evaluates system() at the initial state of a backend with the
+   * given number of threads.
+   */
+  std::vector<gp_float> rhs(size_t num_threads) {
+    ClusterDynamicsCpuImpl cd(config, num_threads);
+    N_Vector derivatives = N_VClone(cd.state);
+    ClusterDynamicsCpuImpl::system(0., cd.state, derivatives, &cd);
+    std::vector<gp_float> result(N_VGetArrayPointer(derivatives),
+                                 N_VGetArrayPointer(derivatives) +
+                                     cd.state_size);
+    N_VDestroy(derivatives);
+    return result;
+  }
+
+  ClusterDynamicsConfig config;
+};
+
+TEST_F(ThreadedBackendTest, Results_IndependentOfThreadCount) {
+  const std::vector<gp_float> two_threads = rhs(2);
+  EXPECT_EQ(rhs(3), two_threads);
+  EXPECT_EQ(rhs(4), two_threads);
+}
+
+// The single threaded backend sums in the same blocks
+TEST_F(ThreadedBackendTest, Results_MatchSingleThreaded) {
+  EXPECT_EQ(rhs(4), rhs(1));
+}
+
+TEST_F(ThreadedBackendTest, Norms_IndependentOfThreadCount) {
+  ClusterDynamicsCpuImpl two_threads(config, 2);
+  ClusterDynamicsCpuImpl threaded(config, 4);
+  N_Vector weights = N_VClone(two_threads.state);
+  N_VConst(1e-3, weights);
+  N_Vector threaded_weights = N_VClone(threaded.state);
+  N_VConst(1e-3, threaded_weights);
+
+  EXPECT_EQ(N_VWrmsNorm(threaded.state, threaded_weights),
+            N_VWrmsNorm(two_threads.state, weights));
+  EXPECT_EQ(N_VDotProd(threaded.state, threaded.state),
+            N_VDotProd(two_threads.state, two_threads.state));
+
+  N_VDestroy(weights);
+  N_VDestroy(threaded_weights);
+}
+
+// Only the threaded backend pays for the block sums
+TEST_F(ThreadedBackendTest, SingleThreaded_KeepsSerialVectorOps) {
+  ClusterDynamicsCpuImpl serial(config, 1);
+  ClusterDynamicsCpuImpl threaded(config, 4);
+  N_Vector stock = N_VNew_Serial(serial.state_size, serial.sun_context);
+
+  EXPECT_EQ(serial.state->ops->nvwrmsnorm, stock->ops->nvwrmsnorm);
+  EXPECT_EQ(serial.state->ops->nvdotprod, stock->ops->nvdotprod);
+  EXPECT_NE(threaded.state->ops->nvwrmsnorm, stock->ops->nvwrmsnorm);
+
+  N_VDestroy(stock);
+}
+
+TEST_F(ThreadedBackendTest, ZeroThreads_Throws) {
+  EXPECT_THROW(ClusterDynamics::cpu_threaded(config, 0),
+               ClusterDynamicsException);
+}
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "../gtest_helpers.hpp"
+#include "cluster_dynamics/cluster_dynamics_config.hpp"
+#include "cpu/cluster_dynamics_cpu_impl.hpp"
+#include "cpu/transport_kernel.hpp"
+#include "model/material.hpp"
+#include "model/nuclear_reactor.hpp"
+
+class TransportKernelTest : public ::testing::Test {
+ protected:
+  // Not a multiple of any vector width, so the scalar remainder runs too
+  static constexpr size_t max_cluster_size = 53;
+
+  void SetUp() override {
+    materials::SA304(config.material);
+    nuclear_reactors::OSIRIS(config.reactor);
+    config.max_cluster_size = max_cluster_size;
+    config.init_interstitials = std::vector<gp_float>(max_cluster_size, 0.);
+    config.init_vacancies = std::vector<gp_float>(max_cluster_size, 0.);
+
+    cd = std::make_unique<ClusterDynamicsCpuImpl>(config);
+
+    for (size_t n = 1; n <= max_cluster_size; ++n) {
+      cd->interstitials[n] = 1e12 / (gp_float)(n * n);
+      cd->vacancies[n] = 3e11 / (gp_float)n;
+    }
+    *cd->dislocation_density = 1e10;
+  }
+
+  /** @brief Returns the kernels of every instruction set the CPU supports.
+   */
+  std::vector<TransportKernel> supported_kernels() {
+    std::vector<TransportKernel> kernels;
+    for (SimdLevel level :
+         {SimdLevel::scalar, SimdLevel::avx2, SimdLevel::avx512}) {
+      TransportKernel kernel = select_transport_kernel(level);
+      if (kernel.level == level) kernels.push_back(kernel);
+    }
+    return kernels;
+  }
+
+  ClusterDynamicsConfig config;
+  std::unique_ptr<ClusterDynamicsCpuImpl> cd;
+};
+
+TEST_F(TransportKernelTest, Stencil_MatchesConcentrationDerivatives) {
+  const size_t N = max_cluster_size;
+  for (const TransportKernel& kernel : supported_kernels()) {
+    SCOPED_TRACE(simd_level_name(kernel.level));
+    std::vector<gp_float> i_derivatives(N + 2, 0.);
+    std::vector<gp_float> v_derivatives(N + 2, 0.);
+    kernel.stencil(cd->transport_kernel_args(), 2, N + 1,
+                   i_derivatives.data(), v_derivatives.data());
+
+    for (size_t n = 2; n <= N; ++n) {
+      // The stencil nearly cancels, so bound the error by its largest term
+      const gp_float i_scale =
+          std::abs(cd->i_combined_promotion_demotion_rate(n) *
+                   cd->interstitials[n]);
+      const gp_float v_scale = std::abs(
+          cd->v_combined_promotion_demotion_rate(n) * cd->vacancies[n]);
+      EXPECT_NEAR(i_derivatives[n], cd->i_concentration_derivative(n),
+                  i_scale * 1e-12);
+      EXPECT_NEAR(v_derivatives[n], cd->v_concentration_derivative(n),
+                  v_scale * 1e-12);
+    }
+  }
+}
+
+TEST_F(TransportKernelTest, Reduce_MatchesScalarKernel) {
+  const size_t N = max_cluster_size;
+  TransportSums expected;
+  transport_reduce_scalar(cd->transport_kernel_args(), 3, N - 1, expected);
+
+  for (const TransportKernel& kernel : supported_kernels()) {
+    SCOPED_TRACE(simd_level_name(kernel.level));
+    TransportSums sums;
+    kernel.reduce(cd->transport_kernel_args(), 3, N - 1, sums);
+
+    GP_EXPECT_NEAR(sums.ii_sum, expected.ii_sum);
+    GP_EXPECT_NEAR(sums.iv_sum, expected.iv_sum);
+    GP_EXPECT_NEAR(sums.vi_sum, expected.vi_sum);
+    GP_EXPECT_NEAR(sums.vv_sum, expected.vv_sum);
+    GP_EXPECT_NEAR(sums.i_absorption, expected.i_absorption);
+    GP_EXPECT_NEAR(sums.v_absorption, expected.v_absorption);
+    GP_EXPECT_NEAR(sums.i_emission, expected.i_emission);
+    GP_EXPECT_NEAR(sums.v_emission, expected.v_emission);
+    GP_EXPECT_NEAR(sums.radius, expected.radius);
+    GP_EXPECT_NEAR(sums.dislocation_gain, expected.dislocation_gain);
+  }
+}
+
+TEST_F(TransportKernelTest, Select_FallsBackToSupportedLevel) {
+  const SimdLevel supported = detect_simd_level();
+  EXPECT_EQ(select_transport_kernel(SimdLevel::scalar).level,
+            SimdLevel::scalar);
+  EXPECT_LE((int)select_transport_kernel(SimdLevel::avx512).level,
+            (int)supported);
+}